@@ -31,6 +31,28 @@ macro(SG_add_gtests)
   endforeach()
 endmacro(SG_add_gtests)
 
+# Minimum requirement is a list of cpp:
+# set(SG_MODULE_${SG_MODULE_NAME}_BENCHMARKS
+#  bench_graphviz_io.cpp
+# )
+# And the dependencies
+#  set(SG_MODULE_${SG_MODULE_NAME}_BENCHMARK_DEPENDS
+#    ${SG_MODULE_${SG_MODULE_NAME}_LIBRARY}
+#    ${SG_MODULE_${SG_MODULE_NAME}_DEPENDS})
+# Benchmarks are executables (not tests), they can read the images folder of
+# the source tree from the SG_BENCHMARK_IMAGES_FOLDER compile definition.
+macro(SG_add_benchmarks)
+  foreach(benchmark_file ${SG_MODULE_${SG_MODULE_NAME}_BENCHMARKS})
+    string(REGEX REPLACE "\\.[^.]*$" "" benchmark_name "${benchmark_file}")
+    add_executable(${benchmark_name} ${benchmark_file})
+    target_link_libraries(${benchmark_name} PRIVATE
+      ${SG_MODULE_${SG_MODULE_NAME}_BENCHMARK_DEPENDS}
+      )
+    target_compile_definitions(${benchmark_name} PRIVATE
+      SG_BENCHMARK_IMAGES_FOLDER="${PROJECT_SOURCE_DIR}/images")
+  endforeach()
+endmacro(SG_add_benchmarks)
+
 # Minimum requirement is a list of python_tests_:
 #  set(python_tests_
 #   test_array3d.py
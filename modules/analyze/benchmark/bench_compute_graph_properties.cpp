@@ -0,0 +1,134 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+/**
+ * Compare calling compute_degrees, compute_ete_distances,
+ * compute_contour_lengths, compute_angles and compute_cosines back to back
+ * (as export_graph_data_interface used to do) with the fused
+ * compute_graph_properties_all, with one and num_threads threads.
+ *
+ * The graph has num_vertices nodes with random positions, each node is
+ * connected to 3 random nodes, and the edge points are a straight line
+ * between them.
+ *
+ * Usage: bench_compute_graph_properties [num_vertices] [num_threads]
+ */
+
+#include "compute_graph_properties.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+
+namespace {
+template <typename TFunction>
+double time_seconds(TFunction &&function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+SG::GraphType random_graph(const size_t num_vertices) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> pos_dis(0.0, 1000.0);
+    std::uniform_int_distribution<size_t> vertex_dis(0, num_vertices - 1);
+    SG::GraphType g(num_vertices);
+    for (size_t i = 0; i < num_vertices; ++i) {
+        g[i].pos = {{pos_dis(gen), pos_dis(gen), pos_dis(gen)}};
+    }
+    for (size_t i = 0; i < num_vertices; ++i) {
+        for (size_t k = 0; k < 3; ++k) {
+            const auto j = vertex_dis(gen);
+            if (i == j) {
+                continue;
+            }
+            SG::SpatialEdge se;
+            const auto &a = g[i].pos;
+            const auto &b = g[j].pos;
+            const size_t num_points = 10 + j % 20;
+            for (size_t p = 1; p <= num_points; ++p) {
+                const double t = static_cast<double>(p) / (num_points + 1);
+                se.edge_points.push_back({{a[0] + t * (b[0] - a[0]),
+                                           a[1] + t * (b[1] - a[1]),
+                                           a[2] + t * (b[2] - a[2])}});
+            }
+            boost::add_edge(i, j, se, g);
+        }
+    }
+    return g;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t num_vertices = argc > 1 ? std::stoul(argv[1]) : 200000;
+    const size_t num_threads =
+            argc > 2 ? std::stoul(argv[2])
+                     : std::max(1u, std::thread::hardware_concurrency());
+    const auto g = random_graph(num_vertices);
+    std::cout << "Vertices: " << boost::num_vertices(g)
+              << ", edges: " << boost::num_edges(g) << std::endl;
+
+    size_t num_values = 0;
+    const auto t_serial = time_seconds([&]() {
+        const auto degrees = SG::compute_degrees(g);
+        const auto ete_distances = SG::compute_ete_distances(g);
+        const auto contour_lengths = SG::compute_contour_lengths(g);
+        const auto angles = SG::compute_angles(g);
+        const auto cosines = SG::compute_cosines(angles);
+        num_values = degrees.size() + ete_distances.size() +
+                     contour_lengths.size() + angles.size() + cosines.size();
+    });
+    std::cout << "compute_* back to back: " << t_serial
+              << " s, values: " << num_values << std::endl;
+
+    SG::GraphPropertiesParameters parameters;
+    parameters.compute_histograms = false;
+    for (const size_t threads : {size_t(1), num_threads}) {
+        parameters.num_threads = threads;
+        const auto t_all = time_seconds([&]() {
+            const auto properties =
+                    SG::compute_graph_properties_all(g, parameters);
+            num_values = properties.degrees.size() +
+                         properties.ete_distances.size() +
+                         properties.contour_lengths.size() +
+                         properties.angles.size() +
+                         properties.cosines.size();
+        });
+        std::cout << "compute_graph_properties_all (" << threads
+                  << " threads): " << t_all << " s, values: " << num_values
+                  << std::endl;
+    }
+    parameters.compute_histograms = true;
+    // Fixed width, the breaks of Scott method cannot always be balanced.
+    parameters.width_histo_distances = 10.0;
+    const auto t_histograms = time_seconds([&]() {
+        const auto properties = SG::compute_graph_properties_all(g, parameters);
+        num_values = properties.histo_angles.bins;
+    });
+    std::cout << "compute_graph_properties_all with histograms ("
+              << num_threads << " threads): " << t_histograms << " s"
+              << std::endl;
+    return EXIT_SUCCESS;
+}
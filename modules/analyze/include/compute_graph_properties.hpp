@@ -21,6 +21,8 @@
 #ifndef COMPUTE_GRAPH_PROPERTIES_HPP
 #define COMPUTE_GRAPH_PROPERTIES_HPP
 
+#include "frozen_spatial_graph.hpp"
+#include "histo.hpp"
 #include "spatial_graph.hpp"
 
 namespace SG {
@@ -33,6 +35,7 @@ namespace SG {
  * @return vector with degrees
  */
 std::vector<unsigned int> compute_degrees(const SG::GraphAL &sg);
+std::vector<unsigned int> compute_degrees(const SG::FrozenSpatialGraph &sg);
 
 /**
  * Compute end to end distances of nodes
@@ -48,6 +51,9 @@ std::vector<unsigned int> compute_degrees(const SG::GraphAL &sg);
 std::vector<double> compute_ete_distances(const SG::GraphAL &sg,
                                           const size_t minimum_size_edges = 0,
                                           bool ignore_end_nodes = false);
+std::vector<double> compute_ete_distances(const SG::FrozenSpatialGraph &sg,
+                                          const size_t minimum_size_edges = 0,
+                                          bool ignore_end_nodes = false);
 
 /**
  * Compute contour distances, taking into account every point in the spatial
@@ -62,6 +68,9 @@ std::vector<double> compute_ete_distances(const SG::GraphAL &sg,
 std::vector<double> compute_contour_lengths(const SG::GraphAL &sg,
                                             const size_t minimum_size_edges = 0,
                                             bool ignore_end_nodes = false);
+std::vector<double> compute_contour_lengths(const SG::FrozenSpatialGraph &sg,
+                                            const size_t minimum_size_edges = 0,
+                                            bool ignore_end_nodes = false);
 
 /**
  * Compute angles between adjacent edges in sg
@@ -80,6 +89,10 @@ std::vector<double> compute_angles(const SG::GraphAL &sg,
                                    const size_t minimum_size_edges = 0,
                                    const bool ignore_parallel_edges = false,
                                    const bool ignore_end_nodes = false);
+std::vector<double> compute_angles(const SG::FrozenSpatialGraph &sg,
+                                   const size_t minimum_size_edges = 0,
+                                   const bool ignore_parallel_edges = false,
+                                   const bool ignore_end_nodes = false);
 
 /**
  * Compute std::cos of input angles.
@@ -89,5 +102,73 @@ std::vector<double> compute_angles(const SG::GraphAL &sg,
  * @return vector with cosines of angles
  */
 std::vector<double> compute_cosines(const std::vector<double> &angles);
+
+/**
+ * Parameters of @ref compute_graph_properties_all.
+ * The filters are the same as in @ref compute_ete_distances,
+ * @ref compute_contour_lengths and @ref compute_angles, and the histogram
+ * parameters are the ones of spatial_histograms.hpp.
+ */
+struct GraphPropertiesParameters {
+    size_t minimum_size_edges = 0;
+    bool ignore_parallel_edges = false;
+    bool ignore_end_nodes = false;
+    /** compute the histograms of the non-empty properties */
+    bool compute_histograms = true;
+    /** @sa histogram_degrees */
+    size_t bins_histo_degrees = 0;
+    /** @sa histogram_ete_distances, histogram_contour_lengths */
+    double width_histo_distances = 0.0;
+    /** @sa histogram_angles */
+    size_t bins_histo_angles = 100;
+    /** @sa histogram_cosines */
+    size_t bins_histo_cosines = 100;
+    /** number of threads, 0 uses hardware_concurrency */
+    size_t num_threads = 0;
+};
+
+/**
+ * Output of @ref compute_graph_properties_all. The histograms are empty
+ * (default constructed) if the property is empty or if the histograms are not
+ * computed.
+ */
+struct GraphProperties {
+    std::vector<unsigned int> degrees;
+    std::vector<double> ete_distances;
+    std::vector<double> contour_lengths;
+    std::vector<double> angles;
+    std::vector<double> cosines;
+    histo::Histo<double> histo_degrees;
+    histo::Histo<double> histo_ete_distances;
+    histo::Histo<double> histo_contour_lengths;
+    histo::Histo<double> histo_angles;
+    histo::Histo<double> histo_cosines;
+};
+
+/**
+ * Compute degrees, end to end distances, contour lengths, angles and cosines
+ * (and their histograms) in the same pass over the graph.
+ *
+ * The edges and the vertices are split in blocks processed by num_threads.
+ * The outputs are allocated once, with a slot per edge and
+ * degree * (degree - 1) / 2 angle slots per node, each edge and node writes
+ * into its own slots and the gaps left by the filters are removed at the end.
+ * The result is equal to the one of calling compute_degrees,
+ * compute_ete_distances, compute_contour_lengths, compute_angles and
+ * compute_cosines, independently of the number of threads.
+ *
+ * @param sg input spatial graph
+ * @param parameters filters, histograms and number of threads.
+ *
+ * @return all the properties
+ */
+GraphProperties compute_graph_properties_all(
+        const SG::GraphType &sg,
+        const GraphPropertiesParameters &parameters =
+                GraphPropertiesParameters());
+GraphProperties compute_graph_properties_all(
+        const SG::FrozenSpatialGraph &sg,
+        const GraphPropertiesParameters &parameters =
+                GraphPropertiesParameters());
 } // namespace SG
 #endif
@@ -20,117 +20,365 @@
 
 #include "compute_graph_properties.hpp"
 #include "edge_points_utilities.hpp"
+#include "parallel_tasks.hpp"
+#include "spatial_histograms.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <numeric>
 
 namespace SG {
 
-std::vector<unsigned int> compute_degrees(const SG::GraphType &sg) {
-    std::vector<unsigned int> degrees;
-    const auto verts = boost::vertices(sg);
-    for (auto vi = verts.first; vi != verts.second; ++vi) {
-        degrees.push_back(static_cast<unsigned int>(boost::degree(*vi, sg)));
+namespace {
+/**
+ * Filter of the edges used in compute_ete_distances and
+ * compute_contour_lengths.
+ */
+template <typename TGraph>
+bool is_edge_selected(
+        const TGraph &sg,
+        const typename boost::graph_traits<TGraph>::edge_descriptor &edge,
+        const size_t minimum_size_edges,
+        const bool ignore_end_nodes) {
+    if (sg[edge].edge_points.size() < minimum_size_edges) {
+        return false;
     }
-    return degrees;
+    // Unqualified calls, found by ADL for boost and SG graphs.
+    return !(ignore_end_nodes && (degree(source(edge, sg), sg) == 1 ||
+                                  degree(target(edge, sg), sg) == 1));
 }
 
-std::vector<double> compute_ete_distances(const SG::GraphType &sg,
-                                          const size_t minimum_size_edges,
-                                          bool ignore_end_nodes) {
-    std::vector<double> ete_distances;
-    const auto edges = boost::edges(sg);
-    for (auto ei = edges.first; ei != edges.second; ++ei) {
-        const auto &eps = sg[*ei].edge_points;
-        if (eps.size() < minimum_size_edges) {
+/**
+ * Call function(source, target1, target2) for each pair of adjacent edges
+ * of vertex that pass the filters of compute_angles.
+ */
+template <typename TGraph, typename TFunction>
+void for_each_angle(
+        const TGraph &sg,
+        const typename boost::graph_traits<TGraph>::vertex_descriptor &vertex,
+        const size_t minimum_size_edges,
+        const bool ignore_parallel_edges,
+        const bool ignore_end_nodes,
+        TFunction &&function) {
+    // From
+    // http://www.boost.org/doc/libs/1_66_0/libs/graph/doc/IncidenceGraph.html
+    // It is guaranteed that given: e=out_edge(v); then source(e) == v.
+    // Don't analyze degree 2 nodes (they are only left to mark self-loops.
+    // Degree 0 and 1 won't be computed even without this guard.
+    // auto degree =  boost::out_degree(*vi,sg);
+    // if (degree < 3)
+    //     continue;
+    const auto out_edges_range = out_edges(vertex, sg);
+    for (auto ei1 = out_edges_range.first; ei1 != out_edges_range.second;
+         ++ei1) {
+        const auto &eps1 = sg[*ei1].edge_points;
+        if (eps1.size() < minimum_size_edges) {
             continue;
         }
-        auto source = boost::source(*ei, sg);
-        auto target = boost::target(*ei, sg);
-        if (ignore_end_nodes &&
-            (boost::degree(source, sg) == 1 ||
-             boost::degree(target, sg) == 1)) {
+        auto source_vertex = source(*ei1, sg); // = vertex
+        auto target1 = target(*ei1, sg);
+        if (ignore_end_nodes && (degree(source_vertex, sg) == 1 ||
+                                 degree(target1, sg) == 1)) {
             continue;
         }
+        // Copy edge iterator and plus one (to avoid compare the edge with
+        // itself)
+        auto ei2 = ei1;
+        ei2++;
+        for (; ei2 != out_edges_range.second; ++ei2) {
+            const auto &eps2 = sg[*ei2].edge_points;
+            if (eps2.size() < minimum_size_edges) {
+                continue;
+            }
+            auto target2 = target(*ei2, sg);
+            if (ignore_end_nodes && degree(target2, sg) == 1) {
+                continue;
+            }
+            // Don't compute angle on parallel edges
+            // WARNING: do not check target2 == source
+            // source(ei2) is guaranteed (by out_edges) to be equal to
+            // source(ei1)
+            if (ignore_parallel_edges && target2 == target1) {
+                continue;
+            }
+            function(source_vertex, target1, target2);
+        }
+    }
+}
+
+template <typename TGraph>
+double angle_between_edges(
+        const TGraph &sg,
+        const typename boost::graph_traits<TGraph>::vertex_descriptor &source,
+        const typename boost::graph_traits<TGraph>::vertex_descriptor &target1,
+        const typename boost::graph_traits<TGraph>::vertex_descriptor
+                &target2) {
+    return ArrayUtilities::angle(
+            ArrayUtilities::minus(sg[target1].pos, sg[source].pos),
+            ArrayUtilities::minus(sg[target2].pos, sg[source].pos));
+}
+
+template <typename TGraph>
+std::vector<unsigned int> compute_degrees_impl(const TGraph &sg) {
+    std::vector<unsigned int> degrees;
+    degrees.reserve(num_vertices(sg));
+    const auto verts = vertices(sg);
+    for (auto vi = verts.first; vi != verts.second; ++vi) {
+        degrees.push_back(static_cast<unsigned int>(degree(*vi, sg)));
+    }
+    return degrees;
+}
 
-        ete_distances.emplace_back(SG::ete_distance(*ei, sg));
+template <typename TGraph>
+std::vector<double> compute_ete_distances_impl(const TGraph &sg,
+                                               const size_t minimum_size_edges,
+                                               bool ignore_end_nodes) {
+    std::vector<double> ete_distances;
+    ete_distances.reserve(num_edges(sg));
+    const auto edges_range = edges(sg);
+    for (auto ei = edges_range.first; ei != edges_range.second; ++ei) {
+        if (is_edge_selected(sg, *ei, minimum_size_edges, ignore_end_nodes)) {
+            ete_distances.emplace_back(SG::ete_distance(*ei, sg));
+        }
     }
     return ete_distances;
 }
 
-std::vector<double> compute_contour_lengths(const SG::GraphType &sg,
-                                            const size_t minimum_size_edges,
-                                            bool ignore_end_nodes) {
+template <typename TGraph>
+std::vector<double>
+compute_contour_lengths_impl(const TGraph &sg,
+                             const size_t minimum_size_edges,
+                             bool ignore_end_nodes) {
     std::vector<double> contour_lengths;
-    const auto edges = boost::edges(sg);
-    for (auto ei = edges.first; ei != edges.second; ++ei) {
-        const auto &eps = sg[*ei].edge_points;
-        if (eps.size() < minimum_size_edges) {
-            continue;
-        }
-        if (ignore_end_nodes &&
-            (boost::degree(boost::source(*ei, sg), sg) == 1 ||
-             boost::degree(boost::target(*ei, sg), sg) == 1)) {
-            continue;
+    contour_lengths.reserve(num_edges(sg));
+    const auto edges_range = edges(sg);
+    for (auto ei = edges_range.first; ei != edges_range.second; ++ei) {
+        if (is_edge_selected(sg, *ei, minimum_size_edges, ignore_end_nodes)) {
+            contour_lengths.emplace_back(SG::contour_length(*ei, sg));
         }
-        contour_lengths.emplace_back(SG::contour_length(*ei, sg));
     }
     return contour_lengths;
 }
 
-std::vector<double> compute_angles(const SG::GraphType &sg,
-                                   const size_t minimum_size_edges,
-                                   const bool ignore_parallel_edges,
-                                   const bool ignore_end_nodes) {
+template <typename TGraph>
+std::vector<double> compute_angles_impl(const TGraph &sg,
+                                        const size_t minimum_size_edges,
+                                        const bool ignore_parallel_edges,
+                                        const bool ignore_end_nodes) {
+    using vertex_descriptor =
+            typename boost::graph_traits<TGraph>::vertex_descriptor;
     std::vector<double> ete_angles;
-    const auto verts = boost::vertices(sg);
-    // From
-    // http://www.boost.org/doc/libs/1_66_0/libs/graph/doc/IncidenceGraph.html
-    // It is guaranteed that given: e=out_edge(v); then source(e) == v.
+    const auto verts = vertices(sg);
     for (auto vi = verts.first; vi != verts.second; ++vi) {
-        // Don't analyze degree 2 nodes (they are only left to mark self-loops.
-        // Degree 0 and 1 won't be computed even without this guard.
-        // auto degree =  boost::out_degree(*vi,sg);
-        // if (degree < 3)
-        //     continue;
-        const auto out_edges = boost::out_edges(*vi, sg);
-        for (auto ei1 = out_edges.first; ei1 != out_edges.second; ++ei1) {
-            const auto &eps1 = sg[*ei1].edge_points;
-            if (eps1.size() < minimum_size_edges) {
-                continue;
-            }
-            auto source = boost::source(*ei1, sg); // = *vi
-            auto target1 = boost::target(*ei1, sg);
-            if (ignore_end_nodes && (boost::degree(source, sg) == 1 ||
-                                     boost::degree(target1, sg) == 1)) {
+        for_each_angle(sg, *vi, minimum_size_edges, ignore_parallel_edges,
+                       ignore_end_nodes,
+                       [&sg, &ete_angles](const vertex_descriptor &source,
+                                          const vertex_descriptor &target1,
+                                          const vertex_descriptor &target2) {
+                           ete_angles.emplace_back(angle_between_edges(
+                                   sg, source, target1, target2));
+                       });
+    }
+    return ete_angles;
+}
+
+/**
+ * Move the values of the ranges [offsets[i], offsets[i] + counts[i]) to be
+ * contiguous, in order, and resize values to the total count.
+ */
+template <typename T>
+void compact_slots(std::vector<T> &values,
+                   const std::vector<size_t> &offsets,
+                   const std::vector<size_t> &counts) {
+    size_t size = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (offsets[i] != size) {
+            std::move(values.begin() + offsets[i],
+                      values.begin() + offsets[i] + counts[i],
+                      values.begin() + size);
+        }
+        size += counts[i];
+    }
+    values.resize(size);
+}
+
+template <typename TGraph>
+GraphProperties
+compute_graph_properties_all_impl(const TGraph &sg,
+                                  const GraphPropertiesParameters &parameters) {
+    using vertex_descriptor =
+            typename boost::graph_traits<TGraph>::vertex_descriptor;
+    using edge_descriptor =
+            typename boost::graph_traits<TGraph>::edge_descriptor;
+    const size_t threads = resolve_num_threads(parameters.num_threads);
+    std::unique_ptr<ThreadPool> pool;
+    if (threads > 1) {
+        pool.reset(new ThreadPool(threads));
+    }
+    const auto run_in_blocks = [&pool](const size_t num_items,
+                                       const std::function<void(size_t, size_t)>
+                                               &block_task) {
+        if (pool) {
+            run_blocks(num_items, *pool, block_task, 1024);
+        } else {
+            block_task(0, num_items);
+        }
+    };
+
+    GraphProperties output;
+    // Random access to the vertices and edges, in the order of vertices and
+    // edges of the graph.
+    std::vector<vertex_descriptor> graph_vertices;
+    graph_vertices.reserve(num_vertices(sg));
+    const auto verts = vertices(sg);
+    for (auto vi = verts.first; vi != verts.second; ++vi) {
+        graph_vertices.push_back(*vi);
+    }
+    std::vector<edge_descriptor> graph_edges;
+    graph_edges.reserve(num_edges(sg));
+    const auto edges_range = edges(sg);
+    for (auto ei = edges_range.first; ei != edges_range.second; ++ei) {
+        graph_edges.push_back(*ei);
+    }
+    const size_t nverts = graph_vertices.size();
+    const size_t nedges = graph_edges.size();
+
+    // Each edge and each vertex writes into its own preallocated slot, so
+    // the result does not depend on the number of threads: one value per
+    // edge, and degree * (degree - 1) / 2 angles per vertex. The gaps left
+    // by the filters are removed at the end.
+    output.degrees.resize(nverts);
+    std::vector<size_t> angle_offsets(nverts);
+    size_t max_num_angles = 0;
+    for (size_t i = 0; i < nverts; ++i) {
+        const size_t vertex_degree = degree(graph_vertices[i], sg);
+        output.degrees[i] = static_cast<unsigned int>(vertex_degree);
+        angle_offsets[i] = max_num_angles;
+        max_num_angles += vertex_degree > 1
+                                  ? vertex_degree * (vertex_degree - 1) / 2
+                                  : 0;
+    }
+    output.ete_distances.resize(nedges);
+    output.contour_lengths.resize(nedges);
+    output.angles.resize(max_num_angles);
+    output.cosines.resize(max_num_angles);
+    std::vector<size_t> edge_offsets(nedges);
+    std::iota(edge_offsets.begin(), edge_offsets.end(), size_t(0));
+    std::vector<size_t> edge_counts(nedges, 0);
+    std::vector<size_t> angle_counts(nverts, 0);
+    const auto minimum_size_edges = parameters.minimum_size_edges;
+    const auto ignore_parallel_edges = parameters.ignore_parallel_edges;
+    const auto ignore_end_nodes = parameters.ignore_end_nodes;
+    run_in_blocks(nedges, [&](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (!is_edge_selected(sg, graph_edges[i], minimum_size_edges,
+                                  ignore_end_nodes)) {
                 continue;
             }
-            // Copy edge iterator and plus one (to avoid compare the edge with
-            // itself)
-            auto ei2 = ei1;
-            ei2++;
-            for (; ei2 != out_edges.second; ++ei2) {
-                const auto &eps2 = sg[*ei2].edge_points;
-                if (eps2.size() < minimum_size_edges) {
-                    continue;
-                }
-                auto target2 = boost::target(*ei2, sg);
-                if (ignore_end_nodes && boost::degree(target2, sg) == 1) {
-                    continue;
-                }
-                // Don't compute angle on parallel edges
-                // WARNING: do not check target2 == source
-                // source(ei2) is guaranteed (by out_edges) to be equal to
-                // source(ei1)
-                if (ignore_parallel_edges && target2 == target1) {
-                    continue;
-                }
-
-                ete_angles.emplace_back(ArrayUtilities::angle(
-                        ArrayUtilities::minus(sg[target1].pos, sg[source].pos),
-                        ArrayUtilities::minus(sg[target2].pos,
-                                              sg[source].pos)));
-            }
+            output.ete_distances[i] = SG::ete_distance(graph_edges[i], sg);
+            output.contour_lengths[i] =
+                    SG::contour_length(graph_edges[i], sg);
+            edge_counts[i] = 1;
+        }
+    });
+    run_in_blocks(nverts, [&](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            size_t index = angle_offsets[i];
+            for_each_angle(sg, graph_vertices[i], minimum_size_edges,
+                           ignore_parallel_edges, ignore_end_nodes,
+                           [&sg, &output, &index](
+                                   const vertex_descriptor &source,
+                                   const vertex_descriptor &target1,
+                                   const vertex_descriptor &target2) {
+                               const auto angle = angle_between_edges(
+                                       sg, source, target1, target2);
+                               output.angles[index] = angle;
+                               output.cosines[index] = std::cos(angle);
+                               ++index;
+                           });
+            angle_counts[i] = index - angle_offsets[i];
         }
+    });
+    compact_slots(output.ete_distances, edge_offsets, edge_counts);
+    compact_slots(output.contour_lengths, edge_offsets, edge_counts);
+    compact_slots(output.angles, angle_offsets, angle_counts);
+    compact_slots(output.cosines, angle_offsets, angle_counts);
+
+    if (!parameters.compute_histograms) {
+        return output;
     }
-    return ete_angles;
+    if (!output.degrees.empty()) {
+        output.histo_degrees = histogram_degrees(output.degrees,
+                                                 parameters.bins_histo_degrees);
+    }
+    if (!output.ete_distances.empty()) {
+        output.histo_ete_distances = histogram_ete_distances(
+                output.ete_distances, parameters.width_histo_distances);
+    }
+    if (!output.contour_lengths.empty()) {
+        output.histo_contour_lengths = histogram_contour_lengths(
+                output.contour_lengths, parameters.width_histo_distances);
+    }
+    if (!output.angles.empty()) {
+        output.histo_angles =
+                histogram_angles(output.angles, parameters.bins_histo_angles);
+    }
+    if (!output.cosines.empty()) {
+        output.histo_cosines = histogram_cosines(
+                output.cosines, parameters.bins_histo_cosines);
+    }
+    return output;
+}
+} // namespace
+
+std::vector<unsigned int> compute_degrees(const SG::GraphType &sg) {
+    return compute_degrees_impl(sg);
+}
+std::vector<unsigned int> compute_degrees(const SG::FrozenSpatialGraph &sg) {
+    return compute_degrees_impl(sg);
+}
+
+std::vector<double> compute_ete_distances(const SG::GraphType &sg,
+                                          const size_t minimum_size_edges,
+                                          bool ignore_end_nodes) {
+    return compute_ete_distances_impl(sg, minimum_size_edges,
+                                      ignore_end_nodes);
+}
+std::vector<double> compute_ete_distances(const SG::FrozenSpatialGraph &sg,
+                                          const size_t minimum_size_edges,
+                                          bool ignore_end_nodes) {
+    return compute_ete_distances_impl(sg, minimum_size_edges,
+                                      ignore_end_nodes);
+}
+
+std::vector<double> compute_contour_lengths(const SG::GraphType &sg,
+                                            const size_t minimum_size_edges,
+                                            bool ignore_end_nodes) {
+    return compute_contour_lengths_impl(sg, minimum_size_edges,
+                                        ignore_end_nodes);
+}
+std::vector<double> compute_contour_lengths(const SG::FrozenSpatialGraph &sg,
+                                            const size_t minimum_size_edges,
+                                            bool ignore_end_nodes) {
+    return compute_contour_lengths_impl(sg, minimum_size_edges,
+                                        ignore_end_nodes);
+}
+
+std::vector<double> compute_angles(const SG::GraphType &sg,
+                                   const size_t minimum_size_edges,
+                                   const bool ignore_parallel_edges,
+                                   const bool ignore_end_nodes) {
+    return compute_angles_impl(sg, minimum_size_edges, ignore_parallel_edges,
+                               ignore_end_nodes);
+}
+std::vector<double> compute_angles(const SG::FrozenSpatialGraph &sg,
+                                   const size_t minimum_size_edges,
+                                   const bool ignore_parallel_edges,
+                                   const bool ignore_end_nodes) {
+    return compute_angles_impl(sg, minimum_size_edges, ignore_parallel_edges,
+                               ignore_end_nodes);
 }
 
 std::vector<double> compute_cosines(const std::vector<double> &angles) {
@@ -140,4 +388,15 @@ std::vector<double> compute_cosines(const std::vector<double> &angles) {
                    [](const double &a) { return std::cos(a); });
     return cosines;
 }
+
+GraphProperties
+compute_graph_properties_all(const SG::GraphType &sg,
+                             const GraphPropertiesParameters &parameters) {
+    return compute_graph_properties_all_impl(sg, parameters);
+}
+GraphProperties
+compute_graph_properties_all(const SG::FrozenSpatialGraph &sg,
+                             const GraphPropertiesParameters &parameters) {
+    return compute_graph_properties_all_impl(sg, parameters);
+}
 } // namespace SG
@@ -71,6 +71,18 @@ TEST_F(SpatialGraphFixture, compute_angles_cosines) {
     }
 }
 
+TEST_F(SpatialGraphFixture, frozen_spatial_graph_matches_graph) {
+    const auto fg = SG::frozen_spatial_graph_from_graph(g);
+    EXPECT_EQ(SG::compute_degrees(fg), SG::compute_degrees(g));
+    EXPECT_EQ(SG::compute_ete_distances(fg), SG::compute_ete_distances(g));
+    EXPECT_EQ(SG::compute_contour_lengths(fg), SG::compute_contour_lengths(g));
+    auto angles = SG::compute_angles(g);
+    auto angles_frozen = SG::compute_angles(fg);
+    std::sort(angles.begin(), angles.end());
+    std::sort(angles_frozen.begin(), angles_frozen.end());
+    EXPECT_EQ(angles_frozen, angles);
+}
+
 struct PlusSymbolFixture : public SpatialGraphFixture {
     void SetUp() override {
         SpatialGraphFixture::SetUp();
@@ -347,3 +359,122 @@ TEST_F(SpatialGraphFixture, filtered_angles_ignoring_end_nodes) {
     EXPECT_EQ(angles_filtered_ignore_end_nodes.empty(), true); // No empty ep
     EXPECT_EQ(angles_unfiltered.size(), 3);
 }
+
+TEST_F(SpatialGraphFixture, compute_graph_properties_all) {
+    SG::GraphPropertiesParameters parameters;
+    const auto properties = SG::compute_graph_properties_all(g, parameters);
+    EXPECT_EQ(properties.degrees, SG::compute_degrees(g));
+    EXPECT_EQ(properties.ete_distances, SG::compute_ete_distances(g));
+    EXPECT_EQ(properties.contour_lengths, SG::compute_contour_lengths(g));
+    const auto angles = SG::compute_angles(g);
+    EXPECT_EQ(properties.angles, angles);
+    EXPECT_EQ(properties.cosines, SG::compute_cosines(angles));
+    EXPECT_EQ(properties.histo_degrees.name, "degrees");
+    EXPECT_EQ(properties.histo_angles.name, "angles");
+    EXPECT_EQ(properties.histo_cosines.name, "cosines");
+    size_t counted_degrees = 0;
+    for (const auto count : properties.histo_degrees.counts) {
+        counted_degrees += count;
+    }
+    EXPECT_EQ(counted_degrees, 4);
+
+    // All the edges are filtered out, empty properties and histograms.
+    parameters.ignore_end_nodes = true;
+    const auto filtered = SG::compute_graph_properties_all(g, parameters);
+    EXPECT_TRUE(filtered.ete_distances.empty());
+    EXPECT_TRUE(filtered.contour_lengths.empty());
+    EXPECT_TRUE(filtered.angles.empty());
+    EXPECT_TRUE(filtered.histo_angles.counts.empty());
+    EXPECT_EQ(filtered.degrees, properties.degrees);
+}
+
+TEST(compute_graph_properties_all, equal_to_compute_functions) {
+    // Star-like graph with edges of different sizes, and parallel edges.
+    const size_t num_vertices = 101;
+    SG::GraphType g(num_vertices);
+    for (size_t i = 0; i < num_vertices; ++i) {
+        g[i].pos = {{static_cast<double>(i % 7), static_cast<double>(i % 11),
+                     static_cast<double>(i % 13)}};
+    }
+    for (size_t i = 1; i < num_vertices; ++i) {
+        SG::SpatialEdge se;
+        for (size_t p = 0; p < i % 5; ++p) {
+            se.edge_points.push_back(
+                    {{static_cast<double>(p), 0.0, static_cast<double>(i)}});
+        }
+        boost::add_edge(i / 3, i, se, g);
+        if (i % 10 == 0) {
+            boost::add_edge(i / 3, i, se, g);
+        }
+    }
+    const auto fg = SG::frozen_spatial_graph_from_graph(g);
+    for (const size_t minimum_size_edges : {size_t(0), size_t(2)}) {
+        for (const bool ignore_flags : {false, true}) {
+            SG::GraphPropertiesParameters parameters;
+            parameters.minimum_size_edges = minimum_size_edges;
+            parameters.ignore_parallel_edges = ignore_flags;
+            parameters.ignore_end_nodes = ignore_flags;
+            parameters.compute_histograms = false;
+            const auto properties =
+                    SG::compute_graph_properties_all(g, parameters);
+            EXPECT_EQ(properties.degrees, SG::compute_degrees(g));
+            EXPECT_EQ(properties.ete_distances,
+                      SG::compute_ete_distances(g, minimum_size_edges,
+                                                ignore_flags));
+            EXPECT_EQ(properties.contour_lengths,
+                      SG::compute_contour_lengths(g, minimum_size_edges,
+                                                  ignore_flags));
+            const auto angles = SG::compute_angles(
+                    g, minimum_size_edges, ignore_flags, ignore_flags);
+            EXPECT_FALSE(angles.empty());
+            EXPECT_EQ(properties.angles, angles);
+            EXPECT_EQ(properties.cosines, SG::compute_cosines(angles));
+            EXPECT_TRUE(properties.histo_angles.counts.empty());
+
+            const auto frozen_properties =
+                    SG::compute_graph_properties_all(fg, parameters);
+            EXPECT_EQ(frozen_properties.degrees, properties.degrees);
+            EXPECT_EQ(frozen_properties.contour_lengths,
+                      properties.contour_lengths);
+            EXPECT_EQ(frozen_properties.angles.size(),
+                      properties.angles.size());
+        }
+    }
+}
+
+TEST(compute_graph_properties_all, same_result_with_1_and_n_threads) {
+    // Large enough to be split in several blocks per thread.
+    const size_t num_vertices = 20000;
+    SG::GraphType g(num_vertices);
+    for (size_t i = 0; i < num_vertices; ++i) {
+        g[i].pos = {{static_cast<double>(i % 7), static_cast<double>(i % 11),
+                     static_cast<double>(i % 13)}};
+    }
+    for (size_t i = 1; i < num_vertices; ++i) {
+        SG::SpatialEdge se;
+        for (size_t p = 0; p < i % 5; ++p) {
+            se.edge_points.push_back(
+                    {{static_cast<double>(p), 0.0, static_cast<double>(i)}});
+        }
+        boost::add_edge(i / 3, i, se, g);
+    }
+    SG::GraphPropertiesParameters parameters;
+    parameters.minimum_size_edges = 2;
+    parameters.ignore_end_nodes = true;
+    parameters.width_histo_distances = 1.0;
+    parameters.num_threads = 1;
+    const auto serial = SG::compute_graph_properties_all(g, parameters);
+    EXPECT_FALSE(serial.angles.empty());
+    for (const size_t num_threads : {size_t(2), size_t(4)}) {
+        parameters.num_threads = num_threads;
+        const auto parallel = SG::compute_graph_properties_all(g, parameters);
+        EXPECT_EQ(parallel.degrees, serial.degrees);
+        EXPECT_EQ(parallel.ete_distances, serial.ete_distances);
+        EXPECT_EQ(parallel.contour_lengths, serial.contour_lengths);
+        EXPECT_EQ(parallel.angles, serial.angles);
+        EXPECT_EQ(parallel.cosines, serial.cosines);
+        EXPECT_EQ(parallel.histo_angles.counts, serial.histo_angles.counts);
+        EXPECT_EQ(parallel.histo_ete_distances.counts,
+                  serial.histo_ete_distances.counts);
+    }
+}
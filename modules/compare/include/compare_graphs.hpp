@@ -22,6 +22,7 @@
 
 #include "bounding_box.hpp"
 #include "filter_spatial_graph.hpp"
+#include "frozen_spatial_graph.hpp"
 #include "spatial_graph.hpp"
 
 namespace SG {
@@ -34,6 +35,15 @@ remove_edges_and_nodes_from_high_info_graph(const GraphType &g0,
 GraphType compare_low_and_high_info_graphs(const GraphType &g0,
                                            const GraphType &g1,
                                            const double radius = 2.0);
+
+/**
+ * FrozenSpatialGraph overload. The result is a mutable GraphType built from
+ * g1, so the inputs are thawed with graph_from_frozen_spatial_graph, which
+ * keeps the vertex descriptors.
+ */
+GraphType compare_low_and_high_info_graphs(const FrozenSpatialGraph &g0,
+                                           const FrozenSpatialGraph &g1,
+                                           const double radius = 2.0);
 } // namespace SG
 
 #endif
@@ -21,6 +21,7 @@
 #ifndef SPATIAL_GRAPH_DIFFERENCE_HPP
 #define SPATIAL_GRAPH_DIFFERENCE_HPP
 
+#include "frozen_spatial_graph.hpp"
 #include "graph_descriptor.hpp"
 #include "spatial_graph.hpp"
 #include <functional>
@@ -49,5 +50,15 @@ GraphType spatial_graph_difference(const GraphType &minuend_sg,
                                    const GraphType &substraend_sg,
                                    double radius_touch,
                                    bool verbose = false);
+
+/**
+ * FrozenSpatialGraph overload. The difference D is a mutable GraphType, the
+ * inputs are thawed with graph_from_frozen_spatial_graph, which keeps the
+ * vertex descriptors.
+ */
+GraphType spatial_graph_difference(const FrozenSpatialGraph &minuend_sg,
+                                   const FrozenSpatialGraph &substraend_sg,
+                                   double radius_touch,
+                                   bool verbose = false);
 } // end namespace SG
 #endif
@@ -241,4 +241,12 @@ GraphType compare_low_and_high_info_graphs(const GraphType &g0,
     return filter_by_sets(remove_edges, remove_nodes, g1);
 }
 
+GraphType compare_low_and_high_info_graphs(const FrozenSpatialGraph &g0,
+                                           const FrozenSpatialGraph &g1,
+                                           const double radius) {
+    return compare_low_and_high_info_graphs(
+            graph_from_frozen_spatial_graph(g0),
+            graph_from_frozen_spatial_graph(g1), radius);
+}
+
 } // namespace SG
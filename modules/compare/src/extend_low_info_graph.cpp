@@ -20,6 +20,7 @@
 
 #include "extend_low_info_graph.hpp"
 #include "extend_low_info_graph_visitor.hpp"
+#include "vertex_vector_map.hpp"
 #include <tuple> // For std::tie
 
 namespace SG {
@@ -48,10 +49,10 @@ GraphType extend_low_info_graph_via_dfs(
     using vertex_descriptor = boost::graph_traits<GraphType>::vertex_descriptor;
     using vertex_iterator = boost::graph_traits<GraphType>::vertex_iterator;
 
-    using ColorMap = std::map<vertex_descriptor, boost::default_color_type>;
-    ColorMap colorMap;
-    using Color = boost::color_traits<ColorMap::mapped_type>;
-    boost::associative_property_map<ColorMap> propColorMap(colorMap);
+    // All the vertices are unvisited (white) in a new VertexColorMap.
+    using ColorMap = VertexColorMap;
+    ColorMap colorMap(boost::num_vertices(input_sg));
+    auto propColorMap = colorMap.property_map();
 
     using VertexMap = std::unordered_map<vertex_descriptor, vertex_descriptor>;
     VertexMap vertex_map;
@@ -60,12 +61,6 @@ GraphType extend_low_info_graph_via_dfs(
             result_sg, graphs, idMap, octree, radius, colorMap, vertex_map,
             verbose);
 
-    // Mark as unvisited (white) all the vertices
-    vertex_iterator ui, ui_end;
-    for (std::tie(ui, ui_end) = boost::vertices(input_sg); ui != ui_end; ++ui) {
-        put(propColorMap, *ui, Color::white());
-    }
-
     vertex_iterator vi, vi_end;
     std::tie(vi, vi_end) = boost::vertices(input_sg);
     vertex_descriptor start;
@@ -22,6 +22,7 @@
 #include "graph_points_locator.hpp"
 #include "print_locator_points.hpp"
 #include "spatial_graph_difference_visitor.hpp"
+#include "vertex_vector_map.hpp"
 #include <tuple> // For std::tie
 #include <vtkIdList.h>
 
@@ -34,25 +35,13 @@ GraphType spatial_graph_difference(const GraphType &minuend_sg,
     // We are going to build on top of the extended graph
     GraphType diff_sg;
     using vertex_descriptor = boost::graph_traits<GraphType>::vertex_descriptor;
-    using vertex_iterator = boost::graph_traits<GraphType>::vertex_iterator;
-    using ColorMap = std::map<vertex_descriptor, boost::default_color_type>;
-    ColorMap colorMap;
-    using Color = boost::color_traits<ColorMap::mapped_type>;
-    boost::associative_property_map<ColorMap> propColorMap(colorMap);
+    // All the vertices are unvisited (white) in a new VertexColorMap.
+    using ColorMap = VertexColorMap;
+    ColorMap colorMap(boost::num_vertices(minuend_sg));
+    auto propColorMap = colorMap.property_map();
     using VertexMap = std::unordered_map<vertex_descriptor, vertex_descriptor>;
     VertexMap vertex_map;
 
-    vertex_iterator vi, vi_end;
-    std::tie(vi, vi_end) = boost::vertices(minuend_sg);
-
-    // Mark as unvisited (white) all the vertices
-    {
-        vertex_iterator ui, ui_end;
-        for (std::tie(ui, ui_end) = boost::vertices(minuend_sg); ui != ui_end;
-             ++ui) {
-            put(propColorMap, *ui, Color::white());
-        }
-    }
     // Create the point locator from input graphs
     std::vector<std::reference_wrapper<const GraphType>> graphs;
     graphs.reserve(2);
@@ -75,4 +64,14 @@ GraphType spatial_graph_difference(const GraphType &minuend_sg,
     return diff_sg;
 }
 
+GraphType spatial_graph_difference(const FrozenSpatialGraph &minuend_sg,
+                                   const FrozenSpatialGraph &substraend_sg,
+                                   double radius_touch,
+                                   bool verbose) {
+    return spatial_graph_difference(
+            graph_from_frozen_spatial_graph(minuend_sg),
+            graph_from_frozen_spatial_graph(substraend_sg), radius_touch,
+            verbose);
+}
+
 } // end namespace SG
@@ -71,6 +71,18 @@ TEST_F(FixtureMatchingGraphs, compare_graphs) {
     EXPECT_EQ(boost::num_edges(filtered_graph), boost::num_edges(g1) - 1);
 }
 
+TEST_F(FixtureMatchingGraphs, compare_low_and_high_info_graphs_frozen) {
+    double radius = 0.6;
+    auto filtered_graph = SG::compare_low_and_high_info_graphs(g0, g1, radius);
+    auto filtered_graph_frozen = SG::compare_low_and_high_info_graphs(
+            SG::frozen_spatial_graph_from_graph(g0),
+            SG::frozen_spatial_graph_from_graph(g1), radius);
+    EXPECT_EQ(boost::num_vertices(filtered_graph_frozen),
+              boost::num_vertices(filtered_graph));
+    EXPECT_EQ(boost::num_edges(filtered_graph_frozen),
+              boost::num_edges(filtered_graph));
+}
+
 TEST_F(FixtureCloseGraphs, works) {
     // FixtureCloseGraphs applies a small shift to all positions of g1
     std::vector<std::reference_wrapper<const GraphType>> graphs;
@@ -68,6 +68,20 @@ TEST_F(FixtureSquareCrossGraph,
 #endif
 }
 
+TEST_F(FixtureSquareCrossGraph,
+       spatial_graph_difference_frozen_equals_graph) {
+    double radius = 0.01;
+    auto g_diff = spatial_graph_difference(g_square_cross, g_square, radius);
+    auto g_diff_frozen = spatial_graph_difference(
+            SG::frozen_spatial_graph_from_graph(g_square_cross),
+            SG::frozen_spatial_graph_from_graph(g_square), radius);
+    EXPECT_EQ(boost::num_vertices(g_diff_frozen), boost::num_vertices(g_diff));
+    EXPECT_EQ(boost::num_edges(g_diff_frozen), boost::num_edges(g_diff));
+    for (const auto v : boost::make_iterator_range(boost::vertices(g_diff))) {
+        EXPECT_EQ(g_diff_frozen[v].pos, g_diff[v].pos);
+    }
+}
+
 // TEST_F(FixtureSquareCrossGraph,
 // spatial_graph_difference_SquareCrossMinusCross_withExtraBanches) {
 // }
@@ -0,0 +1,141 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+/**
+ * Contour lengths of all the edges of a graph: SG::contour_length per edge
+ * (array of structures) against polyline_lengths on EdgePointsSoA of double
+ * and float (structure of arrays + SIMD), and the cost of building the
+ * EdgePointsSoA with contour_polylines.
+ *
+ * Usage: bench_edge_points_soa [num_edges] [edge_points_per_edge]
+ */
+
+#include "edge_points_soa.hpp"
+#include "edge_points_utilities.hpp"
+#include "simd_batch.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+template <typename TFunction>
+double time_seconds(TFunction &&function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void print(const std::string &name,
+           const double seconds,
+           const size_t n,
+           const double sum) {
+    std::cout << name << seconds << " s (" << 1e9 * seconds / n
+              << " ns/point), sum: " << sum << std::endl;
+}
+
+double sum(const std::vector<double> &values) {
+    double total = 0.0;
+    for (const auto v : values) {
+        total += v;
+    }
+    return total;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t num_edges = argc > 1 ? std::stoul(argv[1]) : 200000;
+    const size_t points_per_edge = argc > 2 ? std::stoul(argv[2]) : 20;
+    std::cout << "SIMD backend: " << SG::simd::backend_name() << std::endl;
+
+    // Chain of edges, the edge points are a random walk between the nodes.
+    std::mt19937 gen(13);
+    std::uniform_real_distribution<double> step(-1.0, 1.0);
+    SG::GraphType g(num_edges + 1);
+    SG::PointType pos = {{0.0, 0.0, 0.0}};
+    for (size_t i = 0; i <= num_edges; ++i) {
+        g[i].pos = pos;
+        if (i == num_edges) {
+            break;
+        }
+        SG::SpatialEdge se;
+        for (size_t p = 0; p < points_per_edge; ++p) {
+            pos = {{pos[0] + step(gen), pos[1] + step(gen), pos[2] + step(gen)}};
+            se.edge_points.push_back(pos);
+        }
+        pos = {{pos[0] + step(gen), pos[1] + step(gen), pos[2] + step(gen)}};
+        boost::add_edge(i, i + 1, se, g);
+    }
+    const size_t num_points = num_edges * (points_per_edge + 2);
+    std::cout << "Edges: " << num_edges << ", points: " << num_points
+              << std::endl;
+
+    std::vector<double> lengths;
+    const auto t_contour_length = time_seconds([&]() {
+        lengths.reserve(num_edges);
+        for (const auto e : boost::make_iterator_range(boost::edges(g))) {
+            lengths.push_back(SG::contour_length(e, g));
+        }
+    });
+    print("contour_length per edge:     ", t_contour_length, num_points,
+          sum(lengths));
+
+    std::vector<SG::GraphType::edge_descriptor> edges;
+    for (const auto e : boost::make_iterator_range(boost::edges(g))) {
+        edges.push_back(e);
+    }
+    SG::EdgePointsSoA<double> soa;
+    const auto t_build = time_seconds(
+            [&]() { soa = SG::contour_polylines<double>(g, edges); });
+    print("contour_polylines (double):  ", t_build, num_points,
+          static_cast<double>(soa.num_points()));
+
+    const auto t_soa_double =
+            time_seconds([&]() { lengths = SG::polyline_lengths(soa); });
+    print("polyline_lengths (double):   ", t_soa_double, num_points,
+          sum(lengths));
+
+    const auto soa_float = SG::contour_polylines<float>(g, edges);
+    const auto t_soa_float =
+            time_seconds([&]() { lengths = SG::polyline_lengths(soa_float); });
+    print("polyline_lengths (float):    ", t_soa_float, num_points,
+          sum(lengths));
+
+    double total = 0.0;
+    const auto t_edge_points_length = time_seconds([&]() {
+        for (const auto e : boost::make_iterator_range(boost::edges(g))) {
+            total += SG::edge_points_length(g[e]);
+        }
+    });
+    print("edge_points_length per edge: ", t_edge_points_length, num_points,
+          total);
+    total = 0.0;
+    const auto t_polyline_length = time_seconds([&]() {
+        for (size_t i = 0; i < soa.num_polylines(); ++i) {
+            total += SG::polyline_length(soa, i);
+        }
+    });
+    print("polyline_length per edge:    ", t_polyline_length, num_points,
+          total);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,133 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+/**
+ * Compare read_graphviz_sg/write_graphviz_sg (boost::read_graphviz) with
+ * read_graphviz_sg_fast/write_graphviz_sg_fast.
+ *
+ * The input graph (by default the airway skeleton of the images folder) is
+ * scaled up by copying it scale times as disconnected components.
+ *
+ * Usage: bench_graphviz_io [scale] [input.dot]
+ */
+
+#include "spatial_graph.hpp"
+#include "spatial_graph_io.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+SG::GraphType scale_graph(const SG::GraphType &input, const size_t scale) {
+    const auto nverts = boost::num_vertices(input);
+    SG::GraphType output(nverts * scale);
+    for (size_t copy = 0; copy < scale; ++copy) {
+        const auto shift = copy * nverts;
+        for (size_t v = 0; v < nverts; ++v) {
+            output[shift + v] = input[v];
+            output[shift + v].id = shift + v;
+        }
+        for (const auto e : boost::make_iterator_range(boost::edges(input))) {
+            boost::add_edge(shift + boost::source(e, input),
+                            shift + boost::target(e, input), input[e], output);
+        }
+    }
+    return output;
+}
+
+template <typename TFunction>
+double time_seconds(TFunction &&function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+size_t file_size(const std::string &filename) {
+    std::ifstream ifile(filename, std::ios::binary | std::ios::ate);
+    return static_cast<size_t>(ifile.tellg());
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t scale = argc > 1 ? std::stoul(argv[1]) : 4;
+    const std::string input_file =
+            argc > 2 ? argv[2]
+                     : std::string(SG_BENCHMARK_IMAGES_FOLDER) +
+                               "/airway/airway_p4_chopped_SKEL.dot";
+
+    const auto input = SG::read_graphviz_sg_fast(input_file);
+    auto graph = scale_graph(input, scale);
+    size_t num_edge_points = 0;
+    for (const auto e : boost::make_iterator_range(boost::edges(graph))) {
+        num_edge_points += graph[e].edge_points.size();
+    }
+    std::cout << "Input: " << input_file << " x" << scale << std::endl;
+    std::cout << "Vertices: " << boost::num_vertices(graph)
+              << " | Edges: " << boost::num_edges(graph)
+              << " | Edge points: " << num_edge_points << std::endl;
+
+    const std::string boost_file = "bench_graphviz_io_boost.dot";
+    const std::string fast_file = "bench_graphviz_io_fast.dot";
+
+    const auto t_write_boost =
+            time_seconds([&]() { SG::write_graphviz_sg(boost_file, graph); });
+    const auto t_write_fast = time_seconds(
+            [&]() { SG::write_graphviz_sg_fast(fast_file, graph); });
+
+    SG::GraphType g_boost;
+    const auto t_read_boost = time_seconds(
+            [&]() { SG::read_graphviz_sg(boost_file, g_boost); });
+    SG::GraphType g_fast_from_boost_file;
+    const auto t_read_fast_boost_file = time_seconds([&]() {
+        SG::read_graphviz_sg_fast(boost_file, g_fast_from_boost_file);
+    });
+    SG::GraphType g_fast;
+    const auto t_read_fast =
+            time_seconds([&]() { SG::read_graphviz_sg_fast(fast_file, g_fast); });
+
+    std::cout << "write_graphviz_sg:      " << t_write_boost << " s ("
+              << file_size(boost_file) << " bytes)" << std::endl;
+    std::cout << "write_graphviz_sg_fast: " << t_write_fast << " s ("
+              << file_size(fast_file) << " bytes)" << std::endl;
+    std::cout << "read_graphviz_sg:       " << t_read_boost << " s"
+              << std::endl;
+    std::cout << "read_graphviz_sg_fast:  " << t_read_fast_boost_file
+              << " s (file of write_graphviz_sg)" << std::endl;
+    std::cout << "read_graphviz_sg_fast:  " << t_read_fast
+              << " s (file of write_graphviz_sg_fast)" << std::endl;
+
+    const bool same_size =
+            boost::num_vertices(g_boost) == boost::num_vertices(g_fast) &&
+            boost::num_edges(g_boost) == boost::num_edges(g_fast) &&
+            boost::num_edges(g_boost) ==
+                    boost::num_edges(g_fast_from_boost_file);
+    std::remove(boost_file.c_str());
+    std::remove(fast_file.c_str());
+    if (!same_size) {
+        std::cerr << "Graphs read by both readers differ." << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,129 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+/**
+ * Radius and k-nearest queries of SpatialGridIndex against a linear scan of
+ * all the points (get_all_points), in a graph of random points.
+ *
+ * Usage: bench_spatial_grid_index [num_points] [num_queries]
+ */
+
+#include "spatial_graph_utilities.hpp"
+#include "spatial_grid_index.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+
+namespace {
+template <typename TFunction>
+double time_seconds(TFunction &&function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void print(const std::string &name, const double seconds, const size_t n) {
+    std::cout << name << seconds << " s (" << 1e6 * seconds / n
+              << " us/query)" << std::endl;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t num_points = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const size_t num_queries = argc > 2 ? std::stoul(argv[2]) : 1000;
+    // Chain of vertices with 9 edge points per edge, in a box of
+    // side 100 (density of 1 point per unit volume).
+    const double side = 100.0 * std::cbrt(num_points / 1.0e6);
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> dis(0.0, side);
+    const auto random_point = [&]() {
+        return SG::PointType{{dis(gen), dis(gen), dis(gen)}};
+    };
+    const size_t num_vertices = num_points / 10;
+    SG::GraphType g(num_vertices);
+    for (size_t i = 0; i < num_vertices; ++i) {
+        g[i].pos = random_point();
+    }
+    for (size_t i = 1; i < num_vertices; ++i) {
+        SG::SpatialEdge se;
+        for (size_t p = 0; p < 9; ++p) {
+            se.edge_points.push_back(random_point());
+        }
+        boost::add_edge(i - 1, i, se, g);
+    }
+    std::vector<SG::PointType> queries;
+    for (size_t i = 0; i < num_queries; ++i) {
+        queries.push_back(random_point());
+    }
+    const double radius = 2.0;
+    const size_t k = 10;
+
+    std::unique_ptr<SG::SpatialGridIndex> index;
+    const auto t_build = time_seconds([&]() {
+        index = std::unique_ptr<SG::SpatialGridIndex>(
+                new SG::SpatialGridIndex(g, radius));
+    });
+    std::cout << "Points: " << index->size() << ", cells: "
+              << index->num_cells() << ", build: " << t_build << " s"
+              << std::endl;
+
+    std::vector<SG::PointType> points;
+    std::vector<SG::graph_descriptor> gdescs;
+    std::tie(points, gdescs) = SG::get_all_points(g);
+    size_t found_linear = 0;
+    const auto t_radius_linear = time_seconds([&]() {
+        for (const auto &query : queries) {
+            for (const auto &p : points) {
+                const double dx = p[0] - query[0];
+                const double dy = p[1] - query[1];
+                const double dz = p[2] - query[2];
+                found_linear += (dx * dx + dy * dy + dz * dz <= radius * radius);
+            }
+        }
+    });
+    size_t found_index = 0;
+    const auto t_radius_index = time_seconds([&]() {
+        for (const auto &query : queries) {
+            found_index += index->radius_search(query, radius).size();
+        }
+    });
+    double sum_distances = 0.0;
+    const auto t_knn_index = time_seconds([&]() {
+        for (const auto &query : queries) {
+            sum_distances += index->k_nearest(query, k).back().distance;
+        }
+    });
+    if (found_linear != found_index) {
+        std::cerr << "Different results: " << found_linear
+                  << " != " << found_index << std::endl;
+        return EXIT_FAILURE;
+    }
+    print("Radius linear scan:   ", t_radius_linear, num_queries);
+    print("Radius grid index:    ", t_radius_index, num_queries);
+    print("k-nearest grid index: ", t_knn_index, num_queries);
+    std::cout << "Mean k-th distance: " << sum_distances / num_queries
+              << std::endl;
+    return EXIT_SUCCESS;
+}
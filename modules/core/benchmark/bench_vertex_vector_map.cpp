@@ -0,0 +1,166 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+/**
+ * Per-vertex overhead of the color map in DFS and BFS visits:
+ * std::map with boost::associative_property_map vs VertexColorMap.
+ *
+ * A grid graph of num_vertices is visited once (full visit), and a graph of
+ * disjoint short paths is visited many times from different starts
+ * (reusing the color map with reset).
+ *
+ * Usage: bench_vertex_vector_map [num_vertices] [num_short_visits]
+ */
+
+#include "spatial_graph.hpp"
+#include "vertex_vector_map.hpp"
+
+#include <boost/graph/breadth_first_search.hpp>
+#include <boost/graph/depth_first_search.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+
+namespace {
+using vertex_descriptor = SG::GraphType::vertex_descriptor;
+using StdColorMap = std::map<vertex_descriptor, boost::default_color_type>;
+
+template <typename TFunction>
+double time_seconds(TFunction &&function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+SG::GraphType grid_graph(const size_t side) {
+    SG::GraphType g(side * side);
+    for (size_t y = 0; y < side; ++y) {
+        for (size_t x = 0; x < side; ++x) {
+            const auto v = x + side * y;
+            if (x + 1 < side) {
+                boost::add_edge(v, v + 1, g);
+            }
+            if (y + 1 < side) {
+                boost::add_edge(v, v + side, g);
+            }
+        }
+    }
+    return g;
+}
+
+/** Disjoint paths of path_length vertices. */
+SG::GraphType paths_graph(const size_t num_paths, const size_t path_length) {
+    SG::GraphType g(num_paths * path_length);
+    for (size_t p = 0; p < num_paths; ++p) {
+        for (size_t i = 1; i < path_length; ++i) {
+            boost::add_edge(p * path_length + i - 1, p * path_length + i, g);
+        }
+    }
+    return g;
+}
+
+void print(const std::string &name, const double seconds, const size_t n) {
+    std::cout << name << seconds << " s (" << 1e9 * seconds / n
+              << " ns/vertex)" << std::endl;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t num_vertices = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const size_t num_short_visits = argc > 2 ? std::stoul(argv[2]) : 2000;
+    const auto side = static_cast<size_t>(std::sqrt(num_vertices));
+    const auto g = grid_graph(side);
+    const auto n = boost::num_vertices(g);
+    std::cout << "Grid graph: " << n << " vertices" << std::endl;
+
+    // Full DFS
+    const auto t_dfs_std_map = time_seconds([&]() {
+        StdColorMap color_map;
+        boost::associative_property_map<StdColorMap> pmap(color_map);
+        boost::depth_first_visit(g, 0, boost::default_dfs_visitor(), pmap);
+    });
+    const auto t_dfs_vector = time_seconds([&]() {
+        SG::VertexColorMap color_map(n);
+        boost::depth_first_visit(g, 0, boost::default_dfs_visitor(),
+                                 color_map.property_map());
+    });
+    // Full BFS
+    boost::queue<vertex_descriptor> Q;
+    const auto t_bfs_std_map = time_seconds([&]() {
+        StdColorMap color_map;
+        boost::associative_property_map<StdColorMap> pmap(color_map);
+        boost::breadth_first_visit(g, 0, Q, boost::default_bfs_visitor(),
+                                   pmap);
+    });
+    const auto t_bfs_vector = time_seconds([&]() {
+        SG::VertexColorMap color_map(n);
+        boost::breadth_first_visit(g, 0, Q, boost::default_bfs_visitor(),
+                                   color_map.property_map());
+    });
+    print("DFS std::map:        ", t_dfs_std_map, n);
+    print("DFS VertexColorMap:  ", t_dfs_vector, n);
+    print("BFS std::map:        ", t_bfs_std_map, n);
+    print("BFS VertexColorMap:  ", t_bfs_vector, n);
+
+    // Many short BFS visits in a large graph of disjoint paths, each visit
+    // covers one path. Compare a new std::map per visit, a new vector per
+    // visit, and one VertexColorMap with reset.
+    const size_t path_length = 16;
+    const auto paths_g = paths_graph(n / path_length, path_length);
+    const auto paths_n = boost::num_vertices(paths_g);
+    const auto start_vertex = [&](const size_t i) {
+        return (i * path_length) % paths_n;
+    };
+    const auto t_short_std_map = time_seconds([&]() {
+        for (size_t i = 0; i < num_short_visits; ++i) {
+            StdColorMap color_map;
+            boost::associative_property_map<StdColorMap> pmap(color_map);
+            boost::breadth_first_visit(paths_g, start_vertex(i), Q,
+                                       boost::default_bfs_visitor(), pmap);
+        }
+    });
+    const auto t_short_new_vector = time_seconds([&]() {
+        for (size_t i = 0; i < num_short_visits; ++i) {
+            SG::VertexColorMap color_map(paths_n);
+            boost::breadth_first_visit(paths_g, start_vertex(i), Q,
+                                       boost::default_bfs_visitor(),
+                                       color_map.property_map());
+        }
+    });
+    const auto t_short_reset = time_seconds([&]() {
+        SG::VertexColorMap color_map(paths_n);
+        for (size_t i = 0; i < num_short_visits; ++i) {
+            color_map.reset();
+            boost::breadth_first_visit(paths_g, start_vertex(i), Q,
+                                       boost::default_bfs_visitor(),
+                                       color_map.property_map());
+        }
+    });
+    const auto visited = num_short_visits * path_length;
+    print("Short BFS std::map:               ", t_short_std_map, visited);
+    print("Short BFS new VertexColorMap:     ", t_short_new_vector, visited);
+    print("Short BFS VertexColorMap + reset: ", t_short_reset, visited);
+    return EXIT_SUCCESS;
+}
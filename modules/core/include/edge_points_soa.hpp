@@ -0,0 +1,299 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef EDGE_POINTS_SOA_HPP
+#define EDGE_POINTS_SOA_HPP
+
+#include "bounding_box.hpp"
+#include "frozen_spatial_graph.hpp"
+#include "spatial_graph.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace SG {
+
+/**
+ * Structure of arrays (SoA) storage of a set of polylines, for example the
+ * edge_points of all the edges of a graph.
+ * The coordinates are stored in three contiguous arrays x, y, z
+ * (of double or float), and the points of polyline i are in the range
+ * [offsets[i], offsets[i + 1]), as in FrozenSpatialGraph.
+ *
+ * This layout allows the SIMD kernels of this header
+ * (@ref polyline_length, @ref cumulative_arc_length,
+ * @ref polyline_bounding_box, @ref closest_point_on_polyline) to process
+ * several segments at once, instead of one std::array<double, 3> at a time.
+ * Use TReal = float to halve the memory and double the SIMD width,
+ * the lengths are accumulated per lane in float.
+ */
+template <typename TReal = double> class EdgePointsSoA {
+  public:
+    using value_type = TReal;
+
+    EdgePointsSoA() : m_offsets(1, 0) {}
+    /** Store points as a single polyline. */
+    explicit EdgePointsSoA(const PointContainer &points) : EdgePointsSoA() {
+        add_polyline(points);
+    }
+
+    void reserve(const std::size_t num_polylines, const std::size_t num_points) {
+        m_offsets.reserve(num_polylines + 1);
+        m_x.reserve(num_points);
+        m_y.reserve(num_points);
+        m_z.reserve(num_points);
+    }
+
+    void clear() {
+        m_x.clear();
+        m_y.clear();
+        m_z.clear();
+        m_offsets.assign(1, 0);
+    }
+
+    /** Start a new empty polyline, @sa push_back to add points to it. */
+    std::size_t add_polyline() {
+        m_offsets.push_back(m_x.size());
+        return num_polylines() - 1;
+    }
+
+    /** Add a new polyline with the points in [first, last). */
+    template <typename TIterator>
+    std::size_t add_polyline(TIterator first, TIterator last) {
+        for (; first != last; ++first) {
+            push_back_point(*first);
+        }
+        return add_polyline();
+    }
+
+    template <typename TPointContainer>
+    std::size_t add_polyline(const TPointContainer &points) {
+        return add_polyline(std::begin(points), std::end(points));
+    }
+
+    /** Append point to the last polyline. */
+    void push_back(const PointType &point) {
+        if (num_polylines() == 0) {
+            add_polyline();
+        }
+        push_back_point(point);
+        m_offsets.back() = m_x.size();
+    }
+
+    /**
+     * Set the number of polylines and their sizes, resizing the coordinate
+     * arrays. Use the non-const x, y, z to fill the coordinates.
+     */
+    void assign_polyline_sizes(const std::vector<std::size_t> &sizes) {
+        m_offsets.resize(sizes.size() + 1);
+        m_offsets[0] = 0;
+        for (std::size_t i = 0; i < sizes.size(); ++i) {
+            m_offsets[i + 1] = m_offsets[i] + sizes[i];
+        }
+        m_x.resize(m_offsets.back());
+        m_y.resize(m_offsets.back());
+        m_z.resize(m_offsets.back());
+    }
+
+    std::size_t num_polylines() const { return m_offsets.size() - 1; }
+    std::size_t num_points() const { return m_x.size(); }
+    std::size_t polyline_size(const std::size_t polyline) const {
+        return m_offsets[polyline + 1] - m_offsets[polyline];
+    }
+
+    const TReal *x(const std::size_t polyline = 0) const {
+        return m_x.data() + m_offsets[polyline];
+    }
+    const TReal *y(const std::size_t polyline = 0) const {
+        return m_y.data() + m_offsets[polyline];
+    }
+    const TReal *z(const std::size_t polyline = 0) const {
+        return m_z.data() + m_offsets[polyline];
+    }
+    TReal *x(const std::size_t polyline = 0) {
+        return m_x.data() + m_offsets[polyline];
+    }
+    TReal *y(const std::size_t polyline = 0) {
+        return m_y.data() + m_offsets[polyline];
+    }
+    TReal *z(const std::size_t polyline = 0) {
+        return m_z.data() + m_offsets[polyline];
+    }
+    const std::vector<std::size_t> &offsets() const { return m_offsets; }
+
+    PointType point(const std::size_t polyline, const std::size_t index) const {
+        const auto i = m_offsets[polyline] + index;
+        return PointType{{static_cast<double>(m_x[i]),
+                          static_cast<double>(m_y[i]),
+                          static_cast<double>(m_z[i])}};
+    }
+
+    /** Copy polyline back to a PointContainer (array of structures). */
+    PointContainer polyline(const std::size_t polyline) const {
+        PointContainer points;
+        points.reserve(polyline_size(polyline));
+        for (std::size_t i = 0; i < polyline_size(polyline); ++i) {
+            points.push_back(point(polyline, i));
+        }
+        return points;
+    }
+
+  private:
+    void push_back_point(const PointType &point) {
+        m_x.push_back(static_cast<TReal>(point[0]));
+        m_y.push_back(static_cast<TReal>(point[1]));
+        m_z.push_back(static_cast<TReal>(point[2]));
+    }
+
+    std::vector<TReal> m_x;
+    std::vector<TReal> m_y;
+    std::vector<TReal> m_z;
+    std::vector<std::size_t> m_offsets;
+};
+
+/**
+ * Sum of the distances between consecutive points of the polyline.
+ * 0.0 if there are less than two points.
+ * Equivalent to @ref edge_points_length.
+ */
+template <typename TReal>
+double polyline_length(const TReal *x,
+                       const TReal *y,
+                       const TReal *z,
+                       std::size_t num_points);
+template <typename TReal>
+double polyline_length(const EdgePointsSoA<TReal> &soa,
+                       const std::size_t polyline = 0) {
+    return polyline_length(soa.x(polyline), soa.y(polyline), soa.z(polyline),
+                           soa.polyline_size(polyline));
+}
+
+/** polyline_length of all the polylines of soa. */
+template <typename TReal>
+std::vector<double> polyline_lengths(const EdgePointsSoA<TReal> &soa);
+
+/**
+ * Arc length from the first point to each point of the polyline.
+ * The output has num_points values, the first is 0.0 and the last is
+ * polyline_length.
+ */
+template <typename TReal>
+void cumulative_arc_length(const TReal *x,
+                           const TReal *y,
+                           const TReal *z,
+                           std::size_t num_points,
+                           double *output);
+template <typename TReal>
+std::vector<double> cumulative_arc_length(const EdgePointsSoA<TReal> &soa,
+                                          const std::size_t polyline = 0) {
+    std::vector<double> output(soa.polyline_size(polyline));
+    cumulative_arc_length(soa.x(polyline), soa.y(polyline), soa.z(polyline),
+                          soa.polyline_size(polyline), output.data());
+    return output;
+}
+
+/**
+ * Axis aligned bounding box of the points.
+ * Throws if num_points is 0.
+ */
+template <typename TReal>
+BoundingBox polyline_bounding_box(const TReal *x,
+                                  const TReal *y,
+                                  const TReal *z,
+                                  std::size_t num_points);
+template <typename TReal>
+BoundingBox polyline_bounding_box(const EdgePointsSoA<TReal> &soa,
+                                  const std::size_t polyline) {
+    return polyline_bounding_box(soa.x(polyline), soa.y(polyline),
+                                 soa.z(polyline), soa.polyline_size(polyline));
+}
+/** Bounding box of all the points of soa. */
+template <typename TReal>
+BoundingBox polyline_bounding_box(const EdgePointsSoA<TReal> &soa) {
+    return polyline_bounding_box(soa.x(0), soa.y(0), soa.z(0),
+                                 soa.num_points());
+}
+
+struct ClosestPointOnPolyline {
+    /** closest point of the polyline to the query */
+    PointType point;
+    /** distance between the query and point */
+    double distance;
+    /** point is in the segment between points segment_index and
+     * segment_index + 1 */
+    std::size_t segment_index;
+    /** parameter of point in the segment, in [0, 1] */
+    double segment_parameter;
+};
+
+/**
+ * Closest point to query of the polyline (points and the segments between
+ * them). If there is a tie, the first segment is chosen.
+ * Throws if num_points is 0.
+ */
+template <typename TReal>
+ClosestPointOnPolyline closest_point_on_polyline(const TReal *x,
+                                                 const TReal *y,
+                                                 const TReal *z,
+                                                 std::size_t num_points,
+                                                 const PointType &query);
+template <typename TReal>
+ClosestPointOnPolyline
+closest_point_on_polyline(const EdgePointsSoA<TReal> &soa,
+                          const std::size_t polyline,
+                          const PointType &query) {
+    return closest_point_on_polyline(soa.x(polyline), soa.y(polyline),
+                                     soa.z(polyline),
+                                     soa.polyline_size(polyline), query);
+}
+
+/**
+ * Polylines with the contour of the input edges: source node, edge_points
+ * (in the order connected to source) and target node.
+ * The length of polyline i is equal to contour_length(edges[i], sg).
+ */
+template <typename TReal = double>
+EdgePointsSoA<TReal>
+contour_polylines(const GraphType &sg,
+                  const std::vector<GraphType::edge_descriptor> &edges);
+template <typename TReal = double>
+EdgePointsSoA<TReal> contour_polylines(
+        const FrozenSpatialGraph &sg,
+        const std::vector<FrozenSpatialGraph::edge_descriptor> &edges);
+
+/**
+ * @ref contour_length of the input edges, computed on the graph (not with
+ * the SoA kernels).
+ * Use @ref contour_polylines and @ref polyline_lengths instead when the
+ * polylines are going to be queried more than once.
+ */
+std::vector<double>
+contour_lengths(const GraphType &sg,
+                const std::vector<GraphType::edge_descriptor> &edges);
+std::vector<double> contour_lengths(
+        const FrozenSpatialGraph &sg,
+        const std::vector<FrozenSpatialGraph::edge_descriptor> &edges);
+/** contour_length of all the edges, in the order of edges(sg) */
+std::vector<double> contour_lengths(const GraphType &sg);
+std::vector<double> contour_lengths(const FrozenSpatialGraph &sg);
+
+} // namespace SG
+#endif
@@ -21,6 +21,7 @@
 #ifndef EDGE_POINTS_UTILITIES_HPP
 #define EDGE_POINTS_UTILITIES_HPP
 
+#include "frozen_spatial_graph.hpp"
 #include "spatial_edge.hpp"
 #include "spatial_graph.hpp"
 
@@ -37,6 +38,8 @@ namespace SG {
  */
 double ete_distance(const GraphType::edge_descriptor &edge_desc,
                     const GraphType &sg);
+double ete_distance(const FrozenSpatialGraph::edge_descriptor &edge_desc,
+                    const FrozenSpatialGraph &sg);
 
 /** Compute the length between the first edge point and the last.
  * It sums the distance between every pair of consecutive points.
@@ -53,6 +56,7 @@ double ete_distance(const GraphType::edge_descriptor &edge_desc,
  * @return the length between first and last edge_points
  */
 double edge_points_length(const SpatialEdge &se);
+double edge_points_length(const EdgePointsView &edge_points);
 
 /**
  * Compute the contour length of the edge points, including the distance to the
@@ -74,6 +78,26 @@ double edge_points_length(const SpatialEdge &se);
  */
 double contour_length(const GraphType::edge_descriptor &edge_desc,
                       const GraphType &sg);
+double contour_length(const FrozenSpatialGraph::edge_descriptor &edge_desc,
+                      const FrozenSpatialGraph &sg);
+
+/**
+ * Orientation of the edge_points of an edge with respect to its nodes.
+ * Because the graph is undirected, the source node can be connected to the
+ * front or to the back of the edge_points.
+ * Used by @ref contour_length.
+ *
+ * @param source_pos position of the source node of the edge
+ * @param target_pos position of the target node of the edge
+ * @param front first edge point
+ * @param back last edge point
+ *
+ * @return true if source is connected to front (and target to back)
+ */
+bool edge_points_front_is_connected_to_source(const PointType &source_pos,
+                                              const PointType &target_pos,
+                                              const PointType &front,
+                                              const PointType &back);
 
 /**
  * Insert point in the input container.
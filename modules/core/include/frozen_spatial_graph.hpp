@@ -0,0 +1,392 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef FROZEN_SPATIAL_GRAPH_HPP
+#define FROZEN_SPATIAL_GRAPH_HPP
+
+#include "common_types.hpp"
+#include "spatial_graph.hpp"
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/transform_iterator.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace SG {
+
+/**
+ * Read-only view of a contiguous range of points of
+ * FrozenSpatialGraph::edge_points_pool.
+ * Offers the subset of the std::vector interface used by the algorithms
+ * working on SpatialEdge::edge_points.
+ */
+struct EdgePointsView {
+    using value_type = PointType;
+    using const_iterator = const PointType *;
+    using iterator = const_iterator;
+    using size_type = std::size_t;
+
+    const PointType *m_first = nullptr;
+    const PointType *m_last = nullptr;
+
+    inline const_iterator begin() const { return m_first; }
+    inline const_iterator end() const { return m_last; }
+    inline const_iterator cbegin() const { return m_first; }
+    inline const_iterator cend() const { return m_last; }
+    inline size_type size() const {
+        return static_cast<size_type>(m_last - m_first);
+    }
+    inline bool empty() const { return m_first == m_last; }
+    inline const PointType &operator[](size_type i) const {
+        return m_first[i];
+    }
+    inline const PointType &front() const { return *m_first; }
+    inline const PointType &back() const { return *(m_last - 1); }
+    inline const PointType *data() const { return m_first; }
+};
+
+/** Bundle returned by FrozenSpatialGraph::operator[](vertex_descriptor) */
+struct FrozenSpatialNode {
+    const PointType &pos;
+    std::size_t id;
+};
+
+/** Bundle returned by FrozenSpatialGraph::operator[](edge_descriptor) */
+struct FrozenSpatialEdge {
+    EdgePointsView edge_points;
+};
+
+/**
+ * Edge descriptor of FrozenSpatialGraph.
+ * m_source and m_target follow the naming of the boost edge descriptors, so
+ * helpers like @ref edge_hash work with both graph types.
+ * m_index is the position of the edge in the edge arrays of the graph.
+ */
+struct FrozenEdgeDescriptor {
+    std::size_t m_source = 0;
+    std::size_t m_target = 0;
+    std::size_t m_index = 0;
+    FrozenEdgeDescriptor() = default;
+    FrozenEdgeDescriptor(std::size_t source,
+                         std::size_t target,
+                         std::size_t index)
+            : m_source(source), m_target(target), m_index(index) {}
+};
+inline bool operator==(const FrozenEdgeDescriptor &lhs,
+                       const FrozenEdgeDescriptor &rhs) {
+    return lhs.m_index == rhs.m_index;
+}
+inline bool operator!=(const FrozenEdgeDescriptor &lhs,
+                       const FrozenEdgeDescriptor &rhs) {
+    return !(lhs == rhs);
+}
+inline bool operator<(const FrozenEdgeDescriptor &lhs,
+                      const FrozenEdgeDescriptor &rhs) {
+    return lhs.m_index < rhs.m_index;
+}
+inline std::ostream &operator<<(std::ostream &os,
+                                const FrozenEdgeDescriptor &e) {
+    os << "(" << e.m_source << "," << e.m_target << ")";
+    return os;
+}
+
+/**
+ * Immutable spatial graph stored in compressed sparse row (CSR) format.
+ *
+ * Intended for read-only analysis of large graphs: all the data lives in a
+ * handful of contiguous vectors instead of one heap node per out-edge and one
+ * std::vector per SpatialEdge as in @ref GraphAL.
+ *
+ * - Vertex v has position positions[v] and its out-edges are stored in
+ *   [out_offsets[v], out_offsets[v + 1]) of out_targets and out_edge_indices.
+ * - Edge i connects edge_sources[i] and edge_targets[i], and its edge points
+ *   are [edge_points_offsets[i], edge_points_offsets[i + 1]) of
+ *   edge_points_pool.
+ *
+ * The graph models the BGL concepts VertexListGraph, EdgeListGraph,
+ * IncidenceGraph and AdjacencyGraph (undirected, parallel edges allowed), and
+ * provides g[v].pos and g[e].edge_points like the bundled properties of
+ * GraphType, so generic algorithms can run on it unchanged.
+ * The free functions (source, out_edges, ...) live in namespace SG and are
+ * found by argument dependent lookup: call them unqualified, not as
+ * boost::source(e, g). The entry points of the tree, locate and compare
+ * modules have FrozenSpatialGraph overloads.
+ *
+ * Vertex descriptors, and the order of vertices, edges and out-edges are the
+ * same than the GraphType used to create it.
+ *
+ * @sa frozen_spatial_graph_from_graph, graph_from_frozen_spatial_graph
+ */
+struct FrozenSpatialGraph {
+    using vertex_descriptor = std::size_t;
+    using edge_descriptor = FrozenEdgeDescriptor;
+    using vertices_size_type = std::size_t;
+    using edges_size_type = std::size_t;
+    using degree_size_type = std::size_t;
+    using vertex_bundled = FrozenSpatialNode;
+    using edge_bundled = FrozenSpatialEdge;
+
+    /** CSR offsets, size: num_vertices + 1 */
+    std::vector<std::size_t> out_offsets = {0};
+    /** Target vertex of each out-edge slot */
+    std::vector<vertex_descriptor> out_targets;
+    /** Edge index of each out-edge slot */
+    std::vector<std::size_t> out_edge_indices;
+    /** Position of each vertex */
+    PointContainer positions;
+    /** SpatialNode::id of each vertex */
+    std::vector<std::size_t> ids;
+    /** Source of each edge */
+    std::vector<vertex_descriptor> edge_sources;
+    /** Target of each edge */
+    std::vector<vertex_descriptor> edge_targets;
+    /** Offsets into edge_points_pool, size: num_edges + 1 */
+    std::vector<std::size_t> edge_points_offsets = {0};
+    /** Edge points of all the edges, one after the other */
+    PointContainer edge_points_pool;
+
+    inline std::size_t num_vertices() const { return positions.size(); }
+    inline std::size_t num_edges() const { return edge_sources.size(); }
+
+    inline FrozenSpatialNode operator[](vertex_descriptor v) const {
+        return FrozenSpatialNode{positions[v], ids[v]};
+    }
+    inline FrozenSpatialEdge operator[](const edge_descriptor &e) const {
+        return FrozenSpatialEdge{edge_points(e.m_index)};
+    }
+    inline EdgePointsView edge_points(std::size_t edge_index) const {
+        const auto *pool = edge_points_pool.data();
+        return EdgePointsView{pool + edge_points_offsets[edge_index],
+                              pool + edge_points_offsets[edge_index + 1]};
+    }
+    inline edge_descriptor edge_at(std::size_t edge_index) const {
+        return edge_descriptor(edge_sources[edge_index],
+                               edge_targets[edge_index], edge_index);
+    }
+};
+
+/**
+ * Create a FrozenSpatialGraph from the input graph.
+ * Vertex descriptors and the order of edges and out-edges are kept.
+ *
+ * @param graph input spatial graph
+ *
+ * @return frozen copy of the graph
+ */
+FrozenSpatialGraph frozen_spatial_graph_from_graph(const GraphType &graph);
+
+/**
+ * Create a mutable GraphType from the frozen graph.
+ * The vertex ids (SpatialNode::id) are kept.
+ *
+ * @param frozen input frozen graph
+ *
+ * @return GraphType with the same vertices, edges and edge points
+ */
+GraphType graph_from_frozen_spatial_graph(const FrozenSpatialGraph &frozen);
+
+/**
+ * Fill the CSR adjacency (out_offsets, out_targets, out_edge_indices) of the
+ * frozen graph from its edge list (positions, edge_sources, edge_targets).
+ * Out-edges of each vertex are sorted by edge index, which is the order of
+ * out_edges of a GraphType built adding the edges in that same order.
+ *
+ * Used to create a FrozenSpatialGraph from flat arrays in linear time.
+ * If ids is empty, the vertex ids are set to the vertex descriptors.
+ *
+ * @param frozen graph with the vertices and edge list filled
+ */
+void build_frozen_spatial_graph_adjacency(FrozenSpatialGraph &frozen);
+
+namespace detail {
+struct frozen_out_edge_maker {
+    const FrozenSpatialGraph *m_graph = nullptr;
+    std::size_t m_source = 0;
+    frozen_out_edge_maker() = default;
+    frozen_out_edge_maker(const FrozenSpatialGraph *graph, std::size_t source)
+            : m_graph(graph), m_source(source) {}
+    inline FrozenEdgeDescriptor operator()(std::size_t slot) const {
+        return FrozenEdgeDescriptor(m_source, m_graph->out_targets[slot],
+                                    m_graph->out_edge_indices[slot]);
+    }
+};
+struct frozen_edge_maker {
+    const FrozenSpatialGraph *m_graph = nullptr;
+    frozen_edge_maker() = default;
+    explicit frozen_edge_maker(const FrozenSpatialGraph *graph)
+            : m_graph(graph) {}
+    inline FrozenEdgeDescriptor operator()(std::size_t edge_index) const {
+        return m_graph->edge_at(edge_index);
+    }
+};
+} // namespace detail
+
+struct frozen_spatial_graph_traversal_category
+        : public virtual boost::incidence_graph_tag,
+          public virtual boost::adjacency_graph_tag,
+          public virtual boost::vertex_list_graph_tag,
+          public virtual boost::edge_list_graph_tag {};
+
+/* ************* BGL free functions (found via ADL) *************/
+using frozen_vertex_iterator = boost::counting_iterator<std::size_t>;
+using frozen_out_edge_iterator =
+        boost::transform_iterator<detail::frozen_out_edge_maker,
+                                  boost::counting_iterator<std::size_t>,
+                                  FrozenEdgeDescriptor,
+                                  FrozenEdgeDescriptor>;
+using frozen_edge_iterator =
+        boost::transform_iterator<detail::frozen_edge_maker,
+                                  boost::counting_iterator<std::size_t>,
+                                  FrozenEdgeDescriptor,
+                                  FrozenEdgeDescriptor>;
+using frozen_adjacency_iterator = const std::size_t *;
+
+inline std::pair<frozen_vertex_iterator, frozen_vertex_iterator>
+vertices(const FrozenSpatialGraph &g) {
+    return std::make_pair(frozen_vertex_iterator(0),
+                          frozen_vertex_iterator(g.num_vertices()));
+}
+inline std::size_t num_vertices(const FrozenSpatialGraph &g) {
+    return g.num_vertices();
+}
+inline std::pair<frozen_edge_iterator, frozen_edge_iterator>
+edges(const FrozenSpatialGraph &g) {
+    const detail::frozen_edge_maker maker(&g);
+    return std::make_pair(
+            frozen_edge_iterator(boost::counting_iterator<std::size_t>(0),
+                                 maker),
+            frozen_edge_iterator(
+                    boost::counting_iterator<std::size_t>(g.num_edges()),
+                    maker));
+}
+inline std::size_t num_edges(const FrozenSpatialGraph &g) {
+    return g.num_edges();
+}
+inline std::pair<frozen_out_edge_iterator, frozen_out_edge_iterator>
+out_edges(std::size_t v, const FrozenSpatialGraph &g) {
+    const detail::frozen_out_edge_maker maker(&g, v);
+    return std::make_pair(
+            frozen_out_edge_iterator(
+                    boost::counting_iterator<std::size_t>(g.out_offsets[v]),
+                    maker),
+            frozen_out_edge_iterator(
+                    boost::counting_iterator<std::size_t>(g.out_offsets[v + 1]),
+                    maker));
+}
+inline std::size_t out_degree(std::size_t v, const FrozenSpatialGraph &g) {
+    return g.out_offsets[v + 1] - g.out_offsets[v];
+}
+/** Undirected graph: degree == out_degree */
+inline std::size_t degree(std::size_t v, const FrozenSpatialGraph &g) {
+    return out_degree(v, g);
+}
+inline std::pair<frozen_adjacency_iterator, frozen_adjacency_iterator>
+adjacent_vertices(std::size_t v, const FrozenSpatialGraph &g) {
+    const auto *targets = g.out_targets.data();
+    return std::make_pair(targets + g.out_offsets[v],
+                          targets + g.out_offsets[v + 1]);
+}
+inline std::size_t source(const FrozenEdgeDescriptor &e,
+                          const FrozenSpatialGraph & /*g*/) {
+    return e.m_source;
+}
+inline std::size_t target(const FrozenEdgeDescriptor &e,
+                          const FrozenSpatialGraph & /*g*/) {
+    return e.m_target;
+}
+/**
+ * Get any edge between u and v.
+ * Linear in the out_degree of u.
+ */
+inline std::pair<FrozenEdgeDescriptor, bool>
+edge(std::size_t u, std::size_t v, const FrozenSpatialGraph &g) {
+    for (auto slot = g.out_offsets[u]; slot != g.out_offsets[u + 1]; ++slot) {
+        if (g.out_targets[slot] == v) {
+            return std::make_pair(
+                    FrozenEdgeDescriptor(u, v, g.out_edge_indices[slot]),
+                    true);
+        }
+    }
+    return std::make_pair(FrozenEdgeDescriptor(), false);
+}
+
+/** vertex_index and edge_index property maps, both are identities */
+inline boost::typed_identity_property_map<std::size_t>
+get(boost::vertex_index_t /*tag*/, const FrozenSpatialGraph & /*g*/) {
+    return boost::typed_identity_property_map<std::size_t>();
+}
+inline std::size_t get(boost::vertex_index_t /*tag*/,
+                       const FrozenSpatialGraph & /*g*/,
+                       std::size_t v) {
+    return v;
+}
+struct frozen_edge_index_map {
+    using key_type = FrozenEdgeDescriptor;
+    using value_type = std::size_t;
+    using reference = std::size_t;
+    using category = boost::readable_property_map_tag;
+};
+inline std::size_t get(const frozen_edge_index_map & /*pmap*/,
+                       const FrozenEdgeDescriptor &e) {
+    return e.m_index;
+}
+inline frozen_edge_index_map get(boost::edge_index_t /*tag*/,
+                                 const FrozenSpatialGraph & /*g*/) {
+    return frozen_edge_index_map();
+}
+
+} // namespace SG
+
+namespace boost {
+template <> struct graph_traits<SG::FrozenSpatialGraph> {
+    using vertex_descriptor = std::size_t;
+    using edge_descriptor = SG::FrozenEdgeDescriptor;
+    using directed_category = undirected_tag;
+    using edge_parallel_category = allow_parallel_edge_tag;
+    using traversal_category = SG::frozen_spatial_graph_traversal_category;
+    using vertex_iterator = SG::frozen_vertex_iterator;
+    using edge_iterator = SG::frozen_edge_iterator;
+    using out_edge_iterator = SG::frozen_out_edge_iterator;
+    using adjacency_iterator = SG::frozen_adjacency_iterator;
+    using vertices_size_type = std::size_t;
+    using edges_size_type = std::size_t;
+    using degree_size_type = std::size_t;
+    static vertex_descriptor null_vertex() {
+        return std::numeric_limits<std::size_t>::max();
+    }
+};
+
+template <> struct property_map<SG::FrozenSpatialGraph, vertex_index_t> {
+    using type = typed_identity_property_map<std::size_t>;
+    using const_type = type;
+};
+template <> struct property_map<SG::FrozenSpatialGraph, edge_index_t> {
+    using type = SG::frozen_edge_index_map;
+    using const_type = type;
+};
+} // namespace boost
+#endif
@@ -20,6 +20,7 @@
 #ifndef GRAPH_DESCRIPTOR_HPP
 #define GRAPH_DESCRIPTOR_HPP
 
+#include "frozen_spatial_graph.hpp"
 #include "spatial_graph.hpp"
 
 namespace SG {
@@ -29,8 +30,11 @@ namespace SG {
  * the graph. The point can be in a node: vertex_descriptor, or in an edge:
  * edge_d + edge_points_index This graph_descriptor is used to map a vtk point
  * to differents graphs.
+ *
+ * @tparam TGraph GraphType (graph_descriptor) or FrozenSpatialGraph
+ * (frozen_graph_descriptor)
  */
-struct graph_descriptor {
+template <typename TGraph> struct basic_graph_descriptor {
     /** the point exist in the graph */
     bool exist = false;
     /** the point is in an edge of the graph */
@@ -38,16 +42,46 @@ struct graph_descriptor {
     /** the point is in a vertex of the graph */
     bool is_vertex = false;
     /** vertex_descriptor where point is located */
-    GraphType::vertex_descriptor vertex_d;
+    typename boost::graph_traits<TGraph>::vertex_descriptor vertex_d;
     /** edge_descriptor where point is located */
-    GraphType::edge_descriptor edge_d;
+    typename boost::graph_traits<TGraph>::edge_descriptor edge_d;
     /** index of the edge_points vector where point is located inside the edge
      */
     std::size_t edge_points_index = std::numeric_limits<size_t>::max();
 };
+using graph_descriptor = basic_graph_descriptor<GraphType>;
+using frozen_graph_descriptor = basic_graph_descriptor<FrozenSpatialGraph>;
+
+/**
+ * Two graph_descriptors are equal if they locate the same point, only the
+ * descriptors that are set (given by is_vertex and is_edge) are compared.
+ */
+template <typename TGraph>
+inline bool operator==(const basic_graph_descriptor<TGraph> &lhs,
+                       const basic_graph_descriptor<TGraph> &rhs) {
+    if (lhs.exist != rhs.exist || lhs.is_vertex != rhs.is_vertex ||
+        lhs.is_edge != rhs.is_edge) {
+        return false;
+    }
+    if (lhs.is_vertex && lhs.vertex_d != rhs.vertex_d) {
+        return false;
+    }
+    if (lhs.is_edge && (lhs.edge_d != rhs.edge_d ||
+                        lhs.edge_points_index != rhs.edge_points_index)) {
+        return false;
+    }
+    return true;
+}
+
+template <typename TGraph>
+inline bool operator!=(const basic_graph_descriptor<TGraph> &lhs,
+                       const basic_graph_descriptor<TGraph> &rhs) {
+    return !(lhs == rhs);
+}
 
+template <typename TGraph>
 inline void
-print_graph_descriptor(const graph_descriptor &descriptor,
+print_graph_descriptor(const basic_graph_descriptor<TGraph> &descriptor,
                        const std::string &label = "graph_descriptor",
                        std::ostream &os = std::cout) {
     os << label << ":" << std::endl;
@@ -0,0 +1,154 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef MAPPED_SPATIAL_GRAPH_HPP
+#define MAPPED_SPATIAL_GRAPH_HPP
+
+#include "frozen_spatial_graph.hpp"
+#include "spatial_graph.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace SG {
+
+/**
+ * Header of the binary spatial graph format (.sgb).
+ *
+ * All the values of the file are little-endian. The header is followed by
+ * the blocks, each one starting at the offset (in bytes from the beginning of
+ * the file) stored in the header, and 8-byte aligned:
+ *
+ * - vertex ids: uint64[num_vertices], the SpatialNode::id of each vertex.
+ * - positions: double[3 * num_vertices].
+ * - edge endpoints: uint64[2 * num_edges], (source, target) of each edge.
+ * - edge points offsets: uint64[num_edges + 1], edge i owns the points
+ *   [offsets[i], offsets[i + 1]) of the edge points block.
+ * - edge points: double[3 * num_edge_points].
+ *
+ * The layout matches the arrays of @ref FrozenSpatialGraph, so the file can be
+ * memory mapped and used without parsing.
+ */
+struct SpatialGraphBinaryHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t header_size;
+    std::uint64_t num_vertices;
+    std::uint64_t num_edges;
+    std::uint64_t num_edge_points;
+    std::uint64_t vertex_ids_offset;
+    std::uint64_t positions_offset;
+    std::uint64_t edge_endpoints_offset;
+    std::uint64_t edge_points_offsets_offset;
+    std::uint64_t edge_points_offset;
+    std::uint64_t file_size;
+};
+static_assert(sizeof(SpatialGraphBinaryHeader) == 88,
+              "SpatialGraphBinaryHeader must not have padding.");
+
+constexpr char spatial_graph_binary_magic[8] = {'S', 'G', 'E', 'X',
+                                                'T', 'S', 'G', 'B'};
+constexpr std::uint32_t spatial_graph_binary_version = 1;
+
+/**
+ * The binary format is read and written without byte swapping,
+ * it is only supported on little-endian platforms.
+ */
+bool is_spatial_graph_binary_supported();
+
+/**
+ * Fill the header (sizes and block offsets) of a binary spatial graph.
+ */
+SpatialGraphBinaryHeader
+make_spatial_graph_binary_header(const std::size_t num_vertices,
+                                 const std::size_t num_edges,
+                                 const std::size_t num_edge_points);
+
+/**
+ * Read-only spatial graph backed by a memory mapped binary file
+ * written with @ref write_sg_binary.
+ *
+ * Opening the file is O(1): only the header is checked, and the data is paged
+ * in by the OS when accessed. The mapping is released on destruction.
+ *
+ * Use @ref to_graph or @ref to_frozen_spatial_graph to get a graph that can be
+ * used in the rest of the library.
+ */
+class MappedSpatialGraph {
+  public:
+    explicit MappedSpatialGraph(const std::string &input_file);
+    ~MappedSpatialGraph();
+    MappedSpatialGraph(const MappedSpatialGraph &) = delete;
+    MappedSpatialGraph &operator=(const MappedSpatialGraph &) = delete;
+    MappedSpatialGraph(MappedSpatialGraph &&other) noexcept;
+    MappedSpatialGraph &operator=(MappedSpatialGraph &&other) noexcept;
+
+    inline std::uint32_t version() const { return m_header->version; }
+    inline std::size_t num_vertices() const { return m_header->num_vertices; }
+    inline std::size_t num_edges() const { return m_header->num_edges; }
+    inline std::size_t num_edge_points() const {
+        return m_header->num_edge_points;
+    }
+    inline std::size_t vertex_id(std::size_t v) const {
+        return m_vertex_ids[v];
+    }
+    inline const PointType &position(std::size_t v) const {
+        return m_positions[v];
+    }
+    inline std::size_t edge_source(std::size_t edge_index) const {
+        return m_edge_endpoints[2 * edge_index];
+    }
+    inline std::size_t edge_target(std::size_t edge_index) const {
+        return m_edge_endpoints[2 * edge_index + 1];
+    }
+    inline EdgePointsView edge_points(std::size_t edge_index) const {
+        return EdgePointsView{
+                m_edge_points + m_edge_points_offsets[edge_index],
+                m_edge_points + m_edge_points_offsets[edge_index + 1]};
+    }
+
+    /**
+     * Copy the mapped data into a GraphType, keeping the vertex ids.
+     * Throws if the edge list of the file is inconsistent.
+     */
+    GraphType to_graph() const;
+    /**
+     * Copy the mapped data into a FrozenSpatialGraph.
+     * Throws if the edge list of the file is inconsistent.
+     */
+    FrozenSpatialGraph to_frozen_spatial_graph() const;
+
+  private:
+    void check_edges() const;
+    void unmap() noexcept;
+
+    const char *m_data = nullptr;
+    std::size_t m_size = 0;
+    const SpatialGraphBinaryHeader *m_header = nullptr;
+    const std::uint64_t *m_vertex_ids = nullptr;
+    const PointType *m_positions = nullptr;
+    const std::uint64_t *m_edge_endpoints = nullptr;
+    const std::uint64_t *m_edge_points_offsets = nullptr;
+    const PointType *m_edge_points = nullptr;
+};
+
+} // namespace SG
+#endif
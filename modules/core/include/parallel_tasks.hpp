@@ -0,0 +1,179 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef SG_PARALLEL_TASKS_HPP
+#define SG_PARALLEL_TASKS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SG {
+
+namespace detail {
+/** task(task_index, thread_index), or task(task_index). */
+template <typename TTask>
+auto call_task(TTask &task,
+               const size_t task_index,
+               const size_t thread_index,
+               int) -> decltype(task(task_index, thread_index), void()) {
+    task(task_index, thread_index);
+}
+template <typename TTask>
+void call_task(TTask &task, const size_t task_index, const size_t, long) {
+    task(task_index);
+}
+/** Number of blocks of run_blocks, a few per thread to balance the load. */
+inline size_t num_blocks(const size_t num_items,
+                         const size_t num_threads,
+                         const size_t min_block_size) {
+    const size_t max_blocks = std::max<size_t>(
+            1, num_items / std::max<size_t>(1, min_block_size));
+    return std::min(max_blocks, 4 * num_threads);
+}
+} // namespace detail
+
+/** num_threads, or std::thread::hardware_concurrency if it is 0. */
+size_t resolve_num_threads(const size_t num_threads);
+
+/**
+ * Pool of threads that run batches of tasks. The threads are created once
+ * and wait between batches, so the pool can be reused by loops that run
+ * many short batches.
+ *
+ * The calling thread of run works as the thread 0 of the batch.
+ * run blocks until all the tasks are done, calls to run from different
+ * threads are serialized, and a task must not call run of its own pool.
+ */
+class ThreadPool {
+  public:
+    using Task = std::function<void(const size_t task_index,
+                                    const size_t thread_index)>;
+    /** Pool with num_threads, the calling thread included.
+     * 0 means std::thread::hardware_concurrency. */
+    explicit ThreadPool(const size_t num_threads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /** Number of threads running the tasks, the calling thread included. */
+    size_t num_threads() const { return workers_.size() + 1; }
+
+    /**
+     * Run task(i, thread_index), or task(i), for i in [0, num_tasks).
+     * The tasks are picked in order from a shared counter, thread_index is
+     * in [0, num_threads()) and identifies the thread running the task.
+     * If a task throws, the remaining tasks are skipped and the exception is
+     * rethrown in the calling thread.
+     */
+    template <typename TTask> void run(const size_t num_tasks, TTask &&task) {
+        run_batch(num_tasks, [&task](const size_t task_index,
+                                     const size_t thread_index) {
+            detail::call_task(task, task_index, thread_index, 0);
+        });
+    }
+
+  private:
+    void run_batch(const size_t num_tasks, const Task &task);
+    void work(const size_t thread_index);
+    void worker_loop(const size_t thread_index);
+
+    std::vector<std::thread> workers_;
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    std::condition_variable start_condition_;
+    std::condition_variable done_condition_;
+    const Task *task_ = nullptr;
+    size_t num_tasks_ = 0;
+    std::atomic<size_t> next_task_{0};
+    size_t batch_ = 0;
+    size_t workers_done_ = 0;
+    bool stop_ = false;
+    std::vector<std::exception_ptr> exceptions_;
+};
+
+/**
+ * Run task(i, thread_index), or task(i), for i in [0, num_tasks) in
+ * num_threads threads (the calling thread included).
+ * See ThreadPool::run, the threads are created for this call only, use a
+ * ThreadPool to reuse them.
+ */
+template <typename TTask>
+void run_tasks(const size_t num_tasks, size_t num_threads, TTask &&task) {
+    num_threads = std::max<size_t>(
+            1, std::min(resolve_num_threads(num_threads), num_tasks));
+    if (num_threads == 1) {
+        for (size_t i = 0; i < num_tasks; ++i) {
+            detail::call_task(task, i, 0, 0);
+        }
+        return;
+    }
+    ThreadPool pool(num_threads);
+    pool.run(num_tasks, std::forward<TTask>(task));
+}
+
+/**
+ * Split [0, num_items) in contiguous blocks and run block_task(begin, end)
+ * in num_threads threads. Blocks have at least min_block_size items, so
+ * small ranges run serially in the calling thread.
+ */
+template <typename TBlockTask>
+void run_blocks(const size_t num_items,
+                const size_t num_threads,
+                TBlockTask &&block_task,
+                const size_t min_block_size = 4096) {
+    const size_t num_blocks = detail::num_blocks(
+            num_items, resolve_num_threads(num_threads), min_block_size);
+    run_tasks(num_blocks, num_threads, [&](const size_t block) {
+        block_task(block * num_items / num_blocks,
+                   (block + 1) * num_items / num_blocks);
+    });
+}
+
+/**
+ * run_blocks in the threads of an existing pool, to avoid creating the
+ * threads in loops that call it many times.
+ * A single block runs in the calling thread.
+ */
+template <typename TBlockTask>
+void run_blocks(const size_t num_items,
+                ThreadPool &pool,
+                TBlockTask &&block_task,
+                const size_t min_block_size = 4096) {
+    const size_t num_blocks = detail::num_blocks(
+            num_items, pool.num_threads(), min_block_size);
+    if (num_blocks == 1) {
+        block_task(size_t(0), num_items);
+        return;
+    }
+    pool.run(num_blocks, [&](const size_t block) {
+        block_task(block * num_items / num_blocks,
+                   (block + 1) * num_items / num_blocks);
+    });
+}
+
+} // namespace SG
+#endif
@@ -13,9 +13,11 @@ kind of external source of seed). STATUS: NO multi-thread safety tested.
 #ifndef SG_RNG_UTILS_HPP
 #define SG_RNG_UTILS_HPP
 
+#include <algorithm>
 #include <array>
 #include <boost/math/constants/constants.hpp> // for pi definition
 #include <cmath>                              // for std::acos();
+#include <cstdint>
 #include <random>
 /**
  * Random Number Generator (RNG) namespace.
@@ -177,6 +179,130 @@ inline int random_geometric_shifted_custom(const double &p, const int &shift) {
     return static_cast<int>(log(1. - rand01()) / log(1 - p)) + shift;
 }
 
+/**
+ * Counter-based random number generator Philox4x32-10 (Salmon et al,
+ * "Parallel random numbers: as easy as 1, 2, 3", SC11).
+ *
+ * Unlike engine(), it has no state: the random numbers are a function of a
+ * counter and a key. Keyed by the seed, and with the time step and the
+ * particle id as counter, the random numbers of a particle do not depend on
+ * the order or the thread in which the particles are visited, and a
+ * simulation can be replayed from the seed.
+ */
+struct Philox4x32 {
+    using counter_t = std::array<uint32_t, 4>;
+    using key_t = std::array<uint32_t, 2>;
+    static constexpr size_t rounds = 10;
+
+    static inline counter_t generate(counter_t counter, key_t key) {
+        constexpr uint32_t multiplier_0 = 0xD2511F53;
+        constexpr uint32_t multiplier_1 = 0xCD9E8D57;
+        constexpr uint32_t weyl_0 = 0x9E3779B9;
+        constexpr uint32_t weyl_1 = 0xBB67AE85;
+        for (size_t round = 0; round < rounds; ++round) {
+            const uint64_t product_0 =
+                    static_cast<uint64_t>(multiplier_0) * counter[0];
+            const uint64_t product_1 =
+                    static_cast<uint64_t>(multiplier_1) * counter[2];
+            counter = {{static_cast<uint32_t>(product_1 >> 32) ^ counter[1] ^
+                                key[0],
+                        static_cast<uint32_t>(product_1),
+                        static_cast<uint32_t>(product_0 >> 32) ^ counter[3] ^
+                                key[1],
+                        static_cast<uint32_t>(product_0)}};
+            key[0] += weyl_0;
+            key[1] += weyl_1;
+        }
+        return counter;
+    }
+};
+
+/**
+ * Two uniform random numbers in [0,1) with 53 bits of precision, from the
+ * counter-based generator @ref Philox4x32.
+ *
+ * @param seed key of the generator
+ * @param counter_high for example the time step
+ * @param counter_low for example the particle id
+ *
+ * @return two independent uniform numbers in [0,1)
+ */
+inline std::array<double, 2> counter_based_rand01(const uint64_t seed,
+                                                  const uint64_t counter_high,
+                                                  const uint64_t counter_low) {
+    const auto bits = Philox4x32::generate(
+            {{static_cast<uint32_t>(counter_low),
+              static_cast<uint32_t>(counter_low >> 32),
+              static_cast<uint32_t>(counter_high),
+              static_cast<uint32_t>(counter_high >> 32)}},
+            {{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}});
+    constexpr double two_to_minus_53 = 1.0 / 9007199254740992.0;
+    const auto to_double = [two_to_minus_53](const uint32_t high,
+                                             const uint32_t low) {
+        return static_cast<double>(
+                       ((static_cast<uint64_t>(high) << 32) | low) >> 11) *
+               two_to_minus_53;
+    };
+    return {{to_double(bits[0], bits[1]), to_double(bits[2], bits[3])}};
+}
+
+/**
+ * Four independent standard normal random numbers (Box-Muller), from the
+ * counter-based generator @ref Philox4x32.
+ * The uniform numbers have 32 bits, the tails are truncated at ~6.6 sigma.
+ *
+ * @param seed key of the generator
+ * @param counter_high for example the time step
+ * @param counter_low for example the particle id
+ */
+inline std::array<double, 4> counter_based_normal(const uint64_t seed,
+                                                  const uint64_t counter_high,
+                                                  const uint64_t counter_low) {
+    const auto bits = Philox4x32::generate(
+            {{static_cast<uint32_t>(counter_low),
+              static_cast<uint32_t>(counter_low >> 32),
+              static_cast<uint32_t>(counter_high),
+              static_cast<uint32_t>(counter_high >> 32)}},
+            {{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}});
+    constexpr double two_to_minus_32 = 1.0 / 4294967296.0;
+    std::array<double, 4> normals;
+    for (size_t pair = 0; pair < 2; ++pair) {
+        // u_radius in (0,1], to avoid log(0)
+        const double u_radius =
+                (static_cast<double>(bits[2 * pair]) + 1.0) * two_to_minus_32;
+        const double u_angle =
+                static_cast<double>(bits[2 * pair + 1]) * two_to_minus_32;
+        const double radius = std::sqrt(-2.0 * std::log(u_radius));
+        normals[2 * pair] = radius * std::cos(two_pi * u_angle);
+        normals[2 * pair + 1] = radius * std::sin(two_pi * u_angle);
+    }
+    return normals;
+}
+
+/**
+ * Counter-based version of @ref random_orientation: a 3darray v with |v| = r
+ * and a random orientation, reproducible from (seed, counter_high,
+ * counter_low).
+ * The orientation is uniform on the sphere (cos(phi) uniform in [-1,1)).
+ *
+ * @param r modulus
+ * @param seed key of the generator
+ * @param counter_high for example the time step
+ * @param counter_low for example the particle id
+ */
+inline std::array<double, 3>
+counter_based_random_orientation(const double &r,
+                                 const uint64_t seed,
+                                 const uint64_t counter_high,
+                                 const uint64_t counter_low) {
+    const auto uniform = counter_based_rand01(seed, counter_high, counter_low);
+    const double cos_phi = 2.0 * uniform[0] - 1.0;
+    const double sin_phi = std::sqrt(std::max(0.0, 1.0 - cos_phi * cos_phi));
+    const double theta = two_pi * uniform[1];
+    return {r * sin_phi * std::cos(theta), r * sin_phi * std::sin(theta),
+            r * cos_phi};
+}
+
 } // namespace RNG
 
 #endif // RNG_UTILS_HPP
@@ -0,0 +1,260 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef SIMD_BATCH_HPP
+#define SIMD_BATCH_HPP
+
+/**
+ * Minimal portable SIMD layer for the geometry kernels of
+ * @ref edge_points_soa.hpp.
+ *
+ * simd::Batch<T> holds Batch<T>::width values of T (float or double) and
+ * offers unaligned load/store, broadcast, arithmetic, sqrt, min/max and
+ * horizontal reductions.
+ * The backend is chosen at compile time from the target flags:
+ * - AVX (enabled by -mavx, -mavx2 or -march=native): 4 doubles, 8 floats.
+ * - NEON (aarch64): 2 doubles, 4 floats.
+ * - Otherwise, scalar fallback with width 1.
+ *
+ * Use the CMake option SG_ENABLE_NATIVE_ARCH to compile with -march=native.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#if defined(__AVX__)
+#define SG_SIMD_AVX 1
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define SG_SIMD_NEON 1
+#include <arm_neon.h>
+#else
+#define SG_SIMD_SCALAR 1
+#endif
+
+namespace SG {
+namespace simd {
+
+inline const char *backend_name() {
+#if defined(SG_SIMD_AVX)
+    return "avx";
+#elif defined(SG_SIMD_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+/** Scalar fallback, also used for the types without specialization. */
+template <typename T> struct Batch {
+    using value_type = T;
+    static constexpr std::size_t width = 1;
+    T v;
+
+    static Batch load(const T *p) { return {*p}; }
+    static Batch broadcast(const T a) { return {a}; }
+    void store(T *p) const { *p = v; }
+
+    friend Batch operator+(const Batch a, const Batch b) { return {a.v + b.v}; }
+    friend Batch operator-(const Batch a, const Batch b) { return {a.v - b.v}; }
+    friend Batch operator*(const Batch a, const Batch b) { return {a.v * b.v}; }
+    friend Batch operator/(const Batch a, const Batch b) { return {a.v / b.v}; }
+    friend Batch sqrt(const Batch a) { return {std::sqrt(a.v)}; }
+    friend Batch min(const Batch a, const Batch b) {
+        return {std::min(a.v, b.v)};
+    }
+    friend Batch max(const Batch a, const Batch b) {
+        return {std::max(a.v, b.v)};
+    }
+    friend T reduce_add(const Batch a) { return a.v; }
+    friend T reduce_min(const Batch a) { return a.v; }
+    friend T reduce_max(const Batch a) { return a.v; }
+};
+
+#if defined(SG_SIMD_AVX)
+template <> struct Batch<double> {
+    using value_type = double;
+    static constexpr std::size_t width = 4;
+    __m256d v;
+
+    static Batch load(const double *p) { return {_mm256_loadu_pd(p)}; }
+    static Batch broadcast(const double a) { return {_mm256_set1_pd(a)}; }
+    void store(double *p) const { _mm256_storeu_pd(p, v); }
+
+    friend Batch operator+(const Batch a, const Batch b) {
+        return {_mm256_add_pd(a.v, b.v)};
+    }
+    friend Batch operator-(const Batch a, const Batch b) {
+        return {_mm256_sub_pd(a.v, b.v)};
+    }
+    friend Batch operator*(const Batch a, const Batch b) {
+        return {_mm256_mul_pd(a.v, b.v)};
+    }
+    friend Batch operator/(const Batch a, const Batch b) {
+        return {_mm256_div_pd(a.v, b.v)};
+    }
+    friend Batch sqrt(const Batch a) { return {_mm256_sqrt_pd(a.v)}; }
+    friend Batch min(const Batch a, const Batch b) {
+        return {_mm256_min_pd(a.v, b.v)};
+    }
+    friend Batch max(const Batch a, const Batch b) {
+        return {_mm256_max_pd(a.v, b.v)};
+    }
+    friend double reduce_add(const Batch a) {
+        double lanes[width];
+        a.store(lanes);
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+    friend double reduce_min(const Batch a) {
+        double lanes[width];
+        a.store(lanes);
+        return std::min(std::min(lanes[0], lanes[1]),
+                        std::min(lanes[2], lanes[3]));
+    }
+    friend double reduce_max(const Batch a) {
+        double lanes[width];
+        a.store(lanes);
+        return std::max(std::max(lanes[0], lanes[1]),
+                        std::max(lanes[2], lanes[3]));
+    }
+};
+
+template <> struct Batch<float> {
+    using value_type = float;
+    static constexpr std::size_t width = 8;
+    __m256 v;
+
+    static Batch load(const float *p) { return {_mm256_loadu_ps(p)}; }
+    static Batch broadcast(const float a) { return {_mm256_set1_ps(a)}; }
+    void store(float *p) const { _mm256_storeu_ps(p, v); }
+
+    friend Batch operator+(const Batch a, const Batch b) {
+        return {_mm256_add_ps(a.v, b.v)};
+    }
+    friend Batch operator-(const Batch a, const Batch b) {
+        return {_mm256_sub_ps(a.v, b.v)};
+    }
+    friend Batch operator*(const Batch a, const Batch b) {
+        return {_mm256_mul_ps(a.v, b.v)};
+    }
+    friend Batch operator/(const Batch a, const Batch b) {
+        return {_mm256_div_ps(a.v, b.v)};
+    }
+    friend Batch sqrt(const Batch a) { return {_mm256_sqrt_ps(a.v)}; }
+    friend Batch min(const Batch a, const Batch b) {
+        return {_mm256_min_ps(a.v, b.v)};
+    }
+    friend Batch max(const Batch a, const Batch b) {
+        return {_mm256_max_ps(a.v, b.v)};
+    }
+    friend float reduce_add(const Batch a) {
+        float lanes[width];
+        a.store(lanes);
+        float sum = 0.0f;
+        for (std::size_t i = 0; i < width; ++i) {
+            sum += lanes[i];
+        }
+        return sum;
+    }
+    friend float reduce_min(const Batch a) {
+        float lanes[width];
+        a.store(lanes);
+        return *std::min_element(lanes, lanes + width);
+    }
+    friend float reduce_max(const Batch a) {
+        float lanes[width];
+        a.store(lanes);
+        return *std::max_element(lanes, lanes + width);
+    }
+};
+#endif // SG_SIMD_AVX
+
+#if defined(SG_SIMD_NEON)
+template <> struct Batch<double> {
+    using value_type = double;
+    static constexpr std::size_t width = 2;
+    float64x2_t v;
+
+    static Batch load(const double *p) { return {vld1q_f64(p)}; }
+    static Batch broadcast(const double a) { return {vdupq_n_f64(a)}; }
+    void store(double *p) const { vst1q_f64(p, v); }
+
+    friend Batch operator+(const Batch a, const Batch b) {
+        return {vaddq_f64(a.v, b.v)};
+    }
+    friend Batch operator-(const Batch a, const Batch b) {
+        return {vsubq_f64(a.v, b.v)};
+    }
+    friend Batch operator*(const Batch a, const Batch b) {
+        return {vmulq_f64(a.v, b.v)};
+    }
+    friend Batch operator/(const Batch a, const Batch b) {
+        return {vdivq_f64(a.v, b.v)};
+    }
+    friend Batch sqrt(const Batch a) { return {vsqrtq_f64(a.v)}; }
+    friend Batch min(const Batch a, const Batch b) {
+        return {vminq_f64(a.v, b.v)};
+    }
+    friend Batch max(const Batch a, const Batch b) {
+        return {vmaxq_f64(a.v, b.v)};
+    }
+    friend double reduce_add(const Batch a) { return vaddvq_f64(a.v); }
+    friend double reduce_min(const Batch a) { return vminvq_f64(a.v); }
+    friend double reduce_max(const Batch a) { return vmaxvq_f64(a.v); }
+};
+
+template <> struct Batch<float> {
+    using value_type = float;
+    static constexpr std::size_t width = 4;
+    float32x4_t v;
+
+    static Batch load(const float *p) { return {vld1q_f32(p)}; }
+    static Batch broadcast(const float a) { return {vdupq_n_f32(a)}; }
+    void store(float *p) const { vst1q_f32(p, v); }
+
+    friend Batch operator+(const Batch a, const Batch b) {
+        return {vaddq_f32(a.v, b.v)};
+    }
+    friend Batch operator-(const Batch a, const Batch b) {
+        return {vsubq_f32(a.v, b.v)};
+    }
+    friend Batch operator*(const Batch a, const Batch b) {
+        return {vmulq_f32(a.v, b.v)};
+    }
+    friend Batch operator/(const Batch a, const Batch b) {
+        return {vdivq_f32(a.v, b.v)};
+    }
+    friend Batch sqrt(const Batch a) { return {vsqrtq_f32(a.v)}; }
+    friend Batch min(const Batch a, const Batch b) {
+        return {vminq_f32(a.v, b.v)};
+    }
+    friend Batch max(const Batch a, const Batch b) {
+        return {vmaxq_f32(a.v, b.v)};
+    }
+    friend float reduce_add(const Batch a) { return vaddvq_f32(a.v); }
+    friend float reduce_min(const Batch a) { return vminvq_f32(a.v); }
+    friend float reduce_max(const Batch a) { return vmaxvq_f32(a.v); }
+};
+#endif // SG_SIMD_NEON
+
+} // namespace simd
+} // namespace SG
+#endif
@@ -21,7 +21,9 @@
 #ifndef SPATIAL_GRAPH_IO_HPP
 #define SPATIAL_GRAPH_IO_HPP
 
+#include "frozen_spatial_graph.hpp"
 #include "hash_edge_descriptor.hpp"
+#include "mapped_spatial_graph.hpp"
 #include "spatial_graph.hpp"
 #include <boost/graph/graphviz.hpp>
 #include <iostream>
@@ -44,6 +46,32 @@ void read_graphviz_sg(std::istream &is, GraphType &graph);
 void read_graphviz_sg(const std::string &input_file, GraphType &graph);
 GraphType read_graphviz_sg(const std::string &input_file);
 
+/**
+ * Single pass reader/writer of the .dot files of @ref read_graphviz_sg and
+ * @ref write_graphviz_sg, without boost::read_graphviz and the string
+ * copies of the SpatialEdge stream operators.
+ *
+ * Supports the subset of the dot language used to store spatial graphs:
+ * undirected graphs without subgraphs, with unsigned integer node ids
+ * below the number of vertices (the vertex descriptors written by
+ * @ref write_graphviz_sg). Attributes other than spatial_node and
+ * spatial_edge are ignored.
+ * read_graphviz_sg keeps using boost::read_graphviz, that accepts the full
+ * dot grammar and arbitrary node ids.
+ * As in read_graphviz_sg, vertices are created in order of appearance.
+ * SpatialNode::id is set to the node id of the file (read_graphviz_sg
+ * leaves it to 0 when the spatial_node attribute is present).
+ *
+ * The writer stores the shortest decimal representation that round-trips
+ * (when std::to_chars is available), instead of 100 digits.
+ */
+void write_graphviz_sg_fast(std::ostream &os, const GraphType &graph);
+void write_graphviz_sg_fast(const std::string &output_file,
+                            const GraphType &graph);
+void read_graphviz_sg_fast(std::istream &is, GraphType &graph);
+void read_graphviz_sg_fast(const std::string &input_file, GraphType &graph);
+GraphType read_graphviz_sg_fast(const std::string &input_file);
+
 /* ************* Serialize *************/
 void write_serialized_sg(std::ostream &os, const GraphType &graph);
 void write_serialized_sg(const std::string &output_file,
@@ -52,6 +80,33 @@ void read_serialized_sg(std::istream &is, GraphType &graph);
 void read_serialized_sg(const std::string &input_file, GraphType &graph);
 GraphType read_serialized_sg(const std::string &input_file);
 
+/* ************* Binary *************/
+/**
+ * Write the graph in the binary spatial graph format, see
+ * @ref SpatialGraphBinaryHeader for the layout.
+ * Unlike the text archive of @ref write_serialized_sg, values are stored
+ * with full precision and the file can be memory mapped with
+ * @ref read_sg_mmap.
+ */
+void write_sg_binary(std::ostream &os, const GraphType &graph);
+void write_sg_binary(const std::string &output_file, const GraphType &graph);
+void write_sg_binary(std::ostream &os, const FrozenSpatialGraph &graph);
+void write_sg_binary(const std::string &output_file,
+                     const FrozenSpatialGraph &graph);
+/**
+ * Memory map a file written with @ref write_sg_binary.
+ * Only the header is read, the graph data is accessed lazily.
+ *
+ * @param input_file binary spatial graph
+ *
+ * @return read-only view of the file
+ */
+MappedSpatialGraph read_sg_mmap(const std::string &input_file);
+/**
+ * Read a file written with @ref write_sg_binary into a GraphType.
+ */
+GraphType read_sg_binary(const std::string &input_file);
+
 /* ************ vertex and edge label maps ************/
 
 /**
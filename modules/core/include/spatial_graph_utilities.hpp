@@ -132,7 +132,7 @@ void print_spatial_edges(const GraphType &graph, std::ostream &os = std::cout) {
 /**
  * Check the graph has unique points
  *
- * @param sg input spatial graph
+ * @param sg input spatial graph, GraphType or FrozenSpatialGraph
  *
  * @return repeated_points, true|false
  */
@@ -148,7 +148,7 @@ check_unique_points_in_graph(const GraphType &sg) {
     std::set<SG::PointType> repeated_points;
     size_t npoints = 0;
     vertex_iterator vi, vi_end;
-    std::tie(vi, vi_end) = boost::vertices(sg);
+    std::tie(vi, vi_end) = vertices(sg);
     for (; vi != vi_end; ++vi) {
         ++npoints;
         auto inserted = unique_points.insert(sg[*vi].pos);
@@ -157,10 +157,10 @@ check_unique_points_in_graph(const GraphType &sg) {
     }
 
     edge_iterator ei, ei_end;
-    std::tie(ei, ei_end) = boost::edges(sg);
+    std::tie(ei, ei_end) = edges(sg);
     for (; ei != ei_end; ++ei) {
-        auto &sg_edge = sg[*ei];
-        auto &sg_edge_points = sg_edge.edge_points;
+        const auto &sg_edge = sg[*ei];
+        const auto &sg_edge_points = sg_edge.edge_points;
         for (size_t index = 0; index < sg_edge_points.size(); ++index) {
             const auto &p = sg_edge_points[index];
             ++npoints;
@@ -0,0 +1,429 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef SPATIAL_GRID_INDEX_HPP
+#define SPATIAL_GRID_INDEX_HPP
+
+#include "graph_descriptor.hpp"
+#include "spatial_graph.hpp"
+
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace SG {
+
+/**
+ * Spatial hash of the points of a spatial graph (vertices and edge points)
+ * in a uniform grid of cubic cells of side cell_size.
+ * Only the non-empty cells are stored (in an unordered_map), so the memory
+ * is linear in the number of points, independently of the extent of the graph.
+ *
+ * Each point is stored with its graph_descriptor, locating it in the graph
+ * (vertex, or edge and edge_points_index) as the vtk based locators of the
+ * locate module (@sa build_octree_locator and get_vtk_points_from_graph),
+ * but without the VTK dependency and without copying the points to vtkPoints.
+ *
+ * Points can be inserted and removed incrementally.
+ * The index stores the descriptors, so it has to be updated (or rebuilt)
+ * if the graph is modified in a way that invalidates them
+ * (i.e remove_vertex in GraphType).
+ *
+ * Radius queries visit the cells intersecting the bounding box of the sphere.
+ * k-nearest queries visit shells of cells around the query until the k-th
+ * distance is smaller than the distance to the unvisited cells.
+ * A cell_size close to the usual query radius (or the distance between
+ * points for k-nearest queries) works best.
+ */
+class SpatialGridIndex {
+  public:
+    using CellIndex = std::array<std::int64_t, 3>;
+
+    struct IndexedPoint {
+        PointType pos;
+        graph_descriptor descriptor;
+    };
+
+    struct Neighbor {
+        PointType pos;
+        graph_descriptor descriptor;
+        /** euclidean distance to the query point */
+        double distance;
+    };
+
+    /**
+     * Empty index.
+     *
+     * @param cell_size side of the cells, must be positive.
+     */
+    explicit SpatialGridIndex(const double cell_size) : m_cell_size(cell_size) {
+        if (!(cell_size > 0.0)) {
+            throw std::runtime_error(
+                    "SpatialGridIndex: cell_size must be positive.");
+        }
+    }
+
+    /**
+     * Index all the vertices of graph, and its edge points if
+     * index_edge_points is true.
+     */
+    SpatialGridIndex(const GraphType &graph,
+                     const double cell_size,
+                     const bool index_edge_points = true)
+            : SpatialGridIndex(cell_size) {
+        insert_graph(graph, index_edge_points);
+    }
+
+    double cell_size() const { return m_cell_size; }
+    /** Number of indexed points. */
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    /** Number of non-empty cells. */
+    std::size_t num_cells() const { return m_cells.size(); }
+
+    void clear() {
+        m_cells.clear();
+        m_size = 0;
+        reset_cell_bounds();
+    }
+
+    CellIndex cell_index(const PointType &pos) const {
+        return {{static_cast<std::int64_t>(std::floor(pos[0] / m_cell_size)),
+                 static_cast<std::int64_t>(std::floor(pos[1] / m_cell_size)),
+                 static_cast<std::int64_t>(std::floor(pos[2] / m_cell_size))}};
+    }
+
+    void insert(const PointType &pos, const graph_descriptor &descriptor) {
+        const auto cell = cell_index(pos);
+        m_cells[cell].push_back(IndexedPoint{pos, descriptor});
+        ++m_size;
+        for (std::size_t d = 0; d < 3; ++d) {
+            m_min_cell[d] = std::min(m_min_cell[d], cell[d]);
+            m_max_cell[d] = std::max(m_max_cell[d], cell[d]);
+        }
+    }
+
+    /**
+     * Remove the point at pos with the same descriptor.
+     *
+     * @return false if the point was not found
+     */
+    bool remove(const PointType &pos, const graph_descriptor &descriptor) {
+        const auto cell_it = m_cells.find(cell_index(pos));
+        if (cell_it == m_cells.end()) {
+            return false;
+        }
+        auto &points = cell_it->second;
+        const auto it = std::find_if(
+                points.begin(), points.end(),
+                [&descriptor](const IndexedPoint &indexed_point) {
+                    return indexed_point.descriptor == descriptor;
+                });
+        if (it == points.end()) {
+            return false;
+        }
+        *it = points.back();
+        points.pop_back();
+        if (points.empty()) {
+            m_cells.erase(cell_it);
+        }
+        --m_size;
+        // The cell bounds are not shrunk, they are only used to stop
+        // nearest queries.
+        return true;
+    }
+
+    void insert_vertex(const GraphType::vertex_descriptor vertex,
+                       const GraphType &graph) {
+        insert(graph[vertex].pos, vertex_graph_descriptor(vertex));
+    }
+
+    bool remove_vertex(const GraphType::vertex_descriptor vertex,
+                       const GraphType &graph) {
+        return remove(graph[vertex].pos, vertex_graph_descriptor(vertex));
+    }
+
+    void insert_edge_points(const GraphType::edge_descriptor edge,
+                            const GraphType &graph) {
+        const auto &edge_points = graph[edge].edge_points;
+        for (std::size_t index = 0; index < edge_points.size(); ++index) {
+            insert(edge_points[index], edge_graph_descriptor(edge, index));
+        }
+    }
+
+    /** @return number of removed points */
+    std::size_t remove_edge_points(const GraphType::edge_descriptor edge,
+                                   const GraphType &graph) {
+        const auto &edge_points = graph[edge].edge_points;
+        std::size_t removed = 0;
+        for (std::size_t index = 0; index < edge_points.size(); ++index) {
+            removed += remove(edge_points[index],
+                              edge_graph_descriptor(edge, index));
+        }
+        return removed;
+    }
+
+    void insert_graph(const GraphType &graph,
+                      const bool index_edge_points = true) {
+        for (const auto vertex :
+             boost::make_iterator_range(boost::vertices(graph))) {
+            insert_vertex(vertex, graph);
+        }
+        if (!index_edge_points) {
+            return;
+        }
+        for (const auto edge :
+             boost::make_iterator_range(boost::edges(graph))) {
+            insert_edge_points(edge, graph);
+        }
+    }
+
+    /**
+     * All the points at distance <= radius from query.
+     *
+     * @param sort_by_distance sort the result from closest to furthest.
+     */
+    std::vector<Neighbor> radius_search(const PointType &query,
+                                        const double radius,
+                                        const bool sort_by_distance = true) const {
+        std::vector<Neighbor> neighbors;
+        if (empty() || radius < 0.0) {
+            return neighbors;
+        }
+        const double radius2 = radius * radius;
+        const auto add_if_inside = [&](const std::vector<IndexedPoint> &points) {
+            for (const auto &indexed_point : points) {
+                const double d2 = distance2(indexed_point.pos, query);
+                if (d2 <= radius2) {
+                    neighbors.push_back(Neighbor{indexed_point.pos,
+                                                 indexed_point.descriptor,
+                                                 std::sqrt(d2)});
+                }
+            }
+        };
+        // Upper bound of the cells intersecting the bounding box of the sphere.
+        const double cells_per_side = 2.0 * radius / m_cell_size + 2.0;
+        if (cells_per_side * cells_per_side * cells_per_side >
+            static_cast<double>(m_cells.size())) {
+            // Big radius: cheaper to check all the non-empty cells.
+            for (const auto &cell_points : m_cells) {
+                add_if_inside(cell_points.second);
+            }
+        } else {
+            const auto min_cell = cell_index(
+                    {{query[0] - radius, query[1] - radius, query[2] - radius}});
+            const auto max_cell = cell_index(
+                    {{query[0] + radius, query[1] + radius, query[2] + radius}});
+            CellIndex cell;
+            for (cell[2] = min_cell[2]; cell[2] <= max_cell[2]; ++cell[2]) {
+                for (cell[1] = min_cell[1]; cell[1] <= max_cell[1]; ++cell[1]) {
+                    for (cell[0] = min_cell[0]; cell[0] <= max_cell[0];
+                         ++cell[0]) {
+                        const auto cell_it = m_cells.find(cell);
+                        if (cell_it != m_cells.end()) {
+                            add_if_inside(cell_it->second);
+                        }
+                    }
+                }
+            }
+        }
+        if (sort_by_distance) {
+            sort_neighbors(neighbors.begin(), neighbors.end());
+        }
+        return neighbors;
+    }
+
+    /**
+     * The k closest points to query, sorted from closest to furthest.
+     * Returns less than k points if the index has less than k points.
+     */
+    std::vector<Neighbor> k_nearest(const PointType &query,
+                                    const std::size_t k) const {
+        std::vector<Neighbor> candidates;
+        if (empty() || k == 0) {
+            return candidates;
+        }
+        const auto add_all = [&](const std::vector<IndexedPoint> &points) {
+            for (const auto &indexed_point : points) {
+                candidates.push_back(Neighbor{
+                        indexed_point.pos, indexed_point.descriptor,
+                        std::sqrt(distance2(indexed_point.pos, query))});
+            }
+        };
+        const auto center = cell_index(query);
+        // Shell (Chebyshev distance in cells from center) covering all the
+        // non-empty cells.
+        std::int64_t max_shell = 0;
+        for (std::size_t d = 0; d < 3; ++d) {
+            max_shell = std::max(max_shell, center[d] - m_min_cell[d]);
+            max_shell = std::max(max_shell, m_max_cell[d] - center[d]);
+        }
+        for (std::int64_t shell = 0; shell <= max_shell; ++shell) {
+            const double side = static_cast<double>(2 * shell + 1);
+            if (side * side * side > static_cast<double>(m_cells.size())) {
+                // Sparse index: cheaper to check all the non-empty cells.
+                candidates.clear();
+                for (const auto &cell_points : m_cells) {
+                    add_all(cell_points.second);
+                }
+                break;
+            }
+            for_each_cell_in_shell(center, shell, [&](const CellIndex &cell) {
+                const auto cell_it = m_cells.find(cell);
+                if (cell_it != m_cells.end()) {
+                    add_all(cell_it->second);
+                }
+            });
+            // The points in the next shells are further than shell*cell_size.
+            if (candidates.size() >= k) {
+                keep_k_nearest(candidates, k);
+                if (candidates.back().distance <=
+                    static_cast<double>(shell) * m_cell_size) {
+                    return candidates;
+                }
+            }
+        }
+        keep_k_nearest(candidates, k);
+        return candidates;
+    }
+
+    /**
+     * Closest point to query.
+     *
+     * @return Neighbor with descriptor.exist == false if the index is empty.
+     */
+    Neighbor closest(const PointType &query) const {
+        const auto nearest = k_nearest(query, 1);
+        if (nearest.empty()) {
+            return Neighbor{query, graph_descriptor(),
+                            std::numeric_limits<double>::max()};
+        }
+        return nearest.front();
+    }
+
+    static graph_descriptor
+    vertex_graph_descriptor(const GraphType::vertex_descriptor vertex) {
+        graph_descriptor gdesc;
+        gdesc.exist = true;
+        gdesc.is_vertex = true;
+        gdesc.vertex_d = vertex;
+        return gdesc;
+    }
+
+    static graph_descriptor
+    edge_graph_descriptor(const GraphType::edge_descriptor edge,
+                          const std::size_t edge_points_index) {
+        graph_descriptor gdesc;
+        gdesc.exist = true;
+        gdesc.is_edge = true;
+        gdesc.edge_d = edge;
+        gdesc.edge_points_index = edge_points_index;
+        return gdesc;
+    }
+
+  private:
+    struct CellIndexHash {
+        std::size_t operator()(const CellIndex &cell) const {
+            std::size_t hash = 0;
+            boost::hash_combine(hash, cell[0]);
+            boost::hash_combine(hash, cell[1]);
+            boost::hash_combine(hash, cell[2]);
+            return hash;
+        }
+    };
+
+    static double distance2(const PointType &a, const PointType &b) {
+        const double dx = a[0] - b[0];
+        const double dy = a[1] - b[1];
+        const double dz = a[2] - b[2];
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    template <typename TIterator>
+    static void sort_neighbors(TIterator begin, TIterator end) {
+        std::sort(begin, end, [](const Neighbor &lhs, const Neighbor &rhs) {
+            return lhs.distance < rhs.distance;
+        });
+    }
+
+    static void keep_k_nearest(std::vector<Neighbor> &candidates,
+                               const std::size_t k) {
+        if (candidates.size() > k) {
+            std::nth_element(candidates.begin(), candidates.begin() + k,
+                             candidates.end(),
+                             [](const Neighbor &lhs, const Neighbor &rhs) {
+                                 return lhs.distance < rhs.distance;
+                             });
+            candidates.resize(k);
+        }
+        sort_neighbors(candidates.begin(), candidates.end());
+    }
+
+    /** Apply function to the cells at Chebyshev distance shell of center. */
+    template <typename TFunction>
+    static void for_each_cell_in_shell(const CellIndex &center,
+                                       const std::int64_t shell,
+                                       TFunction &&function) {
+        if (shell == 0) {
+            function(center);
+            return;
+        }
+        CellIndex cell;
+        for (std::int64_t dz = -shell; dz <= shell; ++dz) {
+            cell[2] = center[2] + dz;
+            for (std::int64_t dy = -shell; dy <= shell; ++dy) {
+                cell[1] = center[1] + dy;
+                const bool in_face = (dz == -shell || dz == shell ||
+                                      dy == -shell || dy == shell);
+                const std::int64_t dx_step = in_face ? 1 : 2 * shell;
+                for (std::int64_t dx = -shell; dx <= shell; dx += dx_step) {
+                    cell[0] = center[0] + dx;
+                    function(cell);
+                }
+            }
+        }
+    }
+
+    void reset_cell_bounds() {
+        m_min_cell.fill(std::numeric_limits<std::int64_t>::max());
+        m_max_cell.fill(std::numeric_limits<std::int64_t>::lowest());
+    }
+
+    double m_cell_size;
+    std::size_t m_size = 0;
+    std::unordered_map<CellIndex, std::vector<IndexedPoint>, CellIndexHash>
+            m_cells;
+    CellIndex m_min_cell = {{std::numeric_limits<std::int64_t>::max(),
+                             std::numeric_limits<std::int64_t>::max(),
+                             std::numeric_limits<std::int64_t>::max()}};
+    CellIndex m_max_cell = {{std::numeric_limits<std::int64_t>::lowest(),
+                             std::numeric_limits<std::int64_t>::lowest(),
+                             std::numeric_limits<std::int64_t>::lowest()}};
+};
+
+} // namespace SG
+#endif
@@ -0,0 +1,166 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef VERTEX_VECTOR_MAP_HPP
+#define VERTEX_VECTOR_MAP_HPP
+
+#include <boost/graph/properties.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SG {
+
+template <typename T> class VertexVectorPropertyMap;
+
+/**
+ * Map from vertex_descriptor to T stored in a std::vector, for graphs with
+ * vecS vertices (as GraphType), where the vertex descriptors are dense
+ * indices [0, num_vertices).
+ *
+ * It replaces std::map<vertex_descriptor, T> with
+ * boost::associative_property_map in DFS/BFS visits, where every access was
+ * a tree lookup (and an allocation on the first access).
+ *
+ * Each value is stamped with an epoch. reset() increments the epoch, and all
+ * the values read afterwards are default_value until they are written again.
+ * So the same map can be reused for many visits without clearing it.
+ *
+ * Use property_map() to pass it to boost algorithms, which take property maps
+ * by value.
+ *
+ * VertexColorMap colorMap(boost::num_vertices(g));
+ * boost::depth_first_visit(g, start, vis, colorMap.property_map());
+ * colorMap.reset(); // All vertices are white again
+ */
+template <typename T> class VertexVectorMap {
+  public:
+    using key_type = std::size_t;
+    using value_type = T;
+    using mapped_type = T;
+    using property_map_type = VertexVectorPropertyMap<T>;
+
+    explicit VertexVectorMap(const std::size_t num_vertices = 0,
+                             const T &default_value = T())
+            : m_values(num_vertices, default_value),
+              m_epochs(num_vertices, 0), m_default_value(default_value) {}
+
+    std::size_t size() const { return m_values.size(); }
+
+    /** Resize the map. The new vertices have default_value. */
+    void resize(const std::size_t num_vertices) {
+        m_values.resize(num_vertices, m_default_value);
+        m_epochs.resize(num_vertices, 0);
+    }
+
+    /** All vertices have default_value after reset. O(1) amortized. */
+    void reset() {
+        ++m_epoch;
+        if (m_epoch == 0) { // Overflow, clear the stamps.
+            std::fill(m_epochs.begin(), m_epochs.end(), 0);
+            m_epoch = 1;
+        }
+    }
+
+    /** Change default_value and reset. */
+    void reset(const T &default_value) {
+        m_default_value = default_value;
+        reset();
+    }
+
+    /** True if the value of vertex was written after the last reset. */
+    bool is_set(const key_type vertex) const {
+        return m_epochs[vertex] == m_epoch;
+    }
+
+    const T &get(const key_type vertex) const {
+        return is_set(vertex) ? m_values[vertex] : m_default_value;
+    }
+
+    void put(const key_type vertex, const T &value) {
+        m_values[vertex] = value;
+        m_epochs[vertex] = m_epoch;
+    }
+
+    /** Reference to the value of vertex, marking it as set. */
+    T &operator[](const key_type vertex) {
+        if (!is_set(vertex)) {
+            m_values[vertex] = m_default_value;
+            m_epochs[vertex] = m_epoch;
+        }
+        return m_values[vertex];
+    }
+
+    property_map_type property_map() { return property_map_type(*this); }
+
+  private:
+    std::vector<T> m_values;
+    std::vector<std::uint32_t> m_epochs;
+    std::uint32_t m_epoch = 1;
+    T m_default_value;
+};
+
+/**
+ * Lightweight handle to a VertexVectorMap, modeling the boost
+ * ReadWritePropertyMap and LvaluePropertyMap concepts.
+ * The VertexVectorMap has to outlive it.
+ */
+template <typename T> class VertexVectorPropertyMap {
+  public:
+    using key_type = std::size_t;
+    using value_type = T;
+    using reference = T &;
+    using category = boost::lvalue_property_map_tag;
+
+    VertexVectorPropertyMap() = default;
+    explicit VertexVectorPropertyMap(VertexVectorMap<T> &vertex_map)
+            : m_vertex_map(&vertex_map) {}
+
+    reference operator[](const key_type vertex) const {
+        return (*m_vertex_map)[vertex];
+    }
+
+    friend const T &get(const VertexVectorPropertyMap &pmap,
+                        const key_type vertex) {
+        return pmap.m_vertex_map->get(vertex);
+    }
+
+    friend void put(const VertexVectorPropertyMap &pmap,
+                    const key_type vertex,
+                    const T &value) {
+        pmap.m_vertex_map->put(vertex, value);
+    }
+
+  private:
+    VertexVectorMap<T> *m_vertex_map = nullptr;
+};
+
+/** Color map for DFS/BFS visits, all vertices are white after reset. */
+using VertexColorMap = VertexVectorMap<boost::default_color_type>;
+/** Visited flags (0 or 1), unsigned char to avoid std::vector<bool>. */
+using VertexVisitedMap = VertexVectorMap<unsigned char>;
+/** Distances, set the default_value (i.e infinity) in the constructor. */
+using VertexDistanceMap = VertexVectorMap<double>;
+
+} // namespace SG
+#endif
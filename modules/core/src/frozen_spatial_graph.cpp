@@ -0,0 +1,155 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "frozen_spatial_graph.hpp"
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+namespace SG {
+
+FrozenSpatialGraph frozen_spatial_graph_from_graph(const GraphType &graph) {
+    FrozenSpatialGraph frozen;
+    const auto nverts = boost::num_vertices(graph);
+    const auto nedges = boost::num_edges(graph);
+
+    // Vertices
+    frozen.positions.reserve(nverts);
+    frozen.ids.reserve(nverts);
+    GraphType::vertex_iterator vi, vi_end;
+    std::tie(vi, vi_end) = boost::vertices(graph);
+    for (; vi != vi_end; ++vi) {
+        frozen.positions.push_back(graph[*vi].pos);
+        frozen.ids.push_back(graph[*vi].id);
+    }
+
+    // Edges. The edge bundle has a stable address in the listS edge list,
+    // use it to identify the edge from the out_edges of both ends.
+    std::unordered_map<const SpatialEdge *, size_t> edge_bundle_to_index;
+    edge_bundle_to_index.reserve(nedges);
+    frozen.edge_sources.reserve(nedges);
+    frozen.edge_targets.reserve(nedges);
+    frozen.edge_points_offsets.reserve(nedges + 1);
+    size_t total_edge_points = 0;
+    GraphType::edge_iterator ei, ei_end;
+    std::tie(ei, ei_end) = boost::edges(graph);
+    for (; ei != ei_end; ++ei) {
+        total_edge_points += graph[*ei].edge_points.size();
+    }
+    frozen.edge_points_pool.reserve(total_edge_points);
+    size_t edge_index = 0;
+    std::tie(ei, ei_end) = boost::edges(graph);
+    for (; ei != ei_end; ++ei, ++edge_index) {
+        const auto &eps = graph[*ei].edge_points;
+        edge_bundle_to_index.emplace(&graph[*ei], edge_index);
+        frozen.edge_sources.push_back(boost::source(*ei, graph));
+        frozen.edge_targets.push_back(boost::target(*ei, graph));
+        frozen.edge_points_pool.insert(std::end(frozen.edge_points_pool),
+                                       std::begin(eps), std::end(eps));
+        frozen.edge_points_offsets.push_back(frozen.edge_points_pool.size());
+    }
+
+    // CSR adjacency, keeping the order of out_edges.
+    frozen.out_offsets.reserve(nverts + 1);
+    frozen.out_targets.reserve(2 * nedges);
+    frozen.out_edge_indices.reserve(2 * nedges);
+    std::tie(vi, vi_end) = boost::vertices(graph);
+    for (; vi != vi_end; ++vi) {
+        GraphType::out_edge_iterator oi, oi_end;
+        std::tie(oi, oi_end) = boost::out_edges(*vi, graph);
+        for (; oi != oi_end; ++oi) {
+            frozen.out_targets.push_back(boost::target(*oi, graph));
+            frozen.out_edge_indices.push_back(
+                    edge_bundle_to_index.at(&graph[*oi]));
+        }
+        frozen.out_offsets.push_back(frozen.out_targets.size());
+    }
+    return frozen;
+}
+
+void build_frozen_spatial_graph_adjacency(FrozenSpatialGraph &frozen) {
+    const auto nverts = frozen.num_vertices();
+    const auto nedges = frozen.num_edges();
+    if (frozen.edge_targets.size() != nedges) {
+        throw std::runtime_error(
+                "build_frozen_spatial_graph_adjacency: edge_sources and "
+                "edge_targets have different sizes.");
+    }
+    if (frozen.ids.empty()) {
+        frozen.ids.resize(nverts);
+        for (size_t v = 0; v < nverts; ++v) {
+            frozen.ids[v] = v;
+        }
+    } else if (frozen.ids.size() != nverts) {
+        throw std::runtime_error(
+                "build_frozen_spatial_graph_adjacency: ids and positions "
+                "have different sizes.");
+    }
+    // Counting sort of the out-edge slots by vertex.
+    frozen.out_offsets.assign(nverts + 1, 0);
+    for (size_t edge_index = 0; edge_index < nedges; ++edge_index) {
+        const auto s = frozen.edge_sources[edge_index];
+        const auto t = frozen.edge_targets[edge_index];
+        if (s >= nverts || t >= nverts) {
+            throw std::runtime_error(
+                    "build_frozen_spatial_graph_adjacency: edge " +
+                    std::to_string(edge_index) +
+                    " has an end vertex out of range.");
+        }
+        ++frozen.out_offsets[s + 1];
+        ++frozen.out_offsets[t + 1];
+    }
+    for (size_t v = 0; v < nverts; ++v) {
+        frozen.out_offsets[v + 1] += frozen.out_offsets[v];
+    }
+    frozen.out_targets.resize(2 * nedges);
+    frozen.out_edge_indices.resize(2 * nedges);
+    std::vector<size_t> slot(std::begin(frozen.out_offsets),
+                             std::end(frozen.out_offsets) - 1);
+    for (size_t edge_index = 0; edge_index < nedges; ++edge_index) {
+        const auto s = frozen.edge_sources[edge_index];
+        const auto t = frozen.edge_targets[edge_index];
+        frozen.out_targets[slot[s]] = t;
+        frozen.out_edge_indices[slot[s]++] = edge_index;
+        frozen.out_targets[slot[t]] = s;
+        frozen.out_edge_indices[slot[t]++] = edge_index;
+    }
+}
+
+GraphType graph_from_frozen_spatial_graph(const FrozenSpatialGraph &frozen) {
+    const auto nverts = frozen.num_vertices();
+    const auto nedges = frozen.num_edges();
+    GraphType graph(nverts);
+    for (size_t v = 0; v < nverts; ++v) {
+        graph[v].id = frozen.ids[v];
+        graph[v].pos = frozen.positions[v];
+    }
+    for (size_t edge_index = 0; edge_index < nedges; ++edge_index) {
+        const auto eps = frozen.edge_points(edge_index);
+        SpatialEdge se;
+        se.edge_points.assign(std::begin(eps), std::end(eps));
+        boost::add_edge(frozen.edge_sources[edge_index],
+                        frozen.edge_targets[edge_index], std::move(se), graph);
+    }
+    return graph;
+}
+
+} // namespace SG
@@ -0,0 +1,306 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "mapped_spatial_graph.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SG {
+
+static_assert(sizeof(PointType) == 3 * sizeof(double),
+              "PointType must be three contiguous doubles to be mapped.");
+
+bool is_spatial_graph_binary_supported() {
+    // The file is little-endian and it is mapped without byte swapping.
+    const std::uint32_t one = 1;
+    unsigned char first_byte;
+    std::memcpy(&first_byte, &one, 1);
+    return first_byte == 1;
+}
+
+SpatialGraphBinaryHeader
+make_spatial_graph_binary_header(const std::size_t num_vertices,
+                                 const std::size_t num_edges,
+                                 const std::size_t num_edge_points) {
+    SpatialGraphBinaryHeader header;
+    std::memcpy(header.magic, spatial_graph_binary_magic,
+                sizeof(header.magic));
+    header.version = spatial_graph_binary_version;
+    header.header_size = sizeof(SpatialGraphBinaryHeader);
+    header.num_vertices = num_vertices;
+    header.num_edges = num_edges;
+    header.num_edge_points = num_edge_points;
+    // All the elements are 8 bytes, the blocks stay 8-byte aligned.
+    header.vertex_ids_offset = sizeof(SpatialGraphBinaryHeader);
+    header.positions_offset =
+            header.vertex_ids_offset + num_vertices * sizeof(std::uint64_t);
+    header.edge_endpoints_offset =
+            header.positions_offset + num_vertices * sizeof(PointType);
+    header.edge_points_offsets_offset =
+            header.edge_endpoints_offset +
+            2 * num_edges * sizeof(std::uint64_t);
+    header.edge_points_offset = header.edge_points_offsets_offset +
+                                (num_edges + 1) * sizeof(std::uint64_t);
+    header.file_size =
+            header.edge_points_offset + num_edge_points * sizeof(PointType);
+    return header;
+}
+
+MappedSpatialGraph::MappedSpatialGraph(const std::string &input_file) {
+    if (!is_spatial_graph_binary_supported()) {
+        throw std::runtime_error("MappedSpatialGraph: the binary spatial "
+                                 "graph format requires a little-endian "
+                                 "platform.");
+    }
+#ifdef _WIN32
+    HANDLE file = CreateFileA(input_file.c_str(), GENERIC_READ,
+                              FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to read input_file: " + input_file +
+                                 ".");
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        throw std::runtime_error("Failed to get the size of input_file: " +
+                                 input_file + ".");
+    }
+    m_size = static_cast<std::size_t>(file_size.QuadPart);
+    if (m_size >= sizeof(SpatialGraphBinaryHeader)) {
+        HANDLE mapping =
+                CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr) {
+            m_data = static_cast<const char *>(
+                    MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            // The view keeps a reference to the mapping.
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    const int fd = ::open(input_file.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw std::runtime_error("Failed to read input_file: " + input_file +
+                                 ".");
+    }
+    struct stat file_stat;
+    if (::fstat(fd, &file_stat) == -1) {
+        ::close(fd);
+        throw std::runtime_error("Failed to get the size of input_file: " +
+                                 input_file + ".");
+    }
+    m_size = static_cast<std::size_t>(file_stat.st_size);
+    if (m_size >= sizeof(SpatialGraphBinaryHeader)) {
+        void *addr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            m_data = static_cast<const char *>(addr);
+        }
+    }
+    // The mapping keeps a reference to the file.
+    ::close(fd);
+#endif
+    if (m_size < sizeof(SpatialGraphBinaryHeader)) {
+        throw std::runtime_error("MappedSpatialGraph: input_file: " +
+                                 input_file +
+                                 " is too small to be a binary spatial graph.");
+    }
+    if (m_data == nullptr) {
+        throw std::runtime_error(
+                "MappedSpatialGraph: failed to memory map input_file: " +
+                input_file + ".");
+    }
+
+    m_header = reinterpret_cast<const SpatialGraphBinaryHeader *>(m_data);
+    if (std::memcmp(m_header->magic, spatial_graph_binary_magic,
+                    sizeof(spatial_graph_binary_magic)) != 0) {
+        unmap();
+        throw std::runtime_error("MappedSpatialGraph: input_file: " +
+                                 input_file +
+                                 " is not a binary spatial graph.");
+    }
+    if (m_header->version != spatial_graph_binary_version ||
+        m_header->header_size != sizeof(SpatialGraphBinaryHeader)) {
+        const auto version = m_header->version;
+        unmap();
+        throw std::runtime_error(
+                "MappedSpatialGraph: unsupported version " +
+                std::to_string(version) + " of input_file: " + input_file +
+                ". Supported version: " +
+                std::to_string(spatial_graph_binary_version) + ".");
+    }
+    // Bound the counts by the file size before computing the block offsets
+    // from them, so a corrupted header cannot make the offsets overflow.
+    if (m_header->num_vertices >
+                m_size / (sizeof(std::uint64_t) + sizeof(PointType)) ||
+        m_header->num_edges > m_size / (3 * sizeof(std::uint64_t)) ||
+        m_header->num_edge_points > m_size / sizeof(PointType)) {
+        unmap();
+        throw std::runtime_error("MappedSpatialGraph: input_file: " +
+                                 input_file +
+                                 " is truncated or has a corrupted header.");
+    }
+    const auto expected = make_spatial_graph_binary_header(
+            m_header->num_vertices, m_header->num_edges,
+            m_header->num_edge_points);
+    if (m_header->vertex_ids_offset != expected.vertex_ids_offset ||
+        m_header->positions_offset != expected.positions_offset ||
+        m_header->edge_endpoints_offset != expected.edge_endpoints_offset ||
+        m_header->edge_points_offsets_offset !=
+                expected.edge_points_offsets_offset ||
+        m_header->edge_points_offset != expected.edge_points_offset ||
+        m_header->file_size != expected.file_size ||
+        m_header->file_size != m_size) {
+        unmap();
+        throw std::runtime_error("MappedSpatialGraph: input_file: " +
+                                 input_file +
+                                 " is truncated or has a corrupted header.");
+    }
+
+    m_vertex_ids = reinterpret_cast<const std::uint64_t *>(
+            m_data + m_header->vertex_ids_offset);
+    m_positions = reinterpret_cast<const PointType *>(
+            m_data + m_header->positions_offset);
+    m_edge_endpoints = reinterpret_cast<const std::uint64_t *>(
+            m_data + m_header->edge_endpoints_offset);
+    m_edge_points_offsets = reinterpret_cast<const std::uint64_t *>(
+            m_data + m_header->edge_points_offsets_offset);
+    m_edge_points = reinterpret_cast<const PointType *>(
+            m_data + m_header->edge_points_offset);
+}
+
+MappedSpatialGraph::~MappedSpatialGraph() { unmap(); }
+
+MappedSpatialGraph::MappedSpatialGraph(MappedSpatialGraph &&other) noexcept
+        : m_data(other.m_data), m_size(other.m_size),
+          m_header(other.m_header), m_vertex_ids(other.m_vertex_ids),
+          m_positions(other.m_positions),
+          m_edge_endpoints(other.m_edge_endpoints),
+          m_edge_points_offsets(other.m_edge_points_offsets),
+          m_edge_points(other.m_edge_points) {
+    other.m_data = nullptr;
+    other.m_size = 0;
+}
+
+MappedSpatialGraph &
+MappedSpatialGraph::operator=(MappedSpatialGraph &&other) noexcept {
+    if (this != &other) {
+        unmap();
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_header = other.m_header;
+        m_vertex_ids = other.m_vertex_ids;
+        m_positions = other.m_positions;
+        m_edge_endpoints = other.m_edge_endpoints;
+        m_edge_points_offsets = other.m_edge_points_offsets;
+        m_edge_points = other.m_edge_points;
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+void MappedSpatialGraph::unmap() noexcept {
+    if (m_data == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+#else
+    ::munmap(const_cast<char *>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
+void MappedSpatialGraph::check_edges() const {
+    const auto nverts = num_vertices();
+    const auto nedges = num_edges();
+    if (m_edge_points_offsets[0] != 0 ||
+        m_edge_points_offsets[nedges] != num_edge_points()) {
+        throw std::runtime_error(
+                "MappedSpatialGraph: corrupted edge points offsets.");
+    }
+    for (std::size_t edge_index = 0; edge_index < nedges; ++edge_index) {
+        if (edge_source(edge_index) >= nverts ||
+            edge_target(edge_index) >= nverts ||
+            m_edge_points_offsets[edge_index] >
+                    m_edge_points_offsets[edge_index + 1]) {
+            throw std::runtime_error("MappedSpatialGraph: corrupted edge " +
+                                     std::to_string(edge_index) + ".");
+        }
+    }
+}
+
+GraphType MappedSpatialGraph::to_graph() const {
+    check_edges();
+    const auto nverts = num_vertices();
+    const auto nedges = num_edges();
+    GraphType graph(nverts);
+    for (std::size_t v = 0; v < nverts; ++v) {
+        graph[v].id = vertex_id(v);
+        graph[v].pos = position(v);
+    }
+    for (std::size_t edge_index = 0; edge_index < nedges; ++edge_index) {
+        const auto eps = edge_points(edge_index);
+        SpatialEdge se;
+        se.edge_points.assign(std::begin(eps), std::end(eps));
+        boost::add_edge(edge_source(edge_index), edge_target(edge_index),
+                        std::move(se), graph);
+    }
+    return graph;
+}
+
+FrozenSpatialGraph MappedSpatialGraph::to_frozen_spatial_graph() const {
+    check_edges();
+    const auto nverts = num_vertices();
+    const auto nedges = num_edges();
+    FrozenSpatialGraph frozen;
+    frozen.positions.assign(m_positions, m_positions + nverts);
+    frozen.ids.assign(m_vertex_ids, m_vertex_ids + nverts);
+    frozen.edge_sources.resize(nedges);
+    frozen.edge_targets.resize(nedges);
+    for (std::size_t edge_index = 0; edge_index < nedges; ++edge_index) {
+        frozen.edge_sources[edge_index] = edge_source(edge_index);
+        frozen.edge_targets[edge_index] = edge_target(edge_index);
+    }
+    frozen.edge_points_offsets.assign(m_edge_points_offsets,
+                                      m_edge_points_offsets + nedges + 1);
+    frozen.edge_points_pool.assign(m_edge_points,
+                                   m_edge_points + num_edge_points());
+    build_frozen_spatial_graph_adjacency(frozen);
+    return frozen;
+}
+
+} // namespace SG
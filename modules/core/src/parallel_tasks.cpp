@@ -0,0 +1,116 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "parallel_tasks.hpp"
+
+namespace SG {
+
+size_t resolve_num_threads(const size_t num_threads) {
+    if (num_threads == 0) {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+    return num_threads;
+}
+
+ThreadPool::ThreadPool(const size_t num_threads)
+        : exceptions_(resolve_num_threads(num_threads)) {
+    const size_t num_workers = exceptions_.size() - 1;
+    workers_.reserve(num_workers);
+    for (size_t t = 1; t <= num_workers; ++t) {
+        workers_.emplace_back(&ThreadPool::worker_loop, this, t);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_condition_.notify_all();
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::run_batch(const size_t num_tasks, const Task &task) {
+    std::lock_guard<std::mutex> run_lock(run_mutex_);
+    if (workers_.empty() || num_tasks <= 1) {
+        for (size_t i = 0; i < num_tasks; ++i) {
+            task(i, 0);
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        num_tasks_ = num_tasks;
+        next_task_ = 0;
+        workers_done_ = 0;
+        std::fill(exceptions_.begin(), exceptions_.end(), nullptr);
+        ++batch_;
+    }
+    start_condition_.notify_all();
+    work(0);
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_condition_.wait(
+                lock, [this] { return workers_done_ == workers_.size(); });
+        task_ = nullptr;
+    }
+    for (const auto &exception : exceptions_) {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+}
+
+void ThreadPool::work(const size_t thread_index) {
+    try {
+        for (size_t i = next_task_++; i < num_tasks_; i = next_task_++) {
+            (*task_)(i, thread_index);
+        }
+    } catch (...) {
+        exceptions_[thread_index] = std::current_exception();
+        next_task_ = num_tasks_;
+    }
+}
+
+void ThreadPool::worker_loop(const size_t thread_index) {
+    size_t batch = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_condition_.wait(
+                    lock, [this, batch] { return stop_ || batch_ != batch; });
+            if (stop_) {
+                return;
+            }
+            batch = batch_;
+        }
+        work(thread_index);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++workers_done_;
+        }
+        done_condition_.notify_one();
+    }
+}
+
+} // namespace SG
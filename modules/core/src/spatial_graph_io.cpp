@@ -25,6 +25,10 @@
 
 #include "spatial_graph_io.hpp"
 
+#include <cstdint>
+#include <fstream>
+#include <tuple>
+
 namespace SG {
 
 boost::dynamic_properties get_write_dynamic_properties_sg(GraphType &graph) {
@@ -99,6 +103,146 @@ GraphType read_serialized_sg(const std::string &input_file) {
     return graph;
 }
 
+// Binary
+namespace {
+template <typename T>
+void write_binary_block(std::ostream &os, const T *data, const size_t size) {
+    os.write(reinterpret_cast<const char *>(data),
+             static_cast<std::streamsize>(size * sizeof(T)));
+}
+
+void write_binary_header(std::ostream &os,
+                         const SpatialGraphBinaryHeader &header) {
+    if (!is_spatial_graph_binary_supported()) {
+        throw std::runtime_error("write_sg_binary: the binary spatial graph "
+                                 "format requires a little-endian platform.");
+    }
+    write_binary_block(os, &header, 1);
+    if (!os) {
+        throw std::runtime_error(
+                "write_sg_binary: failed to write the header.");
+    }
+}
+
+void check_binary_data_written(const std::ostream &os) {
+    if (!os) {
+        throw std::runtime_error(
+                "write_sg_binary: failed to write the graph data.");
+    }
+}
+
+// Flushing the buffered tail happens on close, so a full disk only shows up
+// there: close explicitly instead of relying on the destructor.
+void close_binary_output(std::ofstream &os, const std::string &output_file) {
+    os.close();
+    if (os.fail()) {
+        throw std::runtime_error("write_sg_binary: failed to close " +
+                                 output_file + ".");
+    }
+}
+} // namespace
+
+void write_sg_binary(std::ostream &os, const GraphType &graph) {
+    const auto nverts = boost::num_vertices(graph);
+    const auto nedges = boost::num_edges(graph);
+    size_t nedge_points = 0;
+    GraphType::edge_iterator ei, ei_end;
+    std::tie(ei, ei_end) = boost::edges(graph);
+    for (; ei != ei_end; ++ei) {
+        nedge_points += graph[*ei].edge_points.size();
+    }
+    write_binary_header(
+            os, make_spatial_graph_binary_header(nverts, nedges, nedge_points));
+
+    std::vector<std::uint64_t> vertex_ids;
+    vertex_ids.reserve(nverts);
+    PointContainer positions;
+    positions.reserve(nverts);
+    GraphType::vertex_iterator vi, vi_end;
+    std::tie(vi, vi_end) = boost::vertices(graph);
+    for (; vi != vi_end; ++vi) {
+        vertex_ids.push_back(graph[*vi].id);
+        positions.push_back(graph[*vi].pos);
+    }
+    write_binary_block(os, vertex_ids.data(), vertex_ids.size());
+    write_binary_block(os, positions.data(), positions.size());
+
+    std::vector<std::uint64_t> edge_endpoints;
+    edge_endpoints.reserve(2 * nedges);
+    std::vector<std::uint64_t> edge_points_offsets;
+    edge_points_offsets.reserve(nedges + 1);
+    edge_points_offsets.push_back(0);
+    std::tie(ei, ei_end) = boost::edges(graph);
+    for (; ei != ei_end; ++ei) {
+        edge_endpoints.push_back(boost::source(*ei, graph));
+        edge_endpoints.push_back(boost::target(*ei, graph));
+        edge_points_offsets.push_back(edge_points_offsets.back() +
+                                      graph[*ei].edge_points.size());
+    }
+    write_binary_block(os, edge_endpoints.data(), edge_endpoints.size());
+    write_binary_block(os, edge_points_offsets.data(),
+                       edge_points_offsets.size());
+    std::tie(ei, ei_end) = boost::edges(graph);
+    for (; ei != ei_end; ++ei) {
+        const auto &eps = graph[*ei].edge_points;
+        write_binary_block(os, eps.data(), eps.size());
+    }
+    check_binary_data_written(os);
+}
+
+void write_sg_binary(const std::string &output_file, const GraphType &graph) {
+    std::ofstream os(output_file, std::ios::binary);
+    if (!os.is_open()) {
+        throw std::runtime_error("Failed to open output_file: " + output_file +
+                                 ".");
+    }
+    write_sg_binary(os, graph);
+    close_binary_output(os, output_file);
+}
+
+void write_sg_binary(std::ostream &os, const FrozenSpatialGraph &graph) {
+    const auto nverts = graph.num_vertices();
+    const auto nedges = graph.num_edges();
+    write_binary_header(os, make_spatial_graph_binary_header(
+                                    nverts, nedges,
+                                    graph.edge_points_pool.size()));
+    std::vector<std::uint64_t> buffer(std::begin(graph.ids),
+                                      std::end(graph.ids));
+    write_binary_block(os, buffer.data(), buffer.size());
+    write_binary_block(os, graph.positions.data(), graph.positions.size());
+    buffer.resize(2 * nedges);
+    for (size_t edge_index = 0; edge_index < nedges; ++edge_index) {
+        buffer[2 * edge_index] = graph.edge_sources[edge_index];
+        buffer[2 * edge_index + 1] = graph.edge_targets[edge_index];
+    }
+    write_binary_block(os, buffer.data(), buffer.size());
+    buffer.assign(std::begin(graph.edge_points_offsets),
+                  std::end(graph.edge_points_offsets));
+    write_binary_block(os, buffer.data(), buffer.size());
+    write_binary_block(os, graph.edge_points_pool.data(),
+                       graph.edge_points_pool.size());
+    check_binary_data_written(os);
+}
+
+void write_sg_binary(const std::string &output_file,
+                     const FrozenSpatialGraph &graph) {
+    std::ofstream os(output_file, std::ios::binary);
+    if (!os.is_open()) {
+        throw std::runtime_error("Failed to open output_file: " + output_file +
+                                 ".");
+    }
+    write_sg_binary(os, graph);
+    close_binary_output(os, output_file);
+}
+
+MappedSpatialGraph read_sg_mmap(const std::string &input_file) {
+    return MappedSpatialGraph(input_file);
+}
+
+GraphType read_sg_binary(const std::string &input_file) {
+    return read_sg_mmap(input_file).to_graph();
+}
+
 vertex_to_label_map_t
 read_vertex_to_label_map(const std::string &vertex_to_label_map_file) {
     std::vector<size_t> vertex_ids;
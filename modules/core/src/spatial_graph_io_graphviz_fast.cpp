@@ -0,0 +1,569 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "spatial_graph_io.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+// std::from_chars/std::to_chars for doubles (C++17, libstdc++ >= 11).
+// Fallback to strtod/snprintf otherwise.
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define SG_GRAPHVIZ_FAST_USE_CHARCONV
+#endif
+
+namespace SG {
+
+namespace {
+
+/**
+ * Single pass parser over the full contents of a .dot file.
+ * The buffer must be null terminated (std::string guarantees it).
+ */
+class GraphvizSGParser {
+  public:
+    GraphvizSGParser(const char *first, const char *last, GraphType &graph)
+            : m_begin(first), m_p(first), m_end(last), m_graph(graph) {}
+
+    void parse() {
+        skip_ws();
+        if (match_keyword("strict")) {
+            skip_ws();
+        }
+        if (match_keyword("digraph")) {
+            error("directed graphs are not supported");
+        }
+        if (!match_keyword("graph")) {
+            error("expected 'graph'");
+        }
+        skip_ws();
+        if (m_p < m_end && *m_p != '{') {
+            skip_id(); // graph name
+            skip_ws();
+        }
+        expect('{');
+        while (true) {
+            skip_ws();
+            if (m_p >= m_end) {
+                error("unexpected end of file, expected '}'");
+            }
+            if (*m_p == '}') {
+                ++m_p;
+                break;
+            }
+            if (*m_p == ';' || *m_p == ',') {
+                ++m_p;
+                continue;
+            }
+            parse_statement();
+        }
+        // Node IDs are the vertex descriptors of write_graphviz_sg.
+        if (!m_id_to_vertex.empty() && m_max_id >= m_id_to_vertex.size()) {
+            error("node ID " + std::to_string(m_max_id) +
+                  " is not below the number of vertices " +
+                  std::to_string(m_id_to_vertex.size()));
+        }
+    }
+
+  private:
+    [[noreturn]] void error(const std::string &msg) const {
+        const auto line = 1 + std::count(m_begin, m_p, '\n');
+        throw std::runtime_error("read_graphviz_sg_fast: " + msg +
+                                 " (line " + std::to_string(line) + ").");
+    }
+
+    void skip_ws() {
+        while (m_p < m_end) {
+            const char c = *m_p;
+            if (c == ' ' || c == '\n' || c == '\t' || c == '\r') {
+                ++m_p;
+            } else if (c == '#' || (c == '/' && m_p + 1 < m_end &&
+                                    m_p[1] == '/')) {
+                while (m_p < m_end && *m_p != '\n') {
+                    ++m_p;
+                }
+            } else if (c == '/' && m_p + 1 < m_end && m_p[1] == '*') {
+                const char *close = m_p + 2;
+                while (close + 1 < m_end &&
+                       !(close[0] == '*' && close[1] == '/')) {
+                    ++close;
+                }
+                if (close + 1 >= m_end) {
+                    error("unterminated comment");
+                }
+                m_p = close + 2;
+            } else {
+                break;
+            }
+        }
+    }
+
+    void expect(const char c) {
+        skip_ws();
+        if (m_p >= m_end || *m_p != c) {
+            error(std::string("expected '") + c + "'");
+        }
+        ++m_p;
+    }
+
+    static bool is_id_char(const char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+               (c >= '0' && c <= '9') || c == '_' || c == '.' ||
+               (static_cast<unsigned char>(c) >= 128);
+    }
+
+    bool match_keyword(const char *keyword) {
+        const auto n = std::strlen(keyword);
+        if (static_cast<size_t>(m_end - m_p) < n) {
+            return false;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            const char c = m_p[i];
+            const char lower = (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+            if (lower != keyword[i]) {
+                return false;
+            }
+        }
+        if (m_p + n < m_end && is_id_char(m_p[n])) {
+            return false;
+        }
+        m_p += n;
+        return true;
+    }
+
+    /** Range [first, last) of the current ID, without quotes. */
+    void read_id(const char *&first, const char *&last) {
+        skip_ws();
+        if (m_p >= m_end) {
+            error("unexpected end of file, expected an ID");
+        }
+        if (*m_p == '"') {
+            ++m_p;
+            first = m_p;
+            while (m_p < m_end && *m_p != '"') {
+                // Escaped characters are kept raw.
+                m_p += (*m_p == '\\' && m_p + 1 < m_end) ? 2 : 1;
+            }
+            if (m_p >= m_end) {
+                error("unterminated quoted string");
+            }
+            last = m_p;
+            ++m_p;
+            return;
+        }
+        if (*m_p == '<') {
+            error("HTML strings are not supported");
+        }
+        first = m_p;
+        // Negative numerals, '-' is not an ID char to split a--b.
+        if (*m_p == '-' && m_p + 1 < m_end && m_p[1] != '-') {
+            ++m_p;
+        }
+        while (m_p < m_end && is_id_char(*m_p)) {
+            ++m_p;
+        }
+        last = m_p;
+        if (first == last) {
+            error(std::string("unexpected character '") + *m_p + "'");
+        }
+    }
+
+    void skip_id() {
+        const char *first;
+        const char *last;
+        read_id(first, last);
+    }
+
+    size_t parse_node_id(const char *first, const char *last) {
+        if (first == last) {
+            error("empty node ID");
+        }
+        const auto not_unsigned = [this, first, last]() {
+            error("node IDs must be unsigned integers, got '" +
+                  std::string(first, last) + "'");
+        };
+        const auto out_of_range = [this, first, last]() {
+            error("node ID '" + std::string(first, last) + "' is too large");
+        };
+        size_t id = 0;
+#ifdef SG_GRAPHVIZ_FAST_USE_CHARCONV
+        const auto result = std::from_chars(first, last, id);
+        if (result.ec == std::errc::result_out_of_range) {
+            out_of_range();
+        }
+        if (result.ec != std::errc() || result.ptr != last) {
+            not_unsigned();
+        }
+#else
+        constexpr auto max_id = std::numeric_limits<size_t>::max();
+        for (const char *it = first; it != last; ++it) {
+            if (*it < '0' || *it > '9') {
+                not_unsigned();
+            }
+            const auto digit = static_cast<size_t>(*it - '0');
+            if (id > (max_id - digit) / 10) {
+                out_of_range();
+            }
+            id = id * 10 + digit;
+        }
+#endif
+        m_max_id = std::max(m_max_id, id);
+        return id;
+    }
+
+    GraphType::vertex_descriptor get_or_add_vertex(const size_t id) {
+        const auto found = m_id_to_vertex.find(id);
+        if (found != m_id_to_vertex.end()) {
+            return found->second;
+        }
+        const auto v = boost::add_vertex(m_graph);
+        m_graph[v].id = id;
+        m_id_to_vertex.emplace(id, v);
+        return v;
+    }
+
+    static const char *parse_double(const char *first, const char *last,
+                                    double &value) {
+        while (first < last && (*first == ' ' || *first == '\t' ||
+                                *first == '\n' || *first == '\r')) {
+            ++first;
+        }
+#ifdef SG_GRAPHVIZ_FAST_USE_CHARCONV
+        // from_chars does not accept a leading '+'
+        if (first < last && *first == '+') {
+            ++first;
+        }
+        const auto result = std::from_chars(first, last, value);
+        if (result.ec != std::errc()) {
+            return nullptr;
+        }
+        return result.ptr;
+#else
+        (void)last;
+        char *parsed_end = nullptr;
+        value = std::strtod(first, &parsed_end);
+        if (parsed_end == first) {
+            return nullptr;
+        }
+        return parsed_end;
+#endif
+    }
+
+    void parse_point(const char *&it, const char *last, PointType &point) {
+        for (size_t i = 0; i < 3; ++i) {
+            it = parse_double(it, last, point[i]);
+            if (it == nullptr || it > last) {
+                error("invalid number in point");
+            }
+        }
+    }
+
+    /** spatial_node="x y z" */
+    void parse_spatial_node(const char *first, const char *last,
+                            SpatialNode &node) {
+        parse_point(first, last, node.pos);
+    }
+
+    /** spatial_edge="[{x y z},{x y z}]" */
+    void parse_spatial_edge(const char *first, const char *last,
+                            SpatialEdge &edge) {
+        auto &edge_points = edge.edge_points;
+        edge_points.reserve(
+                static_cast<size_t>(std::count(first, last, '{')));
+        const char *it = first;
+        while (true) {
+            it = std::find(it, last, '{');
+            if (it == last) {
+                break;
+            }
+            ++it;
+            PointType point;
+            parse_point(it, last, point);
+            while (it < last && *it != '}') {
+                if (*it != ' ' && *it != '\t') {
+                    error("expected '}' after edge point");
+                }
+                ++it;
+            }
+            edge_points.push_back(point);
+        }
+    }
+
+    /**
+     * Parse the attribute lists [a=b, c=d][e=f] after a statement.
+     * Only spatial_node and spatial_edge are kept, the others are ignored.
+     */
+    void parse_attributes(SpatialNode *node, SpatialEdge *edge) {
+        while (true) {
+            skip_ws();
+            if (m_p >= m_end || *m_p != '[') {
+                return;
+            }
+            ++m_p;
+            while (true) {
+                skip_ws();
+                if (m_p >= m_end) {
+                    error("unexpected end of file, expected ']'");
+                }
+                if (*m_p == ']') {
+                    ++m_p;
+                    break;
+                }
+                if (*m_p == ',' || *m_p == ';') {
+                    ++m_p;
+                    continue;
+                }
+                const char *key_first;
+                const char *key_last;
+                read_id(key_first, key_last);
+                expect('=');
+                const char *value_first;
+                const char *value_last;
+                read_id(value_first, value_last);
+                const auto key_size = static_cast<size_t>(key_last - key_first);
+                if (node && key_size == 12 &&
+                    std::memcmp(key_first, "spatial_node", 12) == 0) {
+                    parse_spatial_node(value_first, value_last, *node);
+                } else if (edge && key_size == 12 &&
+                           std::memcmp(key_first, "spatial_edge", 12) == 0) {
+                    parse_spatial_edge(value_first, value_last, *edge);
+                }
+            }
+        }
+    }
+
+    void parse_statement() {
+        if (*m_p == '{' || match_keyword("subgraph")) {
+            error("subgraphs are not supported");
+        }
+        // Default attribute statements: graph/node/edge [..]
+        if (match_keyword("graph") || match_keyword("node") ||
+            match_keyword("edge")) {
+            parse_attributes(nullptr, nullptr);
+            return;
+        }
+        const char *first;
+        const char *last;
+        read_id(first, last);
+        skip_ws();
+        // Graph attribute: ID = ID
+        if (m_p < m_end && *m_p == '=') {
+            ++m_p;
+            skip_id();
+            return;
+        }
+        const auto id = parse_node_id(first, last);
+        if (m_p + 1 < m_end && m_p[0] == '-' && m_p[1] == '>') {
+            error("directed edges are not supported");
+        }
+        if (m_p + 1 < m_end && m_p[0] == '-' && m_p[1] == '-') {
+            // Edge statement, possibly a chain a -- b -- c
+            std::vector<GraphType::vertex_descriptor> chain = {
+                    get_or_add_vertex(id)};
+            while (m_p + 1 < m_end && m_p[0] == '-' && m_p[1] == '-') {
+                m_p += 2;
+                read_id(first, last);
+                chain.push_back(get_or_add_vertex(parse_node_id(first, last)));
+                skip_ws();
+            }
+            SpatialEdge se;
+            parse_attributes(nullptr, &se);
+            for (size_t i = 0; i + 1 < chain.size(); ++i) {
+                if (i + 2 == chain.size()) {
+                    boost::add_edge(chain[i], chain[i + 1], std::move(se),
+                                    m_graph);
+                } else {
+                    boost::add_edge(chain[i], chain[i + 1], se, m_graph);
+                }
+            }
+            return;
+        }
+        // Node statement
+        const auto v = get_or_add_vertex(id);
+        parse_attributes(&m_graph[v], nullptr);
+    }
+
+    const char *m_begin;
+    const char *m_p;
+    const char *m_end;
+    GraphType &m_graph;
+    std::unordered_map<size_t, GraphType::vertex_descriptor> m_id_to_vertex;
+    size_t m_max_id = 0;
+};
+
+void read_graphviz_sg_fast_from_buffer(const std::string &buffer,
+                                       GraphType &graph) {
+    GraphvizSGParser parser(buffer.data(), buffer.data() + buffer.size(),
+                            graph);
+    parser.parse();
+}
+
+void append_size(std::string &out, size_t value) {
+    char buf[24];
+    char *last = buf + sizeof(buf);
+    char *first = last;
+    do {
+        *--first = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    out.append(first, last);
+}
+
+void append_double(std::string &out, const double value) {
+    char buf[32];
+#ifdef SG_GRAPHVIZ_FAST_USE_CHARCONV
+    // Shortest representation that round-trips.
+    const auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, result.ptr);
+#else
+    // Fast path for integer coordinates (voxels), snprintf is slow.
+    constexpr double max_exact_integer = 9007199254740992.0; // 2^53
+    if (std::abs(value) < max_exact_integer && value == std::trunc(value) &&
+        !std::signbit(value)) {
+        append_size(out, static_cast<size_t>(value));
+        return;
+    }
+    const auto n = std::snprintf(buf, sizeof(buf), "%.17g", value);
+    out.append(buf, static_cast<size_t>(n));
+#endif
+}
+
+void append_point(std::string &out, const PointType &point) {
+    append_double(out, point[0]);
+    out += ' ';
+    append_double(out, point[1]);
+    out += ' ';
+    append_double(out, point[2]);
+}
+
+} // namespace
+
+void write_graphviz_sg_fast(std::ostream &os, const GraphType &graph) {
+    // Flush the buffer to the stream when it reaches this size.
+    constexpr size_t flush_size = 1 << 16;
+    std::string buffer;
+    buffer.reserve(2 * flush_size);
+    auto flush_if_full = [&os, &buffer]() {
+        if (buffer.size() >= flush_size) {
+            os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    };
+    buffer += "graph G {\n";
+    GraphType::vertex_iterator vi, vi_end;
+    std::tie(vi, vi_end) = boost::vertices(graph);
+    for (; vi != vi_end; ++vi) {
+        append_size(buffer, *vi);
+        buffer += " [spatial_node=\"";
+        append_point(buffer, graph[*vi].pos);
+        buffer += "\"];\n";
+        flush_if_full();
+    }
+    GraphType::edge_iterator ei, ei_end;
+    std::tie(ei, ei_end) = boost::edges(graph);
+    for (; ei != ei_end; ++ei) {
+        append_size(buffer, boost::source(*ei, graph));
+        buffer += "--";
+        append_size(buffer, boost::target(*ei, graph));
+        buffer += "  [spatial_edge=\"[";
+        const auto &edge_points = graph[*ei].edge_points;
+        for (size_t i = 0; i < edge_points.size(); ++i) {
+            if (i != 0) {
+                buffer += ',';
+            }
+            buffer += '{';
+            append_point(buffer, edge_points[i]);
+            buffer += '}';
+            flush_if_full();
+        }
+        buffer += "]\"];\n";
+        flush_if_full();
+    }
+    buffer += "}\n";
+    os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+void write_graphviz_sg_fast(const std::string &output_file,
+                            const GraphType &graph) {
+    std::ofstream ofile(output_file, std::ios::binary);
+    if (!ofile.is_open()) {
+        throw std::runtime_error("Failed to open output_file: " + output_file +
+                                 ".");
+    }
+    write_graphviz_sg_fast(ofile, graph);
+}
+
+void read_graphviz_sg_fast(std::istream &is, GraphType &graph) {
+    std::string buffer;
+    constexpr size_t chunk_size = 1 << 16;
+    std::vector<char> chunk(chunk_size);
+    while (is.read(chunk.data(), chunk_size) || is.gcount() > 0) {
+        buffer.append(chunk.data(), static_cast<size_t>(is.gcount()));
+    }
+    if (is.bad()) {
+        throw std::runtime_error(
+                "read_graphviz_sg_fast: failed to read the input stream.");
+    }
+    read_graphviz_sg_fast_from_buffer(buffer, graph);
+}
+
+void read_graphviz_sg_fast(const std::string &input_file, GraphType &graph) {
+    std::ifstream ifile(input_file, std::ios::binary);
+    if (!ifile.is_open()) {
+        throw std::runtime_error("Failed to read input_file: " + input_file +
+                                 ".");
+    }
+    ifile.seekg(0, std::ios::end);
+    const auto file_size = ifile.tellg();
+    ifile.seekg(0, std::ios::beg);
+    if (file_size < 0) {
+        throw std::runtime_error("Failed to get the size of input_file: " +
+                                 input_file + ".");
+    }
+    std::string buffer(static_cast<size_t>(file_size), '\0');
+    if (!ifile.read(&buffer[0], file_size) || ifile.gcount() != file_size) {
+        throw std::runtime_error("Failed to read input_file: " + input_file +
+                                 ".");
+    }
+    read_graphviz_sg_fast_from_buffer(buffer, graph);
+}
+
+GraphType read_graphviz_sg_fast(const std::string &input_file) {
+    GraphType graph;
+    read_graphviz_sg_fast(input_file, graph);
+    return graph;
+}
+
+} // namespace SG
@@ -0,0 +1,185 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "edge_points_soa.hpp"
+#include "edge_points_utilities.hpp"
+#include "frozen_spatial_graph.hpp"
+#include "gmock/gmock.h"
+
+#include <random>
+
+struct EdgePointsSoAFixture : public ::testing::Test {
+    void SetUp() override {
+        std::mt19937 gen(5);
+        std::uniform_real_distribution<double> dis(-5.0, 5.0);
+        const auto random_point = [&]() {
+            return SG::PointType{{dis(gen), dis(gen), dis(gen)}};
+        };
+        // Edges with 0 to 20 edge points, some in reverse order.
+        const size_t num_vertices = 21;
+        g = SG::GraphType(num_vertices);
+        for (size_t i = 0; i < num_vertices; ++i) {
+            g[i].pos = random_point();
+        }
+        for (size_t i = 1; i < num_vertices; ++i) {
+            SG::SpatialEdge se;
+            se.edge_points.push_back(
+                    ArrayUtilities::plus(g[i - 1].pos, {{0.1, 0.1, 0.1}}));
+            for (size_t p = 1; p + 1 < i; ++p) {
+                se.edge_points.push_back(random_point());
+            }
+            se.edge_points.push_back(
+                    ArrayUtilities::plus(g[i].pos, {{0.1, 0.1, 0.1}}));
+            if (i % 2) {
+                std::reverse(se.edge_points.begin(), se.edge_points.end());
+            }
+            boost::add_edge(i - 1, i, se, g);
+        }
+        SG::SpatialEdge se;
+        se.edge_points = {};
+        boost::add_edge(0, num_vertices - 1, se, g);
+    }
+    SG::GraphType g;
+};
+
+TEST_F(EdgePointsSoAFixture, polyline_length_equal_to_edge_points_length) {
+    for (const auto e : boost::make_iterator_range(boost::edges(g))) {
+        const auto &eps = g[e].edge_points;
+        const auto expected = SG::edge_points_length(g[e]);
+        SG::EdgePointsSoA<double> soa(eps);
+        EXPECT_EQ(soa.num_polylines(), 1);
+        EXPECT_EQ(soa.polyline(0), eps);
+        EXPECT_NEAR(SG::polyline_length(soa), expected, 1e-10);
+        SG::EdgePointsSoA<float> soa_float(eps);
+        EXPECT_NEAR(SG::polyline_length(soa_float), expected, 1e-3);
+        if (eps.empty()) {
+            continue;
+        }
+        const auto arc = SG::cumulative_arc_length(soa);
+        ASSERT_EQ(arc.size(), eps.size());
+        EXPECT_EQ(arc.front(), 0.0);
+        EXPECT_NEAR(arc.back(), expected, 1e-10);
+        for (size_t i = 1; i < eps.size(); ++i) {
+            EXPECT_NEAR(arc[i] - arc[i - 1],
+                        ArrayUtilities::distance(eps[i], eps[i - 1]), 1e-10);
+        }
+    }
+}
+
+TEST_F(EdgePointsSoAFixture, contour_lengths_equal_to_contour_length) {
+    std::vector<double> expected;
+    for (const auto e : boost::make_iterator_range(boost::edges(g))) {
+        expected.push_back(SG::contour_length(e, g));
+    }
+    const auto lengths = SG::contour_lengths(g);
+    ASSERT_EQ(lengths.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(lengths[i], expected[i], 1e-10);
+    }
+    const auto fg = SG::frozen_spatial_graph_from_graph(g);
+    const auto frozen_lengths = SG::contour_lengths(fg);
+    ASSERT_EQ(frozen_lengths.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(frozen_lengths[i], expected[i], 1e-10);
+    }
+    // Polylines start at source and end at target
+    std::vector<SG::GraphType::edge_descriptor> edges;
+    for (const auto e : boost::make_iterator_range(boost::edges(g))) {
+        edges.push_back(e);
+    }
+    const auto soa = SG::contour_polylines<float>(g, edges);
+    EXPECT_EQ(soa.num_polylines(), edges.size());
+    for (size_t i = 0; i < edges.size(); ++i) {
+        const auto size = soa.polyline_size(i);
+        EXPECT_EQ(size, g[edges[i]].edge_points.size() + 2);
+        EXPECT_NEAR(soa.point(i, 0)[0], g[boost::source(edges[i], g)].pos[0],
+                    1e-5);
+        EXPECT_NEAR(soa.point(i, size - 1)[0],
+                    g[boost::target(edges[i], g)].pos[0], 1e-5);
+        EXPECT_NEAR(SG::polyline_lengths(soa)[i], expected[i], 1e-3);
+    }
+}
+
+TEST_F(EdgePointsSoAFixture, bounding_box) {
+    SG::EdgePointsSoA<double> soa;
+    for (const auto e : boost::make_iterator_range(boost::edges(g))) {
+        soa.add_polyline(g[e].edge_points);
+    }
+    const auto box = SG::polyline_bounding_box(soa);
+    SG::PointType expected_ini = {{std::numeric_limits<double>::max(),
+                                   std::numeric_limits<double>::max(),
+                                   std::numeric_limits<double>::max()}};
+    SG::PointType expected_end = {{std::numeric_limits<double>::lowest(),
+                                   std::numeric_limits<double>::lowest(),
+                                   std::numeric_limits<double>::lowest()}};
+    for (const auto e : boost::make_iterator_range(boost::edges(g))) {
+        for (const auto &p : g[e].edge_points) {
+            for (size_t d = 0; d < 3; ++d) {
+                expected_ini[d] = std::min(expected_ini[d], p[d]);
+                expected_end[d] = std::max(expected_end[d], p[d]);
+            }
+        }
+    }
+    EXPECT_EQ(box.ini, expected_ini);
+    EXPECT_EQ(box.end, expected_end);
+    // Single polyline with 3 points
+    const auto box_small = SG::polyline_bounding_box(soa, 1);
+    const auto &eps = g[*std::next(boost::edges(g).first)].edge_points;
+    ASSERT_EQ(eps.size(), 2);
+    EXPECT_EQ(box_small.ini[0], std::min(eps[0][0], eps[1][0]));
+    EXPECT_EQ(box_small.end[2], std::max(eps[0][2], eps[1][2]));
+    EXPECT_THROW(SG::polyline_bounding_box(SG::EdgePointsSoA<double>()),
+                 std::runtime_error);
+}
+
+TEST(EdgePointsSoA, closest_point_on_polyline) {
+    // Zig-zag in the plane z = 0, with 11 points.
+    SG::PointContainer points;
+    for (size_t i = 0; i <= 10; ++i) {
+        points.push_back({{static_cast<double>(i), (i % 2) ? 1.0 : 0.0, 0.0}});
+    }
+    SG::EdgePointsSoA<double> soa(points);
+    // At the point 7, end of segment 6 and start of segment 7 (first wins).
+    auto closest = SG::closest_point_on_polyline(soa, 0, {{7.0, 1.0, 0.0}});
+    EXPECT_EQ(closest.segment_index, 6);
+    EXPECT_NEAR(closest.segment_parameter, 1.0, 1e-12);
+    EXPECT_NEAR(closest.distance, 0.0, 1e-12);
+    closest = SG::closest_point_on_polyline(soa, 0, {{8.5, 0.5, 2.0}});
+    EXPECT_EQ(closest.segment_index, 8);
+    EXPECT_NEAR(closest.segment_parameter, 0.5, 1e-12);
+    EXPECT_NEAR(closest.point[0], 8.5, 1e-12);
+    EXPECT_NEAR(closest.point[1], 0.5, 1e-12);
+    EXPECT_NEAR(closest.point[2], 0.0, 1e-12);
+    EXPECT_NEAR(closest.distance, 2.0, 1e-12);
+    // Beyond the last point
+    closest = SG::closest_point_on_polyline(soa, 0, {{12.0, 0.0, 0.0}});
+    EXPECT_EQ(closest.segment_index, 9);
+    EXPECT_NEAR(closest.segment_parameter, 1.0, 1e-12);
+    EXPECT_NEAR(closest.distance, 2.0, 1e-12);
+    // float
+    SG::EdgePointsSoA<float> soa_float(points);
+    closest = SG::closest_point_on_polyline(soa_float, 0, {{8.5, 0.5, 2.0}});
+    EXPECT_EQ(closest.segment_index, 8);
+    EXPECT_NEAR(closest.distance, 2.0, 1e-6);
+    // Single point
+    SG::EdgePointsSoA<double> soa_single(SG::PointContainer{{{1.0, 2.0, 3.0}}});
+    closest = SG::closest_point_on_polyline(soa_single, 0, {{1.0, 2.0, 5.0}});
+    EXPECT_EQ(closest.distance, 2.0);
+}
@@ -0,0 +1,167 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "edge_points_utilities.hpp"
+#include "frozen_spatial_graph.hpp"
+#include "spatial_graph.hpp"
+#include "gmock/gmock.h"
+
+#include <boost/graph/breadth_first_search.hpp>
+#include <boost/graph/connected_components.hpp>
+
+struct FrozenSpatialGraphFixture : public ::testing::Test {
+    using GraphType = SG::GraphAL;
+    GraphType g;
+    void SetUp() override {
+        // Two components: 0-1, 1-2, 1-3 and 4-5
+        this->g = GraphType(6);
+        SG::PointType n0{{0, 0, 0}};
+        SG::PointType n1{{1, 1, 0}};
+        SG::PointType n2{{2, 2, 0}};
+        SG::PointType n3{{1, 3, 0}};
+        SG::PointType n4{{5, 5, 5}};
+        SG::PointType n5{{5, 5, 8}};
+        this->g[0].pos = n0;
+        this->g[1].pos = n1;
+        this->g[2].pos = n2;
+        this->g[3].pos = n3;
+        this->g[4].pos = n4;
+        this->g[5].pos = n5;
+
+        SG::SpatialEdge se01;
+        se01.edge_points.insert(std::end(se01.edge_points), {{0.5, 0.5, 0}});
+        boost::add_edge(0, 1, se01, this->g);
+        SG::SpatialEdge se12;
+        boost::add_edge(1, 2, se12, this->g);
+        SG::SpatialEdge se13;
+        se13.edge_points.insert(std::end(se13.edge_points),
+                                {{1, 1.5, 0}, {1, 2, 0}, {1, 2.5, 0}});
+        boost::add_edge(1, 3, se13, this->g);
+        SG::SpatialEdge se45;
+        se45.edge_points.insert(std::end(se45.edge_points),
+                                {{5, 5, 6}, {5, 5, 7}});
+        boost::add_edge(4, 5, se45, this->g);
+    }
+};
+
+TEST_F(FrozenSpatialGraphFixture, construct) {
+    const auto fg = SG::frozen_spatial_graph_from_graph(g);
+    EXPECT_EQ(fg.num_vertices(), boost::num_vertices(g));
+    EXPECT_EQ(fg.num_edges(), boost::num_edges(g));
+    EXPECT_EQ(fg.edge_points_pool.size(), 6);
+    EXPECT_EQ(fg.out_offsets.size(), fg.num_vertices() + 1);
+    EXPECT_EQ(fg.out_targets.size(), 2 * fg.num_edges());
+    for (const auto v : boost::make_iterator_range(vertices(fg))) {
+        EXPECT_EQ(out_degree(v, fg), boost::out_degree(v, g));
+        EXPECT_EQ(fg[v].pos, g[v].pos);
+    }
+}
+
+TEST_F(FrozenSpatialGraphFixture, edges_and_edge_points) {
+    const auto fg = SG::frozen_spatial_graph_from_graph(g);
+    for (const auto e : boost::make_iterator_range(edges(fg))) {
+        const auto s = source(e, fg);
+        const auto t = target(e, fg);
+        const auto edge_g = boost::edge(s, t, g);
+        ASSERT_TRUE(edge_g.second);
+        const auto &points_g = g[edge_g.first].edge_points;
+        const auto points_fg = fg[e].edge_points;
+        ASSERT_EQ(points_fg.size(), points_g.size());
+        EXPECT_TRUE(
+                std::equal(points_fg.begin(), points_fg.end(), points_g.begin()));
+        EXPECT_DOUBLE_EQ(SG::contour_length(e, fg),
+                         SG::contour_length(edge_g.first, g));
+        EXPECT_DOUBLE_EQ(SG::ete_distance(e, fg),
+                         SG::ete_distance(edge_g.first, g));
+    }
+    const auto edge_fg = edge(1, 3, fg);
+    EXPECT_TRUE(edge_fg.second);
+    EXPECT_EQ(fg[edge_fg.first].edge_points.size(), 3);
+    EXPECT_FALSE(edge(0, 3, fg).second);
+}
+
+TEST_F(FrozenSpatialGraphFixture, out_edges_and_adjacent_vertices) {
+    const auto fg = SG::frozen_spatial_graph_from_graph(g);
+    std::vector<size_t> neighbors;
+    for (const auto e : boost::make_iterator_range(out_edges(1, fg))) {
+        EXPECT_EQ(source(e, fg), 1);
+        neighbors.push_back(target(e, fg));
+    }
+    EXPECT_THAT(neighbors, ::testing::UnorderedElementsAre(0, 2, 3));
+    const auto adj = adjacent_vertices(1, fg);
+    const std::vector<size_t> adjacent(adj.first, adj.second);
+    EXPECT_THAT(adjacent, ::testing::UnorderedElementsAre(0, 2, 3));
+}
+
+TEST_F(FrozenSpatialGraphFixture, bgl_algorithms) {
+    const auto fg = SG::frozen_spatial_graph_from_graph(g);
+    std::vector<size_t> component(fg.num_vertices());
+    const auto num_components = boost::connected_components(
+            fg, boost::make_iterator_property_map(
+                        component.begin(), get(boost::vertex_index, fg)));
+    EXPECT_EQ(num_components, 2);
+    EXPECT_EQ(component[0], component[3]);
+    EXPECT_EQ(component[4], component[5]);
+    EXPECT_NE(component[0], component[4]);
+
+    std::vector<size_t> distances(fg.num_vertices(), 0);
+    boost::breadth_first_search(
+            fg, 0,
+            boost::visitor(boost::make_bfs_visitor(boost::record_distances(
+                    boost::make_iterator_property_map(
+                            distances.begin(),
+                            get(boost::vertex_index, fg)),
+                    boost::on_tree_edge()))));
+    EXPECT_EQ(distances[1], 1);
+    EXPECT_EQ(distances[2], 2);
+    EXPECT_EQ(distances[3], 2);
+}
+
+TEST_F(FrozenSpatialGraphFixture, round_trip) {
+    // Ids different from the vertex descriptors.
+    for (const auto v : boost::make_iterator_range(boost::vertices(g))) {
+        g[v].id = 100 + v;
+    }
+    const auto fg = SG::frozen_spatial_graph_from_graph(g);
+    const auto g2 = SG::graph_from_frozen_spatial_graph(fg);
+    EXPECT_EQ(boost::num_vertices(g2), boost::num_vertices(g));
+    EXPECT_EQ(boost::num_edges(g2), boost::num_edges(g));
+    for (const auto e : boost::make_iterator_range(boost::edges(g))) {
+        const auto s = boost::source(e, g);
+        const auto t = boost::target(e, g);
+        const auto edge_g2 = boost::edge(s, t, g2);
+        ASSERT_TRUE(edge_g2.second);
+        EXPECT_EQ(g2[edge_g2.first].edge_points, g[e].edge_points);
+    }
+    for (const auto v : boost::make_iterator_range(boost::vertices(g))) {
+        EXPECT_EQ(g2[v].pos, g[v].pos);
+        EXPECT_EQ(fg[v].id, g[v].id);
+        EXPECT_EQ(g2[v].id, g[v].id);
+    }
+}
+
+TEST(FrozenSpatialGraph, empty) {
+    SG::GraphAL g;
+    const auto fg = SG::frozen_spatial_graph_from_graph(g);
+    EXPECT_EQ(fg.num_vertices(), 0);
+    EXPECT_EQ(fg.num_edges(), 0);
+    const auto g2 = SG::graph_from_frozen_spatial_graph(fg);
+    EXPECT_EQ(boost::num_vertices(g2), 0);
+}
@@ -64,3 +64,129 @@ TEST_F(SpatialGraph3DFixture, read_graphviz) {
     EXPECT_EQ(boost::num_vertices(g), boost::num_vertices(g2));
     EXPECT_EQ(boost::num_edges(g), boost::num_edges(g2));
 }
+
+namespace {
+void expect_equal_graphs(const SG::GraphAL &g, const SG::GraphAL &g2) {
+    ASSERT_EQ(boost::num_vertices(g2), boost::num_vertices(g));
+    ASSERT_EQ(boost::num_edges(g2), boost::num_edges(g));
+    // ids are not compared, read_graphviz_sg overwrites them with the
+    // spatial_node property.
+    for (size_t v = 0; v < boost::num_vertices(g); ++v) {
+        EXPECT_EQ(g2[v].pos, g[v].pos);
+    }
+    auto ei2 = boost::edges(g2).first;
+    for (const auto e : boost::make_iterator_range(boost::edges(g))) {
+        EXPECT_EQ(boost::source(*ei2, g2), boost::source(e, g));
+        EXPECT_EQ(boost::target(*ei2, g2), boost::target(e, g));
+        EXPECT_EQ(g2[*ei2].edge_points, g[e].edge_points);
+        ++ei2;
+    }
+}
+} // namespace
+
+TEST_F(SpatialGraph3DFixture, read_graphviz_fast_equals_read_graphviz) {
+    // Use non-representable doubles
+    g[0].pos = {{0.1, 1.0 / 3.0, -2.5e-10}};
+    g[boost::edge(0, 1, g).first].edge_points[0] = {{1.0 / 7.0, 1e20, 0}};
+    std::stringstream ss;
+    SG::write_graphviz_sg(ss, g);
+    const auto contents = ss.str();
+
+    GraphType g_boost;
+    std::stringstream ss_boost(contents);
+    SG::read_graphviz_sg(ss_boost, g_boost);
+    GraphType g_fast;
+    std::stringstream ss_fast(contents);
+    SG::read_graphviz_sg_fast(ss_fast, g_fast);
+    expect_equal_graphs(g_boost, g_fast);
+    for (size_t v = 0; v < boost::num_vertices(g_fast); ++v) {
+        EXPECT_EQ(g_fast[v].id, v);
+    }
+}
+
+TEST_F(SpatialGraph3DFixture, write_graphviz_fast) {
+    g[0].pos = {{0.1, 1.0 / 3.0, -2.5e-10}};
+    g[boost::edge(0, 1, g).first].edge_points[0] = {{1.0 / 7.0, 1e20, 0}};
+    std::stringstream ss;
+    SG::write_graphviz_sg_fast(ss, g);
+    const auto contents = ss.str();
+    std::cout << contents << std::endl;
+    // Readable by boost reader.
+    GraphType g_boost;
+    std::stringstream ss_boost(contents);
+    SG::read_graphviz_sg(ss_boost, g_boost);
+    // And round-trips exactly with the fast reader.
+    GraphType g_fast;
+    std::stringstream ss_fast(contents);
+    SG::read_graphviz_sg_fast(ss_fast, g_fast);
+    expect_equal_graphs(g_boost, g_fast);
+    for (size_t v = 0; v < boost::num_vertices(g); ++v) {
+        EXPECT_EQ(g_fast[v].pos, g[v].pos);
+    }
+    auto ei = boost::edges(g).first;
+    for (const auto e : boost::make_iterator_range(boost::edges(g_fast))) {
+        EXPECT_EQ(g_fast[e].edge_points, g[*ei].edge_points);
+        ++ei;
+    }
+}
+
+TEST(read_graphviz_fast, general_dot_syntax) {
+    const std::string contents = R"(/* comment */
+strict graph "name" {
+  node [shape=box]; // default attributes
+  rankdir = LR
+  # another comment
+  2 -- 0 [color="red", spatial_edge="[{1 2 3}, {4 5 6}]"]
+  0 [spatial_node="0 0 1" label="a"]
+  2 [spatial_node="-1 +2 3.5e1"];
+  0 -- 1 -- 2
+}
+)";
+    SG::GraphAL g;
+    std::stringstream ss(contents);
+    SG::read_graphviz_sg_fast(ss, g);
+    ASSERT_EQ(boost::num_vertices(g), 3);
+    EXPECT_EQ(boost::num_edges(g), 3);
+    EXPECT_EQ(g[0].id, 2);
+    EXPECT_EQ(g[1].id, 0);
+    EXPECT_EQ(g[2].id, 1);
+    const SG::PointType expected_pos0 = {{-1, 2, 35}};
+    const SG::PointType expected_pos1 = {{0, 0, 1}};
+    EXPECT_EQ(g[0].pos, expected_pos0);
+    EXPECT_EQ(g[1].pos, expected_pos1);
+    const auto e01 = boost::edge(0, 1, g);
+    ASSERT_TRUE(e01.second);
+    EXPECT_EQ(g[e01.first].edge_points.size(), 2);
+    const SG::PointType expected_ep1 = {{4, 5, 6}};
+    EXPECT_EQ(g[e01.first].edge_points[1], expected_ep1);
+    EXPECT_TRUE(boost::edge(1, 2, g).second);
+    EXPECT_TRUE(boost::edge(2, 0, g).second);
+}
+
+TEST(read_graphviz_fast, throws) {
+    SG::GraphAL g;
+    std::stringstream digraph("digraph G { 0 -> 1 }");
+    EXPECT_THROW(SG::read_graphviz_sg_fast(digraph, g), std::runtime_error);
+    std::stringstream non_integer_id("graph G { a -- b }");
+    EXPECT_THROW(SG::read_graphviz_sg_fast(non_integer_id, g),
+                 std::runtime_error);
+    std::stringstream id_out_of_range(
+            "graph G { 0 -- 99999999999999999999999 }");
+    EXPECT_THROW(SG::read_graphviz_sg_fast(id_out_of_range, g),
+                 std::runtime_error);
+    std::stringstream id_above_num_vertices("graph G { 0 -- 2 }");
+    EXPECT_THROW(SG::read_graphviz_sg_fast(id_above_num_vertices, g),
+                 std::runtime_error);
+    std::stringstream negative_id("graph G { -1 -- 0 }");
+    EXPECT_THROW(SG::read_graphviz_sg_fast(negative_id, g),
+                 std::runtime_error);
+    std::stringstream unterminated("graph G { 0 [spatial_node=\"0 0 0\"];");
+    EXPECT_THROW(SG::read_graphviz_sg_fast(unterminated, g),
+                 std::runtime_error);
+    std::stringstream bad_point("graph G { 0 [spatial_node=\"0 x 0\"]; }");
+    EXPECT_THROW(SG::read_graphviz_sg_fast(bad_point, g), std::runtime_error);
+    std::stringstream failed_stream("graph G { }");
+    failed_stream.setstate(std::ios::badbit);
+    EXPECT_THROW(SG::read_graphviz_sg_fast(failed_stream, g),
+                 std::runtime_error);
+}
@@ -0,0 +1,104 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "parallel_tasks.hpp"
+#include "gmock/gmock.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+TEST(ThreadPool, runs_every_task_once) {
+    SG::ThreadPool pool(4);
+    EXPECT_EQ(pool.num_threads(), 4u);
+    // The pool is reused by consecutive batches.
+    for (size_t batch = 0; batch < 20; ++batch) {
+        std::vector<int> runs(1000, 0);
+        pool.run(runs.size(), [&runs](const size_t i) { ++runs[i]; });
+        EXPECT_EQ(std::accumulate(runs.cbegin(), runs.cend(), 0), 1000);
+        EXPECT_TRUE(std::all_of(runs.cbegin(), runs.cend(),
+                                [](const int r) { return r == 1; }));
+    }
+}
+
+TEST(ThreadPool, thread_index) {
+    SG::ThreadPool pool(3);
+    std::vector<size_t> thread_indices(500);
+    pool.run(thread_indices.size(),
+             [&thread_indices](const size_t i, const size_t thread_index) {
+                 thread_indices[i] = thread_index;
+             });
+    for (const auto &thread_index : thread_indices) {
+        EXPECT_LT(thread_index, pool.num_threads());
+    }
+}
+
+TEST(ThreadPool, rethrows_exception) {
+    SG::ThreadPool pool(2);
+    EXPECT_THROW(pool.run(100,
+                          [](const size_t i) {
+                              if (i == 42) {
+                                  throw std::runtime_error("task 42");
+                              }
+                          }),
+                 std::runtime_error);
+    // The pool is usable after an exception.
+    size_t count = 0;
+    pool.run(1, [&count](const size_t) { ++count; });
+    EXPECT_EQ(count, 1u);
+}
+
+TEST(run_tasks, serial_and_parallel) {
+    for (const size_t num_threads : {1, 2, 8}) {
+        std::vector<int> runs(100, 0);
+        SG::run_tasks(runs.size(), num_threads,
+                      [&runs](const size_t i) { ++runs[i]; });
+        EXPECT_EQ(std::accumulate(runs.cbegin(), runs.cend(), 0), 100);
+    }
+}
+
+TEST(run_blocks, covers_the_range) {
+    std::vector<int> runs(10000, 0);
+    SG::run_blocks(runs.size(), 3,
+                   [&runs](const size_t begin, const size_t end) {
+                       for (size_t i = begin; i < end; ++i) {
+                           ++runs[i];
+                       }
+                   },
+                   100);
+    EXPECT_TRUE(std::all_of(runs.cbegin(), runs.cend(),
+                            [](const int r) { return r == 1; }));
+}
+
+TEST(run_blocks, covers_the_range_with_a_pool) {
+    SG::ThreadPool pool(3);
+    for (const size_t num_items : {0, 50, 10000}) {
+        std::vector<int> runs(num_items, 0);
+        SG::run_blocks(runs.size(), pool,
+                       [&runs](const size_t begin, const size_t end) {
+                           for (size_t i = begin; i < end; ++i) {
+                               ++runs[i];
+                           }
+                       },
+                       100);
+        EXPECT_TRUE(std::all_of(runs.cbegin(), runs.cend(),
+                                [](const int r) { return r == 1; }));
+    }
+}
@@ -0,0 +1,108 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "rng.hpp"
+#include "gmock/gmock.h"
+
+TEST(Philox4x32, known_answers) {
+    // Known answer tests of the Random123 library (kat_vectors).
+    const RNG::Philox4x32::counter_t zero_result = {
+            {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}};
+    EXPECT_EQ(RNG::Philox4x32::generate({{0, 0, 0, 0}}, {{0, 0}}),
+              zero_result);
+    const RNG::Philox4x32::counter_t max_result = {
+            {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}};
+    EXPECT_EQ(RNG::Philox4x32::generate(
+                      {{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}},
+                      {{0xffffffff, 0xffffffff}}),
+              max_result);
+    const RNG::Philox4x32::counter_t pi_result = {
+            {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}};
+    EXPECT_EQ(RNG::Philox4x32::generate(
+                      {{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}},
+                      {{0xa4093822, 0x299f31d0}}),
+              pi_result);
+}
+
+TEST(counter_based_rand01, reproducible_and_uniform) {
+    const uint64_t seed = 1234;
+    EXPECT_EQ(RNG::counter_based_rand01(seed, 7, 3),
+              RNG::counter_based_rand01(seed, 7, 3));
+    EXPECT_NE(RNG::counter_based_rand01(seed, 7, 3),
+              RNG::counter_based_rand01(seed, 7, 4));
+    EXPECT_NE(RNG::counter_based_rand01(seed, 7, 3),
+              RNG::counter_based_rand01(seed, 8, 3));
+    EXPECT_NE(RNG::counter_based_rand01(seed, 7, 3),
+              RNG::counter_based_rand01(seed + 1, 7, 3));
+    const size_t samples = 100000;
+    double sum = 0.0;
+    double sum_squares = 0.0;
+    for (size_t i = 0; i < samples; ++i) {
+        for (const auto &u : RNG::counter_based_rand01(seed, 0, i)) {
+            EXPECT_GE(u, 0.0);
+            EXPECT_LT(u, 1.0);
+            sum += u;
+            sum_squares += u * u;
+        }
+    }
+    const double mean = sum / (2 * samples);
+    const double variance = sum_squares / (2 * samples) - mean * mean;
+    EXPECT_NEAR(mean, 0.5, 0.005);
+    EXPECT_NEAR(variance, 1.0 / 12.0, 0.005);
+}
+
+TEST(counter_based_random_orientation, modulus_and_isotropy) {
+    const size_t samples = 100000;
+    std::array<double, 3> mean = {{0.0, 0.0, 0.0}};
+    std::array<double, 3> mean_squares = {{0.0, 0.0, 0.0}};
+    for (size_t i = 0; i < samples; ++i) {
+        const auto v = RNG::counter_based_random_orientation(2.0, 42, 1, i);
+        EXPECT_NEAR(v[0] * v[0] + v[1] * v[1] + v[2] * v[2], 4.0, 1e-12);
+        for (size_t dim = 0; dim < 3; ++dim) {
+            mean[dim] += v[dim] / samples;
+            mean_squares[dim] += v[dim] * v[dim] / samples;
+        }
+    }
+    // Uniform on the sphere: <v_i> = 0, <v_i^2> = r^2 / 3
+    for (size_t dim = 0; dim < 3; ++dim) {
+        EXPECT_NEAR(mean[dim], 0.0, 0.02);
+        EXPECT_NEAR(mean_squares[dim], 4.0 / 3.0, 0.02);
+    }
+}
+
+TEST(counter_based_normal, moments) {
+    const size_t samples = 100000;
+    double sum = 0.0;
+    double sum_squares = 0.0;
+    double sum_fourth = 0.0;
+    for (size_t i = 0; i < samples; ++i) {
+        for (const auto &n : RNG::counter_based_normal(3, 5, i)) {
+            sum += n;
+            sum_squares += n * n;
+            sum_fourth += n * n * n * n;
+        }
+    }
+    const double count = 4.0 * samples;
+    EXPECT_NEAR(sum / count, 0.0, 0.01);
+    EXPECT_NEAR(sum_squares / count, 1.0, 0.01);
+    EXPECT_NEAR(sum_fourth / count, 3.0, 0.05);
+    EXPECT_EQ(RNG::counter_based_normal(3, 5, 0),
+              RNG::counter_based_normal(3, 5, 0));
+}
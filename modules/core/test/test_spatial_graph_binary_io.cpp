@@ -0,0 +1,210 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "spatial_graph.hpp"
+#include "spatial_graph_io.hpp"
+#include "gmock/gmock.h"
+
+#include <cstring>
+#include <fstream>
+
+struct SpatialGraphBinaryIOFixture : public ::testing::Test {
+    using GraphType = SG::GraphAL;
+    GraphType g;
+    const std::string filename = "test_spatial_graph_binary_io.sgb";
+    void SetUp() override {
+        this->g = GraphType(4);
+        // Positions that are not exactly representable in decimal text.
+        SG::PointType n0{{0.1, 1.0 / 3.0, 0}};
+        SG::PointType n1{{1, 1, 0}};
+        SG::PointType n2{{2, 2, 1e-17}};
+        SG::PointType n3{{1, 3, 0}};
+        this->g[0].pos = n0;
+        this->g[1].pos = n1;
+        this->g[2].pos = n2;
+        this->g[3].pos = n3;
+        for (size_t v = 0; v < 4; ++v) {
+            this->g[v].id = 10 + v;
+        }
+
+        SG::SpatialEdge se01;
+        se01.edge_points.insert(std::end(se01.edge_points),
+                                {{0.5, 2.0 / 3.0, 0}});
+        boost::add_edge(0, 1, se01, this->g);
+        SG::SpatialEdge se12;
+        boost::add_edge(1, 2, se12, this->g);
+        SG::SpatialEdge se13;
+        se13.edge_points.insert(std::end(se13.edge_points),
+                                {{1, 1.5, 0}, {1, 2, 0}, {1, 2.5, 0}});
+        boost::add_edge(1, 3, se13, this->g);
+        SG::SpatialEdge se33;
+        se33.edge_points.insert(std::end(se33.edge_points), {{1, 4, 0}});
+        boost::add_edge(3, 3, se33, this->g);
+    }
+    void TearDown() override { std::remove(filename.c_str()); }
+};
+
+TEST_F(SpatialGraphBinaryIOFixture, write_and_read_mmap) {
+    SG::write_sg_binary(filename, g);
+    const auto mapped = SG::read_sg_mmap(filename);
+    EXPECT_EQ(mapped.version(), SG::spatial_graph_binary_version);
+    EXPECT_EQ(mapped.num_vertices(), 4);
+    EXPECT_EQ(mapped.num_edges(), 4);
+    EXPECT_EQ(mapped.num_edge_points(), 5);
+    for (size_t v = 0; v < 4; ++v) {
+        EXPECT_EQ(mapped.vertex_id(v), g[v].id);
+        EXPECT_EQ(mapped.position(v), g[v].pos);
+    }
+    size_t edge_index = 0;
+    for (const auto e : boost::make_iterator_range(boost::edges(g))) {
+        EXPECT_EQ(mapped.edge_source(edge_index), boost::source(e, g));
+        EXPECT_EQ(mapped.edge_target(edge_index), boost::target(e, g));
+        const auto eps = mapped.edge_points(edge_index);
+        ASSERT_EQ(eps.size(), g[e].edge_points.size());
+        EXPECT_TRUE(std::equal(eps.begin(), eps.end(),
+                               g[e].edge_points.begin()));
+        ++edge_index;
+    }
+}
+
+TEST_F(SpatialGraphBinaryIOFixture, round_trip_graph) {
+    SG::write_sg_binary(filename, g);
+    const auto g2 = SG::read_sg_binary(filename);
+    EXPECT_EQ(boost::num_vertices(g2), boost::num_vertices(g));
+    EXPECT_EQ(boost::num_edges(g2), boost::num_edges(g));
+    for (size_t v = 0; v < 4; ++v) {
+        EXPECT_EQ(g2[v].id, g[v].id);
+        // Bitwise equal, no loss of precision.
+        EXPECT_EQ(g2[v].pos, g[v].pos);
+    }
+    auto ei2 = boost::edges(g2).first;
+    for (const auto e : boost::make_iterator_range(boost::edges(g))) {
+        EXPECT_EQ(boost::source(*ei2, g2), boost::source(e, g));
+        EXPECT_EQ(boost::target(*ei2, g2), boost::target(e, g));
+        EXPECT_EQ(g2[*ei2].edge_points, g[e].edge_points);
+        ++ei2;
+    }
+}
+
+TEST_F(SpatialGraphBinaryIOFixture, round_trip_frozen) {
+    const auto frozen = SG::frozen_spatial_graph_from_graph(g);
+    SG::write_sg_binary(filename, frozen);
+    const auto frozen2 = SG::read_sg_mmap(filename).to_frozen_spatial_graph();
+    EXPECT_EQ(frozen2.positions, frozen.positions);
+    EXPECT_EQ(frozen2.ids, frozen.ids);
+    EXPECT_EQ(frozen2.edge_sources, frozen.edge_sources);
+    EXPECT_EQ(frozen2.edge_targets, frozen.edge_targets);
+    EXPECT_EQ(frozen2.edge_points_offsets, frozen.edge_points_offsets);
+    EXPECT_EQ(frozen2.edge_points_pool, frozen.edge_points_pool);
+    // Adjacency built from the edge list matches the one from the graph.
+    EXPECT_EQ(frozen2.out_offsets, frozen.out_offsets);
+    EXPECT_EQ(frozen2.out_targets, frozen.out_targets);
+    EXPECT_EQ(frozen2.out_edge_indices, frozen.out_edge_indices);
+}
+
+TEST_F(SpatialGraphBinaryIOFixture, move_mapped_graph) {
+    SG::write_sg_binary(filename, g);
+    auto mapped = SG::read_sg_mmap(filename);
+    SG::MappedSpatialGraph moved(std::move(mapped));
+    EXPECT_EQ(moved.num_vertices(), 4);
+    EXPECT_EQ(moved.position(2), g[2].pos);
+}
+
+TEST_F(SpatialGraphBinaryIOFixture, throws_on_invalid_files) {
+    EXPECT_THROW(SG::read_sg_mmap("non_existing_file.sgb"),
+                 std::runtime_error);
+    {
+        std::ofstream os(filename);
+        SG::write_serialized_sg(os, g);
+    }
+    EXPECT_THROW(SG::read_sg_mmap(filename), std::runtime_error);
+    // Truncated file
+    std::stringstream ss;
+    SG::write_sg_binary(ss, g);
+    const auto contents = ss.str();
+    {
+        std::ofstream os(filename, std::ios::binary);
+        os.write(contents.data(),
+                 static_cast<std::streamsize>(contents.size() - 8));
+    }
+    EXPECT_THROW(SG::read_sg_mmap(filename), std::runtime_error);
+}
+
+TEST_F(SpatialGraphBinaryIOFixture, throws_on_overflowing_header) {
+    std::stringstream ss;
+    SG::write_sg_binary(ss, g);
+    auto contents = ss.str();
+    // Each vertex takes 32 bytes: adding 2^61 vertices wraps all the block
+    // offsets and the file size back to the ones of the valid file.
+    SG::SpatialGraphBinaryHeader header;
+    std::memcpy(&header, contents.data(), sizeof(header));
+    header.num_vertices += std::uint64_t(1) << 61;
+    std::memcpy(&contents[0], &header, sizeof(header));
+    {
+        std::ofstream os(filename, std::ios::binary);
+        os.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    }
+    EXPECT_THROW(SG::read_sg_mmap(filename), std::runtime_error);
+}
+
+/** Stream buffer that fails after accepting capacity characters. */
+struct LimitedStreamBuffer : public std::streambuf {
+    explicit LimitedStreamBuffer(size_t capacity) : capacity(capacity) {}
+    int_type overflow(int_type c) override {
+        if (capacity == 0) {
+            return traits_type::eof();
+        }
+        --capacity;
+        return c;
+    }
+    size_t capacity;
+};
+
+TEST_F(SpatialGraphBinaryIOFixture, write_throws_on_failed_stream) {
+    const auto frozen = SG::frozen_spatial_graph_from_graph(g);
+    {
+        // Failure in the header.
+        LimitedStreamBuffer buffer(0);
+        std::ostream os(&buffer);
+        EXPECT_THROW(SG::write_sg_binary(os, g), std::runtime_error);
+    }
+    {
+        // Failure in the data after a complete header.
+        LimitedStreamBuffer buffer(sizeof(SG::SpatialGraphBinaryHeader));
+        std::ostream os(&buffer);
+        EXPECT_THROW(SG::write_sg_binary(os, g), std::runtime_error);
+    }
+    {
+        LimitedStreamBuffer buffer(sizeof(SG::SpatialGraphBinaryHeader));
+        std::ostream os(&buffer);
+        EXPECT_THROW(SG::write_sg_binary(os, frozen), std::runtime_error);
+    }
+}
+
+TEST_F(SpatialGraphBinaryIOFixture, write_file_throws_when_close_fails) {
+    // /dev/full accepts the buffered writes and fails on the final flush.
+    const std::string full_device = "/dev/full";
+    if (!std::ifstream(full_device).good()) {
+        return;
+    }
+    const auto frozen = SG::frozen_spatial_graph_from_graph(g);
+    EXPECT_THROW(SG::write_sg_binary(full_device, g), std::runtime_error);
+    EXPECT_THROW(SG::write_sg_binary(full_device, frozen), std::runtime_error);
+}
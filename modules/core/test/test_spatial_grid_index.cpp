@@ -0,0 +1,172 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "spatial_grid_index.hpp"
+#include "spatial_graph_utilities.hpp" // get_all_points
+#include "gmock/gmock.h"
+
+#include <random>
+
+struct SpatialGridIndexFixture : public ::testing::Test {
+    void SetUp() override {
+        // Random points in a box, connected in a chain with edge points
+        std::mt19937 gen(11);
+        std::uniform_real_distribution<double> dis(-10.0, 10.0);
+        const auto random_point = [&]() {
+            return SG::PointType{{dis(gen), dis(gen), dis(gen)}};
+        };
+        const size_t num_vertices = 200;
+        g = SG::GraphType(num_vertices);
+        for (size_t i = 0; i < num_vertices; ++i) {
+            g[i].pos = random_point();
+        }
+        for (size_t i = 1; i < num_vertices; ++i) {
+            SG::SpatialEdge se;
+            se.edge_points = {random_point(), random_point()};
+            boost::add_edge(i - 1, i, se, g);
+        }
+        std::tie(points, gdescs) = SG::get_all_points(g);
+    }
+
+    /** Distances to all the points, sorted. */
+    std::vector<double> brute_force_distances(const SG::PointType &query) const {
+        std::vector<double> distances;
+        for (const auto &p : points) {
+            const double dx = p[0] - query[0];
+            const double dy = p[1] - query[1];
+            const double dz = p[2] - query[2];
+            distances.push_back(std::sqrt(dx * dx + dy * dy + dz * dz));
+        }
+        std::sort(distances.begin(), distances.end());
+        return distances;
+    }
+
+    static std::vector<double>
+    distances(const std::vector<SG::SpatialGridIndex::Neighbor> &neighbors) {
+        std::vector<double> out;
+        for (const auto &neighbor : neighbors) {
+            out.push_back(neighbor.distance);
+        }
+        return out;
+    }
+
+    SG::GraphType g;
+    std::vector<SG::PointType> points;
+    std::vector<SG::graph_descriptor> gdescs;
+    std::vector<SG::PointType> queries = {{{0.0, 0.0, 0.0}},
+                                          {{9.5, -9.5, 3.0}},
+                                          {{-30.0, 20.0, 0.0}},
+                                          {{2.5, 2.5, 2.5}}};
+};
+
+TEST_F(SpatialGridIndexFixture, radius_search_equal_to_brute_force) {
+    for (const double cell_size : {0.5, 2.0, 50.0}) {
+        SG::SpatialGridIndex index(g, cell_size);
+        EXPECT_EQ(index.size(), points.size());
+        for (const auto &query : queries) {
+            for (const double radius : {0.0, 1.5, 4.0, 100.0}) {
+                const auto neighbors = index.radius_search(query, radius);
+                const auto all_distances = brute_force_distances(query);
+                std::vector<double> expected;
+                std::copy_if(all_distances.begin(), all_distances.end(),
+                             std::back_inserter(expected),
+                             [&radius](const double d) { return d <= radius; });
+                EXPECT_EQ(distances(neighbors), expected);
+            }
+        }
+    }
+}
+
+TEST_F(SpatialGridIndexFixture, k_nearest_equal_to_brute_force) {
+    for (const double cell_size : {0.5, 2.0, 50.0}) {
+        SG::SpatialGridIndex index(g, cell_size);
+        for (const auto &query : queries) {
+            for (const size_t k : {1, 5, 30, 1000}) {
+                const auto neighbors = index.k_nearest(query, k);
+                auto expected = brute_force_distances(query);
+                expected.resize(std::min(k, expected.size()));
+                EXPECT_EQ(distances(neighbors), expected);
+            }
+        }
+    }
+}
+
+TEST_F(SpatialGridIndexFixture, descriptors_locate_the_points) {
+    SG::SpatialGridIndex index(g, 2.0);
+    for (size_t i = 0; i < points.size(); ++i) {
+        const auto closest = index.closest(points[i]);
+        EXPECT_EQ(closest.distance, 0.0);
+        EXPECT_EQ(closest.pos, points[i]);
+        const auto &gdesc = closest.descriptor;
+        EXPECT_TRUE(gdesc == gdescs[i]);
+        if (gdesc.is_vertex) {
+            EXPECT_EQ(g[gdesc.vertex_d].pos, points[i]);
+        } else {
+            EXPECT_EQ(g[gdesc.edge_d].edge_points[gdesc.edge_points_index],
+                      points[i]);
+        }
+    }
+}
+
+TEST_F(SpatialGridIndexFixture, insert_and_remove) {
+    SG::SpatialGridIndex index(g, 2.0, false);
+    EXPECT_EQ(index.size(), boost::num_vertices(g));
+    const auto e = *boost::edges(g).first;
+    index.insert_edge_points(e, g);
+    EXPECT_EQ(index.size(), boost::num_vertices(g) + 2);
+    const auto &edge_point = g[e].edge_points[1];
+    auto closest = index.closest(edge_point);
+    EXPECT_TRUE(closest.descriptor.is_edge);
+    EXPECT_EQ(closest.descriptor.edge_points_index, 1);
+
+    EXPECT_EQ(index.remove_edge_points(e, g), 2);
+    EXPECT_EQ(index.remove_edge_points(e, g), 0);
+    closest = index.closest(edge_point);
+    EXPECT_TRUE(closest.descriptor.is_vertex);
+    EXPECT_GT(closest.distance, 0.0);
+
+    for (const auto v : boost::make_iterator_range(boost::vertices(g))) {
+        EXPECT_TRUE(index.remove_vertex(v, g));
+    }
+    EXPECT_FALSE(index.remove_vertex(0, g));
+    EXPECT_TRUE(index.empty());
+    EXPECT_EQ(index.num_cells(), 0);
+    EXPECT_TRUE(index.radius_search(queries[0], 100.0).empty());
+    EXPECT_FALSE(index.closest(queries[0]).descriptor.exist);
+
+    index.insert_vertex(3, g);
+    closest = index.closest(queries[0]);
+    EXPECT_TRUE(closest.descriptor.exist);
+    EXPECT_EQ(closest.descriptor.vertex_d, 3);
+}
+
+TEST(SpatialGridIndex, negative_coordinates_and_invalid_cell_size) {
+    EXPECT_THROW(SG::SpatialGridIndex(0.0), std::runtime_error);
+    SG::SpatialGridIndex index(1.0);
+    const SG::SpatialGridIndex::CellIndex expected_cell = {{-1, 0, -3}};
+    EXPECT_EQ(index.cell_index({{-0.5, 0.5, -2.5}}), expected_cell);
+    index.insert({{-0.5, 0.5, -2.5}},
+                 SG::SpatialGridIndex::vertex_graph_descriptor(7));
+    index.insert({{0.5, 0.5, -2.5}},
+                 SG::SpatialGridIndex::vertex_graph_descriptor(8));
+    const auto neighbors = index.radius_search({{-0.4, 0.5, -2.5}}, 0.5);
+    ASSERT_EQ(neighbors.size(), 1);
+    EXPECT_EQ(neighbors[0].descriptor.vertex_d, 7);
+}
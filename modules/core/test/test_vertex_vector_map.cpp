@@ -0,0 +1,80 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "vertex_vector_map.hpp"
+#include "spatial_graph.hpp"
+#include "gmock/gmock.h"
+
+#include <boost/graph/breadth_first_search.hpp>
+#include <boost/graph/depth_first_search.hpp>
+#include <limits>
+
+TEST(VertexVectorMap, get_put_and_reset) {
+    const double inf = std::numeric_limits<double>::infinity();
+    SG::VertexDistanceMap distance_map(5, inf);
+    EXPECT_EQ(distance_map.size(), 5);
+    EXPECT_EQ(distance_map.get(3), inf);
+    EXPECT_FALSE(distance_map.is_set(3));
+    distance_map.put(3, 2.0);
+    distance_map[1] += 1.0; // inf + 1
+    EXPECT_EQ(distance_map.get(3), 2.0);
+    EXPECT_TRUE(distance_map.is_set(3));
+    EXPECT_EQ(distance_map.get(1), inf);
+    distance_map.reset();
+    EXPECT_EQ(distance_map.get(3), inf);
+    EXPECT_FALSE(distance_map.is_set(3));
+    distance_map[3] = 1.0;
+    EXPECT_EQ(distance_map.get(3), 1.0);
+    distance_map.reset(0.0);
+    EXPECT_EQ(distance_map.get(3), 0.0);
+    distance_map.resize(7);
+    EXPECT_EQ(distance_map.get(6), 0.0);
+    // property_map handle shares the storage
+    auto pmap = distance_map.property_map();
+    put(pmap, 6, 4.0);
+    EXPECT_EQ(get(pmap, 6), 4.0);
+    EXPECT_EQ(distance_map.get(6), 4.0);
+    EXPECT_EQ(pmap[6], 4.0);
+}
+
+TEST(VertexVectorMap, color_map_reused_in_visits) {
+    // Two components: 0-1-2 and 3-4
+    SG::GraphType g(5);
+    boost::add_edge(0, 1, g);
+    boost::add_edge(1, 2, g);
+    boost::add_edge(3, 4, g);
+    SG::VertexColorMap color_map(boost::num_vertices(g));
+    using Color = boost::color_traits<SG::VertexColorMap::mapped_type>;
+
+    boost::depth_first_visit(g, 0, boost::default_dfs_visitor(),
+                             color_map.property_map());
+    for (const size_t v : {0, 1, 2}) {
+        EXPECT_EQ(color_map.get(v), Color::black());
+    }
+    EXPECT_EQ(color_map.get(3), Color::white());
+
+    color_map.reset();
+    boost::queue<SG::GraphType::vertex_descriptor> Q;
+    boost::breadth_first_visit(g, 3, Q, boost::default_bfs_visitor(),
+                               color_map.property_map());
+    EXPECT_EQ(color_map.get(0), Color::white());
+    EXPECT_EQ(color_map.get(3), Color::black());
+    EXPECT_EQ(color_map.get(4), Color::black());
+}
@@ -0,0 +1,130 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+/**
+ * Time of particles_from_graph (bonds built from the edge list of the graph,
+ * sorted once) for a random graph. make_bonds_from_graph is compared with the
+ * previous construction of the bonds from the conexions (find_bond and sort
+ * after every inserted bond, then a boost::edge lookup per bond) on a smaller
+ * graph of reference_num_vertices, the previous construction is quadratic.
+ *
+ * Usage: bench_bonds_from_graph [num_vertices] [reference_num_vertices]
+ */
+
+#include "dynamics_graph_glue.hpp"
+#include "edge_points_utilities.hpp" // for contour_length
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+template <typename TFunction>
+double time_seconds(TFunction &&function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+/** Chain of num_vertices, plus num_vertices / 2 random edges. */
+SG::GraphType random_graph(const size_t num_vertices) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<size_t> vertex_dis(0, num_vertices - 1);
+    std::uniform_real_distribution<double> pos_dis(0.0, 100.0);
+    SG::GraphType graph(num_vertices);
+    for (size_t i = 0; i < num_vertices; ++i) {
+        graph[i].pos = {{pos_dis(gen), pos_dis(gen), pos_dis(gen)}};
+    }
+    for (size_t i = 0; i + 1 < num_vertices; ++i) {
+        boost::add_edge(i, i + 1, graph);
+    }
+    for (size_t i = 0; i < num_vertices / 2; ++i) {
+        const auto source = vertex_dis(gen);
+        const auto target = vertex_dis(gen);
+        if (source != target) {
+            boost::add_edge(source, target, graph);
+        }
+    }
+    return graph;
+}
+
+/** Construction of the bonds before make_bonds_from_graph. */
+SG::BondCollection reference_bonds(const SG::GraphType &graph,
+                                   const SG::System &sys) {
+    SG::BondCollection bond_collection;
+    bond_collection.sorted = true;
+    auto &bonds = bond_collection.bonds;
+    for (const auto &particle_neighbor : sys.conexions) {
+        for (const auto &neigh : particle_neighbor.neighbors) {
+            auto bond = std::make_shared<SG::BondChain>(
+                    particle_neighbor.particle_id, neigh);
+            SG::sort(*bond);
+            if (bond_collection.find_bond(*bond) == std::end(bonds)) {
+                bonds.push_back(bond);
+                bond_collection.sort();
+            }
+        }
+    }
+    for (auto &bond : bonds) {
+        const auto edge = boost::edge(bond->id_a, bond->id_b, graph);
+        std::static_pointer_cast<SG::BondChain>(bond)->length_contour =
+                SG::contour_length(edge.first, graph);
+    }
+    return bond_collection;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t num_vertices = argc > 1 ? std::stoul(argv[1]) : 200000;
+    const size_t reference_num_vertices =
+            argc > 2 ? std::stoul(argv[2]) : 5000;
+
+    const auto graph = random_graph(num_vertices);
+    std::cout << "Vertices: " << num_vertices
+              << ", edges: " << boost::num_edges(graph) << std::endl;
+    size_t num_bonds = 0;
+    const auto t_graph = time_seconds([&]() {
+        num_bonds = SG::particles_from_graph(graph).bond_collection.bonds.size();
+    });
+    std::cout << "particles_from_graph: " << t_graph << " s, bonds: "
+              << num_bonds << std::endl;
+
+    const auto small_graph = random_graph(reference_num_vertices);
+    const auto small_glue_data = SG::particles_from_graph(small_graph);
+    const auto t_small_graph = time_seconds([&]() {
+        num_bonds = SG::make_bonds_from_graph(
+                            small_graph, *small_glue_data.graph_particle_map)
+                            .bonds.size();
+    });
+    std::cout << "Vertices: " << reference_num_vertices
+              << ", make_bonds_from_graph: " << t_small_graph
+              << " s, bonds: " << num_bonds << std::endl;
+    const auto t_reference = time_seconds([&]() {
+        num_bonds = reference_bonds(small_graph, *small_glue_data.sys)
+                            .bonds.size();
+    });
+    std::cout << "Vertices: " << reference_num_vertices
+              << ", sort after every bond: " << t_reference
+              << " s, bonds: " << num_bonds << std::endl;
+    return EXIT_SUCCESS;
+}
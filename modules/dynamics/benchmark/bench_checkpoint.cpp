@@ -0,0 +1,108 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+/**
+ * Time of write_checkpoint and read_checkpoint of a chain of num_particles
+ * connected by BondChain sharing one BondPropertiesPhysical, compared with a
+ * copy of the particles in memory, and with writing the particles to a file
+ * with one std::ofstream::write.
+ *
+ * Usage: bench_checkpoint [num_particles] [num_repetitions] [output_file]
+ */
+
+#include "checkpoint.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+template <typename TFunction>
+double time_seconds(TFunction &&function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t num_particles = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const size_t num_repetitions = argc > 2 ? std::stoul(argv[2]) : 5;
+    const std::string file_name =
+            argc > 3 ? argv[3] : "bench_checkpoint.sgchk";
+    SG::System sys;
+    sys.all.particles.resize(num_particles);
+    for (size_t i = 0; i < num_particles; ++i) {
+        sys.all.particles[i].id = i;
+        sys.all.particles[i].pos = {{1.0 * i, 0.0, 0.0}};
+    }
+    sys.all.sorted = true;
+    const auto properties =
+            std::make_shared<SG::BondPropertiesPhysical>(1.0, 1.0);
+    for (size_t i = 0; i + 1 < num_particles; ++i) {
+        auto bond = std::make_shared<SG::BondChain>(i, i + 1, 2.0);
+        bond->properties = properties;
+        sys.bonds.bonds.push_back(bond);
+    }
+    sys.bonds.sorted = true;
+    std::cout << "Particles: " << num_particles
+              << ", bonds: " << sys.bonds.bonds.size() << std::endl;
+
+    std::vector<SG::Particle> copy;
+    const auto t_copy = time_seconds([&]() {
+        for (size_t r = 0; r < num_repetitions; ++r) {
+            copy = sys.all.particles;
+        }
+    });
+    std::cout << "Copy of the particles: " << t_copy / num_repetitions
+              << " s" << std::endl;
+
+    const auto t_raw_write = time_seconds([&]() {
+        for (size_t r = 0; r < num_repetitions; ++r) {
+            std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char *>(sys.all.particles.data()),
+                       sys.all.particles.size() * sizeof(SG::Particle));
+        }
+    });
+    std::cout << "std::ofstream::write of the particles: "
+              << t_raw_write / num_repetitions << " s" << std::endl;
+
+    const auto t_write = time_seconds([&]() {
+        for (size_t r = 0; r < num_repetitions; ++r) {
+            SG::write_checkpoint(file_name, sys, nullptr, r);
+        }
+    });
+    std::cout << "write_checkpoint: " << t_write / num_repetitions << " s"
+              << std::endl;
+
+    const auto t_read = time_seconds([&]() {
+        for (size_t r = 0; r < num_repetitions; ++r) {
+            SG::read_checkpoint(file_name, sys);
+        }
+    });
+    std::cout << "read_checkpoint: " << t_read / num_repetitions << " s"
+              << std::endl;
+    std::remove(file_name.c_str());
+    return EXIT_SUCCESS;
+}
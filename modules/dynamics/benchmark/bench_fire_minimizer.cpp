@@ -0,0 +1,145 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+/**
+ * Compare the number of force evaluations and the time to relax a random
+ * network of harmonic bonds to mechanical equilibrium (max force lower than
+ * force_tolerance) with FIREMinimizer, and with damped dynamics
+ * (VerletVelocitiesIntegratorMethod and a LinearDragParticleKernel force).
+ *
+ * Usage: bench_fire_minimizer [num_particles] [force_tolerance] [deltaT]
+ */
+
+#include "fire_minimizer.hpp"
+#include "force_kernels.hpp"
+#include "integrator.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+template <typename TFunction>
+double time_seconds(TFunction &&function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void random_network_system(SG::System &sys, const size_t num_particles) {
+    std::mt19937 gen(3);
+    std::normal_distribution<double> step_dis(0.0, 0.6);
+    std::uniform_int_distribution<size_t> index_dis(0, num_particles - 1);
+    ArrayUtilities::Array3D pos = {{0.0, 0.0, 0.0}};
+    sys.all.particles.resize(num_particles);
+    for (size_t i = 0; i < num_particles; ++i) {
+        sys.all.particles[i].id = i;
+        sys.all.particles[i].pos = pos;
+        pos = ArrayUtilities::plus(
+                pos, {{step_dis(gen), step_dis(gen), step_dis(gen)}});
+    }
+    sys.all.sorted = true;
+    for (size_t i = 0; i + 1 < num_particles; ++i) {
+        sys.bonds.bonds.push_back(std::make_shared<SG::Bond>(i, i + 1));
+    }
+    for (size_t i = 0; i < num_particles / 5; ++i) {
+        const auto a = index_dis(gen);
+        const auto b = index_dis(gen);
+        if (a != b) {
+            sys.bonds.bonds.push_back(std::make_shared<SG::Bond>(a, b));
+        }
+    }
+}
+
+double max_net_force(const SG::System &sys) {
+    double max_force = 0.0;
+    for (const auto &particle : sys.all.particles) {
+        max_force = std::max(max_force,
+                             ArrayUtilities::norm(particle.dynamics.net_force));
+    }
+    return max_force;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t num_particles = argc > 1 ? std::stoul(argv[1]) : 10000;
+    const double force_tolerance = argc > 2 ? std::stod(argv[2]) : 1e-6;
+    const double deltaT = argc > 3 ? std::stod(argv[3]) : 0.02;
+    const size_t max_force_evaluations = 1000000;
+    const SG::HarmonicBondKernel harmonic{10.0, 1.0};
+
+    {
+        SG::System sys;
+        random_network_system(sys, num_particles);
+        SG::IntegratorTwoStep integrator(&sys);
+        integrator.add_force(
+                std::make_shared<SG::PairBondForceT<SG::HarmonicBondKernel>>(
+                        &sys, harmonic));
+        SG::FIREMinimizer minimizer(&sys, &integrator);
+        minimizer.deltaT = deltaT;
+        minimizer.force_tolerance = force_tolerance;
+        minimizer.max_iterations = max_force_evaluations;
+        SG::FIREMinimizer::Result result;
+        const auto t_fire =
+                time_seconds([&]() { result = minimizer.minimize(); });
+        std::cout << "Particles: " << sys.all.particles.size()
+                  << ", bonds: " << sys.bonds.bonds.size() << std::endl;
+        std::cout << "FIREMinimizer: " << result.num_force_evaluations
+                  << " force evaluations, " << t_fire
+                  << " s, max force: " << result.max_force << std::endl;
+    }
+
+    {
+        SG::System sys;
+        random_network_system(sys, num_particles);
+        SG::IntegratorTwoStep integrator(&sys);
+        integrator.integrator_method =
+                std::make_shared<SG::VerletVelocitiesIntegratorMethod>(&sys,
+                                                                       deltaT);
+        integrator.add_force(
+                std::make_shared<SG::PairBondForceT<SG::HarmonicBondKernel>>(
+                        &sys, harmonic));
+        // Close to critical damping of the stiffest bonds.
+        integrator.add_force(std::make_shared<SG::ParticleForceComputeT<
+                                     SG::LinearDragParticleKernel>>(
+                &sys, SG::LinearDragParticleKernel{2.0}));
+        size_t force_evaluations = 0;
+        double max_force = 0.0;
+        const auto t_verlet = time_seconds([&]() {
+            integrator.compute_forces();
+            integrator.compute_net_forces(&sys);
+            do {
+                integrator.update(force_evaluations);
+                ++force_evaluations;
+                max_force = max_net_force(sys);
+            } while (max_force > force_tolerance &&
+                     force_evaluations < max_force_evaluations);
+        });
+        std::cout << "Damped Verlet: " << force_evaluations
+                  << " force evaluations, " << t_verlet
+                  << " s, max force (including drag): " << max_force
+                  << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
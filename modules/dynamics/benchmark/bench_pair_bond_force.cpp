@@ -0,0 +1,177 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+/**
+ * Compare PairBondForce::compute with a per bond search of the particles
+ * (find_particle_and_index, as it was done before the BondTable), with the
+ * index resolved BondTable and the generic force_function, and with the
+ * BondTable and force_function_wlc_petrosyan_bond_table, and with
+ * PairBondForceT<WLCPetrosyanBondKernel>, without std::function.
+ *
+ * The system is a random walk of num_bonds + 1 particles, with ids different
+ * than the indices, connected by BondChain with BondPropertiesPhysical.
+ *
+ * The last run uses num_threads (ForceCompute::num_threads).
+ *
+ * Usage: bench_pair_bond_force [num_bonds] [num_steps] [num_threads]
+ */
+
+#include "force_compute.hpp"
+#include "force_functions.hpp"
+#include "force_kernels.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+template <typename TFunction>
+double time_seconds(TFunction &&function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void random_chain_system(SG::System &sys, const size_t num_bonds) {
+    std::mt19937 gen(42);
+    std::normal_distribution<double> step_dis(0.0, 0.5);
+    const auto properties =
+            std::make_shared<SG::BondPropertiesPhysical>(1.0, 1.0);
+    ArrayUtilities::Array3D pos = {{0.0, 0.0, 0.0}};
+    for (size_t i = 0; i <= num_bonds; ++i) {
+        SG::Particle p;
+        p.id = 2 * i + 1;
+        p.pos = pos;
+        sys.all.particles.push_back(p);
+        pos = ArrayUtilities::plus(
+                pos, {{step_dis(gen), step_dis(gen), step_dis(gen)}});
+    }
+    sys.all.sorted = true;
+    for (size_t i = 0; i < num_bonds; ++i) {
+        auto bond = std::make_shared<SG::BondChain>(
+                sys.all.particles[i].id, sys.all.particles[i + 1].id, 2.0);
+        bond->properties = properties;
+        sys.bonds.bonds.push_back(bond);
+    }
+    sys.bonds.sorted = true;
+}
+
+/** PairBondForce::compute before the BondTable. */
+void compute_with_search(SG::PairBondForce &force_compute,
+                         const SG::System &sys) {
+    force_compute.reset_forces_to_zero();
+    force_compute.reset_bond_forces_to_zero();
+    for (auto &bond_force : force_compute.bond_forces) {
+        const auto [p_a, p_a_index] =
+                sys.all.find_particle_and_index(bond_force.bond->id_a);
+        const auto [p_b, p_b_index] =
+                sys.all.find_particle_and_index(bond_force.bond->id_b);
+        bond_force.force = force_compute.force_function(*p_a, *p_b,
+                                                        *bond_force.bond);
+        const auto half_bond_force =
+                ArrayUtilities::product_scalar(bond_force.force, 0.5);
+        auto &force_on_a = force_compute.particle_forces[p_a_index].force;
+        auto &force_on_b = force_compute.particle_forces[p_b_index].force;
+        force_on_a = ArrayUtilities::plus(force_on_a, half_bond_force);
+        force_on_b = ArrayUtilities::minus(force_on_b, half_bond_force);
+    }
+}
+
+double checksum(const SG::ForceCompute &force_compute) {
+    double sum = 0.0;
+    for (const auto &particle_force : force_compute.particle_forces) {
+        sum += ArrayUtilities::norm(particle_force.force);
+    }
+    return sum;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t num_bonds = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const size_t num_steps = argc > 2 ? std::stoul(argv[2]) : 10;
+    const size_t num_threads = argc > 3 ? std::stoul(argv[3]) : 0;
+    SG::System sys;
+    random_chain_system(sys, num_bonds);
+    std::cout << "Particles: " << sys.all.particles.size()
+              << ", bonds: " << sys.bonds.bonds.size()
+              << ", steps: " << num_steps << std::endl;
+
+    SG::PairBondForce force_compute(&sys, SG::force_function_wlc_petrosyan);
+    const auto t_search = time_seconds([&]() {
+        for (size_t step = 0; step < num_steps; ++step) {
+            compute_with_search(force_compute, sys);
+        }
+    });
+    std::cout << "find_particle_and_index per bond: "
+              << t_search / num_steps << " s/step, checksum: "
+              << checksum(force_compute) << std::endl;
+
+    const auto t_build =
+            time_seconds([&]() { force_compute.update_bond_table(); });
+    std::cout << "BondTable build: " << t_build << " s" << std::endl;
+
+    const auto t_table = time_seconds([&]() {
+        for (size_t step = 0; step < num_steps; ++step) {
+            force_compute.compute();
+        }
+    });
+    std::cout << "BondTable, force_function: " << t_table / num_steps
+              << " s/step, checksum: " << checksum(force_compute)
+              << std::endl;
+
+    force_compute.bond_table_force_function =
+            SG::force_function_wlc_petrosyan_bond_table;
+    const auto t_table_kernel = time_seconds([&]() {
+        for (size_t step = 0; step < num_steps; ++step) {
+            force_compute.compute();
+        }
+    });
+    std::cout << "BondTable, bond_table_force_function: "
+              << t_table_kernel / num_steps
+              << " s/step, checksum: " << checksum(force_compute)
+              << std::endl;
+
+    SG::PairBondForceT<SG::WLCPetrosyanBondKernel> kernel_force_compute(&sys);
+    kernel_force_compute.update_bond_table();
+    const auto t_kernel = time_seconds([&]() {
+        for (size_t step = 0; step < num_steps; ++step) {
+            kernel_force_compute.compute();
+        }
+    });
+    std::cout << "BondTable, PairBondForceT<WLCPetrosyanBondKernel>: "
+              << t_kernel / num_steps
+              << " s/step, checksum: " << checksum(kernel_force_compute)
+              << std::endl;
+
+    force_compute.num_threads = num_threads;
+    const auto t_threads = time_seconds([&]() {
+        for (size_t step = 0; step < num_steps; ++step) {
+            force_compute.compute();
+        }
+    });
+    std::cout << "BondTable, bond_table_force_function, num_threads "
+              << num_threads << ": " << t_threads / num_steps
+              << " s/step, checksum: " << checksum(force_compute)
+              << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,122 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+/**
+ * Thread scaling of IntegratorTwoStep::update, with Integrator::num_threads
+ * from 1 to max_threads (doubling).
+ *
+ * The system is a random walk of num_bonds + 1 particles, connected by
+ * BondChain, with a harmonic PairBondForceT and a linear drag
+ * ParticleForceComputeT. The forces run one after the other, and split the
+ * bonds and particles in blocks in the thread pool of the integrator.
+ *
+ * The checksum has to be equal for all the thread counts.
+ *
+ * Usage: bench_parallel_forces [num_bonds] [num_steps] [max_threads]
+ */
+
+#include "force_kernels.hpp"
+#include "integrator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+
+namespace {
+template <typename TFunction>
+double time_seconds(TFunction &&function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void random_chain_system(SG::System &sys, const size_t num_bonds) {
+    std::mt19937 gen(42);
+    std::normal_distribution<double> step_dis(0.0, 0.5);
+    ArrayUtilities::Array3D pos = {{0.0, 0.0, 0.0}};
+    for (size_t i = 0; i <= num_bonds; ++i) {
+        SG::Particle p;
+        p.id = i;
+        p.pos = pos;
+        sys.all.particles.push_back(p);
+        pos = ArrayUtilities::plus(
+                pos, {{step_dis(gen), step_dis(gen), step_dis(gen)}});
+    }
+    sys.all.sorted = true;
+    for (size_t i = 0; i < num_bonds; ++i) {
+        sys.bonds.bonds.push_back(
+                std::make_shared<SG::BondChain>(i, i + 1, 2.0));
+    }
+    sys.bonds.sorted = true;
+}
+
+double run(const size_t num_bonds,
+           const size_t num_steps,
+           const size_t num_threads) {
+    SG::System sys;
+    random_chain_system(sys, num_bonds);
+    SG::IntegratorTwoStep integrator(&sys);
+    integrator.num_threads = num_threads;
+    integrator.integrator_method =
+            std::make_shared<SG::VerletVelocitiesIntegratorMethod>(&sys,
+                                                                   0.001);
+    integrator.add_force(
+            std::make_shared<SG::PairBondForceT<SG::HarmonicBondKernel>>(
+                    &sys, SG::HarmonicBondKernel{1.0, 0.5}));
+    integrator.add_force(std::make_shared<
+                         SG::ParticleForceComputeT<SG::LinearDragParticleKernel>>(
+            &sys, SG::LinearDragParticleKernel{0.1}));
+    integrator.update(0); // build the bond table
+    const auto t = time_seconds([&]() {
+        for (size_t step = 0; step < num_steps; ++step) {
+            integrator.update(step);
+        }
+    });
+    double checksum = 0.0;
+    for (const auto &particle : sys.all.particles) {
+        checksum += ArrayUtilities::norm(particle.pos);
+    }
+    std::cout << "num_threads " << num_threads << ": " << t / num_steps
+              << " s/step, checksum: " << checksum << std::endl;
+    return t;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t num_bonds = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const size_t num_steps = argc > 2 ? std::stoul(argv[2]) : 10;
+    const size_t max_threads =
+            argc > 3 ? std::stoul(argv[3])
+                     : std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "Bonds: " << num_bonds << ", steps: " << num_steps
+              << ", hardware_concurrency: "
+              << std::thread::hardware_concurrency() << std::endl;
+    const double t_serial = run(num_bonds, num_steps, 1);
+    for (size_t num_threads = 2; num_threads <= max_threads; num_threads *= 2) {
+        const double t = run(num_bonds, num_steps, num_threads);
+        std::cout << "  speedup: " << t_serial / t << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,120 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+/**
+ * Time spent by the caller per frame with TrajectoryWriter::write_frame
+ * (the frame is written by a background thread), compared with writing the
+ * same frame synchronously with std::ofstream. The particles are moved
+ * between frames, standing in for the integration steps.
+ *
+ * Usage: bench_trajectory_io [num_particles] [num_frames] [output_file]
+ */
+
+#include "trajectory_io.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+template <typename TFunction>
+double time_seconds(TFunction &&function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void move_particles(SG::System &sys) {
+    for (auto &particle : sys.all.particles) {
+        particle.pos[0] += 1e-3;
+        particle.dynamics.vel[1] += 1e-3;
+    }
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t num_particles = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const size_t num_frames = argc > 2 ? std::stoul(argv[2]) : 20;
+    const std::string file_name =
+            argc > 3 ? argv[3] : "bench_trajectory_io.sgtraj";
+    SG::System sys;
+    sys.all.particles.resize(num_particles);
+    for (size_t i = 0; i < num_particles; ++i) {
+        sys.all.particles[i].id = i;
+        sys.all.particles[i].pos = {{1.0 * i, 0.0, 0.0}};
+    }
+    std::cout << "Particles: " << num_particles << ", frames: " << num_frames
+              << std::endl;
+
+    double t_sync_write = 0.0;
+    {
+        std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+        const auto t_total = time_seconds([&]() {
+            for (size_t frame = 0; frame < num_frames; ++frame) {
+                move_particles(sys);
+                t_sync_write += time_seconds([&]() {
+                    file.write(reinterpret_cast<const char *>(&frame),
+                               sizeof(frame));
+                    for (const auto &particle : sys.all.particles) {
+                        file.write(reinterpret_cast<const char *>(
+                                           particle.pos.data()),
+                                   3 * sizeof(double));
+                    }
+                    for (const auto &particle : sys.all.particles) {
+                        file.write(reinterpret_cast<const char *>(
+                                           particle.dynamics.vel.data()),
+                                   3 * sizeof(double));
+                    }
+                    for (const auto &particle : sys.all.particles) {
+                        file.write(reinterpret_cast<const char *>(
+                                           particle.dynamics.net_force.data()),
+                                   3 * sizeof(double));
+                    }
+                });
+            }
+            file.flush();
+        });
+        std::cout << "Synchronous ofstream: " << t_sync_write / num_frames
+                  << " s/frame in the caller, total " << t_total << " s"
+                  << std::endl;
+    }
+
+    double t_async_write = 0.0;
+    {
+        const auto t_total = time_seconds([&]() {
+            SG::TrajectoryWriter writer(file_name, sys);
+            for (size_t frame = 0; frame < num_frames; ++frame) {
+                move_particles(sys);
+                t_async_write += time_seconds(
+                        [&]() { writer.write_frame(sys, frame); });
+            }
+            writer.close();
+        });
+        std::cout << "TrajectoryWriter: " << t_async_write / num_frames
+                  << " s/frame in the caller, total " << t_total << " s"
+                  << std::endl;
+    }
+    std::remove(file_name.c_str());
+    return EXIT_SUCCESS;
+}
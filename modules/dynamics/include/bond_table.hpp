@@ -0,0 +1,88 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef SG_BOND_TABLE_HPP
+#define SG_BOND_TABLE_HPP
+
+#include "bond.hpp"
+#include "particle_collection.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace SG {
+
+/**
+ * Precompiled view of a set of bonds, used in the hot loop of
+ * PairBondForce::compute.
+ *
+ * The particles of each bond are resolved to their index in
+ * ParticleCollection::particles, and the parameters used by the bonded
+ * force functions are copied from the Bond and its BondProperties to
+ * contiguous arrays (structure of arrays). Row i of the table corresponds to
+ * input_bonds[i] in @ref build.
+ *
+ * The table depends on the topology (the bonds and the order of the
+ * particles) but not on the positions, so it only needs to be rebuilt when
+ * bonds or particles are added, removed or modified, the parameters of the
+ * bonds are only copied in @ref build.
+ */
+struct BondTable {
+    /** index of the particle id_a of the bond in ParticleCollection */
+    std::vector<size_t> index_a;
+    /** index of the particle id_b of the bond in ParticleCollection */
+    std::vector<size_t> index_b;
+    /** BondChain::length_contour, NaN if the bond is not a BondChain */
+    std::vector<double> contour_length;
+    /** BondPropertiesPhysical::persistence_length, NaN if the properties are
+     * not BondPropertiesPhysical */
+    std::vector<double> persistence_length;
+    /** BondPropertiesPhysical::kT, NaN if the properties are not
+     * BondPropertiesPhysical */
+    std::vector<double> kT;
+    /** number of particles in the collection at build time */
+    size_t num_particles = 0;
+    /** System::topology_version at build time, set by the owner */
+    size_t topology_version = 0;
+    /**
+     * Bonds of each particle, ordered by bond index, to gather the bond
+     * forces per particle without write conflicts between threads.
+     * The bonds of the particle at index p are in
+     * particle_bonds[particle_bonds_offsets[p], particle_bonds_offsets[p+1]),
+     * encoded as 2 * bond_index if the particle is a in the bond, and
+     * 2 * bond_index + 1 if it is b.
+     */
+    std::vector<size_t> particle_bonds_offsets;
+    std::vector<size_t> particle_bonds;
+
+    /**
+     * Resolve the particles of the bonds in all, and copy their parameters.
+     * Throws if a particle of a bond is not found in the collection.
+     * ParticleCollection has to be sorted.
+     */
+    void build(const ParticleCollection &all,
+               const std::vector<const Bond *> &input_bonds);
+    void clear();
+    size_t size() const { return index_a.size(); }
+    bool empty() const { return index_a.empty(); }
+};
+
+} // namespace SG
+#endif
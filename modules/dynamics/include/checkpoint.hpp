@@ -0,0 +1,86 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef SG_CHECKPOINT_HPP
+#define SG_CHECKPOINT_HPP
+
+#include "integrator.hpp"
+#include "system.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace SG {
+
+/**
+ * Write a binary checkpoint with the state of the simulation, to restart it
+ * with @ref read_checkpoint.
+ *
+ * Saved:
+ * - The particles of sys (as one block of memory), conexions and bonds,
+ *   including BondChain contour lengths and BondProperties /
+ *   BondPropertiesPhysical (shared properties are saved once).
+ * - If integrator is not null: the parameters and step counters of the
+ *   integrator method (VerletVelocities, Brownian, LangevinBAOAB) and, for
+ *   each force type, its particle forces (and bond forces), and the seed and
+ *   step of ParticleRandomForceCompute.
+ * - time_step, and the state of RNG::engine() of the calling thread.
+ *
+ * Not saved: collision_neighbor_list (rebuilt from the
+ * particles), force functions and any other
+ * configuration of the integrator, which has to be created again before
+ * read_checkpoint.
+ *
+ * The checkpoint is written to file_name + ".tmp", synced to the disk and
+ * then renamed, so a job interrupted while writing does not corrupt the
+ * previous checkpoint.
+ * Only bonds of type Bond or BondChain are supported.
+ *
+ * @param file_name output file
+ * @param sys system
+ * @param integrator optional integrator
+ * @param time_step current time step of the simulation
+ */
+void write_checkpoint(const std::string &file_name,
+                      const System &sys,
+                      const Integrator *integrator = nullptr,
+                      const uint64_t time_step = 0);
+
+/**
+ * Restore the state saved with @ref write_checkpoint into sys and, if not
+ * null, into integrator, which has to have the same integrator method and
+ * force types (the same types in the same order) than when the checkpoint
+ * was written.
+ *
+ * The whole file is read and validated first: if it throws, sys,
+ * integrator and RNG::engine() are left unchanged.
+ * The particles are replaced. The bonds are updated in place when the
+ * existing bond at the same position has the same type, so the
+ * PairBondForce of integrator keep pointing to valid bonds (their bond
+ * table is rebuilt).
+ *
+ * @return time_step saved in the checkpoint
+ */
+uint64_t read_checkpoint(const std::string &file_name,
+                         System &sys,
+                         Integrator *integrator = nullptr);
+
+} // namespace SG
+#endif
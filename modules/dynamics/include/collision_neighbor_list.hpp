@@ -0,0 +1,132 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef SG_COLLISION_NEIGHBOR_LIST_HPP
+#define SG_COLLISION_NEIGHBOR_LIST_HPP
+
+#include "boundary_conditions.hpp" // from core module
+#include "system.hpp"
+
+#include <array>
+#include <vector>
+
+namespace SG {
+
+/**
+ * Populate System::collision_neighbor_list with the particles closer than
+ * cutoff + skin (the list radius), using a linked-cell (uniform grid) search.
+ *
+ * The particles are binned in cells of size >= list radius, and only the
+ * particles in the 27 cells around each particle are checked, so the
+ * build is O(N) for a homogeneous system.
+ *
+ * Verlet skin: with skin > 0, @ref update only rebuilds the list when a
+ * particle has moved more than skin / 2 since the last build, the list is
+ * still valid for all the pairs closer than cutoff.
+ *
+ * With boundary_condition::PERIODIC, the positions are wrapped into the box
+ * [0, box_size) and the distances use the minimum image convention
+ * (@sa ArrayUtilities::minus_with_boundary_condition_periodic).
+ * With boundary_condition::NONE, the grid covers the bounding box of the
+ * particles at each build.
+ *
+ * The collision_neighbor_list has one ParticleNeighbors per particle, in the
+ * same order than System::all, and the neighbors are particle ids.
+ * With half_list = true, a pair (i, j) is only stored in the particle with
+ * the lower index in System::all, useful to compute pair forces once.
+ */
+class CollisionNeighborListBuilder {
+  public:
+    using Array3D = ArrayUtilities::Array3D;
+    using boundary_condition = ArrayUtilities::boundary_condition;
+
+    /**
+     * @param cutoff interaction distance, has to be positive.
+     * @param skin extra distance for the Verlet list, 0.0 rebuilds the list
+     * at every update.
+     * @param half_list store each pair only once.
+     */
+    explicit CollisionNeighborListBuilder(const double cutoff,
+                                          const double skin = 0.0,
+                                          const bool half_list = false);
+
+    /** Use periodic boundary conditions in a box [0, box_size) */
+    void set_periodic_box(const Array3D &box_size);
+    /** Use no boundary conditions (the default) */
+    void set_no_boundary_condition();
+
+    /**
+     * Rebuild the collision_neighbor_list of sys if it is needed (@ref
+     * needs_rebuild).
+     *
+     * @return true if the list was rebuilt.
+     */
+    bool update(System *sys);
+    /** Rebuild the collision_neighbor_list of sys. */
+    void build(System *sys);
+    /**
+     * True if there is no list yet, the number of particles has changed, or
+     * any particle has moved more than skin / 2 since the last build.
+     */
+    bool needs_rebuild(const System *sys) const;
+
+    /** distance between positions, using the boundary condition */
+    Array3D minus(const Array3D &lhs, const Array3D &rhs) const;
+
+    double cutoff() const { return m_cutoff; }
+    double skin() const { return m_skin; }
+    bool half_list() const { return m_half_list; }
+    boundary_condition get_boundary_condition() const {
+        return m_boundary_condition;
+    }
+    const Array3D &box_size() const { return m_box_size; }
+    /** Number of builds since construction. */
+    size_t num_builds() const { return m_num_builds; }
+    /** Number of cells per dimension of the last build. */
+    const std::array<size_t, 3> &num_cells() const { return m_num_cells; }
+
+  private:
+    void build_cells(const System *sys);
+    size_t cell_coordinate(double coordinate, size_t dim) const;
+
+    double m_cutoff;
+    double m_skin;
+    bool m_half_list;
+    boundary_condition m_boundary_condition = boundary_condition::NONE;
+    Array3D m_box_size = {{1.0, 1.0, 1.0}};
+    Array3D m_box_size_inverse = {{1.0, 1.0, 1.0}};
+    size_t m_num_builds = 0;
+
+    // Grid
+    Array3D m_origin;
+    Array3D m_cell_size;
+    std::array<size_t, 3> m_num_cells = {{0, 0, 0}};
+    /** cell of each particle (index in System::all) */
+    std::vector<size_t> m_particle_cell;
+    /** particles of cell c are m_cell_particles[m_cell_start[c],
+     * m_cell_start[c+1]) */
+    std::vector<size_t> m_cell_start;
+    std::vector<size_t> m_cell_particles;
+    /** positions at the last build, for the Verlet skin */
+    std::vector<Array3D> m_positions_at_build;
+};
+
+} // namespace SG
+#endif
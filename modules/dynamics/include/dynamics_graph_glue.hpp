@@ -45,5 +45,23 @@ struct ParticleGraphGlueData {
 };
 
 ParticleGraphGlueData particles_from_graph(const GraphType &graph);
+
+/**
+ * Create a BondChain per edge of the graph, with the contour length of the
+ * edge, in one pass over the edge list, sorting the bonds once.
+ * Parallel edges between the same vertices result in one bond, with the
+ * contour length of the first edge.
+ * Bonds with a particle of degree 1 are tagged with tag_bond_free_chain,
+ * the rest with tag_bond_contour_length_chain.
+ *
+ * @param graph input spatial graph
+ * @param graph_particle_map map from the vertices of the graph to the ids of
+ * the particles
+ *
+ * @return sorted collection of unique bonds
+ */
+BondCollection make_bonds_from_graph(
+        const GraphType &graph,
+        const ParticleGraphGlueData::graph_particle_map_t &graph_particle_map);
 } // namespace SG
 #endif
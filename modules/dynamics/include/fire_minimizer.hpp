@@ -0,0 +1,88 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef SG_FIRE_MINIMIZER_HPP
+#define SG_FIRE_MINIMIZER_HPP
+
+#include "integrator.hpp"
+#include "system.hpp"
+
+namespace SG {
+
+/**
+ * FIRE (Fast Inertial Relaxation Engine) minimizer, relaxing the particles
+ * of the system to mechanical equilibrium under the force_types of an
+ * Integrator.
+ *
+ * Follows FIRE 2.0 (Guenole et al, Comput. Mater. Sci. 175, 2020):
+ * semi-implicit Euler steps, with the velocities mixed towards the direction
+ * of the forces, and an adaptive time step. When the power P = F.v becomes
+ * negative, the particles are moved back half a step, the velocities are set
+ * to zero and the time step is reduced.
+ *
+ * The forces are computed with Integrator::compute_forces and
+ * Integrator::compute_net_forces (and the collision neighbor list is
+ * updated), using num_threads of the integrator.
+ * The velocities and net forces of the particles are modified.
+ *
+ * Converged when the norm of the net force of every particle is lower than
+ * force_tolerance.
+ */
+struct FIREMinimizer {
+    struct Result {
+        bool converged = false;
+        size_t num_iterations = 0;
+        size_t num_force_evaluations = 0;
+        /** Max norm of the net force of the particles at the end. */
+        double max_force = 0.0;
+    };
+
+    FIREMinimizer(System *sys, Integrator *integrator);
+
+    /** Initial time step. */
+    double deltaT = 0.01;
+    /** If <= 0.0, 10 * deltaT */
+    double deltaT_max = 0.0;
+    /** If <= 0.0, 0.02 * deltaT */
+    double deltaT_min = 0.0;
+    /** Max displacement of a particle per step. */
+    double max_displacement = 0.1;
+    /** Steps with positive power before increasing the time step. */
+    size_t n_min = 5;
+    double f_increase = 1.1;
+    double f_decrease = 0.5;
+    double alpha_start = 0.1;
+    double f_alpha = 0.99;
+
+    double force_tolerance = 1e-6;
+    size_t max_iterations = 100000;
+
+    /** Relax the system until converged, or max_iterations. */
+    Result minimize();
+
+  protected:
+    /** Compute the net forces, returns the max norm of them. */
+    double evaluate_forces(Result &result);
+    System *m_sys;
+    Integrator *m_integrator;
+};
+
+} // namespace SG
+#endif
@@ -21,9 +21,15 @@
 #ifndef SG_FORCE_COMPUTE_HPP
 #define SG_FORCE_COMPUTE_HPP
 
+#include "bond_table.hpp"
+#include "collision_neighbor_list.hpp"
+#include "parallel_tasks.hpp"
 #include "system.hpp"
+#include <cassert>
+#include <cstdint>
 #include <functional>
 #include <set>
+#include <stdexcept>
 
 namespace SG {
 struct ParticleForce {
@@ -61,8 +67,36 @@ struct ForceCompute {
     }
     inline virtual std::string get_type() { return "ForceCompute"; };
 
+    /**
+     * Number of threads used by compute(), 1 (serial) by default, 0 uses
+     * std::thread::hardware_concurrency.
+     * The force functions have to be thread-safe if it is not 1.
+     * Integrator::num_threads sets it before computing the forces.
+     */
+    size_t num_threads = 1;
+    /**
+     * Optional pool used by compute() when num_threads != 1, instead of
+     * creating the threads in each call. Integrator::compute_forces sets it
+     * to the pool of the integrator. It is not owned.
+     */
+    ThreadPool *thread_pool = nullptr;
+
   protected:
     const System *m_sys;
+    /** run_blocks in thread_pool if it is set, otherwise in threads. */
+    template <typename TBlockTask>
+    void run_force_blocks(const size_t num_items,
+                          const size_t threads,
+                          TBlockTask &&block_task,
+                          const size_t min_block_size = 4096) const {
+        if (thread_pool != nullptr && threads > 1) {
+            run_blocks(num_items, *thread_pool,
+                       std::forward<TBlockTask>(block_task), min_block_size);
+        } else {
+            run_blocks(num_items, threads,
+                       std::forward<TBlockTask>(block_task), min_block_size);
+        }
+    }
 };
 
 struct ParticleForceCompute : public ForceCompute {
@@ -78,6 +112,74 @@ struct ParticleForceCompute : public ForceCompute {
     inline virtual std::string get_type() override {
         return "ParticleForceCompute";
     };
+
+  protected:
+    /**
+     * Loop of compute(), adding particle_force(particle) to each particle
+     * force. Used by compute() with force_function, and by
+     * ParticleForceComputeT with an inlined kernel.
+     */
+    template <typename TParticleForce>
+    void compute_with_particle_force(TParticleForce &&particle_force) {
+        reset_forces_to_zero();
+        const auto &particles = m_sys->all.particles;
+        const auto threads = resolve_num_threads(num_threads);
+        if (threads > 1) {
+            run_force_blocks(
+                    particles.size(), threads,
+                    [&](const size_t begin, const size_t end) {
+                        for (size_t index = begin; index < end; ++index) {
+                            auto &current_particle_force =
+                                    particle_forces[index].force;
+                            current_particle_force = ArrayUtilities::plus(
+                                    current_particle_force,
+                                    particle_force(particles[index]));
+                        }
+                    });
+            return;
+        }
+
+        size_t current_particle_index = 0;
+        for (const auto &particle : particles) {
+            auto &current_particle_force =
+                    particle_forces[current_particle_index].force;
+            assert(particle.id ==
+                           particle_forces[current_particle_index].particle_id &&
+                   "particle ids are not synchronized in "
+                   "ParticleForceCompute:compute(), they should be sorted as "
+                   "well as all the particles.");
+            current_particle_force = ArrayUtilities::plus(
+                    current_particle_force, particle_force(particle));
+            current_particle_index++;
+        }
+    }
+};
+
+/**
+ * ParticleForceCompute with the force given by a kernel type instead of a
+ * std::function, so the call is resolved at compile time and can be inlined
+ * in the loop. @sa force_kernels.hpp for the available kernels.
+ *
+ * TParticleKernel has to provide
+ * Array3D operator()(const Particle &) const.
+ */
+template <typename TParticleKernel>
+struct ParticleForceComputeT : public ParticleForceCompute {
+    TParticleKernel kernel;
+
+    explicit ParticleForceComputeT(const System *sys,
+                                   const TParticleKernel &in_kernel =
+                                           TParticleKernel())
+            : ParticleForceCompute(sys), kernel(in_kernel) {}
+
+    void compute() override {
+        const TParticleKernel &k = kernel;
+        this->compute_with_particle_force(
+                [&k](const Particle &particle) { return k(particle); });
+    }
+    inline virtual std::string get_type() override {
+        return "ParticleForceComputeT";
+    };
 };
 
 struct ParticleRandomForceCompute : public ParticleForceCompute {
@@ -106,6 +208,23 @@ struct ParticleRandomForceCompute : public ParticleForceCompute {
         return "ParticleRandomForceCompute";
     };
 
+    /**
+     * With use_counter_based_rng, the random force of each particle is
+     * RNG::counter_based_random_orientation(_modulo, seed, step, particle.id)
+     * and step is incremented after each compute(). The forces are
+     * reproducible from the seed and do not depend on num_threads.
+     * Otherwise (default) force_function is used, drawing from RNG::engine().
+     */
+    void compute() override;
+    /** Enable use_counter_based_rng with the seed, and set step to 0. */
+    void set_seed(const uint64_t in_seed);
+
+    bool use_counter_based_rng = false;
+    uint64_t seed = 0;
+    /** Counter of the calls to compute() with use_counter_based_rng. Store
+     * it, together with the seed, to replay the random forces. */
+    uint64_t step = 0;
+
     /** These variables can only be set via constructor. */
     /** Temperature */
     const double kT = 0.0;
@@ -142,12 +261,38 @@ struct BondForce {
 /**
  * PairBondForce is a ForceCompute that computes the force F_ab only once
  * (per bond) and assign the force to the two particles i.e F_ab = - F_ba
+ *
+ * compute() uses a BondTable built from bond_forces, with the particles of
+ * each bond resolved to their index, avoiding a search of the particles per
+ * bond and step. The table is built on the first compute, and rebuilt if
+ * the number of bonds or particles change, or if System::topology_version
+ * changes (@sa System::invalidate_topology). Call @ref update_bond_table
+ * after modifying bond_forces or the parameters of the bonds (contour
+ * length, properties).
+ *
+ * If bond_table_force_function is set, it is used instead of
+ * force_function, reading the parameters of the bond from the table
+ * instead of from the Bond, for example
+ * force_function_wlc_petrosyan_bond_table.
+ *
+ * With num_threads != 1, the bond forces are computed in parallel, and then
+ * gathered per particle (@sa BondTable::particle_bonds) in parallel, in
+ * the same order than the serial compute, so the result does not depend on
+ * the number of threads.
  */
 struct PairBondForce : public ForceCompute {
     using force_function_t = std::function<ArrayUtilities::Array3D(
             const Particle &, const Particle &, const Bond &)>;
+    /** F_{a,b}(ab_vector, bond_table, bond_index) */
+    using bond_table_force_function_t =
+            std::function<ArrayUtilities::Array3D(
+                    const ArrayUtilities::Array3D &, const BondTable &,
+                    const size_t)>;
     force_function_t force_function;
+    bond_table_force_function_t bond_table_force_function;
     std::vector<BondForce> bond_forces;
+    /** Rows are in the same order than bond_forces. */
+    BondTable bond_table;
 
     using ForceCompute::ForceCompute;
 
@@ -185,6 +330,11 @@ struct PairBondForce : public ForceCompute {
     }
 
     void compute() override;
+    /** Rebuild bond_table from bond_forces and the particles of the system. */
+    void update_bond_table();
+    /** True if bond_table is out of sync with the number of bonds or
+     * particles, or with System::topology_version. */
+    bool bond_table_needs_update() const;
     inline void reset_bond_forces_to_zero() {
         for (auto &bf : bond_forces) {
             std::fill(bf.force.begin(), bf.force.end(), 0);
@@ -194,6 +344,133 @@ struct PairBondForce : public ForceCompute {
     inline virtual std::string get_type() override {
         return "PairBondForce";
     };
+
+  protected:
+    /**
+     * Loop of compute(), with the force F_{a,b} of each bond given by
+     * bond_force_ab(particle_a, particle_b, bond_index).
+     * Used by compute() with the std::function members, and by
+     * PairBondForceT with an inlined kernel.
+     */
+    template <typename TBondForce>
+    void compute_with_bond_force(TBondForce &&bond_force_ab);
+};
+
+template <typename TBondForce>
+void PairBondForce::compute_with_bond_force(TBondForce &&bond_force_ab) {
+    if (bond_table_needs_update()) {
+        update_bond_table();
+    }
+    const auto threads = resolve_num_threads(num_threads);
+    const auto &particles = m_sys->all.particles;
+    if (particle_forces.size() != bond_table.num_particles) {
+        throw std::runtime_error("PairBondForce: the number of particles of "
+                                 "the system has changed.");
+    }
+
+    const auto num_bonds = bond_table.size();
+    if (threads == 1) {
+        reset_forces_to_zero();
+        // Compute and store forces per bond
+        for (size_t bond_index = 0; bond_index < num_bonds; ++bond_index) {
+            const auto p_a_index = bond_table.index_a[bond_index];
+            const auto p_b_index = bond_table.index_b[bond_index];
+            // Bond force is equal to F_{a,b}
+            auto &bond_force = bond_forces[bond_index];
+            bond_force.force = bond_force_ab(particles[p_a_index],
+                                             particles[p_b_index], bond_index);
+            // Translating a bond force using as a reference the force
+            // from particle a to b, (i.e. F_{a,b}) to each particle.
+            // We divide the bond force by half, and apply each half to each
+            // particle, changing the sign. (the particles are always at the
+            // two ends of the bond).
+            const auto half_bond_force =
+                    ArrayUtilities::product_scalar(bond_force.force, 0.5);
+            auto &force_on_a = particle_forces[p_a_index].force;
+            auto &force_on_b = particle_forces[p_b_index].force;
+            // F_{a,b}
+            force_on_a = ArrayUtilities::plus(force_on_a, half_bond_force);
+            // change sign of bond_force for the F_{b,a}
+            force_on_b = ArrayUtilities::minus(force_on_b, half_bond_force);
+        }
+        return;
+    }
+
+    // Compute and store forces per bond, F_{a,b}
+    run_force_blocks(
+            num_bonds, threads, [&](const size_t begin, const size_t end) {
+                for (size_t bond_index = begin; bond_index < end;
+                     ++bond_index) {
+                    bond_forces[bond_index].force = bond_force_ab(
+                            particles[bond_table.index_a[bond_index]],
+                            particles[bond_table.index_b[bond_index]],
+                            bond_index);
+                }
+            });
+
+    // Gather half of the bond forces per particle, in bond order as in the
+    // serial compute: +F_{a,b}/2 to a, -F_{a,b}/2 to b.
+    run_force_blocks(
+            particle_forces.size(), threads,
+            [&](const size_t begin, const size_t end) {
+                for (size_t p = begin; p < end; ++p) {
+                    ArrayUtilities::Array3D force = {{0.0, 0.0, 0.0}};
+                    for (size_t k = bond_table.particle_bonds_offsets[p];
+                         k < bond_table.particle_bonds_offsets[p + 1]; ++k) {
+                        const auto bond_end = bond_table.particle_bonds[k];
+                        const auto half_bond_force =
+                                ArrayUtilities::product_scalar(
+                                        bond_forces[bond_end / 2].force, 0.5);
+                        force = (bond_end % 2 == 0)
+                                        ? ArrayUtilities::plus(force,
+                                                               half_bond_force)
+                                        : ArrayUtilities::minus(
+                                                  force, half_bond_force);
+                    }
+                    particle_forces[p].force = force;
+                }
+            });
+}
+
+/**
+ * PairBondForce with the force F_{a,b} given by a kernel type instead of a
+ * std::function, so the call is resolved at compile time and can be inlined
+ * in the bond loop. The bond parameters are read from the bond_table.
+ * @sa force_kernels.hpp for the available kernels.
+ *
+ * TBondKernel has to provide
+ * Array3D operator()(const Array3D &ab_vector, const BondTable &,
+ *                    const size_t bond_index) const.
+ *
+ * force_function and bond_table_force_function are ignored. Python defined
+ * forces still use PairBondForce with a force_function.
+ */
+template <typename TBondKernel>
+struct PairBondForceT : public PairBondForce {
+    TBondKernel kernel;
+
+    explicit PairBondForceT(const System *sys,
+                            const TBondKernel &in_kernel = TBondKernel())
+            : PairBondForce(sys), kernel(in_kernel) {}
+    PairBondForceT(const System *sys,
+                   const TBondKernel &in_kernel,
+                   const BondProperties::tags_t &in_only_apply_to_bond_with_tags)
+            : PairBondForce(sys, in_only_apply_to_bond_with_tags),
+              kernel(in_kernel) {}
+
+    void compute() override {
+        const TBondKernel &k = kernel;
+        const BondTable &table = bond_table;
+        this->compute_with_bond_force(
+                [&k, &table](const Particle &p_a, const Particle &p_b,
+                             const size_t bond_index) {
+                    return k(ArrayUtilities::minus(p_b.pos, p_a.pos), table,
+                             bond_index);
+                });
+    }
+    inline virtual std::string get_type() override {
+        return "PairBondForceT";
+    };
 };
 
 struct FixedPairBondForce : public PairBondForce {
@@ -208,6 +485,59 @@ struct FixedPairBondForce : public PairBondForce {
     };
 };
 
+/**
+ * PairNeighborForce is a ForceCompute for unbonded pair interactions
+ * (excluded volume, steric repulsion) between the particles of
+ * System::collision_neighbor_list, populated by a
+ * CollisionNeighborListBuilder.
+ *
+ * Each pair is computed once (from the particle with lower index in
+ * System::all), the force F_ab returned by force_function is added to a, and
+ * -F_ab to b. A half list (CollisionNeighborListBuilder with half_list = true)
+ * avoids visiting the pairs twice, but a full list gives the same result.
+ * Only the pairs closer than cutoff are computed.
+ *
+ * The neighbor list has to be updated after the particles move, see
+ * Integrator::collision_neighbor_list_builder.
+ *
+ * With num_threads != 1 and a full list, each particle gathers the forces of
+ * all its neighbors in parallel (each pair is computed twice, but without
+ * write conflicts). A half list is always computed serially.
+ */
+struct PairNeighborForce : public ForceCompute {
+    /** F_ab: force on a due to b, given the vector from a to b (minimum
+     * image in periodic boxes). */
+    using force_function_t = std::function<ArrayUtilities::Array3D(
+            const Particle &, const Particle &,
+            const ArrayUtilities::Array3D &)>;
+    force_function_t force_function;
+    /** Provides the boundary conditions for the distances between
+     * particles. */
+    std::shared_ptr<const CollisionNeighborListBuilder> neighbor_list_builder;
+    /** Pairs at a distance >= cutoff are ignored. It cannot be larger than
+     * the cutoff of neighbor_list_builder, the pairs beyond it are not
+     * guaranteed to be in the list. */
+    double cutoff;
+
+    /**
+     * @param sys shared system
+     * @param in_neighbor_list_builder builder of the collision_neighbor_list
+     * of sys.
+     * @param in_force_function F_ab(a, b, ab_vector)
+     * @param in_cutoff if <= 0.0, the cutoff of the builder is used.
+     * Throws if it is larger than the cutoff of the builder.
+     */
+    PairNeighborForce(const System *sys,
+                      std::shared_ptr<const CollisionNeighborListBuilder>
+                              in_neighbor_list_builder,
+                      force_function_t in_force_function = force_function_t(),
+                      const double in_cutoff = 0.0);
+
+    void compute() override;
+    inline virtual std::string get_type() override {
+        return "PairNeighborForce";
+    };
+};
 
 } // namespace SG
 #endif
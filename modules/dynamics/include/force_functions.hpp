@@ -25,13 +25,26 @@
 
 #include "array_utilities.hpp"
 #include "bond.hpp"
+#include "bond_table.hpp"
 #include "bonded_forces.hpp"
 #include "particle.hpp"
+#include "unbonded_forces.hpp"
 
 namespace SG {
 using force_function_particles_with_bond_t =
         std::function<ArrayUtilities::Array3D(
                 const Particle &, const Particle &, const Bond &)>;
+/** Force on a due to b, given the vector from a to b. */
+using force_function_particles_with_distance_t =
+        std::function<ArrayUtilities::Array3D(const Particle &,
+                                              const Particle &,
+                                              const ArrayUtilities::Array3D &)>;
+/** Force F_{a,b} of row bond_index of a BondTable, given the vector from a to
+ * b (@sa PairBondForce::bond_table_force_function). */
+using force_function_bond_table_t =
+        std::function<ArrayUtilities::Array3D(const ArrayUtilities::Array3D &,
+                                              const BondTable &,
+                                              const size_t)>;
 
 
 /**
@@ -54,5 +67,62 @@ using force_function_particles_with_bond_t =
  */
 ArrayUtilities::Array3D force_function_wlc_petrosyan(
         const SG::Particle &a, const SG::Particle &b, const SG::Bond &chain);
+
+/**
+ * force_function_wlc_petrosyan with the parameters of the bond already
+ * resolved.
+ *
+ * @param ab_vector end to end vector, from the first to the second particle
+ * @param contour_length
+ * @param persistence_length
+ * @param kT
+ *
+ * @return F_{a,b}
+ */
+ArrayUtilities::Array3D force_function_wlc_petrosyan_with_parameters(
+        const ArrayUtilities::Array3D &ab_vector,
+        const double contour_length,
+        const double persistence_length,
+        const double kT);
+
+/**
+ * force_function_wlc_petrosyan using the contour_length, persistence_length
+ * and kT of row bond_index of the table.
+ * Throws if the bond was not a BondChain with BondPropertiesPhysical.
+ *
+ * @return F_{a,b}
+ */
+ArrayUtilities::Array3D
+force_function_wlc_petrosyan_bond_table(const ArrayUtilities::Array3D &ab_vector,
+                                        const BondTable &table,
+                                        const size_t bond_index);
+
+/**
+ * force_function for unbonded particles (@sa PairNeighborForce) applying
+ * force_soft_sphere(distance, sigma, stiffness).
+ * The force on a points away from b.
+ *
+ * @param sigma contact distance, if sigma <= 0.0, the sum of the radius of
+ * the particles is used.
+ * @param stiffness
+ *
+ * @return force function F_{a,b}(a, b, ab_vector)
+ */
+force_function_particles_with_distance_t
+make_force_function_soft_sphere(const double sigma, const double stiffness);
+
+/**
+ * force_function for unbonded particles (@sa PairNeighborForce) applying
+ * force_wca(distance, sigma, epsilon).
+ * The force on a points away from b.
+ *
+ * @param sigma LJ diameter, if sigma <= 0.0, the sum of the radius of
+ * the particles is used.
+ * @param epsilon LJ energy
+ *
+ * @return force function F_{a,b}(a, b, ab_vector)
+ */
+force_function_particles_with_distance_t
+make_force_function_wca(const double sigma, const double epsilon);
 } // end namespace SG
 #endif
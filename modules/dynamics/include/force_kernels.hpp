@@ -0,0 +1,147 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef SG_FORCE_KERNELS_HPP
+#define SG_FORCE_KERNELS_HPP
+
+#include "array_utilities.hpp"
+#include "bond_table.hpp"
+#include "bonded_forces.hpp"
+#include "particle.hpp"
+#include "unbonded_forces.hpp"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+/**
+ * Force kernels: small function objects with the force of a bond or a
+ * particle, used as template parameters of PairBondForceT and
+ * ParticleForceComputeT. Unlike the std::function members of PairBondForce
+ * and ParticleForceCompute, the call to a kernel is known at compile time and
+ * can be inlined in the loop over bonds or particles.
+ */
+namespace SG {
+
+/**
+ * Worm-like chain force of Petrosyan, using the contour_length,
+ * persistence_length and kT of the BondTable.
+ * @sa force_function_wlc_petrosyan_bond_table
+ */
+struct WLCPetrosyanBondKernel {
+    /**
+     * F_{a,b} with the parameters of the bond already resolved.
+     * The relative extension is clamped to 0.98.
+     *
+     * @param ab_vector end to end vector, from the first to the second particle
+     */
+    static inline ArrayUtilities::Array3D
+    force(const ArrayUtilities::Array3D &ab_vector,
+          const double contour_length,
+          const double persistence_length,
+          const double kT) {
+        const auto ab_modulo = ArrayUtilities::norm(ab_vector);
+        // handle chains with same start/end particles (zero force)
+        if (ab_modulo <= 2.0 * std::numeric_limits<double>::epsilon()) {
+            return ArrayUtilities::Array3D();
+        }
+        double relative_extension = ab_modulo / contour_length;
+        // TODO handle relative_extension ~ 1 (wlc_petrosyan_normalized
+        // would diverge)
+        if (relative_extension > 0.98) {
+            relative_extension = 0.98;
+        }
+        const auto force_modulo = force_extension_wlc_petrosyan(
+                relative_extension, persistence_length, kT);
+        // ab_vector/ab_modulo is the unitary vector, in the direction F_{a,b}
+        return ArrayUtilities::product_scalar(ab_vector,
+                                              force_modulo / ab_modulo);
+    }
+
+    inline ArrayUtilities::Array3D
+    operator()(const ArrayUtilities::Array3D &ab_vector,
+               const BondTable &table,
+               const size_t bond_index) const {
+        const auto contour_length = table.contour_length[bond_index];
+        const auto persistence_length = table.persistence_length[bond_index];
+        const auto kT = table.kT[bond_index];
+        // NaN parameters: missing BondChain or BondPropertiesPhysical
+        if (std::isnan(persistence_length) || std::isnan(kT) ||
+            std::isnan(contour_length)) {
+            throw std::runtime_error(
+                    "To use force_extension_wlc_petrosyan, the bonds need to "
+                    "be BondChain and have properties of type "
+                    "BondPropertiesPhysical with persistence_length and kT "
+                    "populated");
+        }
+        return force(ab_vector, contour_length, persistence_length, kT);
+    }
+};
+
+/**
+ * Harmonic spring, with the same stiffness and rest_length for all the
+ * bonds.
+ * \f[ \vec{F}_{ab} = k (r - r_0) \hat{r}_{ab} \f]
+ * Attractive (towards b) when the bond is stretched beyond rest_length.
+ */
+struct HarmonicBondKernel {
+    double stiffness = 1.0;
+    double rest_length = 0.0;
+
+    inline ArrayUtilities::Array3D
+    operator()(const ArrayUtilities::Array3D &ab_vector,
+               const BondTable & /* table */,
+               const size_t /* bond_index */) const {
+        const auto ab_modulo = ArrayUtilities::norm(ab_vector);
+        if (ab_modulo <= 2.0 * std::numeric_limits<double>::epsilon()) {
+            return ArrayUtilities::Array3D();
+        }
+        return ArrayUtilities::product_scalar(
+                ab_vector, stiffness * (ab_modulo - rest_length) / ab_modulo);
+    }
+};
+
+/**
+ * Linear drag, proportional to the velocity of the particle.
+ * @sa force_linear_drag
+ */
+struct LinearDragParticleKernel {
+    double damping_parameter = 1.0;
+
+    inline ArrayUtilities::Array3D operator()(const Particle &particle) const {
+        return force_linear_drag(damping_parameter, particle.dynamics.vel);
+    }
+};
+
+/**
+ * Stokes drag of a sphere of the radius of the particle.
+ * @sa force_linear_drag
+ */
+struct StokesDragParticleKernel {
+    double fluid_viscosity = 1.0;
+
+    inline ArrayUtilities::Array3D operator()(const Particle &particle) const {
+        return force_linear_drag(particle.material.radius, fluid_viscosity,
+                                 particle.dynamics.vel);
+    }
+};
+
+} // namespace SG
+#endif
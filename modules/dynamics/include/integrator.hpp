@@ -21,6 +21,7 @@
 #ifndef SG_INTEGRATOR_HPP
 #define SG_INTEGRATOR_HPP
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -76,13 +77,95 @@ struct VerletVelocitiesIntegratorMethod : public TwoStepIntegratorMethod {
     void integrateStepTwo() override;
 };
 
+/**
+ * Overdamped Brownian dynamics (Euler-Maruyama), without inertia:
+ * \f[ r(t+\Delta t) = r(t) + \frac{\Delta t}{\gamma} F(t)
+ *      + \sqrt{2 k_B T \Delta t / \gamma} \, \xi \f]
+ * with \f$\xi\f$ a standard normal vector.
+ *
+ * The drag and the random force are part of the method, do not add a
+ * ParticleRandomForceCompute or a drag force to the integrator.
+ * The time step is limited by the stiffness of the forces, not by the mass.
+ *
+ * integrateStepOne moves the particles with the net_force of the previous
+ * update (compute them before the first update if the initial forces are not
+ * zero), and stores the displacement per deltaT in the velocity.
+ * integrateStepTwo does nothing.
+ *
+ * The noise is RNG::counter_based_normal(seed, step, particle id), step is
+ * incremented after each integrateStepOne: a run is reproducible from the
+ * seed.
+ */
+struct BrownianIntegratorMethod : public TwoStepIntegratorMethod {
+    /**
+     * @param sys system
+     * @param deltaT_input time step
+     * @param kT_input temperature
+     * @param gamma_input drag coefficient, has to be positive
+     * @param seed_input seed of the noise
+     */
+    BrownianIntegratorMethod(System *sys,
+                             double deltaT_input,
+                             double kT_input,
+                             double gamma_input,
+                             uint64_t seed_input = 0);
+    double kT;
+    double gamma;
+    uint64_t seed;
+    uint64_t step = 0;
+
+    void integrate() override{};
+    void integrateStepOne() override;
+    void integrateStepTwo() override{};
+};
+
+/**
+ * Langevin dynamics with the BAOAB splitting of Leimkuhler and Matthews:
+ * B (half kick), A (half drift), O (exact Ornstein-Uhlenbeck on the
+ * velocities), A (half drift), forces, B (half kick).
+ * The O step is
+ * \f[ v = c_1 v + \sqrt{(1 - c_1^2) k_B T / m} \, \xi,
+ *      \quad c_1 = e^{-\gamma \Delta t / m} \f]
+ * Configurational averages are accurate for much larger time steps than
+ * with a random force and a drag added to VerletVelocitiesIntegratorMethod.
+ *
+ * The drag and the random force are part of the method, do not add a
+ * ParticleRandomForceCompute or a drag force to the integrator.
+ *
+ * integrateStepOne fuses B, A, O, A in one pass over the particles.
+ * integrateStepTwo is the same as in VerletVelocitiesIntegratorMethod.
+ * The noise is reproducible from the seed, as in BrownianIntegratorMethod.
+ */
+struct LangevinBAOABIntegratorMethod : public TwoStepIntegratorMethod {
+    /**
+     * @param sys system
+     * @param deltaT_input time step
+     * @param kT_input temperature
+     * @param gamma_input drag coefficient, has to be positive
+     * @param seed_input seed of the noise
+     */
+    LangevinBAOABIntegratorMethod(System *sys,
+                                  double deltaT_input,
+                                  double kT_input,
+                                  double gamma_input,
+                                  uint64_t seed_input = 0);
+    double kT;
+    double gamma;
+    uint64_t seed;
+    uint64_t step = 0;
+
+    void integrate() override{};
+    void integrateStepOne() override;
+    void integrateStepTwo() override;
+};
+
 // 1. Collect, and sum all the forces affecting every particle.
 // 2. Integrate equation to get new positions from current state of the system
 //    plus the forces.
 class Integrator {
   public:
     explicit Integrator(System *sys) : m_sys(sys), all_old_state(sys->all){};
-    virtual ~Integrator(){};
+    virtual ~Integrator();
     virtual void update(unsigned int time_step) = 0;
     /// Compute the sum of forces for each particle and store it in Particle
     virtual void compute_net_forces(System *sys) const;
@@ -114,9 +197,44 @@ class Integrator {
      */
     std::vector<std::shared_ptr<ForceCompute>> force_types;
 
+    /**
+     * Optional. If set, it updates the collision_neighbor_list of the system
+     * after the positions change, before computing the forces
+     * (@sa PairNeighborForce). With a Verlet skin the list is only rebuilt
+     * when needed.
+     */
+    std::shared_ptr<CollisionNeighborListBuilder>
+            collision_neighbor_list_builder;
+    /** Update the collision_neighbor_list, if there is a builder.
+     * @return true if the list was rebuilt.
+     */
+    bool update_collision_neighbor_list();
+
+    /**
+     * Number of threads to compute the forces and their sum per particle,
+     * 1 (serial) by default, 0 uses std::thread::hardware_concurrency.
+     * The threads are created once, in a ThreadPool owned by the integrator
+     * that is passed to the force_types (@sa ForceCompute::thread_pool).
+     * If there are at least as many force_types as threads, they are
+     * computed concurrently, one per thread. Otherwise they are computed one
+     * after the other, each one using all the threads.
+     * The force functions have to be thread-safe.
+     */
+    size_t num_threads = 1;
+    /** Compute all the force_types, using num_threads. */
+    void compute_forces();
+
   protected:
     System *m_sys;
     ParticleCollection all_old_state;
+    /**
+     * Pool with num_threads threads, created on first use and recreated if
+     * num_threads changes. nullptr if num_threads is 1.
+     */
+    ThreadPool *thread_pool() const;
+
+  private:
+    mutable std::unique_ptr<ThreadPool> m_thread_pool;
 };
 
 struct IntegratorTwoStep : public Integrator {
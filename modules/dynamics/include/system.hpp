@@ -22,6 +22,8 @@
 #define SG_SYSTEM_HPP
 
 #include <memory> // for std::enable_shared_from_this
+#include <utility>
+#include <vector>
 
 #include "bond_collection.hpp"
 #include "particle_collection.hpp"
@@ -38,6 +40,17 @@ struct System : public std::enable_shared_from_this<System> {
     ParticleNeighborsCollection conexions;
     /** Dynamic neighbors per particle based on positions. */
     ParticleNeighborsCollection collision_neighbor_list;
+    /**
+     * Incremented by @ref invalidate_topology. Caches that depend on the
+     * topology, as PairBondForce::bond_table, are rebuilt when it changes.
+     */
+    size_t topology_version = 0;
+    /**
+     * Call after modifying the particles or bonds of the system without
+     * changing their number: reordering the particles, or changing the
+     * particle ids of the bonds.
+     */
+    void invalidate_topology();
     // Helpers to get references of data.
     ArrayUtilities::Array3D &get_position(size_t index);
     const ArrayUtilities::Array3D &get_position(size_t index) const;
@@ -53,32 +66,35 @@ struct System : public std::enable_shared_from_this<System> {
     auto all_accelerations_copy();
 };
 
+/**
+ * Unique pairs of particle ids (first < second) from conexions, sorted.
+ * The pairs are collected and sorted once, O(B log B) for B conexions.
+ *
+ * @param sys
+ *
+ * @return sorted vector with unique pairs of particle ids
+ */
+std::vector<std::pair<size_t, size_t>> unique_bond_pairs(const System *sys);
+
 /**
  * Get unique bonds from conexions
  *
  * @param sys
  *
- * @return vector with unique Bonds
+ * @return vector with unique Bonds, sorted
  */
 std::vector<Bond> unique_bonds(const System *sys);
 
 template <typename TBond>
 BondCollection make_unique_bonds_from_system_conexions(const System *sys) {
     BondCollection bond_collection;
-    bond_collection.sorted = true;
     auto &bonds = bond_collection.bonds;
-    for (const auto &particle_neighbor : sys->conexions) {
-        const auto source_particle_id = particle_neighbor.particle_id;
-        for (const auto &neigh : particle_neighbor.neighbors) {
-            auto bond_ptr = std::make_shared<TBond>(source_particle_id, neigh);
-            sort(*bond_ptr);
-            auto found = bond_collection.find_bond(*bond_ptr);
-            if (found == std::end(bonds)) {
-                bonds.push_back(bond_ptr);
-                bond_collection.sort();
-            }
-        }
+    const auto pairs = unique_bond_pairs(sys);
+    bonds.reserve(pairs.size());
+    for (const auto &pair : pairs) {
+        bonds.push_back(std::make_shared<TBond>(pair.first, pair.second));
     }
+    bond_collection.sorted = true;
     return bond_collection;
 }
 } // namespace SG
@@ -0,0 +1,165 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef SG_TRAJECTORY_IO_HPP
+#define SG_TRAJECTORY_IO_HPP
+
+#include "system.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SG {
+
+/**
+ * Binary trajectory format (.sgtraj), append-only.
+ *
+ * Header, written once:
+ * - magic "SGTRAJ01" (8 bytes), uint32 version, uint32 contents
+ *   (TrajectoryContents flags), uint64 num_particles, uint64 num_bonds.
+ * - Per particle: uint64 id, double mass, double radius, double volume.
+ * - Per bond: uint64 id_a, uint64 id_b.
+ *
+ * Then fixed size frames: uint64 time_step, positions (num_particles * 3
+ * doubles, x y z per particle), and if present in contents, velocities and
+ * net forces with the same layout.
+ *
+ * Numbers are written in the byte order of the machine (little endian in
+ * all the supported platforms). The particles are in the order of
+ * System::all when the writer was created, and the number of particles
+ * cannot change.
+ */
+enum TrajectoryContents : uint32_t {
+    TRAJECTORY_POSITIONS = 0, // always written
+    TRAJECTORY_VELOCITIES = 1u << 0,
+    TRAJECTORY_FORCES = 1u << 1,
+};
+
+/**
+ * Write frames of the system to a binary trajectory file.
+ *
+ * write_frame copies the state of the particles to a buffer and returns,
+ * the buffer is written to disk by a background thread. There are two
+ * buffers: write_frame only waits if the previous frame has not been
+ * written yet (the disk is slower than the frame rate).
+ *
+ * Errors in the background thread are thrown by the next call to
+ * write_frame, flush or close.
+ */
+class TrajectoryWriter {
+  public:
+    /**
+     * Open file_name (truncating it) and write the header with the topology
+     * of sys (particles and bonds).
+     *
+     * @param file_name output file
+     * @param sys system
+     * @param contents TrajectoryContents flags: what is written per frame
+     * besides the positions.
+     */
+    TrajectoryWriter(const std::string &file_name,
+                     const System &sys,
+                     const uint32_t contents = TRAJECTORY_VELOCITIES |
+                                               TRAJECTORY_FORCES);
+    TrajectoryWriter(const TrajectoryWriter &) = delete;
+    TrajectoryWriter &operator=(const TrajectoryWriter &) = delete;
+    /** Calls close, errors are ignored. */
+    ~TrajectoryWriter();
+
+    /** Copy the state of the particles of sys and queue it to be written. */
+    void write_frame(const System &sys, const uint64_t time_step);
+    /** Wait until the queued frame is written and flushed to the file. */
+    void flush();
+    /** Flush, stop the background thread and close the file. */
+    void close();
+
+    size_t num_frames_written() const;
+    uint32_t contents() const { return m_contents; }
+
+  private:
+    void writer_loop();
+    void rethrow_error();
+
+    std::ofstream m_file;
+    uint32_t m_contents;
+    size_t m_num_particles;
+    /** Buffer being filled by write_frame. */
+    std::vector<char> m_front_buffer;
+    /** Buffer being written by the background thread. */
+    std::vector<char> m_back_buffer;
+    bool m_back_buffer_pending = false;
+    bool m_stop = false;
+    bool m_closed = false;
+    size_t m_num_frames_written = 0;
+    std::exception_ptr m_error;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::thread m_thread;
+};
+
+/**
+ * Read a binary trajectory written with TrajectoryWriter.
+ * The frames have a fixed size, read_frame accesses any frame directly.
+ * An incomplete last frame (for example, from a simulation that is still
+ * running) is ignored.
+ */
+class TrajectoryReader {
+  public:
+    explicit TrajectoryReader(const std::string &file_name);
+
+    size_t num_particles() const { return m_particle_ids.size(); }
+    size_t num_bonds() const { return m_bond_ids.size() / 2; }
+    uint32_t contents() const { return m_contents; }
+    /** Number of complete frames in the file, checked on each call. */
+    size_t num_frames();
+
+    /**
+     * System with the particles (ids, material) and bonds (of type Bond) of
+     * the header, and the state of the first frame if any.
+     */
+    std::shared_ptr<System> make_system();
+    /**
+     * Set the positions (and velocities and net forces if present) of frame
+     * frame_index into the particles of sys, which have to be in the same
+     * order than in the header (@sa make_system).
+     *
+     * @return time_step of the frame
+     */
+    uint64_t read_frame(const size_t frame_index, System &sys);
+
+  private:
+    std::ifstream m_file;
+    uint32_t m_contents;
+    std::vector<uint64_t> m_particle_ids;
+    std::vector<double> m_particle_material; // mass, radius, volume
+    std::vector<uint64_t> m_bond_ids;        // id_a, id_b
+    std::streamoff m_header_size;
+    std::streamoff m_frame_size;
+    std::vector<char> m_buffer;
+};
+
+} // namespace SG
+#endif
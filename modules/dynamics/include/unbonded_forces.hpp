@@ -60,6 +60,49 @@ force_linear_drag(double sphere_radius,
                              velocity);
 }
 
+/**
+ * Soft sphere (harmonic) repulsion between two particles,
+ * with potential \f[ U = \frac{k}{2} (\sigma - r)^2 \f] for
+ * \f$ r < \sigma \f$, and 0 otherwise.
+ *
+ * @param distance between the particles (r)
+ * @param sigma contact distance, for example the sum of the radii.
+ * @param stiffness k
+ *
+ * @return modulo of the force, positive (repulsive) or 0.0.
+ */
+inline double force_soft_sphere(const double &distance,
+                                const double &sigma,
+                                const double &stiffness) {
+    return distance < sigma ? stiffness * (sigma - distance) : 0.0;
+}
+
+/**
+ * Weeks-Chandler-Andersen (WCA) repulsion: Lennard-Jones potential
+ * truncated at its minimum \f$ r_c = 2^{1/6} \sigma \f$ and shifted by
+ * \f$ \epsilon \f$, so it is purely repulsive.
+ * \f[ F = \frac{24 \epsilon}{r} \left[ 2 \left(\frac{\sigma}{r}\right)^{12} -
+ * \left(\frac{\sigma}{r}\right)^{6} \right] \f] for \f$ r < r_c \f$.
+ *
+ * @param distance between the particles (r)
+ * @param sigma LJ diameter
+ * @param epsilon LJ energy
+ *
+ * @return modulo of the force, positive (repulsive) or 0.0.
+ */
+inline double force_wca(const double &distance,
+                        const double &sigma,
+                        const double &epsilon) {
+    // 2^{1/6}
+    constexpr double wca_cutoff_factor = 1.122462048309373;
+    if (distance >= wca_cutoff_factor * sigma) {
+        return 0.0;
+    }
+    const double s2 = sigma * sigma / (distance * distance);
+    const double s6 = s2 * s2 * s2;
+    return 24.0 * epsilon * (2.0 * s6 * s6 - s6) / distance;
+}
+
 // TODO: Add Newtonian fluid: shear_stress = shear_viscosity * du/dy
 // where du/dy is the derivative of the velocity component that is parallel
 // to the direction of shear, relative to displacement in the perpendicular
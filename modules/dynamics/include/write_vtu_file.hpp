@@ -74,6 +74,21 @@ void read_vtu_bond_ids(vtkUnstructuredGrid *ugrid, System *sys);
  * @sa read_vtu_file
  */
 void read_vtu_bond_contour_length(vtkUnstructuredGrid *ugrid, System *sys);
+
+/**
+ * Convert the frames of a binary trajectory (@sa TrajectoryWriter) to .vtu
+ * files, for visualization. The file of each frame is
+ * output_prefix + "_" + time_step + ".vtu".
+ *
+ * @param trajectory_file_name input trajectory
+ * @param output_prefix prefix of the output files, including folder.
+ * @param stride convert one of each stride frames.
+ *
+ * @return number of files written
+ */
+size_t write_vtu_files_from_trajectory(const std::string &trajectory_file_name,
+                                       const std::string &output_prefix,
+                                       const size_t stride = 1);
 } // namespace SG
 #endif // SG_USING_VTK
 #endif // header guard
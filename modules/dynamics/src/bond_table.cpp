@@ -0,0 +1,97 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "bond_table.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace SG {
+
+void BondTable::clear() {
+    index_a.clear();
+    index_b.clear();
+    contour_length.clear();
+    persistence_length.clear();
+    kT.clear();
+    num_particles = 0;
+    topology_version = 0;
+    particle_bonds_offsets.clear();
+    particle_bonds.clear();
+}
+
+void BondTable::build(const ParticleCollection &all,
+                      const std::vector<const Bond *> &input_bonds) {
+    clear();
+    const auto num_bonds = input_bonds.size();
+    index_a.reserve(num_bonds);
+    index_b.reserve(num_bonds);
+    contour_length.reserve(num_bonds);
+    persistence_length.reserve(num_bonds);
+    kT.reserve(num_bonds);
+    num_particles = all.particles.size();
+
+    const auto not_found = std::numeric_limits<size_t>::max();
+    const auto nan = std::numeric_limits<double>::quiet_NaN();
+    // ids are usually equal to the index, avoid the binary search.
+    const auto index_of = [&all, &not_found](const size_t id) -> size_t {
+        if (id < all.particles.size() && all.particles[id].id == id) {
+            return id;
+        }
+        const auto index = all.find_index(id);
+        if (index == not_found) {
+            throw std::runtime_error("BondTable: particle id " +
+                                     std::to_string(id) +
+                                     " of a bond not found.");
+        }
+        return index;
+    };
+    for (const auto *bond : input_bonds) {
+        index_a.push_back(index_of(bond->id_a));
+        index_b.push_back(index_of(bond->id_b));
+        const auto *chain = dynamic_cast<const BondChain *>(bond);
+        contour_length.push_back(chain ? chain->length_contour : nan);
+        const auto *physical = dynamic_cast<const BondPropertiesPhysical *>(
+                bond->properties.get());
+        persistence_length.push_back(physical ? physical->persistence_length
+                                              : nan);
+        kT.push_back(physical ? physical->kT : nan);
+    }
+
+    // Counting sort of the bond ends per particle, keeps the bond order.
+    particle_bonds_offsets.assign(num_particles + 1, 0);
+    for (size_t bond = 0; bond < num_bonds; ++bond) {
+        ++particle_bonds_offsets[index_a[bond] + 1];
+        ++particle_bonds_offsets[index_b[bond] + 1];
+    }
+    for (size_t p = 0; p < num_particles; ++p) {
+        particle_bonds_offsets[p + 1] += particle_bonds_offsets[p];
+    }
+    particle_bonds.resize(2 * num_bonds);
+    std::vector<size_t> fill(particle_bonds_offsets.begin(),
+                             particle_bonds_offsets.end() - 1);
+    for (size_t bond = 0; bond < num_bonds; ++bond) {
+        particle_bonds[fill[index_a[bond]]++] = 2 * bond;
+        particle_bonds[fill[index_b[bond]]++] = 2 * bond + 1;
+    }
+}
+
+} // namespace SG
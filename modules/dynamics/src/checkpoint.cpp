@@ -0,0 +1,641 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "checkpoint.hpp"
+#include "rng.hpp" // from core module
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace SG {
+
+namespace {
+constexpr char checkpoint_magic[8] = {'S', 'G', 'C', 'H', 'K', 'P', 'T', '1'};
+constexpr uint32_t checkpoint_version = 1;
+constexpr uint64_t no_properties = std::numeric_limits<uint64_t>::max();
+
+static_assert(std::is_trivially_copyable<Particle>::value,
+              "The particles are saved as a block of memory.");
+static_assert(std::is_trivially_copyable<ArrayUtilities::Array3D>::value,
+              "The forces are saved as a block of memory.");
+
+enum class BondKind : uint64_t { BOND = 0, BOND_CHAIN = 1 };
+/** Bonds are written as an array of records. */
+struct BondRecord {
+    uint64_t kind;
+    uint64_t id_a;
+    uint64_t id_b;
+    double length_contour;
+    uint64_t properties;
+};
+
+enum class PropertiesKind : uint8_t { PROPERTIES = 0, PHYSICAL = 1 };
+enum class MethodKind : uint8_t {
+    NONE = 0,
+    VERLET_VELOCITIES = 1,
+    BROWNIAN = 2,
+    LANGEVIN_BAOAB = 3,
+    OTHER = 255
+};
+
+/** Small values go through the buffer of the stream, large blocks (the
+ * particles) are passed by the stream directly to the file, without copies. */
+struct OutputBuffer {
+    std::ofstream &file;
+    explicit OutputBuffer(std::ofstream &file) : file(file) {}
+    void write_bytes(const void *source, const size_t size) {
+        file.write(static_cast<const char *>(source),
+                   static_cast<std::streamsize>(size));
+    }
+    template <typename T> void write(const T &value) {
+        static_assert(std::is_trivially_copyable<T>::value, "");
+        write_bytes(&value, sizeof(T));
+    }
+    void write_string(const std::string &value) {
+        write<uint64_t>(value.size());
+        write_bytes(value.data(), value.size());
+    }
+    template <typename T> void write_vector(const std::vector<T> &values) {
+        static_assert(std::is_trivially_copyable<T>::value, "");
+        write<uint64_t>(values.size());
+        write_bytes(values.data(), values.size() * sizeof(T));
+    }
+};
+
+struct InputBuffer {
+    std::ifstream &file;
+    size_t size;
+    size_t position = 0;
+    InputBuffer(std::ifstream &file, const size_t size)
+            : file(file), size(size) {}
+    void read_bytes(void *destination, const size_t num_bytes) {
+        if (num_bytes > size - position) {
+            throw std::runtime_error("read_checkpoint: truncated checkpoint.");
+        }
+        file.read(static_cast<char *>(destination),
+                  static_cast<std::streamsize>(num_bytes));
+        if (!file) {
+            throw std::runtime_error("read_checkpoint: error reading file.");
+        }
+        position += num_bytes;
+    }
+    template <typename T> T read() {
+        static_assert(std::is_trivially_copyable<T>::value, "");
+        T value;
+        read_bytes(&value, sizeof(T));
+        return value;
+    }
+    size_t read_size(const size_t element_size) {
+        const auto num_elements = read<uint64_t>();
+        if (element_size &&
+            num_elements > (size - position) / element_size) {
+            throw std::runtime_error("read_checkpoint: truncated checkpoint.");
+        }
+        return static_cast<size_t>(num_elements);
+    }
+    std::string read_string() {
+        std::string value(read_size(1), '\0');
+        read_bytes(&value[0], value.size());
+        return value;
+    }
+    template <typename T> void read_vector(std::vector<T> &values) {
+        values.resize(read_size(sizeof(T)));
+        read_bytes(values.data(), values.size() * sizeof(T));
+    }
+};
+
+/**
+ * Flush the file from the operating system cache to the disk, so a crash
+ * right after renaming it does not leave an empty or partial checkpoint.
+ */
+bool sync_file(const std::string &file_name) {
+#ifdef _WIN32
+    const int fd = _open(file_name.c_str(), _O_RDWR | _O_BINARY);
+    if (fd < 0) {
+        return false;
+    }
+    const bool synced = _commit(fd) == 0;
+    _close(fd);
+#else
+    const int fd = ::open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    const bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+#endif
+    return synced;
+}
+
+MethodKind method_kind(const TwoStepIntegratorMethod *method) {
+    if (!method) {
+        return MethodKind::NONE;
+    }
+    if (dynamic_cast<const LangevinBAOABIntegratorMethod *>(method)) {
+        return MethodKind::LANGEVIN_BAOAB;
+    }
+    if (dynamic_cast<const BrownianIntegratorMethod *>(method)) {
+        return MethodKind::BROWNIAN;
+    }
+    if (dynamic_cast<const VerletVelocitiesIntegratorMethod *>(method)) {
+        return MethodKind::VERLET_VELOCITIES;
+    }
+    return MethodKind::OTHER;
+}
+
+const TwoStepIntegratorMethod *
+integrator_two_step_method(const Integrator *integrator) {
+    const auto integrator_two_step =
+            dynamic_cast<const IntegratorTwoStep *>(integrator);
+    return integrator_two_step ? integrator_two_step->integrator_method.get()
+                               : nullptr;
+}
+
+void write_bonds(OutputBuffer &buffer, const BondCollection &bond_collection) {
+    const auto &bonds = bond_collection.bonds;
+    // Properties shared between bonds are written once.
+    std::unordered_map<const BondProperties *, uint64_t> properties_index;
+    std::vector<const BondProperties *> unique_properties;
+    std::vector<uint64_t> bond_properties_index(bonds.size(), no_properties);
+    const BondProperties *last_properties = nullptr;
+    uint64_t last_index = no_properties;
+    for (size_t i = 0; i < bonds.size(); ++i) {
+        const auto *properties = bonds[i]->properties.get();
+        // Consecutive bonds usually share the properties.
+        if (properties && properties != last_properties) {
+            last_index = properties_index
+                                 .emplace(properties, unique_properties.size())
+                                 .first->second;
+            if (last_index == unique_properties.size()) {
+                unique_properties.push_back(properties);
+            }
+            last_properties = properties;
+        }
+        if (properties) {
+            bond_properties_index[i] = last_index;
+        }
+    }
+    buffer.write<uint8_t>(bond_collection.sorted);
+    buffer.write<uint64_t>(unique_properties.size());
+    for (const auto *properties : unique_properties) {
+        const auto *physical =
+                dynamic_cast<const BondPropertiesPhysical *>(properties);
+        if (!physical && typeid(*properties) != typeid(BondProperties)) {
+            throw std::runtime_error(
+                    "write_checkpoint: unsupported type of BondProperties.");
+        }
+        buffer.write(physical ? PropertiesKind::PHYSICAL
+                              : PropertiesKind::PROPERTIES);
+        buffer.write<uint64_t>(properties->tags.size());
+        for (const auto &tag : properties->tags) {
+            buffer.write<BondProperties::tag_t>(tag);
+        }
+        if (physical) {
+            buffer.write<double>(physical->persistence_length);
+            buffer.write<double>(physical->kT);
+        }
+    }
+    std::vector<BondRecord> records(bonds.size());
+    for (size_t i = 0; i < bonds.size(); ++i) {
+        const auto &bond = *bonds[i];
+        const auto &bond_type = typeid(bond);
+        auto &record = records[i];
+        if (bond_type == typeid(BondChain)) {
+            record.kind = static_cast<uint64_t>(BondKind::BOND_CHAIN);
+            record.length_contour =
+                    static_cast<const BondChain &>(bond).length_contour;
+        } else if (bond_type == typeid(Bond)) {
+            record.kind = static_cast<uint64_t>(BondKind::BOND);
+            record.length_contour = 0.0;
+        } else {
+            throw std::runtime_error(
+                    "write_checkpoint: unsupported type of Bond.");
+        }
+        record.id_a = bond.id_a;
+        record.id_b = bond.id_b;
+        record.properties = bond_properties_index[i];
+    }
+    buffer.write_vector(records);
+}
+
+/** Bonds read from a checkpoint, applied with apply_bonds. */
+struct BondsState {
+    bool sorted = false;
+    std::vector<std::shared_ptr<BondProperties>> unique_properties;
+    std::vector<BondRecord> records;
+};
+
+void read_bonds(InputBuffer &buffer, BondsState &state) {
+    state.sorted = buffer.read<uint8_t>();
+    state.unique_properties.resize(
+            buffer.read_size(sizeof(uint8_t) + sizeof(uint64_t)));
+    for (auto &properties : state.unique_properties) {
+        const auto kind = buffer.read<PropertiesKind>();
+        BondProperties::tags_t tags;
+        const auto num_tags = buffer.read_size(sizeof(BondProperties::tag_t));
+        for (size_t t = 0; t < num_tags; ++t) {
+            tags.insert(buffer.read<BondProperties::tag_t>());
+        }
+        if (kind == PropertiesKind::PHYSICAL) {
+            const auto persistence_length = buffer.read<double>();
+            const auto kT = buffer.read<double>();
+            properties = std::make_shared<BondPropertiesPhysical>(
+                    tags, persistence_length, kT);
+        } else if (kind == PropertiesKind::PROPERTIES) {
+            properties = std::make_shared<BondProperties>(tags);
+        } else {
+            throw std::runtime_error(
+                    "read_checkpoint: unknown type of BondProperties.");
+        }
+    }
+
+    buffer.read_vector(state.records);
+    for (const auto &record : state.records) {
+        if (record.kind > static_cast<uint64_t>(BondKind::BOND_CHAIN)) {
+            throw std::runtime_error("read_checkpoint: unknown type of Bond.");
+        }
+        if (record.properties != no_properties &&
+            record.properties >= state.unique_properties.size()) {
+            throw std::runtime_error(
+                    "read_checkpoint: wrong index of BondProperties.");
+        }
+    }
+}
+
+void apply_bonds(const BondsState &state, BondCollection &bond_collection) {
+    auto &bonds = bond_collection.bonds;
+    bonds.resize(state.records.size());
+    for (size_t i = 0; i < state.records.size(); ++i) {
+        auto &bond = bonds[i];
+        const auto kind = static_cast<BondKind>(state.records[i].kind);
+        const auto id_a = state.records[i].id_a;
+        const auto id_b = state.records[i].id_b;
+        const auto length_contour = state.records[i].length_contour;
+        const auto properties = state.records[i].properties;
+        // Update in place if possible, keeping the Bond pointers valid.
+        const auto &expected_type =
+                kind == BondKind::BOND_CHAIN ? typeid(BondChain) : typeid(Bond);
+        if (!bond || typeid(*bond) != expected_type) {
+            if (kind == BondKind::BOND_CHAIN) {
+                bond = std::make_shared<BondChain>(id_a, id_b, length_contour);
+            } else {
+                bond = std::make_shared<Bond>(id_a, id_b);
+            }
+        }
+        bond->id_a = id_a;
+        bond->id_b = id_b;
+        if (kind == BondKind::BOND_CHAIN) {
+            static_cast<BondChain &>(*bond).length_contour = length_contour;
+        }
+        bond->properties = properties == no_properties
+                                   ? nullptr
+                                   : state.unique_properties[properties];
+    }
+    bond_collection.sorted = state.sorted;
+}
+
+void write_integrator(OutputBuffer &buffer, const Integrator &integrator) {
+    const auto *method = integrator_two_step_method(&integrator);
+    const auto kind = method_kind(method);
+    buffer.write(kind);
+    if (kind != MethodKind::NONE) {
+        buffer.write<double>(method->deltaT);
+    }
+    if (kind == MethodKind::BROWNIAN) {
+        const auto &brownian =
+                static_cast<const BrownianIntegratorMethod &>(*method);
+        buffer.write<double>(brownian.kT);
+        buffer.write<double>(brownian.gamma);
+        buffer.write<uint64_t>(brownian.seed);
+        buffer.write<uint64_t>(brownian.step);
+    } else if (kind == MethodKind::LANGEVIN_BAOAB) {
+        const auto &langevin =
+                static_cast<const LangevinBAOABIntegratorMethod &>(*method);
+        buffer.write<double>(langevin.kT);
+        buffer.write<double>(langevin.gamma);
+        buffer.write<uint64_t>(langevin.seed);
+        buffer.write<uint64_t>(langevin.step);
+    }
+
+    buffer.write<uint64_t>(integrator.force_types.size());
+    for (const auto &force_type : integrator.force_types) {
+        buffer.write_string(force_type->get_type());
+        std::vector<ArrayUtilities::Array3D> forces;
+        forces.reserve(force_type->particle_forces.size());
+        for (const auto &particle_force : force_type->particle_forces) {
+            forces.push_back(particle_force.force);
+        }
+        buffer.write_vector(forces);
+        forces.clear();
+        if (const auto *pair_bond_force =
+                    dynamic_cast<const PairBondForce *>(force_type.get())) {
+            for (const auto &bond_force : pair_bond_force->bond_forces) {
+                forces.push_back(bond_force.force);
+            }
+        }
+        buffer.write_vector(forces);
+        const auto *random_force =
+                dynamic_cast<const ParticleRandomForceCompute *>(
+                        force_type.get());
+        buffer.write<uint8_t>(random_force &&
+                              random_force->use_counter_based_rng);
+        buffer.write<uint64_t>(random_force ? random_force->seed : 0);
+        buffer.write<uint64_t>(random_force ? random_force->step : 0);
+        const auto *fixed_force =
+                dynamic_cast<const FixedPairBondForce *>(force_type.get());
+        buffer.write<uint8_t>(fixed_force &&
+                              fixed_force->forces_are_populated);
+    }
+}
+
+/** Saved state of a force type of the integrator. */
+struct ForceTypeState {
+    std::vector<ArrayUtilities::Array3D> particle_forces;
+    std::vector<ArrayUtilities::Array3D> bond_forces;
+    bool use_counter_based_rng = false;
+    uint64_t seed = 0;
+    uint64_t step = 0;
+    bool forces_are_populated = false;
+};
+
+/** Integrator read from a checkpoint, applied with apply_integrator. */
+struct IntegratorState {
+    MethodKind kind = MethodKind::NONE;
+    double deltaT = 0.0;
+    double kT = 0.0;
+    double gamma = 0.0;
+    uint64_t seed = 0;
+    uint64_t step = 0;
+    std::vector<ForceTypeState> force_types;
+};
+
+/** Read the integrator state, checking that it matches integrator. */
+void read_integrator(InputBuffer &buffer,
+                     const Integrator &integrator,
+                     IntegratorState &state) {
+    state.kind = buffer.read<MethodKind>();
+    if (state.kind != method_kind(integrator_two_step_method(&integrator))) {
+        throw std::runtime_error("read_checkpoint: the integrator method "
+                                 "differs from the checkpoint.");
+    }
+    if (state.kind != MethodKind::NONE) {
+        state.deltaT = buffer.read<double>();
+    }
+    if (state.kind == MethodKind::BROWNIAN ||
+        state.kind == MethodKind::LANGEVIN_BAOAB) {
+        state.kT = buffer.read<double>();
+        state.gamma = buffer.read<double>();
+        state.seed = buffer.read<uint64_t>();
+        state.step = buffer.read<uint64_t>();
+    }
+
+    const auto num_force_types = buffer.read_size(sizeof(uint64_t));
+    if (num_force_types != integrator.force_types.size()) {
+        throw std::runtime_error("read_checkpoint: the number of force types "
+                                 "differs from the checkpoint.");
+    }
+    state.force_types.resize(num_force_types);
+    for (size_t f = 0; f < num_force_types; ++f) {
+        const auto &force_type = integrator.force_types[f];
+        auto &force_state = state.force_types[f];
+        if (buffer.read_string() != force_type->get_type()) {
+            throw std::runtime_error("read_checkpoint: the force types differ "
+                                     "from the checkpoint.");
+        }
+        buffer.read_vector(force_state.particle_forces);
+        if (force_state.particle_forces.size() !=
+            force_type->particle_forces.size()) {
+            throw std::runtime_error(
+                    "read_checkpoint: the number of particle forces of " +
+                    force_type->get_type() + " differs from the checkpoint.");
+        }
+        buffer.read_vector(force_state.bond_forces);
+        if (const auto *pair_bond_force =
+                    dynamic_cast<const PairBondForce *>(force_type.get())) {
+            if (force_state.bond_forces.size() !=
+                pair_bond_force->bond_forces.size()) {
+                throw std::runtime_error(
+                        "read_checkpoint: the number of bond forces of " +
+                        force_type->get_type() +
+                        " differs from the checkpoint.");
+            }
+        }
+        force_state.use_counter_based_rng = buffer.read<uint8_t>();
+        force_state.seed = buffer.read<uint64_t>();
+        force_state.step = buffer.read<uint64_t>();
+        force_state.forces_are_populated = buffer.read<uint8_t>();
+    }
+}
+
+void apply_integrator(const IntegratorState &state, Integrator &integrator) {
+    auto *method = const_cast<TwoStepIntegratorMethod *>(
+            integrator_two_step_method(&integrator));
+    if (state.kind != MethodKind::NONE) {
+        method->deltaT = state.deltaT;
+    }
+    if (state.kind == MethodKind::BROWNIAN) {
+        auto &brownian = static_cast<BrownianIntegratorMethod &>(*method);
+        brownian.kT = state.kT;
+        brownian.gamma = state.gamma;
+        brownian.seed = state.seed;
+        brownian.step = state.step;
+    } else if (state.kind == MethodKind::LANGEVIN_BAOAB) {
+        auto &langevin = static_cast<LangevinBAOABIntegratorMethod &>(*method);
+        langevin.kT = state.kT;
+        langevin.gamma = state.gamma;
+        langevin.seed = state.seed;
+        langevin.step = state.step;
+    }
+
+    for (size_t f = 0; f < state.force_types.size(); ++f) {
+        auto &force_type = integrator.force_types[f];
+        const auto &force_state = state.force_types[f];
+        for (size_t i = 0; i < force_state.particle_forces.size(); ++i) {
+            force_type->particle_forces[i].force =
+                    force_state.particle_forces[i];
+        }
+        if (auto *pair_bond_force =
+                    dynamic_cast<PairBondForce *>(force_type.get())) {
+            for (size_t i = 0; i < force_state.bond_forces.size(); ++i) {
+                pair_bond_force->bond_forces[i].force =
+                        force_state.bond_forces[i];
+            }
+            // The parameters of the bonds may have changed.
+            pair_bond_force->update_bond_table();
+        }
+        if (auto *random_force = dynamic_cast<ParticleRandomForceCompute *>(
+                    force_type.get())) {
+            random_force->use_counter_based_rng =
+                    force_state.use_counter_based_rng;
+            random_force->seed = force_state.seed;
+            random_force->step = force_state.step;
+        }
+        if (auto *fixed_force =
+                    dynamic_cast<FixedPairBondForce *>(force_type.get())) {
+            fixed_force->forces_are_populated =
+                    force_state.forces_are_populated;
+        }
+    }
+}
+} // namespace
+
+void write_checkpoint(const std::string &file_name,
+                      const System &sys,
+                      const Integrator *integrator,
+                      const uint64_t time_step) {
+    const std::string temporary_file_name = file_name + ".tmp";
+    std::ofstream file(temporary_file_name,
+                       std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("write_checkpoint: cannot open " +
+                                 temporary_file_name);
+    }
+    OutputBuffer buffer(file);
+    try {
+        const auto &particles = sys.all.particles;
+        buffer.write_bytes(checkpoint_magic, sizeof(checkpoint_magic));
+        buffer.write<uint32_t>(checkpoint_version);
+        buffer.write<uint32_t>(sizeof(Particle));
+        buffer.write<uint64_t>(time_step);
+
+        buffer.write<uint8_t>(sys.all.sorted);
+        buffer.write_vector(particles);
+        write_bonds(buffer, sys.bonds);
+        buffer.write<uint64_t>(sys.conexions.size());
+        for (const auto &particle_neighbors : sys.conexions) {
+            buffer.write<uint64_t>(particle_neighbors.particle_id);
+            buffer.write_vector(particle_neighbors.neighbors);
+        }
+
+        std::ostringstream engine_state;
+        engine_state << RNG::engine();
+        buffer.write_string(engine_state.str());
+
+        buffer.write<uint8_t>(integrator != nullptr);
+        if (integrator) {
+            write_integrator(buffer, *integrator);
+        }
+    } catch (...) {
+        file.close();
+        std::remove(temporary_file_name.c_str());
+        throw;
+    }
+
+    file.flush();
+    file.close();
+    if (!file || !sync_file(temporary_file_name)) {
+        std::remove(temporary_file_name.c_str());
+        throw std::runtime_error("write_checkpoint: error writing " +
+                                 temporary_file_name);
+    }
+    if (std::rename(temporary_file_name.c_str(), file_name.c_str()) != 0) {
+        // rename does not replace existing files in all the platforms.
+        std::remove(file_name.c_str());
+        if (std::rename(temporary_file_name.c_str(), file_name.c_str()) != 0) {
+            throw std::runtime_error("write_checkpoint: cannot rename " +
+                                     temporary_file_name + " to " +
+                                     file_name);
+        }
+    }
+}
+
+uint64_t read_checkpoint(const std::string &file_name,
+                         System &sys,
+                         Integrator *integrator) {
+    std::ifstream file(file_name, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw std::runtime_error("read_checkpoint: cannot open " + file_name);
+    }
+    InputBuffer buffer(file, static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    char magic[sizeof(checkpoint_magic)];
+    buffer.read_bytes(magic, sizeof(magic));
+    if (std::memcmp(magic, checkpoint_magic, sizeof(magic)) != 0) {
+        throw std::runtime_error("read_checkpoint: " + file_name +
+                                 " is not a checkpoint file.");
+    }
+    if (buffer.read<uint32_t>() != checkpoint_version ||
+        buffer.read<uint32_t>() != sizeof(Particle)) {
+        throw std::runtime_error(
+                "read_checkpoint: unsupported version of " + file_name);
+    }
+    const auto time_step = buffer.read<uint64_t>();
+
+    // The whole checkpoint is read and validated before modifying sys and
+    // integrator, so they are left untouched if it is corrupted.
+    const bool sorted = buffer.read<uint8_t>();
+    std::vector<Particle> particles;
+    buffer.read_vector(particles);
+    BondsState bonds;
+    read_bonds(buffer, bonds);
+    ParticleNeighborsCollection conexions(
+            buffer.read_size(2 * sizeof(uint64_t)));
+    for (auto &particle_neighbors : conexions) {
+        particle_neighbors.particle_id = buffer.read<uint64_t>();
+        buffer.read_vector(particle_neighbors.neighbors);
+    }
+
+    auto engine = RNG::engine();
+    std::istringstream engine_state(buffer.read_string());
+    if (!(engine_state >> engine)) {
+        throw std::runtime_error("read_checkpoint: corrupted state of the "
+                                 "random engine in " +
+                                 file_name);
+    }
+
+    const bool has_integrator = buffer.read<uint8_t>();
+    IntegratorState integrator_state;
+    if (integrator) {
+        if (!has_integrator) {
+            throw std::runtime_error("read_checkpoint: " + file_name +
+                                     " has no integrator state.");
+        }
+        read_integrator(buffer, *integrator, integrator_state);
+    }
+
+    sys.all.sorted = sorted;
+    sys.all.particles.swap(particles);
+    apply_bonds(bonds, sys.bonds);
+    sys.conexions.swap(conexions);
+    // Derived from the particles.
+    sys.collision_neighbor_list.clear();
+    RNG::engine() = engine;
+    if (integrator) {
+        apply_integrator(integrator_state, *integrator);
+    }
+    return time_step;
+}
+
+} // namespace SG
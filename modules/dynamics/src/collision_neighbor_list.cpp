@@ -0,0 +1,259 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "collision_neighbor_list.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace SG {
+
+CollisionNeighborListBuilder::CollisionNeighborListBuilder(const double cutoff,
+                                                           const double skin,
+                                                           const bool half_list)
+        : m_cutoff(cutoff), m_skin(skin), m_half_list(half_list) {
+    if (!(cutoff > 0.0)) {
+        throw std::runtime_error(
+                "CollisionNeighborListBuilder: cutoff has to be positive.");
+    }
+    if (!(skin >= 0.0)) {
+        throw std::runtime_error(
+                "CollisionNeighborListBuilder: skin cannot be negative.");
+    }
+}
+
+void CollisionNeighborListBuilder::set_periodic_box(const Array3D &box_size) {
+    for (size_t dim = 0; dim < 3; ++dim) {
+        if (!(box_size[dim] > 0.0)) {
+            throw std::runtime_error("CollisionNeighborListBuilder: "
+                                     "box_size has to be positive.");
+        }
+        m_box_size_inverse[dim] = 1.0 / box_size[dim];
+    }
+    m_box_size = box_size;
+    m_boundary_condition = boundary_condition::PERIODIC;
+    // Force a rebuild
+    m_positions_at_build.clear();
+}
+
+void CollisionNeighborListBuilder::set_no_boundary_condition() {
+    m_boundary_condition = boundary_condition::NONE;
+    m_positions_at_build.clear();
+}
+
+ArrayUtilities::Array3D
+CollisionNeighborListBuilder::minus(const Array3D &lhs,
+                                    const Array3D &rhs) const {
+    if (m_boundary_condition == boundary_condition::PERIODIC) {
+        return ArrayUtilities::minus_with_boundary_condition_periodic(
+                lhs, rhs, m_box_size, m_box_size_inverse);
+    }
+    return ArrayUtilities::minus(lhs, rhs);
+}
+
+bool CollisionNeighborListBuilder::needs_rebuild(const System *sys) const {
+    const auto num_particles = sys->all.particles.size();
+    if (m_num_builds == 0 || m_positions_at_build.size() != num_particles ||
+        sys->collision_neighbor_list.size() != num_particles ||
+        m_skin == 0.0) {
+        return true;
+    }
+    const double max_displacement_squared = 0.25 * m_skin * m_skin;
+    for (size_t i = 0; i < num_particles; ++i) {
+        const auto displacement =
+                minus(sys->get_position(i), m_positions_at_build[i]);
+        if (ArrayUtilities::dot_product(displacement, displacement) >
+            max_displacement_squared) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CollisionNeighborListBuilder::update(System *sys) {
+    if (!needs_rebuild(sys)) {
+        return false;
+    }
+    build(sys);
+    return true;
+}
+
+size_t CollisionNeighborListBuilder::cell_coordinate(double coordinate,
+                                                     const size_t dim) const {
+    if (m_boundary_condition == boundary_condition::PERIODIC) {
+        coordinate -= std::floor(coordinate * m_box_size_inverse[dim]) *
+                      m_box_size[dim];
+    } else {
+        coordinate -= m_origin[dim];
+    }
+    const auto cell = static_cast<size_t>(
+            std::max(0.0, coordinate / m_cell_size[dim]));
+    return std::min(cell, m_num_cells[dim] - 1);
+}
+
+void CollisionNeighborListBuilder::build_cells(const System *sys) {
+    const auto num_particles = sys->all.particles.size();
+    const double list_radius = m_cutoff + m_skin;
+    if (m_boundary_condition == boundary_condition::PERIODIC) {
+        m_origin = {{0.0, 0.0, 0.0}};
+        for (size_t dim = 0; dim < 3; ++dim) {
+            m_num_cells[dim] = std::max<size_t>(
+                    1, static_cast<size_t>(m_box_size[dim] / list_radius));
+            m_cell_size[dim] = m_box_size[dim] / m_num_cells[dim];
+        }
+    } else {
+        Array3D min_position = {{std::numeric_limits<double>::max(),
+                                 std::numeric_limits<double>::max(),
+                                 std::numeric_limits<double>::max()}};
+        Array3D max_position = {{std::numeric_limits<double>::lowest(),
+                                 std::numeric_limits<double>::lowest(),
+                                 std::numeric_limits<double>::lowest()}};
+        for (size_t i = 0; i < num_particles; ++i) {
+            const auto &pos = sys->get_position(i);
+            for (size_t dim = 0; dim < 3; ++dim) {
+                min_position[dim] = std::min(min_position[dim], pos[dim]);
+                max_position[dim] = std::max(max_position[dim], pos[dim]);
+            }
+        }
+        m_origin = num_particles ? min_position : Array3D{{0.0, 0.0, 0.0}};
+        // Avoid a huge grid for sparse systems (for example, one particle far
+        // away), larger cells are still valid, only slower.
+        const double max_num_cells =
+                8.0 * static_cast<double>(std::max<size_t>(num_particles, 1));
+        double cell_size = list_radius;
+        while (true) {
+            double total_cells = 1.0;
+            for (size_t dim = 0; dim < 3; ++dim) {
+                const double extent =
+                        num_particles ? max_position[dim] - min_position[dim]
+                                      : 0.0;
+                m_num_cells[dim] = static_cast<size_t>(extent / cell_size) + 1;
+                m_cell_size[dim] = cell_size;
+                total_cells *= static_cast<double>(m_num_cells[dim]);
+            }
+            if (total_cells <= max_num_cells) {
+                break;
+            }
+            cell_size *= std::cbrt(total_cells / max_num_cells) * 1.01;
+        }
+    }
+
+    // Counting sort of the particles in the cells.
+    const size_t total_cells = m_num_cells[0] * m_num_cells[1] * m_num_cells[2];
+    m_cell_start.assign(total_cells + 1, 0);
+    m_particle_cell.resize(num_particles);
+    for (size_t i = 0; i < num_particles; ++i) {
+        const auto &pos = sys->get_position(i);
+        const size_t cell =
+                cell_coordinate(pos[0], 0) +
+                m_num_cells[0] * (cell_coordinate(pos[1], 1) +
+                                  m_num_cells[1] * cell_coordinate(pos[2], 2));
+        m_particle_cell[i] = cell;
+        ++m_cell_start[cell + 1];
+    }
+    for (size_t c = 0; c < total_cells; ++c) {
+        m_cell_start[c + 1] += m_cell_start[c];
+    }
+    m_cell_particles.resize(num_particles);
+    std::vector<size_t> cell_fill(m_cell_start.begin(), m_cell_start.end() - 1);
+    for (size_t i = 0; i < num_particles; ++i) {
+        m_cell_particles[cell_fill[m_particle_cell[i]]++] = i;
+    }
+}
+
+void CollisionNeighborListBuilder::build(System *sys) {
+    build_cells(sys);
+    const auto num_particles = sys->all.particles.size();
+    const double list_radius = m_cutoff + m_skin;
+    const double list_radius_squared = list_radius * list_radius;
+    const bool periodic = m_boundary_condition == boundary_condition::PERIODIC;
+
+    // Reuse the allocated neighbors vectors between builds.
+    auto &neighbor_list = sys->collision_neighbor_list;
+    neighbor_list.resize(num_particles);
+    m_positions_at_build.resize(num_particles);
+    for (size_t i = 0; i < num_particles; ++i) {
+        m_positions_at_build[i] = sys->get_position(i);
+    }
+
+    for (size_t i = 0; i < num_particles; ++i) {
+        auto &particle_neighbors = neighbor_list[i];
+        particle_neighbors.particle_id = sys->all.particles[i].id;
+        particle_neighbors.neighbors.clear();
+        const auto &pos = m_positions_at_build[i];
+        // Neighbor cells in each dimension, without repetitions.
+        std::array<std::array<size_t, 3>, 3> cells;
+        std::array<size_t, 3> num_neighbor_cells;
+        size_t cell = m_particle_cell[i];
+        for (size_t dim = 0; dim < 3; ++dim) {
+            const size_t n = m_num_cells[dim];
+            const size_t c = cell % n;
+            cell /= n;
+            size_t count = 0;
+            if (periodic && n < 3) {
+                for (size_t k = 0; k < n; ++k) {
+                    cells[dim][count++] = k;
+                }
+            } else if (periodic) {
+                cells[dim][count++] = (c + n - 1) % n;
+                cells[dim][count++] = c;
+                cells[dim][count++] = (c + 1) % n;
+            } else {
+                if (c > 0) {
+                    cells[dim][count++] = c - 1;
+                }
+                cells[dim][count++] = c;
+                if (c + 1 < n) {
+                    cells[dim][count++] = c + 1;
+                }
+            }
+            num_neighbor_cells[dim] = count;
+        }
+        for (size_t cz = 0; cz < num_neighbor_cells[2]; ++cz) {
+            for (size_t cy = 0; cy < num_neighbor_cells[1]; ++cy) {
+                for (size_t cx = 0; cx < num_neighbor_cells[0]; ++cx) {
+                    const size_t neighbor_cell =
+                            cells[0][cx] +
+                            m_num_cells[0] *
+                                    (cells[1][cy] +
+                                     m_num_cells[1] * cells[2][cz]);
+                    for (size_t k = m_cell_start[neighbor_cell];
+                         k < m_cell_start[neighbor_cell + 1]; ++k) {
+                        const size_t j = m_cell_particles[k];
+                        if (j == i || (m_half_list && j < i)) {
+                            continue;
+                        }
+                        const auto diff = minus(pos, m_positions_at_build[j]);
+                        if (ArrayUtilities::dot_product(diff, diff) <
+                            list_radius_squared) {
+                            particle_neighbors.neighbors.push_back(
+                                    sys->all.particles[j].id);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    ++m_num_builds;
+}
+
+} // namespace SG
@@ -22,6 +22,9 @@
 #include "edge_points_utilities.hpp" // for contour_length
 #include "system.hpp"
 
+#include <algorithm>
+#include <tuple>
+
 namespace SG {
 ParticleGraphGlueData particles_from_graph(const GraphType &graph) {
     ParticleGraphGlueData glue_data;
@@ -53,31 +56,65 @@ ParticleGraphGlueData particles_from_graph(const GraphType &graph) {
         }
         connected_list.emplace_back(connected_particles);
     }
-    // add bonds
-    // BondChain has contour length attribute
     glue_data.bond_collection =
-            make_unique_bonds_from_system_conexions<BondChain>(
-                    glue_data.sys.get());
-    // iterate over bonds and populate contour length
-    for (auto &bond : glue_data.bond_collection.bonds) {
-        const auto source_g = graph_particle_map->at(bond->id_a);
-        const auto target_g = graph_particle_map->at(bond->id_b);
-        // graph is undirected, source, target does not matter
-        const auto [edge_desc, exists] = boost::edge(source_g, target_g, graph);
-        assert(exists == true && "Edge has to exist");
-        std::static_pointer_cast<BondChain>(bond)->length_contour =
-                contour_length(edge_desc, graph);
+            make_bonds_from_graph(graph, *graph_particle_map);
+
+    return glue_data;
+}
+
+BondCollection make_bonds_from_graph(
+        const GraphType &graph,
+        const ParticleGraphGlueData::graph_particle_map_t &graph_particle_map) {
+    struct EdgeBond {
+        size_t id_a;
+        size_t id_b;
+        GraphType::edge_descriptor edge;
+    };
+    std::vector<EdgeBond> edge_bonds;
+    edge_bonds.reserve(boost::num_edges(graph));
+    for (auto [ei, ei_end] = boost::edges(graph); ei != ei_end; ++ei) {
+        const auto id_source =
+                graph_particle_map.at(boost::source(*ei, graph));
+        const auto id_target =
+                graph_particle_map.at(boost::target(*ei, graph));
+        edge_bonds.push_back({std::min(id_source, id_target),
+                              std::max(id_source, id_target), *ei});
+    }
+    // stable, the first edge of parallel edges is kept.
+    std::stable_sort(std::begin(edge_bonds), std::end(edge_bonds),
+                     [](const EdgeBond &lhs, const EdgeBond &rhs) {
+                         return std::tie(lhs.id_a, lhs.id_b) <
+                                std::tie(rhs.id_a, rhs.id_b);
+                     });
+    edge_bonds.erase(std::unique(std::begin(edge_bonds), std::end(edge_bonds),
+                                 [](const EdgeBond &lhs, const EdgeBond &rhs) {
+                                     return lhs.id_a == rhs.id_a &&
+                                            lhs.id_b == rhs.id_b;
+                                 }),
+                     std::end(edge_bonds));
+
+    BondCollection bond_collection;
+    auto &bonds = bond_collection.bonds;
+    bonds.reserve(edge_bonds.size());
+    for (const auto &edge_bond : edge_bonds) {
+        // BondChain has contour length attribute
+        auto bond = std::make_shared<BondChain>(
+                edge_bond.id_a, edge_bond.id_b,
+                contour_length(edge_bond.edge, graph));
         // Tag bonds that correspond to free-chains (where any of the two
         // particles have degree 1)
-        const auto degree_source = boost::degree(source_g, graph);
-        const auto degree_target = boost::degree(target_g, graph);
+        const auto degree_source =
+                boost::degree(boost::source(edge_bond.edge, graph), graph);
+        const auto degree_target =
+                boost::degree(boost::target(edge_bond.edge, graph), graph);
         if (degree_source == 1 || degree_target == 1) {
             bond->properties->tags.insert(tag_bond_free_chain);
         } else {
             bond->properties->tags.insert(tag_bond_contour_length_chain);
         }
+        bonds.push_back(std::move(bond));
     }
-
-    return glue_data;
+    bond_collection.sorted = true;
+    return bond_collection;
 }
 } // namespace SG
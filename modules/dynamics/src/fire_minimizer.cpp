@@ -0,0 +1,142 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "fire_minimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace SG {
+
+FIREMinimizer::FIREMinimizer(System *sys, Integrator *integrator)
+        : m_sys(sys), m_integrator(integrator) {
+    if (!m_sys || !m_integrator) {
+        throw std::runtime_error(
+                "FIREMinimizer requires a System and an Integrator.");
+    }
+}
+
+double FIREMinimizer::evaluate_forces(Result &result) {
+    m_integrator->update_collision_neighbor_list();
+    m_integrator->compute_forces();
+    m_integrator->compute_net_forces(m_sys);
+    ++result.num_force_evaluations;
+    double max_force_squared = 0.0;
+    for (const auto &particle : m_sys->all.particles) {
+        max_force_squared = std::max(
+                max_force_squared,
+                ArrayUtilities::dot_product(particle.dynamics.net_force,
+                                            particle.dynamics.net_force));
+    }
+    return std::sqrt(max_force_squared);
+}
+
+FIREMinimizer::Result FIREMinimizer::minimize() {
+    if (!(deltaT > 0.0)) {
+        throw std::runtime_error("FIREMinimizer: deltaT has to be positive.");
+    }
+    const double dt_max = deltaT_max > 0.0 ? deltaT_max : 10.0 * deltaT;
+    const double dt_min = deltaT_min > 0.0 ? deltaT_min : 0.02 * deltaT;
+    const double max_displacement_squared =
+            max_displacement * max_displacement;
+    auto &particles = m_sys->all.particles;
+    for (auto &particle : particles) {
+        std::fill(particle.dynamics.vel.begin(), particle.dynamics.vel.end(),
+                  0.0);
+    }
+
+    Result result;
+    double dt = deltaT;
+    double alpha = alpha_start;
+    size_t steps_with_positive_power = 0;
+    result.max_force = evaluate_forces(result);
+    while (result.max_force > force_tolerance &&
+           result.num_iterations < max_iterations) {
+        ++result.num_iterations;
+        double power = 0.0;
+        for (const auto &particle : particles) {
+            power += ArrayUtilities::dot_product(particle.dynamics.net_force,
+                                                 particle.dynamics.vel);
+        }
+        if (power > 0.0) {
+            if (++steps_with_positive_power > n_min) {
+                dt = std::min(dt * f_increase, dt_max);
+                alpha *= f_alpha;
+            }
+        } else {
+            steps_with_positive_power = 0;
+            dt = std::max(dt * f_decrease, dt_min);
+            alpha = alpha_start;
+            // Go back half step, and stop.
+            for (auto &particle : particles) {
+                particle.pos = ArrayUtilities::minus(
+                        particle.pos, ArrayUtilities::product_scalar(
+                                              particle.dynamics.vel, 0.5 * dt));
+                std::fill(particle.dynamics.vel.begin(),
+                          particle.dynamics.vel.end(), 0.0);
+            }
+        }
+
+        // Semi-implicit Euler, v(t + dt) first.
+        double velocity_norm_squared = 0.0;
+        double force_norm_squared = 0.0;
+        for (auto &particle : particles) {
+            const auto &force = particle.dynamics.net_force;
+            auto &velocity = particle.dynamics.vel;
+            velocity = ArrayUtilities::plus(
+                    velocity, ArrayUtilities::product_scalar(
+                                      force, dt / particle.material.mass));
+            velocity_norm_squared +=
+                    ArrayUtilities::dot_product(velocity, velocity);
+            force_norm_squared += ArrayUtilities::dot_product(force, force);
+        }
+        // Mix the velocities towards the direction of the forces.
+        const double mixing =
+                force_norm_squared > 0.0
+                        ? alpha * std::sqrt(velocity_norm_squared /
+                                            force_norm_squared)
+                        : 0.0;
+        for (auto &particle : particles) {
+            auto &velocity = particle.dynamics.vel;
+            velocity = ArrayUtilities::plus(
+                    ArrayUtilities::product_scalar(velocity, 1.0 - alpha),
+                    ArrayUtilities::product_scalar(particle.dynamics.net_force,
+                                                   mixing));
+            auto displacement = ArrayUtilities::product_scalar(velocity, dt);
+            const double displacement_squared =
+                    ArrayUtilities::dot_product(displacement, displacement);
+            if (displacement_squared > max_displacement_squared) {
+                // Limit the velocity too, it is used to go back half step.
+                const double scale =
+                        max_displacement / std::sqrt(displacement_squared);
+                displacement =
+                        ArrayUtilities::product_scalar(displacement, scale);
+                velocity = ArrayUtilities::product_scalar(velocity, scale);
+            }
+            particle.pos = ArrayUtilities::plus(particle.pos, displacement);
+        }
+        result.max_force = evaluate_forces(result);
+    }
+    result.converged = result.max_force <= force_tolerance;
+    return result;
+}
+
+} // namespace SG
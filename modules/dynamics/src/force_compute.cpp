@@ -19,41 +19,47 @@
  * *******************************************************************/
 
 #include "force_compute.hpp"
+#include "parallel_tasks.hpp"
 #include "particle_collection.hpp"
 #include "rng.hpp" // from core module
 
+#include <limits>
+#include <string>
+
 namespace SG {
-void PairBondForce::compute() {
-    if (!force_function) {
-        throw std::runtime_error("force_function is not set in PairBondForce");
+void PairBondForce::update_bond_table() {
+    std::vector<const Bond *> bonds;
+    bonds.reserve(bond_forces.size());
+    for (const auto &bond_force : bond_forces) {
+        bonds.push_back(bond_force.bond);
     }
+    bond_table.build(m_sys->all, bonds);
+    bond_table.topology_version = m_sys->topology_version;
+}
 
-    reset_forces_to_zero();
-    reset_bond_forces_to_zero();
-
-    // Compute and store forces per bond
-    for (auto &bond_force : bond_forces) {
-        const auto [p_a, p_a_index] =
-                m_sys->all.find_particle_and_index(bond_force.bond->id_a);
-        const auto [p_b, p_b_index] =
-                m_sys->all.find_particle_and_index(bond_force.bond->id_b);
-        // Assign to bond_force
-        // Bond force is equal to F_{a,b}
-        bond_force.force = force_function(*p_a, *p_b, *bond_force.bond);
-        // Translating a bond force using as a reference the force
-        // from particle a to b, (i.e. F_{a,b}) to each particle.
-        // We divide the bond force by half, and apply each half to each
-        // particle, changing the sign. (the particles are always at the two
-        // ends of the bond).
-        const auto half_bond_force =
-                ArrayUtilities::product_scalar(bond_force.force, 0.5);
-        // Assign to the per particle forces
-        auto &force_on_a = particle_forces[p_a_index].force;
-        auto &force_on_b = particle_forces[p_b_index].force;
-        // F_{a,b}
-        force_on_a = ArrayUtilities::plus(force_on_a, half_bond_force);
-        // change sign of bond_force for the F_{b,a}
-        force_on_b = ArrayUtilities::minus(force_on_b, half_bond_force);
+bool PairBondForce::bond_table_needs_update() const {
+    return bond_table.size() != bond_forces.size() ||
+           bond_table.num_particles != m_sys->all.particles.size() ||
+           bond_table.topology_version != m_sys->topology_version;
+}
+
+void PairBondForce::compute() {
+    if (bond_table_force_function) {
+        compute_with_bond_force([this](const Particle &p_a,
+                                       const Particle &p_b,
+                                       const size_t bond_index) {
+            return bond_table_force_function(
+                    ArrayUtilities::minus(p_b.pos, p_a.pos), bond_table,
+                    bond_index);
+        });
+    } else if (force_function) {
+        compute_with_bond_force([this](const Particle &p_a,
+                                       const Particle &p_b,
+                                       const size_t bond_index) {
+            return force_function(p_a, p_b, *bond_forces[bond_index].bond);
+        });
+    } else {
+        throw std::runtime_error("force_function is not set in PairBondForce");
     }
 }
 
@@ -98,20 +104,130 @@ void ParticleForceCompute::compute() {
         throw std::runtime_error(
                 "force_function is not set in ParticleForceCompute");
     }
+    compute_with_particle_force(force_function);
+}
+
+namespace {
+/**
+ * The neighbor list only guarantees the pairs closer than the cutoff of the
+ * builder (the skin is consumed by the motion of the particles between
+ * rebuilds), pairs beyond it would be silently missed.
+ */
+void check_pair_neighbor_cutoff(
+        const double cutoff,
+        const CollisionNeighborListBuilder &neighbor_list_builder) {
+    if (cutoff > neighbor_list_builder.cutoff()) {
+        throw std::runtime_error(
+                "PairNeighborForce: cutoff (" + std::to_string(cutoff) +
+                ") is larger than the cutoff of the "
+                "CollisionNeighborListBuilder (" +
+                std::to_string(neighbor_list_builder.cutoff()) + ").");
+    }
+}
+} // namespace
+
+PairNeighborForce::PairNeighborForce(
+        const System *sys,
+        std::shared_ptr<const CollisionNeighborListBuilder>
+                in_neighbor_list_builder,
+        force_function_t in_force_function,
+        const double in_cutoff)
+        : ForceCompute(sys), force_function(in_force_function),
+          neighbor_list_builder(in_neighbor_list_builder),
+          cutoff(in_cutoff) {
+    if (!neighbor_list_builder) {
+        throw std::runtime_error(
+                "PairNeighborForce requires a CollisionNeighborListBuilder.");
+    }
+    if (cutoff <= 0.0) {
+        cutoff = neighbor_list_builder->cutoff();
+    }
+    check_pair_neighbor_cutoff(cutoff, *neighbor_list_builder);
+}
+
+void PairNeighborForce::compute() {
+    if (!force_function) {
+        throw std::runtime_error(
+                "force_function is not set in PairNeighborForce");
+    }
+    // cutoff is public and can be changed after construction.
+    check_pair_neighbor_cutoff(cutoff, *neighbor_list_builder);
     reset_forces_to_zero();
 
-    size_t current_particle_index = 0;
-    for (const auto &particle : m_sys->all.particles) {
-        auto &current_particle_force =
-                particle_forces[current_particle_index].force;
-        assert(particle.id ==
-                       particle_forces[current_particle_index].particle_id &&
-               "particle ids are not synchronized in "
-               "PairBondeForce:compute(), they should be sorted as well as "
-               "all the particles.");
-        current_particle_force = ArrayUtilities::plus(current_particle_force,
-                                                      force_function(particle));
-        current_particle_index++;
+    const auto &particles = m_sys->all.particles;
+    const auto num_particles = particles.size();
+    // ids are usually equal to the index, avoid the binary search.
+    const auto index_of = [this, &particles,
+                           num_particles](const size_t id) -> size_t {
+        if (id < num_particles && particles[id].id == id) {
+            return id;
+        }
+        const auto index = m_sys->all.find_index(id);
+        if (index == std::numeric_limits<size_t>::max()) {
+            throw std::runtime_error("PairNeighborForce: particle id " +
+                                     std::to_string(id) +
+                                     " of collision_neighbor_list not found.");
+        }
+        return index;
+    };
+    const double cutoff_squared = cutoff * cutoff;
+    const auto &neighbor_list = m_sys->collision_neighbor_list;
+    const auto threads = resolve_num_threads(num_threads);
+    if (threads > 1 && !neighbor_list_builder->half_list()) {
+        // Each particle gathers the forces of all its neighbors.
+        run_force_blocks(
+                neighbor_list.size(), threads,
+                [&](const size_t begin, const size_t end) {
+                    for (size_t n = begin; n < end; ++n) {
+                        const auto &particle_neighbors = neighbor_list[n];
+                        const auto a_index =
+                                index_of(particle_neighbors.particle_id);
+                        const auto &a = particles[a_index];
+                        auto &force_on_a = particle_forces[a_index].force;
+                        for (const auto &neighbor_id :
+                             particle_neighbors.neighbors) {
+                            const auto b_index = index_of(neighbor_id);
+                            if (b_index == a_index) {
+                                continue;
+                            }
+                            const auto &b = particles[b_index];
+                            const auto ab_vector =
+                                    neighbor_list_builder->minus(b.pos, a.pos);
+                            if (ArrayUtilities::dot_product(ab_vector,
+                                                            ab_vector) >=
+                                cutoff_squared) {
+                                continue;
+                            }
+                            force_on_a = ArrayUtilities::plus(
+                                    force_on_a,
+                                    force_function(a, b, ab_vector));
+                        }
+                    }
+                },
+                512);
+        return;
+    }
+    for (const auto &particle_neighbors : neighbor_list) {
+        const auto a_index = index_of(particle_neighbors.particle_id);
+        const auto &a = particles[a_index];
+        for (const auto &neighbor_id : particle_neighbors.neighbors) {
+            const auto b_index = index_of(neighbor_id);
+            // Compute each pair once.
+            if (b_index <= a_index) {
+                continue;
+            }
+            const auto &b = particles[b_index];
+            const auto ab_vector = neighbor_list_builder->minus(b.pos, a.pos);
+            if (ArrayUtilities::dot_product(ab_vector, ab_vector) >=
+                cutoff_squared) {
+                continue;
+            }
+            const auto force_ab = force_function(a, b, ab_vector);
+            auto &force_on_a = particle_forces[a_index].force;
+            auto &force_on_b = particle_forces[b_index].force;
+            force_on_a = ArrayUtilities::plus(force_on_a, force_ab);
+            force_on_b = ArrayUtilities::minus(force_on_b, force_ab);
+        }
     }
 }
 
@@ -131,4 +247,26 @@ ParticleRandomForceCompute::ParticleRandomForceCompute(
     };
 }
 
+void ParticleRandomForceCompute::compute() {
+    if (!use_counter_based_rng) {
+        ParticleForceCompute::compute();
+        return;
+    }
+    const auto modulo = _modulo;
+    const auto current_seed = seed;
+    const auto current_step = step;
+    compute_with_particle_force([modulo, current_seed,
+                                 current_step](const Particle &particle) {
+        return RNG::counter_based_random_orientation(modulo, current_seed,
+                                                     current_step, particle.id);
+    });
+    ++step;
+}
+
+void ParticleRandomForceCompute::set_seed(const uint64_t in_seed) {
+    use_counter_based_rng = true;
+    seed = in_seed;
+    step = 0;
+}
+
 } // namespace SG
@@ -19,28 +19,15 @@
  * *******************************************************************/
 
 #include "force_functions.hpp"
+#include "force_kernels.hpp"
+
+#include <cmath>
+#include <limits>
 
 namespace SG {
 ArrayUtilities::Array3D force_function_wlc_petrosyan(const SG::Particle &a,
                                                      const SG::Particle &b,
                                                      const SG::Bond &chain) {
-    const auto d_ete_vector = ArrayUtilities::minus(b.pos, a.pos); // F_{a, b}
-    const auto d_ete_modulo = ArrayUtilities::norm(d_ete_vector);
-    // handle chains with same start/end particles (zero force)
-    if (d_ete_modulo <= 2.0 * std::numeric_limits<double>::epsilon()) {
-        return ArrayUtilities::Array3D();
-    }
-    const auto &l_contour_length =
-            static_cast<const SG::BondChain &>(chain).length_contour;
-    double relative_extension = d_ete_modulo / l_contour_length;
-    // TODO handle relative_extension ~ 1 (wlc_petrosyan_normalized
-    // would diverge)
-    // TODO: THis is a hack, if relative extension is close to one return zero.
-    // Most of the close-to-one relative extension comes from really short
-    // edges.
-    if (relative_extension > 0.98) {
-        relative_extension = 0.98;
-    }
     const auto bond_properties_physical =
             std::dynamic_pointer_cast<SG::BondPropertiesPhysical>(
                     chain.properties);
@@ -50,15 +37,76 @@ ArrayUtilities::Array3D force_function_wlc_petrosyan(const SG::Particle &a,
                 "properties of type BondPropertiesPhysical with "
                 "persistence_length and kT populated");
     }
-    const auto persistence_length =
-            bond_properties_physical->persistence_length;
-    const auto kT = bond_properties_physical->kT;
+    return force_function_wlc_petrosyan_with_parameters(
+            ArrayUtilities::minus(b.pos, a.pos), // F_{a, b}
+            static_cast<const SG::BondChain &>(chain).length_contour,
+            bond_properties_physical->persistence_length,
+            bond_properties_physical->kT);
+}
+
+ArrayUtilities::Array3D force_function_wlc_petrosyan_with_parameters(
+        const ArrayUtilities::Array3D &d_ete_vector,
+        const double l_contour_length,
+        const double persistence_length,
+        const double kT) {
+    return WLCPetrosyanBondKernel::force(d_ete_vector, l_contour_length,
+                                         persistence_length, kT);
+}
+
+ArrayUtilities::Array3D
+force_function_wlc_petrosyan_bond_table(const ArrayUtilities::Array3D &ab_vector,
+                                        const BondTable &table,
+                                        const size_t bond_index) {
+    return WLCPetrosyanBondKernel()(ab_vector, table, bond_index);
+}
+
+namespace {
+/**
+ * Apply a repulsive force_modulo(distance, sigma) to a, in the opposite
+ * direction of ab_vector.
+ */
+template <typename TForceModulo>
+ArrayUtilities::Array3D
+repulsive_force(const SG::Particle &a,
+                const SG::Particle &b,
+                const ArrayUtilities::Array3D &ab_vector,
+                const double sigma,
+                TForceModulo &&force_modulo) {
+    const auto distance = ArrayUtilities::norm(ab_vector);
+    // overlapping particles have no defined direction (zero force)
+    if (distance <= 2.0 * std::numeric_limits<double>::epsilon()) {
+        return ArrayUtilities::Array3D();
+    }
+    const auto contact_distance =
+            sigma > 0.0 ? sigma : a.material.radius + b.material.radius;
+    const auto modulo = force_modulo(distance, contact_distance);
+    return ArrayUtilities::product_scalar(ab_vector, -modulo / distance);
+}
+} // namespace
+
+force_function_particles_with_distance_t
+make_force_function_soft_sphere(const double sigma, const double stiffness) {
+    return [sigma, stiffness](const SG::Particle &a, const SG::Particle &b,
+                              const ArrayUtilities::Array3D &ab_vector) {
+        return repulsive_force(a, b, ab_vector, sigma,
+                               [stiffness](const double distance,
+                                           const double contact_distance) {
+                                   return force_soft_sphere(
+                                           distance, contact_distance,
+                                           stiffness);
+                               });
+    };
+}
 
-    const auto force_modulo = SG::force_extension_wlc_petrosyan(
-            relative_extension, persistence_length, kT);
-    // d_ete_vector/d_ete_modulo is the unitary vector, in the direction
-    // F_{a,b}
-    return ArrayUtilities::product_scalar(d_ete_vector,
-                                          force_modulo / d_ete_modulo);
+force_function_particles_with_distance_t
+make_force_function_wca(const double sigma, const double epsilon) {
+    return [sigma, epsilon](const SG::Particle &a, const SG::Particle &b,
+                            const ArrayUtilities::Array3D &ab_vector) {
+        return repulsive_force(
+                a, b, ab_vector, sigma,
+                [epsilon](const double distance, const double contact_distance) {
+                    return force_wca(distance, contact_distance, epsilon);
+                });
+    };
 }
 } // end namespace SG
@@ -19,21 +19,91 @@
  * *******************************************************************/
 
 #include "integrator.hpp"
+#include "parallel_tasks.hpp"
+#include "rng.hpp" // from core module
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 
 namespace SG {
 
+Integrator::~Integrator() {
+    // The force_types can outlive the integrator and its pool.
+    for (auto &force_type : force_types) {
+        if (force_type->thread_pool == m_thread_pool.get()) {
+            force_type->thread_pool = nullptr;
+        }
+    }
+}
+
+ThreadPool *Integrator::thread_pool() const {
+    const auto threads = resolve_num_threads(num_threads);
+    if (threads == 1) {
+        return nullptr;
+    }
+    if (!m_thread_pool || m_thread_pool->num_threads() != threads) {
+        m_thread_pool.reset(new ThreadPool(threads));
+    }
+    return m_thread_pool.get();
+}
+
 void Integrator::compute_net_forces(System *sys) const {
     const auto nparts = sys->all.particles.size();
-    for (size_t part_index = 0; part_index < nparts; ++part_index) {
-        auto &net_force = sys->all.particles[part_index].dynamics.net_force;
-        std::fill(net_force.begin(), net_force.end(), 0.0);
-        for (const auto &force_type : force_types) {
-            net_force = ArrayUtilities::plus(
-                    net_force, force_type->particle_forces[part_index].force);
-        };
+    const auto sum_forces = [&](const size_t begin, const size_t end) {
+        for (size_t part_index = begin; part_index < end; ++part_index) {
+            auto &net_force = sys->all.particles[part_index].dynamics.net_force;
+            std::fill(net_force.begin(), net_force.end(), 0.0);
+            for (const auto &force_type : force_types) {
+                net_force = ArrayUtilities::plus(
+                        net_force, force_type->particle_forces[part_index].force);
+            };
+        }
+    };
+    auto *pool = thread_pool();
+    if (pool) {
+        run_blocks(nparts, *pool, sum_forces);
+    } else {
+        sum_forces(0, nparts);
+    }
+}
+
+void Integrator::compute_forces() {
+    auto *pool = thread_pool();
+    const auto num_force_types = force_types.size();
+    if (pool == nullptr) {
+        for (auto &force_type : force_types) {
+            force_type->num_threads = 1;
+            force_type->thread_pool = nullptr;
+            force_type->compute();
+        }
+        return;
+    }
+    if (num_force_types >= pool->num_threads()) {
+        // Independent force types run concurrently, one per thread.
+        for (auto &force_type : force_types) {
+            force_type->num_threads = 1;
+            force_type->thread_pool = nullptr;
+        }
+        pool->run(num_force_types,
+                  [&](const size_t i) { force_types[i]->compute(); });
+        return;
+    }
+    // Each force type splits its work in blocks, in all the threads.
+    for (auto &force_type : force_types) {
+        force_type->num_threads = pool->num_threads();
+        force_type->thread_pool = pool;
+        force_type->compute();
     }
 }
 
+bool Integrator::update_collision_neighbor_list() {
+    if (!collision_neighbor_list_builder) {
+        return false;
+    }
+    return collision_neighbor_list_builder->update(m_sys);
+}
+
 void IntegratorTwoStep::update(unsigned int /* time_step */) {
     // sum all forces affecting every particles and
     // perform integration to get positions from forces.
@@ -41,29 +111,12 @@ void IntegratorTwoStep::update(unsigned int /* time_step */) {
         throw std::runtime_error("Provide an integrator method to Integrator");
     }
     this->integrator_method->integrateStepOne();
+    this->update_collision_neighbor_list();
     // compute all types of forces
-    for (auto &force_type : this->force_types) {
-        force_type->compute();
-        { // TODO remove debug
-            std::cout << "force_type: " << force_type->get_type() << std::endl;
-            for (auto &particle_force : force_type->particle_forces) {
-                std::cout << "Particle: " << particle_force.particle_id
-                          << ", force: "
-                          << ArrayUtilities::to_string(particle_force.force)
-                          << std::endl;
-            }
-        }
-    }
+    this->compute_forces();
     // sum net forces
     this->compute_net_forces(m_sys);
     this->integrator_method->integrateStepTwo();
-    { // TODO remove debug
-        for (auto &particle : m_sys->all.particles) {
-            std::cout << "id: " << particle.id << "; net_force: "
-                      << ArrayUtilities::to_string(particle.dynamics.net_force)
-                      << std::endl;
-        }
-    }
 }
 
 void VerletVelocitiesIntegratorMethod::integrateStepOne() {
@@ -104,4 +157,97 @@ void VerletVelocitiesIntegratorMethod::integrateStepTwo() {
                 ArrayUtilities::product_scalar(acceleration, deltaT * 0.5));
     }
 }
+
+namespace {
+void check_langevin_parameters(const double deltaT,
+                               const double kT,
+                               const double gamma) {
+    if (!(deltaT > 0.0)) {
+        throw std::runtime_error("deltaT has to be positive.");
+    }
+    if (!(kT >= 0.0)) {
+        throw std::runtime_error("kT cannot be negative.");
+    }
+    if (!(gamma > 0.0)) {
+        throw std::runtime_error("gamma (drag coefficient) has to be positive.");
+    }
+}
+} // namespace
+
+BrownianIntegratorMethod::BrownianIntegratorMethod(System *sys,
+                                                   double deltaT_input,
+                                                   double kT_input,
+                                                   double gamma_input,
+                                                   uint64_t seed_input)
+        : TwoStepIntegratorMethod(sys, deltaT_input), kT(kT_input),
+          gamma(gamma_input), seed(seed_input) {
+    check_langevin_parameters(deltaT, kT, gamma);
+}
+
+void BrownianIntegratorMethod::integrateStepOne() {
+    // r(t+deltaT) = r(t) + deltaT/gamma F(t) + sqrt(2 kT deltaT/gamma) xi
+    const double mobility_deltaT = deltaT / gamma;
+    const double noise_amplitude = std::sqrt(2.0 * kT * deltaT / gamma);
+    for (auto &particle : m_sys->all.particles) {
+        const auto noise = RNG::counter_based_normal(seed, step, particle.id);
+        const auto &force = particle.dynamics.net_force;
+        for (size_t dim = 0; dim < 3; ++dim) {
+            const double dr = mobility_deltaT * force[dim] +
+                              noise_amplitude * noise[dim];
+            particle.pos[dim] += dr;
+            particle.dynamics.vel[dim] = dr / deltaT;
+        }
+    }
+    ++step;
+}
+
+LangevinBAOABIntegratorMethod::LangevinBAOABIntegratorMethod(
+        System *sys,
+        double deltaT_input,
+        double kT_input,
+        double gamma_input,
+        uint64_t seed_input)
+        : TwoStepIntegratorMethod(sys, deltaT_input), kT(kT_input),
+          gamma(gamma_input), seed(seed_input) {
+    check_langevin_parameters(deltaT, kT, gamma);
+}
+
+void LangevinBAOABIntegratorMethod::integrateStepOne() {
+    const double half_deltaT = deltaT * 0.5;
+    for (auto &particle : m_sys->all.particles) {
+        auto &position = particle.pos;
+        auto &velocity = particle.dynamics.vel;
+        const auto &acceleration = particle.dynamics.acc;
+        const double mass = particle.material.mass;
+        // O: exact solution of dv = -gamma/m v dt + sqrt(2 gamma kT)/m dW
+        const double c1 = std::exp(-gamma * deltaT / mass);
+        const double noise_amplitude = std::sqrt((1.0 - c1 * c1) * kT / mass);
+        const auto noise = RNG::counter_based_normal(seed, step, particle.id);
+        for (size_t dim = 0; dim < 3; ++dim) {
+            // B
+            velocity[dim] += acceleration[dim] * half_deltaT;
+            // A
+            position[dim] += velocity[dim] * half_deltaT;
+            // O
+            velocity[dim] = c1 * velocity[dim] + noise_amplitude * noise[dim];
+            // A
+            position[dim] += velocity[dim] * half_deltaT;
+        }
+    }
+    ++step;
+}
+
+void LangevinBAOABIntegratorMethod::integrateStepTwo() {
+    // B: a(t+deltaT) = force/mass, v += 1/2 * a(t+deltaT)*deltaT
+    const double half_deltaT = deltaT * 0.5;
+    for (auto &particle : m_sys->all.particles) {
+        const double inverse_mass = 1.0 / particle.material.mass;
+        for (size_t dim = 0; dim < 3; ++dim) {
+            particle.dynamics.acc[dim] =
+                    particle.dynamics.net_force[dim] * inverse_mass;
+            particle.dynamics.vel[dim] +=
+                    particle.dynamics.acc[dim] * half_deltaT;
+        }
+    }
+}
 } // namespace SG
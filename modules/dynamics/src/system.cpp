@@ -19,6 +19,9 @@
  * *******************************************************************/
 
 #include "system.hpp"
+
+#include <algorithm>
+
 namespace SG {
 
 ArrayUtilities::Array3D &System::get_position(size_t index) {
@@ -39,6 +42,8 @@ ArrayUtilities::Array3D &System::get_acceleration(size_t index) {
 const ArrayUtilities::Array3D &System::get_acceleration(size_t index) const {
     return all.particles[index].dynamics.acc;
 }
+void System::invalidate_topology() { ++topology_version; }
+
 auto System::all_positions_copy() {
     const auto nparts = all.particles.size();
     std::vector<ArrayUtilities::Array3D> positions(nparts);
@@ -64,19 +69,33 @@ auto System::all_accelerations_copy() {
     return accelerations;
 }
 
-std::vector<Bond> unique_bonds(const System *sys) {
-    std::vector<Bond> bonds;
+std::vector<std::pair<size_t, size_t>> unique_bond_pairs(const System *sys) {
+    std::vector<std::pair<size_t, size_t>> pairs;
+    size_t num_conexions = 0;
+    for (const auto &particle_neighbor : sys->conexions) {
+        num_conexions += particle_neighbor.neighbors.size();
+    }
+    pairs.reserve(num_conexions);
     for (const auto &particle_neighbor : sys->conexions) {
         const auto source_particle_id = particle_neighbor.particle_id;
         for (const auto &neigh : particle_neighbor.neighbors) {
-            Bond bond = {source_particle_id, neigh};
-            sort(bond);
-            auto found = std::find(std::begin(bonds), std::end(bonds), bond);
-            if (found == std::end(bonds)) {
-                bonds.push_back(bond);
-            }
+            pairs.emplace_back(std::min(source_particle_id, neigh),
+                               std::max(source_particle_id, neigh));
         }
     }
+    std::sort(std::begin(pairs), std::end(pairs));
+    pairs.erase(std::unique(std::begin(pairs), std::end(pairs)),
+                std::end(pairs));
+    return pairs;
+}
+
+std::vector<Bond> unique_bonds(const System *sys) {
+    const auto pairs = unique_bond_pairs(sys);
+    std::vector<Bond> bonds;
+    bonds.reserve(pairs.size());
+    for (const auto &pair : pairs) {
+        bonds.emplace_back(pair.first, pair.second);
+    }
     return bonds;
 }
 } // namespace SG
@@ -0,0 +1,337 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "trajectory_io.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace SG {
+
+namespace {
+constexpr char trajectory_magic[8] = {'S', 'G', 'T', 'R', 'A', 'J', '0', '1'};
+constexpr uint32_t trajectory_version = 1;
+
+template <typename T> void write_value(std::ostream &os, const T &value) {
+    os.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+template <typename T> T read_value(std::istream &is) {
+    T value;
+    is.read(reinterpret_cast<char *>(&value), sizeof(T));
+    return value;
+}
+
+/** Number of Array3D blocks per frame: positions, velocities, forces. */
+size_t frame_num_blocks(const uint32_t contents) {
+    return 1 + ((contents & TRAJECTORY_VELOCITIES) ? 1 : 0) +
+           ((contents & TRAJECTORY_FORCES) ? 1 : 0);
+}
+size_t frame_size_bytes(const uint32_t contents, const size_t num_particles) {
+    return sizeof(uint64_t) +
+           frame_num_blocks(contents) * num_particles * 3 * sizeof(double);
+}
+} // namespace
+
+TrajectoryWriter::TrajectoryWriter(const std::string &file_name,
+                                   const System &sys,
+                                   const uint32_t contents)
+        : m_file(file_name, std::ios::binary | std::ios::trunc),
+          m_contents(contents), m_num_particles(sys.all.particles.size()) {
+    if (!m_file) {
+        throw std::runtime_error("TrajectoryWriter: cannot open " + file_name);
+    }
+    m_file.write(trajectory_magic, sizeof(trajectory_magic));
+    write_value<uint32_t>(m_file, trajectory_version);
+    write_value<uint32_t>(m_file, m_contents);
+    write_value<uint64_t>(m_file, m_num_particles);
+    write_value<uint64_t>(m_file, sys.bonds.bonds.size());
+    for (const auto &particle : sys.all.particles) {
+        write_value<uint64_t>(m_file, particle.id);
+        write_value<double>(m_file, particle.material.mass);
+        write_value<double>(m_file, particle.material.radius);
+        write_value<double>(m_file, particle.material.volume);
+    }
+    for (const auto &bond : sys.bonds.bonds) {
+        write_value<uint64_t>(m_file, bond->id_a);
+        write_value<uint64_t>(m_file, bond->id_b);
+    }
+    if (!m_file) {
+        throw std::runtime_error("TrajectoryWriter: error writing the header "
+                                 "of " + file_name);
+    }
+    const auto frame_size = frame_size_bytes(m_contents, m_num_particles);
+    m_front_buffer.resize(frame_size);
+    m_back_buffer.resize(frame_size);
+    m_thread = std::thread(&TrajectoryWriter::writer_loop, this);
+}
+
+TrajectoryWriter::~TrajectoryWriter() {
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+void TrajectoryWriter::writer_loop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_condition.wait(lock,
+                         [this]() { return m_back_buffer_pending || m_stop; });
+        if (!m_back_buffer_pending) {
+            // m_stop and nothing left to write
+            return;
+        }
+        // write_frame does not touch the back buffer while it is pending.
+        lock.unlock();
+        m_file.write(m_back_buffer.data(), m_back_buffer.size());
+        const bool failed = !m_file;
+        lock.lock();
+        if (failed && !m_error) {
+            m_error = std::make_exception_ptr(std::runtime_error(
+                    "TrajectoryWriter: error writing a frame."));
+        } else if (!failed) {
+            ++m_num_frames_written;
+        }
+        m_back_buffer_pending = false;
+        m_condition.notify_all();
+    }
+}
+
+void TrajectoryWriter::rethrow_error() {
+    if (m_error) {
+        auto error = m_error;
+        m_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void TrajectoryWriter::write_frame(const System &sys,
+                                   const uint64_t time_step) {
+    if (m_closed) {
+        throw std::runtime_error("TrajectoryWriter: write_frame after close.");
+    }
+    const auto &particles = sys.all.particles;
+    if (particles.size() != m_num_particles) {
+        throw std::runtime_error(
+                "TrajectoryWriter: the number of particles has changed.");
+    }
+    // Fill the front buffer without blocking the background thread.
+    char *data = m_front_buffer.data();
+    std::memcpy(data, &time_step, sizeof(uint64_t));
+    data += sizeof(uint64_t);
+    const auto copy_block = [&particles, &data](auto &&get_array) {
+        for (const auto &particle : particles) {
+            std::memcpy(data, get_array(particle).data(), 3 * sizeof(double));
+            data += 3 * sizeof(double);
+        }
+    };
+    copy_block([](const Particle &p) -> const ArrayUtilities::Array3D & {
+        return p.pos;
+    });
+    if (m_contents & TRAJECTORY_VELOCITIES) {
+        copy_block([](const Particle &p) -> const ArrayUtilities::Array3D & {
+            return p.dynamics.vel;
+        });
+    }
+    if (m_contents & TRAJECTORY_FORCES) {
+        copy_block([](const Particle &p) -> const ArrayUtilities::Array3D & {
+            return p.dynamics.net_force;
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this]() { return !m_back_buffer_pending; });
+    rethrow_error();
+    std::swap(m_front_buffer, m_back_buffer);
+    m_back_buffer_pending = true;
+    m_condition.notify_all();
+}
+
+void TrajectoryWriter::flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this]() { return !m_back_buffer_pending; });
+    rethrow_error();
+    if (!m_closed) {
+        m_file.flush();
+    }
+}
+
+void TrajectoryWriter::close() {
+    if (m_closed) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_file.close();
+    m_closed = true;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    rethrow_error();
+}
+
+size_t TrajectoryWriter::num_frames_written() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_num_frames_written;
+}
+
+TrajectoryReader::TrajectoryReader(const std::string &file_name)
+        : m_file(file_name, std::ios::binary) {
+    if (!m_file) {
+        throw std::runtime_error("TrajectoryReader: cannot open " + file_name);
+    }
+    char magic[sizeof(trajectory_magic)];
+    m_file.read(magic, sizeof(magic));
+    if (!m_file ||
+        !std::equal(std::begin(magic), std::end(magic), trajectory_magic)) {
+        throw std::runtime_error("TrajectoryReader: " + file_name +
+                                 " is not a trajectory file.");
+    }
+    const auto version = read_value<uint32_t>(m_file);
+    if (version != trajectory_version) {
+        throw std::runtime_error(
+                "TrajectoryReader: unsupported version of " + file_name);
+    }
+    m_contents = read_value<uint32_t>(m_file);
+    const auto num_particles = read_value<uint64_t>(m_file);
+    const auto num_bonds = read_value<uint64_t>(m_file);
+    if (!m_file) {
+        throw std::runtime_error("TrajectoryReader: truncated header in " +
+                                 file_name);
+    }
+    // Check that the particle and bond records fit in the file before
+    // allocating them, the division avoids overflows with corrupted counts.
+    const auto counts_end = m_file.tellg();
+    m_file.seekg(0, std::ios::end);
+    const auto file_size = m_file.tellg();
+    m_file.seekg(counts_end);
+    if (counts_end < 0 || file_size < counts_end) {
+        throw std::runtime_error("TrajectoryReader: cannot read " + file_name);
+    }
+    const auto remaining_size = static_cast<uint64_t>(file_size - counts_end);
+    constexpr uint64_t particle_record_size =
+            sizeof(uint64_t) + 3 * sizeof(double);
+    constexpr uint64_t bond_record_size = 2 * sizeof(uint64_t);
+    if (num_particles > remaining_size / particle_record_size ||
+        num_bonds > (remaining_size - num_particles * particle_record_size) /
+                            bond_record_size) {
+        throw std::runtime_error("TrajectoryReader: truncated header in " +
+                                 file_name);
+    }
+    m_particle_ids.resize(num_particles);
+    m_particle_material.resize(3 * num_particles);
+    for (size_t i = 0; i < num_particles; ++i) {
+        m_particle_ids[i] = read_value<uint64_t>(m_file);
+        m_file.read(reinterpret_cast<char *>(&m_particle_material[3 * i]),
+                    3 * sizeof(double));
+    }
+    m_bond_ids.resize(2 * num_bonds);
+    m_file.read(reinterpret_cast<char *>(m_bond_ids.data()),
+                m_bond_ids.size() * sizeof(uint64_t));
+    if (!m_file) {
+        throw std::runtime_error("TrajectoryReader: truncated header in " +
+                                 file_name);
+    }
+    m_header_size = m_file.tellg();
+    m_frame_size = frame_size_bytes(m_contents, num_particles);
+    m_buffer.resize(m_frame_size);
+}
+
+size_t TrajectoryReader::num_frames() {
+    m_file.clear();
+    m_file.seekg(0, std::ios::end);
+    const auto file_size = static_cast<std::streamoff>(m_file.tellg());
+    return static_cast<size_t>((file_size - m_header_size) / m_frame_size);
+}
+
+std::shared_ptr<System> TrajectoryReader::make_system() {
+    auto sys = std::make_shared<System>();
+    auto &particles = sys->all.particles;
+    particles.resize(num_particles());
+    for (size_t i = 0; i < particles.size(); ++i) {
+        particles[i].id = m_particle_ids[i];
+        particles[i].material.mass = m_particle_material[3 * i];
+        particles[i].material.radius = m_particle_material[3 * i + 1];
+        particles[i].material.volume = m_particle_material[3 * i + 2];
+    }
+    sys->all.sorted = std::is_sorted(
+            particles.begin(), particles.end(),
+            [](const Particle &a, const Particle &b) { return a.id < b.id; });
+    auto &bonds = sys->bonds.bonds;
+    bonds.reserve(num_bonds());
+    for (size_t i = 0; i < num_bonds(); ++i) {
+        bonds.push_back(std::make_shared<Bond>(m_bond_ids[2 * i],
+                                               m_bond_ids[2 * i + 1]));
+    }
+    if (num_frames() > 0) {
+        read_frame(0, *sys);
+    }
+    return sys;
+}
+
+uint64_t TrajectoryReader::read_frame(const size_t frame_index, System &sys) {
+    if (frame_index >= num_frames()) {
+        throw std::runtime_error("TrajectoryReader: frame " +
+                                 std::to_string(frame_index) +
+                                 " is not in the file.");
+    }
+    auto &particles = sys.all.particles;
+    if (particles.size() != num_particles()) {
+        throw std::runtime_error("TrajectoryReader: the number of particles "
+                                 "of the system differs from the file.");
+    }
+    m_file.clear();
+    m_file.seekg(m_header_size + static_cast<std::streamoff>(frame_index) *
+                                         m_frame_size);
+    m_file.read(m_buffer.data(), m_frame_size);
+    if (!m_file) {
+        throw std::runtime_error("TrajectoryReader: error reading frame " +
+                                 std::to_string(frame_index));
+    }
+    const char *data = m_buffer.data();
+    uint64_t time_step;
+    std::memcpy(&time_step, data, sizeof(uint64_t));
+    data += sizeof(uint64_t);
+    const auto read_block = [&particles, &data](auto &&get_array) {
+        for (auto &particle : particles) {
+            std::memcpy(get_array(particle).data(), data, 3 * sizeof(double));
+            data += 3 * sizeof(double);
+        }
+    };
+    read_block([](Particle &p) -> ArrayUtilities::Array3D & { return p.pos; });
+    if (m_contents & TRAJECTORY_VELOCITIES) {
+        read_block([](Particle &p) -> ArrayUtilities::Array3D & {
+            return p.dynamics.vel;
+        });
+    }
+    if (m_contents & TRAJECTORY_FORCES) {
+        read_block([](Particle &p) -> ArrayUtilities::Array3D & {
+            return p.dynamics.net_force;
+        });
+    }
+    return time_step;
+}
+
+} // namespace SG
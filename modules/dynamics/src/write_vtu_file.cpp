@@ -20,6 +20,7 @@
 
 #include "write_vtu_file.hpp"
 #include "bond.hpp"
+#include "trajectory_io.hpp"
 
 #include <vtkDoubleArray.h>
 #include <vtkIdTypeArray.h>
@@ -257,4 +258,24 @@ void read_vtu_bond_contour_length(vtkUnstructuredGrid *ugrid, System *sys) {
     }
 }
 
+size_t write_vtu_files_from_trajectory(const std::string &trajectory_file_name,
+                                       const std::string &output_prefix,
+                                       const size_t stride) {
+    if (stride == 0) {
+        throw std::runtime_error(
+                "write_vtu_files_from_trajectory: stride has to be positive.");
+    }
+    TrajectoryReader reader(trajectory_file_name);
+    auto sys = reader.make_system();
+    const auto num_frames = reader.num_frames();
+    size_t num_files = 0;
+    for (size_t frame = 0; frame < num_frames; frame += stride) {
+        const auto time_step = reader.read_frame(frame, *sys);
+        write_vtu_file(sys.get(), output_prefix + "_" +
+                                          std::to_string(time_step) + ".vtu");
+        ++num_files;
+    }
+    return num_files;
+}
+
 } // namespace SG
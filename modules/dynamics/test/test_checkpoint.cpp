@@ -0,0 +1,233 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "checkpoint.hpp"
+#include "dynamics_common_fixtures.hpp"
+#include "force_kernels.hpp"
+#include "rng.hpp" // from core module
+#include "gmock/gmock.h"
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <typeinfo>
+
+namespace {
+struct CheckpointSimulation {
+    std::shared_ptr<SG::System> sys = std::make_shared<SG::System4Fixture>();
+    SG::IntegratorTwoStep integrator;
+    CheckpointSimulation() : integrator(sys.get()) {
+        integrator.integrator_method =
+                std::make_shared<SG::LangevinBAOABIntegratorMethod>(
+                        sys.get(), 0.01, 1.0, 0.5, 7);
+        integrator.add_force(
+                std::make_shared<SG::PairBondForceT<SG::HarmonicBondKernel>>(
+                        sys.get(), SG::HarmonicBondKernel{2.0, 0.5}));
+        auto seeded_random_force =
+                std::make_shared<SG::ParticleRandomForceCompute>(
+                        sys.get(), 1.0, 0.5, 0.01);
+        seeded_random_force->set_seed(3);
+        integrator.add_force(seeded_random_force);
+        // Uses RNG::engine()
+        integrator.add_force(std::make_shared<SG::ParticleRandomForceCompute>(
+                sys.get(), 0.1, 0.5, 0.01));
+    }
+    void run(const size_t num_steps) {
+        for (size_t step = 0; step < num_steps; ++step) {
+            integrator.update(step);
+        }
+    }
+};
+
+void expect_equal_particles(const std::vector<SG::Particle> &expected,
+                            const std::vector<SG::Particle> &result) {
+    ASSERT_EQ(expected.size(), result.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(expected[i].id, result[i].id);
+        EXPECT_EQ(expected[i].pos, result[i].pos);
+        EXPECT_EQ(expected[i].dynamics.vel, result[i].dynamics.vel);
+        EXPECT_EQ(expected[i].dynamics.net_force,
+                  result[i].dynamics.net_force);
+    }
+}
+} // namespace
+
+TEST(Checkpoint, restart_is_bitwise_equal) {
+    const std::string file_name = "test_checkpoint_restart.sgchk";
+    CheckpointSimulation simulation;
+    simulation.run(10);
+    SG::write_checkpoint(file_name, *simulation.sys, &simulation.integrator,
+                         10);
+    simulation.run(10);
+    const auto expected = simulation.sys->all.particles;
+
+    // Restore in the same simulation.
+    EXPECT_EQ(SG::read_checkpoint(file_name, *simulation.sys,
+                                  &simulation.integrator),
+              10);
+    simulation.run(10);
+    expect_equal_particles(expected, simulation.sys->all.particles);
+
+    // Restore in a new simulation.
+    CheckpointSimulation restarted;
+    restarted.sys->all.particles[0].pos = {{5.0, 5.0, 5.0}};
+    EXPECT_EQ(SG::read_checkpoint(file_name, *restarted.sys,
+                                  &restarted.integrator),
+              10);
+    restarted.run(10);
+    expect_equal_particles(expected, restarted.sys->all.particles);
+    std::remove(file_name.c_str());
+}
+
+TEST(Checkpoint, bonds_and_properties) {
+    const std::string file_name = "test_checkpoint_bonds.sgchk";
+    SG::System4Fixture sys;
+    ASSERT_EQ(sys.bonds.bonds.size(), 3);
+    const auto shared_properties =
+            std::make_shared<SG::BondPropertiesPhysical>(2.0, 0.5);
+    shared_properties->tags = {1, 3};
+    sys.bonds.bonds[0]->properties = shared_properties;
+    sys.bonds.bonds[1]->properties = shared_properties;
+    sys.bonds.bonds[2]->properties =
+            std::make_shared<SG::BondProperties>(SG::BondProperties::tags_t{5});
+    static_cast<SG::BondChain &>(*sys.bonds.bonds[2]).length_contour = 1.5;
+    sys.bonds.bonds.push_back(std::make_shared<SG::Bond>(10, 13));
+    sys.bonds.bonds[3]->properties = nullptr;
+    SG::write_checkpoint(file_name, sys);
+
+    SG::System restored;
+    EXPECT_EQ(SG::read_checkpoint(file_name, restored), 0);
+    expect_equal_particles(sys.all.particles, restored.all.particles);
+    EXPECT_EQ(restored.all.sorted, sys.all.sorted);
+    ASSERT_EQ(restored.conexions.size(), sys.conexions.size());
+    for (size_t i = 0; i < sys.conexions.size(); ++i) {
+        EXPECT_EQ(restored.conexions[i].particle_id,
+                  sys.conexions[i].particle_id);
+        EXPECT_EQ(restored.conexions[i].neighbors,
+                  sys.conexions[i].neighbors);
+    }
+    const auto &bonds = restored.bonds.bonds;
+    ASSERT_EQ(bonds.size(), 4);
+    for (size_t i = 0; i < bonds.size(); ++i) {
+        EXPECT_EQ(bonds[i]->id_a, sys.bonds.bonds[i]->id_a);
+        EXPECT_EQ(bonds[i]->id_b, sys.bonds.bonds[i]->id_b);
+        EXPECT_EQ(typeid(*bonds[i]), typeid(*sys.bonds.bonds[i]));
+    }
+    EXPECT_DOUBLE_EQ(static_cast<SG::BondChain &>(*bonds[2]).length_contour,
+                     1.5);
+    EXPECT_EQ(bonds[0]->properties, bonds[1]->properties);
+    const auto physical = std::dynamic_pointer_cast<SG::BondPropertiesPhysical>(
+            bonds[0]->properties);
+    ASSERT_TRUE(physical);
+    EXPECT_EQ(physical->persistence_length, 2.0);
+    EXPECT_EQ(physical->kT, 0.5);
+    EXPECT_EQ(physical->tags, shared_properties->tags);
+    EXPECT_EQ(typeid(*bonds[2]->properties), typeid(SG::BondProperties));
+    EXPECT_EQ(bonds[2]->properties->tags, SG::BondProperties::tags_t{5});
+    EXPECT_FALSE(bonds[3]->properties);
+
+    // No integrator state in the checkpoint.
+    SG::IntegratorTwoStep integrator(&restored);
+    EXPECT_THROW(SG::read_checkpoint(file_name, restored, &integrator),
+                 std::runtime_error);
+    std::remove(file_name.c_str());
+}
+
+TEST(Checkpoint, throws_with_wrong_files) {
+    const std::string file_name = "test_checkpoint_wrong.sgchk";
+    SG::System sys;
+    EXPECT_THROW(SG::read_checkpoint("non_existing.sgchk", sys),
+                 std::runtime_error);
+
+    CheckpointSimulation simulation;
+    simulation.run(2);
+    SG::write_checkpoint(file_name, *simulation.sys, &simulation.integrator);
+    std::vector<char> data;
+    {
+        std::ifstream file(file_name, std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>());
+    }
+    // Different integrator method.
+    CheckpointSimulation other;
+    other.integrator.integrator_method =
+            std::make_shared<SG::VerletVelocitiesIntegratorMethod>(
+                    other.sys.get(), 0.01);
+    EXPECT_THROW(SG::read_checkpoint(file_name, *other.sys, &other.integrator),
+                 std::runtime_error);
+    // Truncated.
+    {
+        std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), data.size() / 2);
+    }
+    EXPECT_THROW(SG::read_checkpoint(file_name, sys), std::runtime_error);
+    // Not a checkpoint.
+    {
+        std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+        file << "not a checkpoint";
+    }
+    EXPECT_THROW(SG::read_checkpoint(file_name, sys), std::runtime_error);
+    std::remove(file_name.c_str());
+}
+
+TEST(Checkpoint, failed_read_leaves_state_unchanged) {
+    const std::string file_name = "test_checkpoint_unchanged.sgchk";
+    CheckpointSimulation simulation;
+    simulation.run(2);
+    std::ostringstream saved_engine;
+    saved_engine << RNG::engine();
+    SG::write_checkpoint(file_name, *simulation.sys, &simulation.integrator);
+
+    // The integrator method is only checked after the system is read.
+    CheckpointSimulation other;
+    other.integrator.integrator_method =
+            std::make_shared<SG::VerletVelocitiesIntegratorMethod>(
+                    other.sys.get(), 0.01);
+    other.run(3);
+    const auto particles = other.sys->all.particles;
+    const auto num_bonds = other.sys->bonds.bonds.size();
+    const auto engine = RNG::engine();
+    EXPECT_THROW(SG::read_checkpoint(file_name, *other.sys, &other.integrator),
+                 std::runtime_error);
+    expect_equal_particles(particles, other.sys->all.particles);
+    EXPECT_EQ(other.sys->bonds.bonds.size(), num_bonds);
+    EXPECT_EQ(RNG::engine(), engine);
+
+    // Corrupted state of the random engine.
+    std::string data;
+    {
+        std::ifstream file(file_name, std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>());
+    }
+    const auto engine_position = data.find(saved_engine.str());
+    ASSERT_NE(engine_position, std::string::npos);
+    data[engine_position] = 'x';
+    {
+        std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+    EXPECT_THROW(
+            SG::read_checkpoint(file_name, *simulation.sys,
+                                &simulation.integrator),
+            std::runtime_error);
+    EXPECT_EQ(RNG::engine(), engine);
+    std::remove(file_name.c_str());
+}
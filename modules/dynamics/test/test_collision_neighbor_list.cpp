@@ -0,0 +1,163 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "collision_neighbor_list.hpp"
+#include "gmock/gmock.h"
+
+#include <random>
+
+namespace {
+SG::System random_system(const size_t num_particles,
+                         const double box_size,
+                         const unsigned int seed = 42) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dis(0.0, box_size);
+    SG::System sys;
+    for (size_t i = 0; i < num_particles; ++i) {
+        SG::Particle p;
+        p.id = 2 * i + 1; // ids different than indices
+        p.pos = {{dis(gen), dis(gen), dis(gen)}};
+        sys.all.particles.push_back(p);
+    }
+    sys.all.sorted = true;
+    return sys;
+}
+
+/** Sorted neighbor ids per particle index, computed with all pairs. */
+std::vector<std::vector<size_t>>
+brute_force_neighbors(const SG::System &sys,
+                      const SG::CollisionNeighborListBuilder &builder,
+                      const double radius,
+                      const bool half_list) {
+    const auto n = sys.all.particles.size();
+    std::vector<std::vector<size_t>> neighbors(n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = half_list ? i + 1 : 0; j < n; ++j) {
+            if (i == j) {
+                continue;
+            }
+            const auto diff =
+                    builder.minus(sys.get_position(i), sys.get_position(j));
+            if (ArrayUtilities::norm(diff) < radius) {
+                neighbors[i].push_back(sys.all.particles[j].id);
+            }
+        }
+        std::sort(neighbors[i].begin(), neighbors[i].end());
+    }
+    return neighbors;
+}
+
+std::vector<std::vector<size_t>> sorted_neighbors(const SG::System &sys) {
+    std::vector<std::vector<size_t>> neighbors;
+    for (const auto &particle_neighbors : sys.collision_neighbor_list) {
+        neighbors.push_back(particle_neighbors.neighbors);
+        std::sort(neighbors.back().begin(), neighbors.back().end());
+    }
+    return neighbors;
+}
+} // namespace
+
+TEST(CollisionNeighborListBuilder, equal_to_brute_force) {
+    const double box_size = 10.0;
+    const double cutoff = 1.3;
+    for (const bool periodic : {false, true}) {
+        for (const bool half_list : {false, true}) {
+            auto sys = random_system(500, box_size);
+            SG::CollisionNeighborListBuilder builder(cutoff, 0.0, half_list);
+            if (periodic) {
+                builder.set_periodic_box({{box_size, box_size, box_size}});
+            }
+            builder.build(&sys);
+            ASSERT_EQ(sys.collision_neighbor_list.size(), 500);
+            for (size_t i = 0; i < 500; ++i) {
+                EXPECT_EQ(sys.collision_neighbor_list[i].particle_id,
+                          sys.all.particles[i].id);
+            }
+            EXPECT_EQ(sorted_neighbors(sys),
+                      brute_force_neighbors(sys, builder, cutoff, half_list));
+        }
+    }
+}
+
+TEST(CollisionNeighborListBuilder, periodic_small_box) {
+    // Less than 3 cells per dimension, and positions outside the box.
+    const double box_size = 3.0;
+    const double cutoff = 1.2;
+    auto sys = random_system(50, 2 * box_size);
+    SG::CollisionNeighborListBuilder builder(cutoff);
+    builder.set_periodic_box({{box_size, box_size, box_size}});
+    builder.build(&sys);
+    EXPECT_EQ(builder.num_cells()[0], 2);
+    EXPECT_EQ(sorted_neighbors(sys),
+              brute_force_neighbors(sys, builder, cutoff, false));
+}
+
+TEST(CollisionNeighborListBuilder, sparse_system) {
+    auto sys = random_system(20, 5.0);
+    sys.all.particles[3].pos = {{1e6, -1e6, 1e6}};
+    SG::CollisionNeighborListBuilder builder(1.0);
+    builder.build(&sys);
+    const auto &num_cells = builder.num_cells();
+    EXPECT_LE(num_cells[0] * num_cells[1] * num_cells[2], 8 * 20);
+    EXPECT_EQ(sorted_neighbors(sys),
+              brute_force_neighbors(sys, builder, 1.0, false));
+}
+
+TEST(CollisionNeighborListBuilder, verlet_skin) {
+    const double cutoff = 1.0;
+    const double skin = 0.4;
+    auto sys = random_system(300, 8.0);
+    SG::CollisionNeighborListBuilder builder(cutoff, skin);
+    EXPECT_TRUE(builder.update(&sys));
+    EXPECT_EQ(builder.num_builds(), 1);
+    EXPECT_FALSE(builder.update(&sys));
+
+    // Move all the particles less than skin / 2
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> dis(-0.1, 0.1);
+    for (auto &p : sys.all.particles) {
+        p.pos = ArrayUtilities::plus(p.pos, {{dis(gen), dis(gen), dis(gen)}});
+    }
+    EXPECT_FALSE(builder.update(&sys));
+    EXPECT_EQ(builder.num_builds(), 1);
+    // The list still contains all the pairs closer than cutoff
+    const auto expected = brute_force_neighbors(sys, builder, cutoff, false);
+    const auto neighbors = sorted_neighbors(sys);
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_TRUE(std::includes(neighbors[i].begin(), neighbors[i].end(),
+                                  expected[i].begin(), expected[i].end()));
+    }
+
+    // Move one particle more than skin / 2
+    sys.all.particles[10].pos[0] += 0.3;
+    EXPECT_TRUE(builder.update(&sys));
+    EXPECT_EQ(builder.num_builds(), 2);
+    EXPECT_EQ(sorted_neighbors(sys),
+              brute_force_neighbors(sys, builder, cutoff + skin, false));
+}
+
+TEST(CollisionNeighborListBuilder, throws_with_wrong_parameters) {
+    EXPECT_THROW(SG::CollisionNeighborListBuilder(0.0), std::runtime_error);
+    EXPECT_THROW(SG::CollisionNeighborListBuilder(1.0, -1.0),
+                 std::runtime_error);
+    SG::CollisionNeighborListBuilder builder(1.0);
+    EXPECT_THROW(builder.set_periodic_box({{1.0, 0.0, 1.0}}),
+                 std::runtime_error);
+}
@@ -0,0 +1,105 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "dynamics_common_fixtures.hpp"
+#include "fire_minimizer.hpp"
+#include "force_compute.hpp"
+#include "force_kernels.hpp"
+#include "integrator.hpp"
+#include "gmock/gmock.h"
+
+#include <random>
+
+namespace {
+/** Random walk of num_particles connected by bonds, with random extra bonds
+ * to get a frustrated network. */
+std::shared_ptr<SG::System> random_network_system(const size_t num_particles) {
+    auto sys = std::make_shared<SG::System>();
+    std::mt19937 gen(3);
+    std::normal_distribution<double> step_dis(0.0, 0.6);
+    std::uniform_int_distribution<size_t> index_dis(0, num_particles - 1);
+    ArrayUtilities::Array3D pos = {{0.0, 0.0, 0.0}};
+    sys->all.particles.resize(num_particles);
+    for (size_t i = 0; i < num_particles; ++i) {
+        sys->all.particles[i].id = i;
+        sys->all.particles[i].pos = pos;
+        pos = ArrayUtilities::plus(
+                pos, {{step_dis(gen), step_dis(gen), step_dis(gen)}});
+    }
+    sys->all.sorted = true;
+    for (size_t i = 0; i + 1 < num_particles; ++i) {
+        sys->bonds.bonds.push_back(std::make_shared<SG::Bond>(i, i + 1));
+    }
+    for (size_t i = 0; i < num_particles / 5; ++i) {
+        const auto a = index_dis(gen);
+        const auto b = index_dis(gen);
+        if (a != b) {
+            sys->bonds.bonds.push_back(std::make_shared<SG::Bond>(a, b));
+        }
+    }
+    return sys;
+}
+} // namespace
+
+TEST(FIREMinimizer, spring_relaxes_to_rest_length) {
+    SG::System4Fixture sys;
+    // Stretch the bond 0-1 and the others
+    sys.all.particles[0].pos = {{-1.0, 0.0, 0.0}};
+    SG::IntegratorTwoStep integrator(&sys);
+    integrator.add_force(
+            std::make_shared<SG::PairBondForceT<SG::HarmonicBondKernel>>(
+                    &sys, SG::HarmonicBondKernel{1.0, 1.0}));
+    SG::FIREMinimizer minimizer(&sys, &integrator);
+    minimizer.force_tolerance = 1e-8;
+    const auto result = minimizer.minimize();
+    EXPECT_TRUE(result.converged);
+    EXPECT_LE(result.max_force, 1e-8);
+    for (const auto &bond : sys.bonds.bonds) {
+        const auto distance = ArrayUtilities::distance(
+                sys.all.particles[sys.all.find_index(bond->id_a)].pos,
+                sys.all.particles[sys.all.find_index(bond->id_b)].pos);
+        EXPECT_NEAR(distance, 1.0, 1e-7);
+    }
+}
+
+TEST(FIREMinimizer, network_converges) {
+    const auto sys = random_network_system(500);
+    SG::IntegratorTwoStep integrator(sys.get());
+    auto bond_force = integrator.add_force(
+            std::make_shared<SG::PairBondForceT<SG::HarmonicBondKernel>>(
+                    sys.get(), SG::HarmonicBondKernel{10.0, 1.0}));
+    SG::FIREMinimizer minimizer(sys.get(), &integrator);
+    minimizer.deltaT = 0.02;
+    minimizer.force_tolerance = 1e-6;
+    const auto result = minimizer.minimize();
+    EXPECT_TRUE(result.converged);
+    EXPECT_EQ(result.num_force_evaluations, result.num_iterations + 1);
+    EXPECT_LT(result.num_iterations, minimizer.max_iterations);
+    for (const auto &pf : bond_force->particle_forces) {
+        EXPECT_LE(ArrayUtilities::norm(pf.force), 1e-6);
+    }
+
+    SG::FIREMinimizer not_enough(sys.get(), &integrator);
+    sys->all.particles[0].pos = {{10.0, 10.0, 10.0}};
+    not_enough.max_iterations = 2;
+    const auto result_not_enough = not_enough.minimize();
+    EXPECT_FALSE(result_not_enough.converged);
+    EXPECT_EQ(result_not_enough.num_iterations, 2);
+}
@@ -0,0 +1,126 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "dynamics_common_fixtures.hpp"
+#include "force_compute.hpp"
+#include "force_functions.hpp"
+#include "force_kernels.hpp"
+#include "gmock/gmock.h"
+
+namespace {
+/** System4Fixture with persistence_length and kT in the bonds. */
+struct PhysicalBondsSystem : public SG::System4Fixture {
+    PhysicalBondsSystem() : SG::System4Fixture() {
+        double contour_length = 1.5;
+        for (auto &bond : bonds.bonds) {
+            bond->properties =
+                    std::make_shared<SG::BondPropertiesPhysical>(2.0, 0.5);
+            static_cast<SG::BondChain &>(*bond).length_contour =
+                    contour_length;
+            contour_length += 0.25;
+        }
+        all.particles[2].pos = {{2.2, 0.1, 0.0}};
+    }
+};
+} // namespace
+
+TEST(PairBondForceT, wlc_kernel_equal_to_force_function) {
+    PhysicalBondsSystem sys;
+    SG::PairBondForce generic(&sys, SG::force_function_wlc_petrosyan);
+    generic.compute();
+    SG::PairBondForceT<SG::WLCPetrosyanBondKernel> kernel_force(&sys);
+    kernel_force.compute();
+    EXPECT_EQ(kernel_force.get_type(), "PairBondForceT");
+    ASSERT_EQ(kernel_force.particle_forces.size(),
+              generic.particle_forces.size());
+    for (size_t i = 0; i < generic.particle_forces.size(); ++i) {
+        EXPECT_EQ(kernel_force.particle_forces[i].force,
+                  generic.particle_forces[i].force);
+    }
+    for (size_t i = 0; i < generic.bond_forces.size(); ++i) {
+        EXPECT_EQ(kernel_force.bond_forces[i].force,
+                  generic.bond_forces[i].force);
+    }
+
+    kernel_force.num_threads = 3;
+    kernel_force.compute();
+    for (size_t i = 0; i < generic.particle_forces.size(); ++i) {
+        EXPECT_EQ(kernel_force.particle_forces[i].force,
+                  generic.particle_forces[i].force);
+    }
+}
+
+TEST(PairBondForceT, wlc_kernel_throws_without_physical_properties) {
+    SG::System4Fixture sys;
+    SG::PairBondForceT<SG::WLCPetrosyanBondKernel> kernel_force(&sys);
+    EXPECT_THROW(kernel_force.compute(), std::runtime_error);
+}
+
+TEST(PairBondForceT, harmonic_kernel) {
+    SG::System4Fixture sys;
+    // particles 0 (0,0,0) and 1 (1,0,0) are bonded
+    SG::HarmonicBondKernel harmonic;
+    harmonic.stiffness = 2.0;
+    harmonic.rest_length = 0.5;
+    SG::PairBondForceT<SG::HarmonicBondKernel> force(&sys, harmonic);
+    force.compute();
+    // F_ab = k * (r - r0) = 2 * 0.5, towards b.
+    const auto &bond_force = force.bond_forces[0].force;
+    EXPECT_DOUBLE_EQ(bond_force[0], 1.0);
+    EXPECT_DOUBLE_EQ(bond_force[1], 0.0);
+    EXPECT_DOUBLE_EQ(bond_force[2], 0.0);
+    // Net force is zero for internal forces.
+    ArrayUtilities::Array3D total_force = {{0.0, 0.0, 0.0}};
+    for (const auto &pf : force.particle_forces) {
+        total_force = ArrayUtilities::plus(total_force, pf.force);
+    }
+    for (size_t dim = 0; dim < 3; ++dim) {
+        EXPECT_NEAR(total_force[dim], 0.0, 1e-12);
+    }
+}
+
+TEST(ParticleForceComputeT, drag_kernels) {
+    SG::System4Fixture sys;
+    for (auto &p : sys.all.particles) {
+        p.dynamics.vel = {{1.0, -2.0, 0.5}};
+        p.material.radius = 0.5;
+    }
+    SG::ParticleForceComputeT<SG::LinearDragParticleKernel> linear_drag(
+            &sys, SG::LinearDragParticleKernel{3.0});
+    linear_drag.compute();
+    SG::ParticleForceCompute generic(&sys, [](const SG::Particle &p) {
+        return SG::force_linear_drag(3.0, p.dynamics.vel);
+    });
+    generic.compute();
+    for (size_t i = 0; i < generic.particle_forces.size(); ++i) {
+        EXPECT_EQ(linear_drag.particle_forces[i].force,
+                  generic.particle_forces[i].force);
+    }
+    EXPECT_DOUBLE_EQ(linear_drag.particle_forces[0].force[1], 6.0);
+
+    SG::ParticleForceComputeT<SG::StokesDragParticleKernel> stokes_drag(
+            &sys, SG::StokesDragParticleKernel{2.0});
+    stokes_drag.num_threads = 2;
+    stokes_drag.compute();
+    const auto expected = SG::force_linear_drag(0.5, 2.0, {{1.0, -2.0, 0.5}});
+    for (const auto &pf : stokes_drag.particle_forces) {
+        EXPECT_EQ(pf.force, expected);
+    }
+}
@@ -0,0 +1,165 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "dynamics_common_fixtures.hpp"
+#include "force_compute.hpp"
+#include "force_kernels.hpp"
+#include "integrator.hpp"
+#include "gmock/gmock.h"
+
+namespace {
+/** num_particles free particles at the origin. */
+std::shared_ptr<SG::System> free_particles_system(const size_t num_particles) {
+    auto sys = std::make_shared<SG::System>();
+    sys->all.particles.resize(num_particles);
+    for (size_t i = 0; i < num_particles; ++i) {
+        sys->all.particles[i].id = i;
+        sys->all.particles[i].pos = {{0.0, 0.0, 0.0}};
+    }
+    sys->all.sorted = true;
+    return sys;
+}
+
+double mean_squared_displacement(const SG::System &sys) {
+    double msd = 0.0;
+    for (const auto &p : sys.all.particles) {
+        msd += ArrayUtilities::dot_product(p.pos, p.pos);
+    }
+    return msd / sys.all.particles.size();
+}
+} // namespace
+
+TEST(BrownianIntegratorMethod, free_diffusion) {
+    const auto sys = free_particles_system(5000);
+    const double kT = 1.0;
+    const double gamma = 2.0;
+    const double deltaT = 0.1;
+    const size_t num_steps = 50;
+    SG::IntegratorTwoStep integrator(sys.get());
+    integrator.integrator_method =
+            std::make_shared<SG::BrownianIntegratorMethod>(sys.get(), deltaT,
+                                                           kT, gamma, 42);
+    for (size_t step = 0; step < num_steps; ++step) {
+        integrator.update(step);
+    }
+    // <r^2> = 6 D t, D = kT / gamma
+    const double expected = 6.0 * kT / gamma * deltaT * num_steps;
+    EXPECT_NEAR(mean_squared_displacement(*sys), expected, 0.05 * expected);
+}
+
+TEST(BrownianIntegratorMethod, drift_without_temperature) {
+    SG::System4Fixture sys;
+    const double gamma = 2.0;
+    const double deltaT = 0.1;
+    SG::IntegratorTwoStep integrator(&sys);
+    integrator.integrator_method =
+            std::make_shared<SG::BrownianIntegratorMethod>(&sys, deltaT, 0.0,
+                                                           gamma);
+    // Constant force F = -gamma * (-1, 0, 0) = (2, 0, 0)
+    SG::LinearDragParticleKernel constant_force{gamma};
+    for (auto &p : sys.all.particles) {
+        p.dynamics.vel = {{-1.0, 0.0, 0.0}};
+    }
+    const auto initial_positions = sys.all.particles;
+    integrator.add_force(
+            std::make_shared<SG::ParticleForceComputeT<
+                    SG::LinearDragParticleKernel>>(&sys, constant_force));
+    integrator.compute_forces();
+    integrator.compute_net_forces(&sys);
+    integrator.update(0);
+    // dr = deltaT / gamma * F = 0.1
+    for (size_t i = 0; i < sys.all.particles.size(); ++i) {
+        EXPECT_DOUBLE_EQ(sys.all.particles[i].pos[0],
+                         initial_positions[i].pos[0] + 0.1);
+        EXPECT_DOUBLE_EQ(sys.all.particles[i].pos[1],
+                         initial_positions[i].pos[1]);
+    }
+    EXPECT_THROW(SG::BrownianIntegratorMethod(&sys, deltaT, 1.0, 0.0),
+                 std::runtime_error);
+}
+
+TEST(LangevinBAOABIntegratorMethod, equipartition) {
+    const auto sys = free_particles_system(5000);
+    for (size_t i = 0; i < sys->all.particles.size(); ++i) {
+        sys->all.particles[i].material.mass = 1.0 + (i % 3);
+    }
+    const double kT = 1.5;
+    SG::IntegratorTwoStep integrator(sys.get());
+    integrator.integrator_method =
+            std::make_shared<SG::LangevinBAOABIntegratorMethod>(
+                    sys.get(), 0.5, kT, 1.0, 7);
+    for (size_t step = 0; step < 50; ++step) {
+        integrator.update(step);
+    }
+    // <m v^2> = 3 kT
+    double mean_m_v2 = 0.0;
+    for (const auto &p : sys->all.particles) {
+        mean_m_v2 += p.material.mass *
+                     ArrayUtilities::dot_product(p.dynamics.vel,
+                                                 p.dynamics.vel);
+    }
+    mean_m_v2 /= sys->all.particles.size();
+    EXPECT_NEAR(mean_m_v2, 3.0 * kT, 0.05 * 3.0 * kT);
+}
+
+TEST(LangevinBAOABIntegratorMethod, reproducible) {
+    const auto run = []() {
+        SG::System4Fixture sys;
+        SG::IntegratorTwoStep integrator(&sys);
+        integrator.integrator_method =
+                std::make_shared<SG::LangevinBAOABIntegratorMethod>(
+                        &sys, 0.01, 1.0, 1.0, 123);
+        integrator.add_force(std::make_shared<
+                             SG::PairBondForceT<SG::HarmonicBondKernel>>(
+                &sys, SG::HarmonicBondKernel{10.0, 1.0}));
+        for (size_t step = 0; step < 20; ++step) {
+            integrator.update(step);
+        }
+        return sys.all.particles;
+    };
+    const auto particles = run();
+    const auto particles_again = run();
+    for (size_t i = 0; i < particles.size(); ++i) {
+        EXPECT_EQ(particles[i].pos, particles_again[i].pos);
+        EXPECT_EQ(particles[i].dynamics.vel, particles_again[i].dynamics.vel);
+    }
+}
+
+TEST(BrownianIntegratorMethod, reproducible) {
+    const auto run = []() {
+        SG::System4Fixture sys;
+        SG::IntegratorTwoStep integrator(&sys);
+        integrator.integrator_method =
+                std::make_shared<SG::BrownianIntegratorMethod>(&sys, 0.01, 1.0,
+                                                               1.0, 123);
+        integrator.add_force(std::make_shared<
+                             SG::PairBondForceT<SG::HarmonicBondKernel>>(
+                &sys, SG::HarmonicBondKernel{10.0, 1.0}));
+        for (size_t step = 0; step < 20; ++step) {
+            integrator.update(step);
+        }
+        return sys.all.particles;
+    };
+    const auto particles = run();
+    const auto particles_again = run();
+    for (size_t i = 0; i < particles.size(); ++i) {
+        EXPECT_EQ(particles[i].pos, particles_again[i].pos);
+    }
+}
@@ -0,0 +1,174 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "dynamics_common_fixtures.hpp"
+#include "force_compute.hpp"
+#include "force_functions.hpp"
+#include "gmock/gmock.h"
+
+#include <cmath>
+
+namespace {
+/** System4Fixture with persistence_length and kT in the bonds. */
+struct PhysicalBondsSystem : public SG::System4Fixture {
+    PhysicalBondsSystem() : SG::System4Fixture() {
+        double contour_length = 1.5;
+        for (auto &bond : bonds.bonds) {
+            bond->properties =
+                    std::make_shared<SG::BondPropertiesPhysical>(2.0, 0.5);
+            static_cast<SG::BondChain &>(*bond).length_contour =
+                    contour_length;
+            contour_length += 0.25;
+        }
+    }
+};
+} // namespace
+
+TEST(BondTable, build) {
+    PhysicalBondsSystem sys;
+    std::vector<const SG::Bond *> bonds;
+    for (const auto &bond : sys.bonds.bonds) {
+        bonds.push_back(bond.get());
+    }
+    SG::Bond plain_bond(10, 13);
+    bonds.push_back(&plain_bond);
+    SG::BondTable table;
+    table.build(sys.all, bonds);
+    ASSERT_EQ(table.size(), 4);
+    EXPECT_EQ(table.num_particles, 4);
+    for (size_t i = 0; i < table.size(); ++i) {
+        EXPECT_EQ(sys.all.particles[table.index_a[i]].id, bonds[i]->id_a);
+        EXPECT_EQ(sys.all.particles[table.index_b[i]].id, bonds[i]->id_b);
+    }
+    EXPECT_DOUBLE_EQ(table.contour_length[0], 1.5);
+    EXPECT_DOUBLE_EQ(table.persistence_length[0], 2.0);
+    EXPECT_DOUBLE_EQ(table.kT[0], 0.5);
+    // Plain bond, no parameters
+    EXPECT_TRUE(std::isnan(table.contour_length[3]));
+    EXPECT_TRUE(std::isnan(table.kT[3]));
+
+    SG::Bond missing_bond(10, 100);
+    bonds.push_back(&missing_bond);
+    EXPECT_THROW(table.build(sys.all, bonds), std::runtime_error);
+}
+
+TEST(PairBondForce, bond_table_force_function_equal_to_force_function) {
+    PhysicalBondsSystem sys;
+    sys.all.particles[2].pos = {{2.2, 0.1, 0.0}};
+    SG::PairBondForce generic(&sys, SG::force_function_wlc_petrosyan);
+    generic.compute();
+    SG::PairBondForce table_force(&sys);
+    table_force.bond_table_force_function =
+            SG::force_function_wlc_petrosyan_bond_table;
+    table_force.compute();
+    ASSERT_EQ(generic.bond_table.size(), sys.bonds.bonds.size());
+    for (size_t i = 0; i < sys.all.particles.size(); ++i) {
+        for (size_t dim = 0; dim < 3; ++dim) {
+            EXPECT_DOUBLE_EQ(generic.particle_forces[i].force[dim],
+                             table_force.particle_forces[i].force[dim]);
+        }
+    }
+    for (size_t i = 0; i < generic.bond_forces.size(); ++i) {
+        EXPECT_EQ(generic.bond_forces[i].force,
+                  table_force.bond_forces[i].force);
+    }
+    // Newton's third law
+    ArrayUtilities::Array3D total_force = {{0.0, 0.0, 0.0}};
+    for (const auto &particle_force : generic.particle_forces) {
+        total_force = ArrayUtilities::plus(total_force, particle_force.force);
+    }
+    EXPECT_NEAR(ArrayUtilities::norm(total_force), 0.0, 1e-12);
+
+    // Missing parameters in the table
+    SG::System4Fixture sys_without_properties;
+    SG::PairBondForce table_force_without_properties(&sys_without_properties);
+    table_force_without_properties.bond_table_force_function =
+            SG::force_function_wlc_petrosyan_bond_table;
+    EXPECT_THROW(table_force_without_properties.compute(),
+                 std::runtime_error);
+}
+
+TEST(PairBondForce, bond_table_is_rebuilt_when_particles_change) {
+    PhysicalBondsSystem sys;
+    SG::PairBondForce force_compute(&sys, SG::force_function_wlc_petrosyan);
+    EXPECT_TRUE(force_compute.bond_table_needs_update());
+    force_compute.compute();
+    EXPECT_FALSE(force_compute.bond_table_needs_update());
+    const auto force_before = force_compute.particle_forces[1].force;
+
+    // Same number of particles, but particle with id 13 is now at index 0.
+    auto moved_particle = sys.all.particles[3];
+    moved_particle.id = 9;
+    sys.all.particles.pop_back();
+    sys.all.particles.insert(sys.all.particles.begin(), moved_particle);
+    for (auto &bond : sys.bonds.bonds) {
+        if (bond->id_b == 13) {
+            bond->id_a = 9;
+            bond->id_b = 11;
+        }
+    }
+    for (size_t i = 0; i < sys.all.particles.size(); ++i) {
+        force_compute.particle_forces[i].particle_id = sys.all.particles[i].id;
+    }
+    // Same sizes, the change has to be signaled.
+    EXPECT_FALSE(force_compute.bond_table_needs_update());
+    sys.invalidate_topology();
+    EXPECT_TRUE(force_compute.bond_table_needs_update());
+    force_compute.compute();
+    EXPECT_FALSE(force_compute.bond_table_needs_update());
+    EXPECT_EQ(force_compute.bond_table.index_a.back(), 0);
+    // particle with id 11 (middle particle) is now at index 2.
+    for (size_t dim = 0; dim < 3; ++dim) {
+        EXPECT_NEAR(force_compute.particle_forces[2].force[dim],
+                    force_before[dim], 1e-12);
+    }
+}
+
+TEST(PairBondForce, bond_table_is_rebuilt_when_bonds_change) {
+    PhysicalBondsSystem sys;
+    SG::PairBondForce force_compute(&sys, SG::force_function_wlc_petrosyan);
+    force_compute.compute();
+    // Same number of bonds and particles, the bond 10-11 is now 10-12.
+    auto &bond = *sys.bonds.bonds[0];
+    ASSERT_EQ(bond.id_a, 10);
+    ASSERT_EQ(bond.id_b, 11);
+    bond.id_b = 12;
+    EXPECT_FALSE(force_compute.bond_table_needs_update());
+    sys.invalidate_topology();
+    EXPECT_TRUE(force_compute.bond_table_needs_update());
+    force_compute.compute();
+    EXPECT_EQ(force_compute.bond_table.index_b[0], 2);
+    SG::PairBondForce expected(&sys, SG::force_function_wlc_petrosyan);
+    expected.compute();
+    for (size_t i = 0; i < sys.all.particles.size(); ++i) {
+        for (size_t dim = 0; dim < 3; ++dim) {
+            EXPECT_DOUBLE_EQ(force_compute.particle_forces[i].force[dim],
+                             expected.particle_forces[i].force[dim]);
+        }
+    }
+
+    // A different bond object with the same particles.
+    auto other_bond = std::make_shared<SG::BondChain>(10, 12, 3.0);
+    other_bond->properties = bond.properties;
+    force_compute.bond_forces[0].bond = other_bond.get();
+    force_compute.update_bond_table();
+    force_compute.compute();
+    EXPECT_DOUBLE_EQ(force_compute.bond_table.contour_length[0], 3.0);
+}
@@ -0,0 +1,165 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "force_compute.hpp"
+#include "force_functions.hpp"
+#include "integrator.hpp"
+#include "gmock/gmock.h"
+
+#include <random>
+
+namespace {
+SG::System two_particles_system(const ArrayUtilities::Array3D &pos_a,
+                                const ArrayUtilities::Array3D &pos_b) {
+    SG::System sys;
+    SG::Particle a;
+    a.id = 0;
+    a.pos = pos_a;
+    SG::Particle b;
+    b.id = 1;
+    b.pos = pos_b;
+    sys.all.particles = {a, b};
+    sys.all.sorted = true;
+    return sys;
+}
+} // namespace
+
+TEST(unbonded_forces, soft_sphere_and_wca) {
+    EXPECT_DOUBLE_EQ(SG::force_soft_sphere(0.5, 1.0, 2.0), 1.0);
+    EXPECT_DOUBLE_EQ(SG::force_soft_sphere(1.5, 1.0, 2.0), 0.0);
+    EXPECT_DOUBLE_EQ(SG::force_wca(1.0, 1.0, 1.0), 24.0);
+    EXPECT_NEAR(SG::force_wca(std::pow(2.0, 1.0 / 6.0) - 1e-12, 1.0, 1.0), 0.0,
+                1e-9);
+    EXPECT_DOUBLE_EQ(SG::force_wca(1.2, 1.0, 1.0), 0.0);
+}
+
+TEST(PairNeighborForce, two_particles) {
+    auto sys = two_particles_system({{0.0, 0.0, 0.0}}, {{0.5, 0.0, 0.0}});
+    auto builder = std::make_shared<SG::CollisionNeighborListBuilder>(1.0);
+    builder->build(&sys);
+    SG::PairNeighborForce force_compute(
+            &sys, builder, SG::make_force_function_soft_sphere(1.0, 2.0));
+    force_compute.compute();
+    EXPECT_EQ(force_compute.particle_forces[0].force,
+              (ArrayUtilities::Array3D{{-1.0, 0.0, 0.0}}));
+    EXPECT_EQ(force_compute.particle_forces[1].force,
+              (ArrayUtilities::Array3D{{1.0, 0.0, 0.0}}));
+
+    // cutoff smaller than the distance
+    force_compute.cutoff = 0.4;
+    force_compute.compute();
+    EXPECT_EQ(force_compute.particle_forces[0].force,
+              ArrayUtilities::Array3D());
+
+    // cutoff larger than the one of the neighbor list
+    force_compute.cutoff = 1.5;
+    EXPECT_THROW(force_compute.compute(), std::runtime_error);
+    auto builder_with_skin =
+            std::make_shared<SG::CollisionNeighborListBuilder>(1.0, 0.5);
+    EXPECT_THROW(SG::PairNeighborForce(
+                         &sys, builder_with_skin,
+                         SG::make_force_function_soft_sphere(1.0, 2.0), 1.2),
+                 std::runtime_error);
+}
+
+TEST(PairNeighborForce, periodic_box) {
+    auto sys = two_particles_system({{0.1, 5.0, 5.0}}, {{9.9, 5.0, 5.0}});
+    auto builder = std::make_shared<SG::CollisionNeighborListBuilder>(1.0);
+    builder->set_periodic_box({{10.0, 10.0, 10.0}});
+    builder->build(&sys);
+    // sigma <= 0 uses the sum of the radius of the particles (2.0),
+    // the distance between the particles is 0.2 with the minimum image.
+    SG::PairNeighborForce force_compute(
+            &sys, builder, SG::make_force_function_soft_sphere(0.0, 1.0));
+    force_compute.compute();
+    // a is pushed away from the image of b, in +x
+    EXPECT_NEAR(force_compute.particle_forces[0].force[0], 1.8, 1e-12);
+    EXPECT_NEAR(force_compute.particle_forces[1].force[0], -1.8, 1e-12);
+}
+
+TEST(PairNeighborForce, half_and_full_list_equal_to_all_pairs) {
+    const size_t num_particles = 400;
+    const double box_size = 8.0;
+    const double sigma = 1.0;
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> dis(0.0, box_size);
+    SG::System sys;
+    for (size_t i = 0; i < num_particles; ++i) {
+        SG::Particle p;
+        p.id = 10 + 3 * i; // ids different than indices
+        p.pos = {{dis(gen), dis(gen), dis(gen)}};
+        sys.all.particles.push_back(p);
+    }
+    sys.all.sorted = true;
+    const auto force_function = SG::make_force_function_wca(sigma, 1.0);
+    const double cutoff = std::pow(2.0, 1.0 / 6.0) * sigma;
+
+    std::vector<ArrayUtilities::Array3D> expected(num_particles);
+    for (size_t i = 0; i < num_particles; ++i) {
+        for (size_t j = 0; j < num_particles; ++j) {
+            if (i == j) {
+                continue;
+            }
+            const auto &a = sys.all.particles[i];
+            const auto &b = sys.all.particles[j];
+            expected[i] = ArrayUtilities::plus(
+                    expected[i],
+                    force_function(a, b, ArrayUtilities::minus(b.pos, a.pos)));
+        }
+    }
+
+    for (const bool half_list : {false, true}) {
+        auto builder = std::make_shared<SG::CollisionNeighborListBuilder>(
+                cutoff, 0.3, half_list);
+        builder->build(&sys);
+        SG::PairNeighborForce force_compute(&sys, builder, force_function);
+        force_compute.compute();
+        ArrayUtilities::Array3D total_force = {{0.0, 0.0, 0.0}};
+        double total_force_norm = 0.0;
+        for (size_t i = 0; i < num_particles; ++i) {
+            const auto &force = force_compute.particle_forces[i].force;
+            for (size_t dim = 0; dim < 3; ++dim) {
+                EXPECT_NEAR(force[dim], expected[i][dim],
+                            1e-9 * (1.0 + std::abs(expected[i][dim])));
+            }
+            total_force = ArrayUtilities::plus(total_force, force);
+            total_force_norm += ArrayUtilities::norm(force);
+        }
+        // Newton's third law
+        EXPECT_NEAR(ArrayUtilities::norm(total_force), 0.0,
+                    1e-12 * total_force_norm);
+    }
+}
+
+TEST(PairNeighborForce, integrator_updates_neighbor_list) {
+    auto sys = std::make_shared<SG::System>(
+            two_particles_system({{0.0, 0.0, 0.0}}, {{3.0, 0.0, 0.0}}));
+    auto builder = std::make_shared<SG::CollisionNeighborListBuilder>(1.0);
+    SG::IntegratorTwoStep integrator(sys.get());
+    integrator.collision_neighbor_list_builder = builder;
+    EXPECT_TRUE(integrator.update_collision_neighbor_list());
+    EXPECT_TRUE(sys->collision_neighbor_list[0].neighbors.empty());
+    sys->all.particles[1].pos = {{0.5, 0.0, 0.0}};
+    EXPECT_TRUE(integrator.update_collision_neighbor_list());
+    EXPECT_EQ(sys->collision_neighbor_list[0].neighbors,
+              std::vector<size_t>{1});
+    EXPECT_THROW(SG::PairNeighborForce(sys.get(), nullptr),
+                 std::runtime_error);
+}
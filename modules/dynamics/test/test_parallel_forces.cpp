@@ -0,0 +1,213 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "force_compute.hpp"
+#include "force_functions.hpp"
+#include "integrator.hpp"
+#include "gmock/gmock.h"
+
+#include <random>
+
+namespace {
+/** Random walk of num_particles with ids 2 * index + 1, connected by
+ * BondChain, with random extra bonds to get particles of higher degree. */
+std::shared_ptr<SG::System> random_chain_system(const size_t num_particles) {
+    auto sys = std::make_shared<SG::System>();
+    std::mt19937 gen(7);
+    std::normal_distribution<double> step_dis(0.0, 0.4);
+    std::uniform_int_distribution<size_t> index_dis(0, num_particles - 1);
+    const auto properties =
+            std::make_shared<SG::BondPropertiesPhysical>(1.0, 1.0);
+    ArrayUtilities::Array3D pos = {{0.0, 0.0, 0.0}};
+    sys->all.particles.resize(num_particles);
+    for (size_t i = 0; i < num_particles; ++i) {
+        auto &p = sys->all.particles[i];
+        p.id = 2 * i + 1;
+        p.pos = pos;
+        pos = ArrayUtilities::plus(
+                pos, {{step_dis(gen), step_dis(gen), step_dis(gen)}});
+    }
+    sys->all.sorted = true;
+    const auto add_bond = [&](const size_t a, const size_t b) {
+        auto bond = std::make_shared<SG::BondChain>(
+                sys->all.particles[a].id, sys->all.particles[b].id, 100.0);
+        bond->properties = properties;
+        sys->bonds.bonds.push_back(bond);
+    };
+    for (size_t i = 0; i + 1 < num_particles; ++i) {
+        add_bond(i, i + 1);
+    }
+    for (size_t i = 0; i < num_particles / 10; ++i) {
+        add_bond(index_dis(gen), index_dis(gen));
+    }
+    return sys;
+}
+} // namespace
+
+TEST(ParallelForces, PairBondForce_equal_to_serial) {
+    const auto sys = random_chain_system(20000);
+    SG::PairBondForce serial(sys.get(), SG::force_function_wlc_petrosyan);
+    serial.compute();
+    SG::PairBondForce parallel(sys.get(), SG::force_function_wlc_petrosyan);
+    parallel.num_threads = 4;
+    parallel.compute();
+    // Same order of the sums, the result is the same.
+    for (size_t i = 0; i < serial.particle_forces.size(); ++i) {
+        EXPECT_EQ(serial.particle_forces[i].force,
+                  parallel.particle_forces[i].force);
+    }
+    for (size_t i = 0; i < serial.bond_forces.size(); ++i) {
+        EXPECT_EQ(serial.bond_forces[i].force,
+                  parallel.bond_forces[i].force);
+    }
+}
+
+TEST(ParallelForces, PairNeighborForce_full_list) {
+    const auto sys = random_chain_system(5000);
+    auto builder =
+            std::make_shared<SG::CollisionNeighborListBuilder>(1.0, 0.0);
+    builder->build(sys.get());
+    const auto force_function = SG::make_force_function_soft_sphere(1.0, 1.0);
+    SG::PairNeighborForce serial(sys.get(), builder, force_function);
+    serial.compute();
+    SG::PairNeighborForce parallel(sys.get(), builder, force_function);
+    parallel.num_threads = 3;
+    parallel.compute();
+    for (size_t i = 0; i < serial.particle_forces.size(); ++i) {
+        for (size_t dim = 0; dim < 3; ++dim) {
+            EXPECT_NEAR(serial.particle_forces[i].force[dim],
+                        parallel.particle_forces[i].force[dim], 1e-12);
+        }
+    }
+}
+
+TEST(ParallelForces, Integrator_num_threads) {
+    auto run = [](const size_t num_threads) {
+        auto sys = random_chain_system(10000);
+        SG::IntegratorTwoStep integrator(sys.get());
+        integrator.num_threads = num_threads;
+        integrator.integrator_method =
+                std::make_shared<SG::VerletVelocitiesIntegratorMethod>(
+                        sys.get(), 0.001);
+        integrator.add_force(std::make_shared<SG::PairBondForce>(
+                sys.get(), SG::force_function_wlc_petrosyan));
+        integrator.add_force(std::make_shared<SG::ParticleForceCompute>(
+                sys.get(), [](const SG::Particle &p) {
+                    return ArrayUtilities::product_scalar(p.pos, -0.01);
+                }));
+        for (size_t step = 0; step < 3; ++step) {
+            integrator.update(step);
+        }
+        return sys;
+    };
+    const auto serial = run(1);
+    // 2 threads: the two forces run concurrently. 4 threads: the forces run
+    // one after the other in all the threads.
+    for (const size_t num_threads : {2, 4}) {
+        const auto parallel = run(num_threads);
+        for (size_t i = 0; i < serial->all.particles.size(); ++i) {
+            const auto &expected = serial->all.particles[i];
+            const auto &result = parallel->all.particles[i];
+            EXPECT_EQ(expected.pos, result.pos);
+            EXPECT_EQ(expected.dynamics.net_force, result.dynamics.net_force);
+        }
+    }
+
+    // Exceptions in the threads are rethrown.
+    auto sys = random_chain_system(100);
+    SG::IntegratorTwoStep integrator(sys.get());
+    integrator.num_threads = 2;
+    integrator.integrator_method =
+            std::make_shared<SG::VerletVelocitiesIntegratorMethod>(sys.get(),
+                                                                   0.001);
+    integrator.add_force(std::make_shared<SG::PairBondForce>(sys.get()));
+    integrator.add_force(std::make_shared<SG::ParticleForceCompute>(
+            sys.get(), [](const SG::Particle &) {
+                return ArrayUtilities::Array3D{{0.0, 0.0, 0.0}};
+            }));
+    EXPECT_THROW(integrator.update(0), std::runtime_error);
+}
+
+TEST(ParallelForces, Integrator_thread_pool) {
+    auto sys = random_chain_system(100);
+    auto bond_force = std::make_shared<SG::PairBondForce>(
+            sys.get(), SG::force_function_wlc_petrosyan);
+    {
+        SG::IntegratorTwoStep integrator(sys.get());
+        integrator.num_threads = 3;
+        integrator.integrator_method =
+                std::make_shared<SG::VerletVelocitiesIntegratorMethod>(
+                        sys.get(), 0.001);
+        integrator.add_force(bond_force);
+        integrator.update(0);
+        ASSERT_NE(bond_force->thread_pool, nullptr);
+        const auto *pool = bond_force->thread_pool;
+        EXPECT_EQ(pool->num_threads(), 3u);
+        // The pool is reused by the next updates.
+        integrator.update(1);
+        EXPECT_EQ(bond_force->thread_pool, pool);
+        integrator.num_threads = 1;
+        integrator.update(2);
+        EXPECT_EQ(bond_force->thread_pool, nullptr);
+        integrator.num_threads = 2;
+        integrator.update(3);
+        EXPECT_NE(bond_force->thread_pool, nullptr);
+    }
+    // The force outlives the integrator and its pool.
+    EXPECT_EQ(bond_force->thread_pool, nullptr);
+    bond_force->num_threads = 2;
+    EXPECT_NO_THROW(bond_force->compute());
+}
+
+TEST(ParallelForces, ParticleRandomForceCompute_counter_based_rng) {
+    const auto sys = random_chain_system(10000);
+    const double kT = 1.0;
+    const double gamma = 2.0;
+    const double deltaT = 0.01;
+    SG::ParticleRandomForceCompute serial(sys.get(), kT, gamma, deltaT);
+    serial.set_seed(42);
+    SG::ParticleRandomForceCompute parallel(sys.get(), kT, gamma, deltaT);
+    parallel.set_seed(42);
+    parallel.num_threads = 4;
+    for (size_t step = 0; step < 3; ++step) {
+        serial.compute();
+        parallel.compute();
+        for (size_t i = 0; i < serial.particle_forces.size(); ++i) {
+            EXPECT_EQ(serial.particle_forces[i].force,
+                      parallel.particle_forces[i].force);
+            EXPECT_NEAR(ArrayUtilities::norm(serial.particle_forces[i].force),
+                        serial._modulo, 1e-10);
+        }
+    }
+    EXPECT_EQ(serial.step, 3);
+    // Replay the third step.
+    const auto third_step_forces = serial.particle_forces;
+    SG::ParticleRandomForceCompute replay(sys.get(), kT, gamma, deltaT);
+    replay.set_seed(42);
+    replay.step = 2;
+    replay.compute();
+    for (size_t i = 0; i < replay.particle_forces.size(); ++i) {
+        EXPECT_EQ(replay.particle_forces[i].force,
+                  third_step_forces[i].force);
+    }
+    // Different steps give different forces.
+    replay.compute();
+    EXPECT_NE(replay.particle_forces[0].force, third_step_forces[0].force);
+}
@@ -96,3 +96,33 @@ TEST_F(ParticleGraphGlueData_Fixture, bonds_have_contour_length) {
                     ->length_contour,
             4);
 }
+
+TEST_F(ParticleGraphGlueData_Fixture, make_bonds_from_graph) {
+    // Parallel edge, the first edge (1, 2) is used for the contour length.
+    SG::SpatialEdge se_parallel;
+    se_parallel.edge_points.insert(std::end(se_parallel.edge_points),
+                                   {SG::PointType{{1.5, 3.0, 0}}});
+    boost::add_edge(2, 1, se_parallel, graph0);
+    auto particle_graph_data = SG::particles_from_graph(graph0);
+    const auto &bond_collection = particle_graph_data.bond_collection;
+    EXPECT_TRUE(bond_collection.sorted);
+    const auto expected_bonds =
+            SG::make_unique_bonds_from_system_conexions<SG::Bond>(
+                    particle_graph_data.sys.get());
+    ASSERT_EQ(bond_collection.bonds.size(), 3);
+    ASSERT_EQ(expected_bonds.bonds.size(), 3);
+    for (size_t i = 0; i < bond_collection.bonds.size(); ++i) {
+        EXPECT_EQ(*bond_collection.bonds[i], *expected_bonds.bonds[i]);
+    }
+    EXPECT_DOUBLE_EQ(
+            std::static_pointer_cast<SG::BondChain>(bond_collection.bonds[1])
+                    ->length_contour,
+            1.077032961426901);
+    // Vertex 0 has degree 1, vertex 2 has degree 2 (parallel edge).
+    EXPECT_EQ(bond_collection.bonds[0]->properties->tags.count(
+                      SG::tag_bond_free_chain),
+              1);
+    EXPECT_EQ(bond_collection.bonds[1]->properties->tags.count(
+                      SG::tag_bond_contour_length_chain),
+              1);
+}
@@ -0,0 +1,164 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "dynamics_common_fixtures.hpp"
+#include "trajectory_io.hpp"
+#include "gmock/gmock.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace {
+struct TrajectorySystem : public SG::System4Fixture {
+    TrajectorySystem() : SG::System4Fixture() {
+        all.particles[2].material.mass = 3.0;
+        all.particles[3].material.radius = 0.25;
+    }
+    void move(const size_t step) {
+        for (auto &p : all.particles) {
+            p.pos[0] += 0.1 * step;
+            p.dynamics.vel = {{1.0 * step, 2.0, -3.0}};
+            p.dynamics.net_force = {{-0.5, 0.5 * step, 0.0}};
+        }
+    }
+};
+} // namespace
+
+TEST(TrajectoryIO, write_and_read) {
+    const std::string file_name = "test_trajectory_io.sgtraj";
+    TrajectorySystem sys;
+    std::vector<std::vector<SG::Particle>> frames;
+    {
+        SG::TrajectoryWriter writer(file_name, sys);
+        for (size_t step = 0; step < 5; ++step) {
+            sys.move(step);
+            writer.write_frame(sys, 10 * step);
+            frames.push_back(sys.all.particles);
+        }
+        writer.close();
+        EXPECT_EQ(writer.num_frames_written(), 5);
+        EXPECT_THROW(writer.write_frame(sys, 100), std::runtime_error);
+    }
+
+    SG::TrajectoryReader reader(file_name);
+    EXPECT_EQ(reader.num_particles(), sys.all.particles.size());
+    EXPECT_EQ(reader.num_bonds(), sys.bonds.bonds.size());
+    ASSERT_EQ(reader.num_frames(), 5);
+    auto read_sys = reader.make_system();
+    EXPECT_TRUE(read_sys->all.sorted);
+    for (size_t i = 0; i < sys.bonds.bonds.size(); ++i) {
+        EXPECT_EQ(read_sys->bonds.bonds[i]->id_a, sys.bonds.bonds[i]->id_a);
+        EXPECT_EQ(read_sys->bonds.bonds[i]->id_b, sys.bonds.bonds[i]->id_b);
+    }
+    // Read in reverse order, frames are accessed directly.
+    for (size_t frame = 5; frame-- > 0;) {
+        EXPECT_EQ(reader.read_frame(frame, *read_sys), 10 * frame);
+        for (size_t i = 0; i < sys.all.particles.size(); ++i) {
+            const auto &expected = frames[frame][i];
+            const auto &p = read_sys->all.particles[i];
+            EXPECT_EQ(p.id, expected.id);
+            EXPECT_EQ(p.material.mass, expected.material.mass);
+            EXPECT_EQ(p.material.radius, expected.material.radius);
+            EXPECT_EQ(p.pos, expected.pos);
+            EXPECT_EQ(p.dynamics.vel, expected.dynamics.vel);
+            EXPECT_EQ(p.dynamics.net_force, expected.dynamics.net_force);
+        }
+    }
+    EXPECT_THROW(reader.read_frame(5, *read_sys), std::runtime_error);
+    std::remove(file_name.c_str());
+}
+
+TEST(TrajectoryIO, only_positions_and_incomplete_frame) {
+    const std::string file_name = "test_trajectory_io_positions.sgtraj";
+    TrajectorySystem sys;
+    {
+        SG::TrajectoryWriter writer(file_name, sys,
+                                    SG::TRAJECTORY_POSITIONS);
+        for (size_t step = 0; step < 3; ++step) {
+            sys.move(step);
+            writer.write_frame(sys, step);
+        }
+        writer.flush();
+        EXPECT_EQ(writer.num_frames_written(), 3);
+    }
+    // Simulate a frame being written.
+    {
+        std::ofstream file(file_name, std::ios::binary | std::ios::app);
+        file.write("partial", 7);
+    }
+    SG::TrajectoryReader reader(file_name);
+    EXPECT_EQ(reader.contents(), SG::TRAJECTORY_POSITIONS);
+    EXPECT_EQ(reader.num_frames(), 3);
+    auto read_sys = reader.make_system();
+    EXPECT_EQ(reader.read_frame(2, *read_sys), 2);
+    for (size_t i = 0; i < sys.all.particles.size(); ++i) {
+        EXPECT_EQ(read_sys->all.particles[i].pos, sys.all.particles[i].pos);
+        EXPECT_EQ(read_sys->all.particles[i].dynamics.vel,
+                  (ArrayUtilities::Array3D{{0.0, 0.0, 0.0}}));
+    }
+    std::remove(file_name.c_str());
+}
+
+TEST(TrajectoryIO, errors) {
+    EXPECT_THROW(SG::TrajectoryReader("non_existing_file.sgtraj"),
+                 std::runtime_error);
+    const std::string file_name = "test_trajectory_io_not_a_trajectory.sgtraj";
+    {
+        std::ofstream file(file_name, std::ios::binary);
+        file << "this is not a trajectory file";
+    }
+    EXPECT_THROW(SG::TrajectoryReader{file_name}, std::runtime_error);
+    std::remove(file_name.c_str());
+
+    const std::string trajectory_file_name = "test_trajectory_io_errors.sgtraj";
+    TrajectorySystem sys;
+    SG::TrajectoryWriter writer(trajectory_file_name, sys);
+    sys.all.particles.pop_back();
+    EXPECT_THROW(writer.write_frame(sys, 0), std::runtime_error);
+    writer.close();
+
+    // Corrupted counts of particles and bonds, larger than the file.
+    std::string data;
+    {
+        std::ifstream file(trajectory_file_name, std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>());
+    }
+    // magic, version and contents precede the counts.
+    const size_t num_particles_offset = 8 + 2 * sizeof(uint32_t);
+    const size_t num_bonds_offset = num_particles_offset + sizeof(uint64_t);
+    for (const auto offset : {num_particles_offset, num_bonds_offset}) {
+        auto corrupted = data;
+        const uint64_t huge_count = uint64_t(1) << 60;
+        std::memcpy(&corrupted[offset], &huge_count, sizeof(huge_count));
+        {
+            std::ofstream file(trajectory_file_name,
+                               std::ios::binary | std::ios::trunc);
+            file.write(corrupted.data(),
+                       static_cast<std::streamsize>(corrupted.size()));
+        }
+        EXPECT_THROW(SG::TrajectoryReader{trajectory_file_name},
+                     std::runtime_error);
+    }
+    std::remove(trajectory_file_name.c_str());
+}
@@ -0,0 +1,154 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+/**
+ * Compare the reduction of a thin volume using the raw graph
+ * (RawGraphSlabBuilder + remove_extra_edges + reduce_spatial_graph_via_dfs)
+ * with reduced_graph_from_thin_volume and ReducedGraphSlabBuilder, and
+ * reduce_spatial_graph_via_dfs with reduce_spatial_graph_via_dfs_parallel.
+ *
+ * The thin volume of size^3 voxels is made of random walks with
+ * 26-connected steps.
+ *
+ * Usage: bench_reduced_graph_from_thin_volume [size] [num_walks] [num_threads]
+ *        [slab_thickness]
+ */
+
+#include "raw_graph_slab_builder.hpp"
+#include "reduce_spatial_graph_via_dfs.hpp"
+#include "reduced_graph_from_thin_volume.hpp"
+#include "reduced_graph_slab_builder.hpp"
+#include "remove_extra_edges.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+template <typename TFunction>
+double time_seconds(TFunction &&function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+std::vector<unsigned char> random_walks_volume(const size_t size,
+                                               const size_t num_walks) {
+    std::vector<unsigned char> volume(size * size * size, 0);
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<long> start_dis(0, size - 1);
+    std::uniform_int_distribution<int> step_dis(-1, 1);
+    const auto max_index = static_cast<long>(size) - 1;
+    for (size_t walk = 0; walk < num_walks; ++walk) {
+        std::array<long, 3> p = {
+                {start_dis(gen), start_dis(gen), start_dis(gen)}};
+        // Persistent direction to get long branches instead of blobs.
+        std::array<int, 3> direction = {
+                {step_dis(gen), step_dis(gen), step_dis(gen)}};
+        for (size_t i = 0; i < 4 * size; ++i) {
+            if (i % 8 == 0) {
+                direction = {{step_dis(gen), step_dis(gen), step_dis(gen)}};
+            }
+            for (size_t d = 0; d < 3; ++d) {
+                p[d] = std::min(std::max(p[d] + direction[d], 0L), max_index);
+            }
+            volume[p[0] + size * (p[1] + size * p[2])] = 1;
+        }
+    }
+    return volume;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t size = argc > 1 ? std::stoul(argv[1]) : 256;
+    const size_t num_walks = argc > 2 ? std::stoul(argv[2]) : 200;
+    const size_t num_threads = argc > 3 ? std::stoul(argv[3]) : 0;
+    const size_t slab_thickness = argc > 4 ? std::stoul(argv[4]) : 32;
+    const auto volume = random_walks_volume(size, num_walks);
+    const auto num_foreground = static_cast<size_t>(
+            std::count(volume.begin(), volume.end(), 1));
+    std::cout << "Volume: " << size << "^3 | Walks: " << num_walks
+              << " | Foreground voxels: " << num_foreground << std::endl;
+
+    SG::GraphType raw;
+    const auto t_raw = time_seconds([&]() {
+        SG::RawGraphSlabBuilder builder(size, size);
+        builder.add_slab(volume.data(), size);
+        raw = builder.release_graph();
+    });
+    const auto t_remove_extra_edges = time_seconds([&]() {
+        while (SG::remove_extra_edges(raw)) {
+        }
+    });
+    SG::GraphType reduced_via_raw;
+    const auto t_reduce = time_seconds(
+            [&]() { reduced_via_raw = SG::reduce_spatial_graph_via_dfs(raw); });
+    SG::GraphType reduced_parallel;
+    const auto t_reduce_parallel = time_seconds([&]() {
+        reduced_parallel =
+                SG::reduce_spatial_graph_via_dfs_parallel(raw, num_threads);
+    });
+
+    SG::GraphType reduced;
+    const auto t_direct = time_seconds([&]() {
+        reduced = SG::reduced_graph_from_thin_volume(volume.data(),
+                                                     {{size, size, size}});
+    });
+
+    SG::GraphType reduced_by_slabs;
+    const auto t_slabs = time_seconds([&]() {
+        SG::ReducedGraphSlabBuilder builder(size, size);
+        for (size_t z = 0; z < size; z += slab_thickness) {
+            builder.add_slab(volume.data() + z * size * size,
+                             std::min(slab_thickness, size - z));
+        }
+        reduced_by_slabs = builder.release_graph();
+    });
+
+    std::cout << "raw graph:                      " << t_raw << " s"
+              << std::endl;
+    std::cout << "remove_extra_edges:             " << t_remove_extra_edges
+              << " s" << std::endl;
+    std::cout << "reduce_spatial_graph_via_dfs:   " << t_reduce << " s"
+              << std::endl;
+    std::cout << "reduce_spatial_graph_via_dfs_parallel: "
+              << t_reduce_parallel << " s" << std::endl;
+    std::cout << "total via raw graph:            "
+              << t_raw + t_remove_extra_edges + t_reduce << " s"
+              << std::endl;
+    std::cout << "reduced_graph_from_thin_volume: " << t_direct << " s"
+              << std::endl;
+    std::cout << "ReducedGraphSlabBuilder:        " << t_slabs << " s"
+              << std::endl;
+    std::cout << "Reduced graph via raw graph: "
+              << boost::num_vertices(reduced_via_raw) << " vertices, "
+              << boost::num_edges(reduced_via_raw) << " edges" << std::endl;
+    std::cout << "Reduced graph direct:        "
+              << boost::num_vertices(reduced) << " vertices, "
+              << boost::num_edges(reduced) << " edges" << std::endl;
+    std::cout << "Reduced graph by slabs:      "
+              << boost::num_vertices(reduced_by_slabs) << " vertices, "
+              << boost::num_edges(reduced_by_slabs) << " edges" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,111 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef RAW_GRAPH_SLAB_BUILDER_HPP
+#define RAW_GRAPH_SLAB_BUILDER_HPP
+
+#include "spatial_graph.hpp"
+
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace SG {
+
+/**
+ * Build the raw graph of a thin (skeletonized) binary volume, one z-slab at
+ * a time, without holding the whole volume in memory.
+ *
+ * The raw graph has a vertex per foreground voxel, positioned at its index,
+ * and an edge between each pair of 26-adjacent foreground voxels,
+ * the same graph than spatial_graph_from_object with a DT26_6 DGtal::Object.
+ *
+ * Voxels are visited in raster order (x fastest, then y, then z), and each
+ * voxel is connected to its 13 neighbors that precede it in that order.
+ * Those are in the same z-plane or in the previous one, so the only state
+ * kept between slabs is the vertex of each foreground voxel of the last
+ * plane of the previous slab (the one-voxel halo).
+ * Slabs are stitched exactly, and the resulting graph (including the order
+ * of vertices and edges) does not depend on the slab thickness.
+ *
+ * Peak memory of the builder, besides the output graph, is the vertex map of
+ * two planes, independent of the depth of the volume. The output raw graph
+ * has a vertex per foreground voxel, use ReducedGraphSlabBuilder to get the
+ * reduced graph of large volumes without building it.
+ *
+ * Usage:
+ * RawGraphSlabBuilder builder(nx, ny);
+ * for each slab: builder.add_slab(slab_buffer, nz_of_slab);
+ * auto raw_graph = builder.release_graph();
+ */
+class RawGraphSlabBuilder {
+  public:
+    using IndexType = std::array<long, 3>;
+
+    /**
+     * @param nx size in x of each z-plane
+     * @param ny size in y of each z-plane
+     * @param origin_index index of the first voxel of the volume,
+     * the positions of the vertices are origin_index + (x, y, z).
+     */
+    RawGraphSlabBuilder(const std::size_t nx,
+                        const std::size_t ny,
+                        const IndexType &origin_index = {{0, 0, 0}});
+
+    /**
+     * Add the next slab of the volume.
+     * Voxels with value different than zero are foreground.
+     *
+     * @param slab_buffer contiguous buffer of size nx * ny * nz with x
+     * varying fastest (the layout of itk::Image).
+     * @param nz number of z-planes in the slab.
+     */
+    void add_slab(const unsigned char *slab_buffer, const std::size_t nz);
+
+    /** Number of z-planes added so far. */
+    std::size_t num_planes() const { return m_num_planes; }
+
+    /** Graph built from all the slabs added so far. */
+    const GraphType &graph() const { return m_graph; }
+
+    /**
+     * Move out the graph, the builder should not be used after this.
+     */
+    GraphType release_graph();
+
+  private:
+    /** (xy-index, vertex) of the foreground voxels of a plane, sorted. */
+    using PlaneVertices = std::vector<std::pair<std::size_t, std::size_t>>;
+    void add_plane(const unsigned char *plane_buffer);
+    static bool find_vertex(const PlaneVertices &plane,
+                            const std::size_t xy_index,
+                            std::size_t &vertex);
+
+    std::array<std::size_t, 2> m_size_xy;
+    IndexType m_origin_index;
+    std::size_t m_num_planes = 0;
+    PlaneVertices m_previous_plane;
+    PlaneVertices m_current_plane;
+    GraphType m_graph;
+};
+
+} // namespace SG
+#endif
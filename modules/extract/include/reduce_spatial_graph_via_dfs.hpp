@@ -44,5 +44,37 @@ namespace SG {
 GraphType reduce_spatial_graph_via_dfs(const GraphType &input_sg,
                                        bool verbose = false);
 
+/**
+ * Multi-threaded version of @sa reduce_spatial_graph_via_dfs.
+ *
+ * The input graph is partitioned into connected components, which are
+ * independent. Small components are grouped into work items of around
+ * max_work_item_size vertices. Components larger than max_work_item_size
+ * are split into junction-bounded work items: chunks of their end and
+ * junction vertices, each one visiting the chains until the next junction.
+ *
+ * Each work item is reduced by a thread into its own graph, and the results
+ * are merged in the order of the work items. The chains between junctions
+ * of different chunks are found by both, and merged only once.
+ *
+ * The output is deterministic and independent of num_threads.
+ * It has the same nodes and edges than reduce_spatial_graph_via_dfs, but
+ * the vertices are ordered by component. Short loops at the junctions of
+ * large components might differ, see @sa reduced_graph_from_thin_volume.
+ *
+ * @param input_sg input
+ * @param num_threads number of threads, 0 uses hardware_concurrency.
+ * @param max_work_item_size number of vertices of the input graph per work
+ * item.
+ * @param verbose print the number of components and work items.
+ *
+ * @return reduced graph.
+ */
+GraphType reduce_spatial_graph_via_dfs_parallel(
+        const GraphType &input_sg,
+        size_t num_threads = 0,
+        size_t max_work_item_size = 20000,
+        bool verbose = false);
+
 } // namespace SG
 #endif
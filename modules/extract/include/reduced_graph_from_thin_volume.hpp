@@ -0,0 +1,74 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef REDUCED_GRAPH_FROM_THIN_VOLUME_HPP
+#define REDUCED_GRAPH_FROM_THIN_VOLUME_HPP
+
+#include "spatial_graph.hpp"
+
+#include <array>
+#include <cstddef>
+
+namespace SG {
+
+/**
+ * Build the reduced spatial graph of a thin (skeletonized) binary volume
+ * directly, without creating the raw graph with one vertex per voxel.
+ *
+ * Equivalent to build the raw 26-adjacency graph (@sa RawGraphSlabBuilder),
+ * apply remove_extra_edges until no edge is removed (if removeExtraEdges is
+ * true), and reduce it with reduce_spatial_graph_via_dfs.
+ * The resulting graph has the same nodes and edges, but the order of the
+ * vertices and the orientation of the edge_points might differ.
+ * Short loops starting and ending in the same junction are always split
+ * once (@sa split_loop), reduce_spatial_graph_via_dfs can miss them or split
+ * them twice depending on the order of the visit.
+ *
+ * The adjacency of each foreground voxel is stored as a 26-bit
+ * configuration, computed from a precomputed table of neighbor offsets.
+ * The degree of each voxel is the popcount of its configuration, which
+ * classifies the voxels into end (1), chain (2) or junction (> 2) nodes.
+ * Extra edges are removed modifying the configurations, and the chains
+ * are traced into the edge_points of the edges between end and junction
+ * nodes. Isolated voxels are ignored, as in reduce_spatial_graph_via_dfs.
+ *
+ * Time is linear in the number of voxels of the volume, and memory is
+ * linear in the number of foreground voxels (around 20 bytes per voxel).
+ *
+ * @param buffer contiguous buffer of size[0] * size[1] * size[2] voxels
+ * with x varying fastest (the layout of itk::Image). Non-zero voxels are
+ * foreground.
+ * @param size number of voxels in each dimension.
+ * @param origin_index index of the first voxel of the buffer,
+ * the positions of the nodes are origin_index + (x, y, z).
+ * @param removeExtraEdges remove edges of triangles as remove_extra_edges.
+ * @param verbose print the number of end, chain and junction voxels.
+ *
+ * @return reduced spatial graph
+ */
+GraphType reduced_graph_from_thin_volume(
+        const unsigned char *buffer,
+        const std::array<std::size_t, 3> &size,
+        const std::array<long, 3> &origin_index = {{0, 0, 0}},
+        bool removeExtraEdges = true,
+        bool verbose = false);
+
+} // namespace SG
+#endif
@@ -0,0 +1,179 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef REDUCED_GRAPH_SLAB_BUILDER_HPP
+#define REDUCED_GRAPH_SLAB_BUILDER_HPP
+
+#include "spatial_graph.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace SG {
+
+/**
+ * Build the reduced graph of a thin (skeletonized) binary volume, one z-slab
+ * at a time, without holding the volume or its raw graph in memory.
+ *
+ * The result is equivalent to build the raw 26-adjacency graph
+ * (@sa RawGraphSlabBuilder), apply remove_extra_edges until no edge is
+ * removed (if removeExtraEdges is true), and reduce it with
+ * reduce_spatial_graph_via_dfs, with the same differences in the order of
+ * vertices, orientation of edge_points and short loops than
+ * reduced_graph_from_thin_volume.
+ *
+ * The planes go through three stages, each one plane behind the previous:
+ * 1. The 26-neighborhood configuration of the foreground voxels of plane z
+ *    is computed when plane z + 1 is added.
+ * 2. The extra edges of the voxels of plane z are removed when the
+ *    configurations of plane z + 1 are known, the degrees of the neighbors
+ *    are needed to detect the isolated triangles.
+ * 3. The voxels of plane z are reduced: end and junction voxels become
+ *    nodes of the graph, and the chain voxels are added to open chains.
+ *    A chain becomes an edge when both of its ends reach a node, and is
+ *    split when it closes a loop.
+ *
+ * Only the voxels of the last two reduced planes (the halo) keep a
+ * reference to their node or open chain, the previous planes are
+ * complete. Peak memory, besides the output graph and the edge_points of
+ * the open chains, is a few planes, independent of the depth of the volume.
+ * The result does not depend on the slab thickness.
+ *
+ * Usage:
+ * ReducedGraphSlabBuilder builder(nx, ny);
+ * for each slab: builder.add_slab(slab_buffer, nz_of_slab);
+ * auto reduced_graph = builder.release_graph();
+ */
+class ReducedGraphSlabBuilder {
+  public:
+    using IndexType = std::array<long, 3>;
+
+    /**
+     * @param nx size in x of each z-plane
+     * @param ny size in y of each z-plane
+     * @param origin_index index of the first voxel of the volume,
+     * the positions of the nodes are origin_index + (x, y, z).
+     * @param removeExtraEdges remove edges of triangles as remove_extra_edges.
+     */
+    ReducedGraphSlabBuilder(const std::size_t nx,
+                            const std::size_t ny,
+                            const IndexType &origin_index = {{0, 0, 0}},
+                            const bool removeExtraEdges = true);
+
+    /**
+     * Add the next slab of the volume.
+     * Voxels with value different than zero are foreground.
+     *
+     * @param slab_buffer contiguous buffer of size nx * ny * nz with x
+     * varying fastest (the layout of itk::Image).
+     * @param nz number of z-planes in the slab.
+     */
+    void add_slab(const unsigned char *slab_buffer, const std::size_t nz);
+
+    /** Number of z-planes added so far. */
+    std::size_t num_planes() const { return m_num_planes; }
+
+    /** Nodes and edges completed so far, the last planes are pending. */
+    const GraphType &graph() const { return m_graph; }
+
+    /** Number of chains that have not reached a node in both ends yet. */
+    std::size_t num_open_chains() const {
+        return m_chains.size() - m_free_chains.size();
+    }
+
+    /**
+     * Reduce the pending planes and move out the graph,
+     * the builder should not be used after this.
+     */
+    GraphType release_graph();
+
+  private:
+    /** (xy-index, configuration) of the foreground voxels of a plane. */
+    using PlaneConfigurations =
+            std::vector<std::pair<std::size_t, std::uint32_t>>;
+    /** Node (vertex of the graph) or open chain of a voxel. */
+    struct VoxelHandle {
+        bool is_node;
+        std::size_t index;
+    };
+    /** (xy-index, handle) of the voxels of a plane with pending edges. */
+    using PlaneHandles = std::vector<std::pair<std::size_t, VoxelHandle>>;
+    /** End of a chain, a node or an open voxel of the halo. */
+    struct ChainEnd {
+        bool is_node;
+        std::size_t vertex;
+        long z;
+        std::size_t xy_index;
+    };
+    /** Chain voxels, ordered from ends[0] to ends[1]. */
+    struct Chain {
+        std::deque<PointType> points;
+        std::array<ChainEnd, 2> ends;
+    };
+
+    void add_plane(const unsigned char *plane_buffer);
+    const unsigned char *plane_buffer(const long z) const;
+    void compute_configurations(const long z);
+    void remove_extra_edges(const long z,
+                            PlaneConfigurations &configurations) const;
+    void reduce_plane(const long z, const PlaneConfigurations &configurations);
+    void finish_plane(const long z);
+
+    PointType position(const long z, const std::size_t xy_index) const;
+    int degree(const long z, const std::size_t xy_index) const;
+    VoxelHandle &handle(const long z, const std::size_t xy_index);
+    static ChainEnd open_end(const long z, const std::size_t xy_index);
+    static ChainEnd node_end(const std::size_t vertex);
+    int end_at(const std::size_t chain,
+               const long z,
+               const std::size_t xy_index) const;
+    std::size_t new_chain(const ChainEnd &end0,
+                          const PointType &point,
+                          const ChainEnd &end1);
+    void merge_chains(std::size_t chain,
+                      int chain_end,
+                      std::size_t other,
+                      int other_end,
+                      const PointType &point);
+    void close_loop(const std::size_t chain, const PointType &point);
+    void finish_chain_if_closed(const std::size_t chain);
+    void release_chain(const std::size_t chain);
+
+    std::array<std::size_t, 2> m_size_xy;
+    IndexType m_origin_index;
+    bool m_remove_extra_edges;
+    std::size_t m_num_planes = 0;
+    /** Buffers of the last three planes added, plane z in z % 3. */
+    std::array<std::vector<unsigned char>, 3> m_plane_buffers;
+    /** Configurations of the last three planes, plane z in z % 3. */
+    std::array<PlaneConfigurations, 3> m_configurations;
+    /** Handles of the last two reduced planes, plane z in z % 2. */
+    std::array<PlaneHandles, 2> m_handles;
+    std::vector<Chain> m_chains;
+    std::vector<std::size_t> m_free_chains;
+    GraphType m_graph;
+};
+
+} // namespace SG
+#endif
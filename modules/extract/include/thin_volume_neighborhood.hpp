@@ -0,0 +1,112 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef THIN_VOLUME_NEIGHBORHOOD_HPP
+#define THIN_VOLUME_NEIGHBORHOOD_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace SG {
+namespace detail {
+
+constexpr std::size_t num_neighbors = 26;
+/** The first 13 neighbors precede the center voxel in raster order. */
+constexpr std::size_t num_preceding_neighbors = 13;
+constexpr int no_neighbor = -1;
+constexpr std::uint32_t neighbors_mask = (1u << num_neighbors) - 1;
+
+/**
+ * Look-up tables of the 26-neighborhood, used to store the adjacency of
+ * a foreground voxel as a 26-bit configuration.
+ *
+ * The neighbors k are ordered in raster order of (dz, dy, dx), so the
+ * opposite of neighbor k is 25 - k.
+ * between[k1][k2] is the neighbor of k1 (seen from k1) that is k2,
+ * or no_neighbor if k1 and k2 are not adjacent.
+ */
+struct NeighborhoodLUT {
+    std::array<std::array<int, 3>, num_neighbors> offset;
+    std::array<int, num_neighbors> squared_distance;
+    std::array<std::array<int, num_neighbors>, num_neighbors> between;
+    std::array<std::array<int, num_neighbors>, num_neighbors>
+            squared_distance_between;
+
+    NeighborhoodLUT() {
+        std::size_t k = 0;
+        for (int dz = -1; dz <= 1; ++dz) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    if (dx == 0 && dy == 0 && dz == 0) {
+                        continue;
+                    }
+                    offset[k] = {{dx, dy, dz}};
+                    squared_distance[k] = dx * dx + dy * dy + dz * dz;
+                    ++k;
+                }
+            }
+        }
+        for (std::size_t k1 = 0; k1 < num_neighbors; ++k1) {
+            for (std::size_t k2 = 0; k2 < num_neighbors; ++k2) {
+                std::array<int, 3> d;
+                int squared = 0;
+                bool adjacent = k1 != k2;
+                for (std::size_t i = 0; i < 3; ++i) {
+                    d[i] = offset[k2][i] - offset[k1][i];
+                    squared += d[i] * d[i];
+                    adjacent &= d[i] >= -1 && d[i] <= 1;
+                }
+                squared_distance_between[k1][k2] = squared;
+                between[k1][k2] = adjacent ? index_of(d) : no_neighbor;
+            }
+        }
+    }
+
+    static int index_of(const std::array<int, 3> &d) {
+        const int raster = (d[2] + 1) * 9 + (d[1] + 1) * 3 + (d[0] + 1);
+        return raster < 13 ? raster : raster - 1;
+    }
+};
+
+inline const NeighborhoodLUT &neighborhood_lut() {
+    static const NeighborhoodLUT lut;
+    return lut;
+}
+
+inline int popcount(std::uint32_t mask) {
+    int count = 0;
+    for (; mask; mask &= mask - 1) {
+        ++count;
+    }
+    return count;
+}
+
+inline int lowest_bit(const std::uint32_t mask) {
+    int k = 0;
+    while (!(mask & (1u << k))) {
+        ++k;
+    }
+    return k;
+}
+
+} // namespace detail
+} // namespace SG
+#endif
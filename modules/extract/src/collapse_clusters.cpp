@@ -21,6 +21,7 @@
 #include "collapse_clusters.hpp"
 #include "collapse_clusters_visitor.hpp"
 #include "filter_spatial_graph.hpp" // for filter_component_graphs
+#include "vertex_vector_map.hpp"
 #include "hash_edge_descriptor.hpp"
 
 #include <boost/graph/connected_components.hpp>
@@ -39,9 +40,8 @@ collapse_clusters(const GraphType &input_sg,
     using vertex_descriptor = boost::graph_traits<GraphType>::vertex_descriptor;
     using edge_descriptor = boost::graph_traits<GraphType>::edge_descriptor;
 
-    using ColorMap = std::map<vertex_descriptor, boost::default_color_type>;
-    ColorMap colorMap;
-    boost::associative_property_map<ColorMap> propColorMap(colorMap);
+    VertexColorMap colorMap(boost::num_vertices(input_sg));
+    auto propColorMap = colorMap.property_map();
 
     using VertexMap = std::unordered_map<vertex_descriptor, vertex_descriptor>;
     VertexMap vertex_map;
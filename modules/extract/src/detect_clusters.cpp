@@ -21,6 +21,7 @@
 #include "detect_clusters.hpp"
 #include "detect_clusters_visitor.hpp"
 #include "filter_spatial_graph.hpp" // for filter_component_graphs
+#include "vertex_vector_map.hpp"
 
 #include <boost/graph/connected_components.hpp>
 #include <boost/graph/depth_first_search.hpp>
@@ -51,9 +52,8 @@ detect_clusters_with_radius(const GraphType &input_sg,
                                        cluster_edge_condition, verbose);
 
     // For dfs/bfs
-    using ColorMap = std::map<vertex_descriptor, boost::default_color_type>;
-    ColorMap colorMap;
-    boost::associative_property_map<ColorMap> propColorMap(colorMap);
+    VertexColorMap colorMap(boost::num_vertices(input_sg));
+    auto propColorMap = colorMap.property_map();
 
     // Run the visitor for each component of the graph
     auto filtered_component_graphs = filter_component_graphs(input_sg);
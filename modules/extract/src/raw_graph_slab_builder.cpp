@@ -0,0 +1,133 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "raw_graph_slab_builder.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace SG {
+
+RawGraphSlabBuilder::RawGraphSlabBuilder(const std::size_t nx,
+                                         const std::size_t ny,
+                                         const IndexType &origin_index)
+        : m_size_xy({{nx, ny}}), m_origin_index(origin_index) {
+    if (m_size_xy[0] == 0 || m_size_xy[1] == 0) {
+        throw std::runtime_error(
+                "RawGraphSlabBuilder: the size of the planes cannot be 0.");
+    }
+}
+
+void RawGraphSlabBuilder::add_slab(const unsigned char *slab_buffer,
+                                   const std::size_t nz) {
+    const auto plane_size = m_size_xy[0] * m_size_xy[1];
+    for (std::size_t z = 0; z < nz; ++z) {
+        add_plane(slab_buffer + z * plane_size);
+    }
+}
+
+bool RawGraphSlabBuilder::find_vertex(const PlaneVertices &plane,
+                                      const std::size_t xy_index,
+                                      std::size_t &vertex) {
+    const auto it = std::lower_bound(
+            std::begin(plane), std::end(plane), xy_index,
+            [](const std::pair<std::size_t, std::size_t> &xy_vertex,
+               const std::size_t value) { return xy_vertex.first < value; });
+    if (it == std::end(plane) || it->first != xy_index) {
+        return false;
+    }
+    vertex = it->second;
+    return true;
+}
+
+void RawGraphSlabBuilder::add_plane(const unsigned char *plane_buffer) {
+    const auto nx = static_cast<long>(m_size_xy[0]);
+    const auto ny = static_cast<long>(m_size_xy[1]);
+    const auto z = static_cast<long>(m_num_planes);
+    std::swap(m_previous_plane, m_current_plane);
+    m_current_plane.clear();
+    // Only the planes z and z-1 are needed to find the preceding neighbors.
+    const bool has_previous_plane = !m_previous_plane.empty();
+
+    std::size_t neighbor_vertex = 0;
+    for (long y = 0; y < ny; ++y) {
+        for (long x = 0; x < nx; ++x) {
+            const auto xy_index = static_cast<std::size_t>(y * nx + x);
+            if (plane_buffer[xy_index] == 0) {
+                continue;
+            }
+            const auto v = boost::add_vertex(m_graph);
+            m_graph[v].id = v;
+            m_graph[v].pos = {{static_cast<double>(m_origin_index[0] + x),
+                               static_cast<double>(m_origin_index[1] + y),
+                               static_cast<double>(m_origin_index[2] + z)}};
+
+            // Neighbors in the previous plane: the 9 voxels (x+dx, y+dy, z-1)
+            if (has_previous_plane) {
+                for (long dy = -1; dy <= 1; ++dy) {
+                    const auto yn = y + dy;
+                    if (yn < 0 || yn >= ny) {
+                        continue;
+                    }
+                    for (long dx = -1; dx <= 1; ++dx) {
+                        const auto xn = x + dx;
+                        if (xn < 0 || xn >= nx) {
+                            continue;
+                        }
+                        if (find_vertex(m_previous_plane,
+                                        static_cast<std::size_t>(yn * nx + xn),
+                                        neighbor_vertex)) {
+                            boost::add_edge(neighbor_vertex, v, m_graph);
+                        }
+                    }
+                }
+            }
+            // Neighbors in the same plane preceding (x, y) in raster order:
+            // (x-1, y-1), (x, y-1), (x+1, y-1) and (x-1, y).
+            // Read the buffer first, the plane vertices are searched only for
+            // foreground voxels.
+            const auto check_same_plane = [&](const long xn, const long yn) {
+                if (xn < 0 || xn >= nx || yn < 0) {
+                    return;
+                }
+                const auto n_xy_index = static_cast<std::size_t>(yn * nx + xn);
+                if (plane_buffer[n_xy_index] != 0 &&
+                    find_vertex(m_current_plane, n_xy_index, neighbor_vertex)) {
+                    boost::add_edge(neighbor_vertex, v, m_graph);
+                }
+            };
+            check_same_plane(x - 1, y - 1);
+            check_same_plane(x, y - 1);
+            check_same_plane(x + 1, y - 1);
+            check_same_plane(x - 1, y);
+
+            m_current_plane.emplace_back(xy_index, v);
+        }
+    }
+    ++m_num_planes;
+}
+
+GraphType RawGraphSlabBuilder::release_graph() {
+    m_previous_plane.clear();
+    m_current_plane.clear();
+    return std::move(m_graph);
+}
+
+} // namespace SG
@@ -20,31 +20,60 @@
 
 #include "reduce_spatial_graph_via_dfs.hpp"
 #include "reduce_dfs_visitor.hpp"
+#include "parallel_tasks.hpp"
+#include "vertex_vector_map.hpp"
+
+#include <boost/graph/connected_components.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
 namespace SG {
 
-GraphType reduce_spatial_graph_via_dfs(const GraphType &input_sg,
-                                       bool verbose) {
-    GraphType sg;
-    using vertex_descriptor = boost::graph_traits<GraphType>::vertex_descriptor;
-    using vertex_iterator = boost::graph_traits<GraphType>::vertex_iterator;
+namespace {
+using vertex_descriptor = boost::graph_traits<GraphType>::vertex_descriptor;
+using ColorMap = VertexColorMap;
+using VertexMap = std::unordered_map<vertex_descriptor, vertex_descriptor>;
 
-    using ColorMap = std::map<vertex_descriptor, boost::default_color_type>;
-    ColorMap colorMap;
+/**
+ * Reduce the part of input_sg reachable from the start vertices into sg.
+ *
+ * colorMap has to be sized to the number of vertices of input_sg,
+ * it is reset (all white) at the beginning.
+ *
+ * @param input_sg input graph
+ * @param start_vertices end and junction vertices (degree != 2)
+ * to start the visit, in order.
+ * @param self_loop_vertices vertices that can start a self-loop visit
+ * if they were not visited and have degree 2.
+ * @param sg output graph
+ * @param vertex_map map between the vertices of input_sg and sg
+ * @param colorMap color map of the visit, reused between calls.
+ * @param verbose
+ */
+void reduce_from_start_vertices(
+        const GraphType &input_sg,
+        const std::vector<vertex_descriptor> &start_vertices,
+        const std::vector<vertex_descriptor> &self_loop_vertices,
+        GraphType &sg,
+        VertexMap &vertex_map,
+        ColorMap &colorMap,
+        bool verbose) {
+    colorMap.reset();
     using Color = boost::color_traits<ColorMap::mapped_type>;
-    boost::associative_property_map<ColorMap> propColorMap(colorMap);
+    auto propColorMap = colorMap.property_map();
 
     // std::cout << "ReduceGraphVistor:" << std::endl;
-    using VertexMap = std::unordered_map<vertex_descriptor, vertex_descriptor>;
-    VertexMap vertex_map;
     bool is_not_loop = false;
     ReduceGraphVisitor<GraphType, VertexMap, ColorMap> vis(
             sg, colorMap, vertex_map, is_not_loop, verbose);
 
-    // for each end vertex:
-    vertex_iterator vi, vi_end;
-    std::tie(vi, vi_end) = boost::vertices(input_sg);
-    auto vi_start = vi;
-    auto start = *vi;
+    vertex_descriptor start = 0;
     // Terminate function.
     // Stop the visit when find a non-chain (degree= 2) vertex.
     auto finish_on_junctions = [&start, &is_not_loop, &propColorMap,
@@ -67,36 +96,16 @@ GraphType reduce_spatial_graph_via_dfs(const GraphType &input_sg,
         return false; // Do not terminate
     };
 
-    vertex_iterator ui, ui_end;
-    for (std::tie(ui, ui_end) = boost::vertices(input_sg); ui != ui_end; ++ui) {
-        put(propColorMap, *ui, Color::white());
-    }
-
-    for (; vi != vi_end; ++vi) {
-        auto degree = boost::out_degree(*vi, input_sg);
-        if (degree == 1) {
-            start = *vi;
-            if (verbose) {
-                std::cout << "Visit: start: " << start << " : "
-                          << ArrayUtilities::to_string(input_sg[start].pos)
-                          << ". Degree: " << degree << std::endl;
-            }
-            boost::depth_first_visit(input_sg, start, vis, propColorMap,
-                                     finish_on_junctions);
-        }
-    }
-    for (vi = vi_start; vi != vi_end; ++vi) {
-        auto degree = boost::out_degree(*vi, input_sg);
-        if (degree > 2) {
-            start = *vi;
-            if (verbose) {
-                std::cout << "Visit: start: " << start << " : "
-                          << ArrayUtilities::to_string(input_sg[start].pos)
-                          << ". Degree: " << degree << std::endl;
-            }
-            boost::depth_first_visit(input_sg, start, vis, propColorMap,
-                                     finish_on_junctions);
+    for (const auto start_vertex : start_vertices) {
+        start = start_vertex;
+        if (verbose) {
+            std::cout << "Visit: start: " << start << " : "
+                      << ArrayUtilities::to_string(input_sg[start].pos)
+                      << ". Degree: " << boost::out_degree(start, input_sg)
+                      << std::endl;
         }
+        boost::depth_first_visit(input_sg, start, vis, propColorMap,
+                                 finish_on_junctions);
     }
 
     {
@@ -109,10 +118,10 @@ GraphType reduce_spatial_graph_via_dfs(const GraphType &input_sg,
         // Detect self-loops (no degree > 2 in any vertex)
         SelfLoopGraphVisitor<GraphType, VertexMap, ColorMap> vis_self_loop(
                 sg, colorMap, start, end_visit_flag);
-        for (vi = vi_start; vi != vi_end; ++vi) {
-            if (get(propColorMap, *vi) == Color::white() &&
-                boost::out_degree(*vi, input_sg) == 2) {
-                start = *vi;
+        for (const auto vertex : self_loop_vertices) {
+            if (get(propColorMap, vertex) == Color::white() &&
+                boost::out_degree(vertex, input_sg) == 2) {
+                start = vertex;
                 end_visit_flag = false;
                 if (verbose) {
                     std::cout << "Self-loops: Visit: start: " << start << " : "
@@ -125,7 +134,256 @@ GraphType reduce_spatial_graph_via_dfs(const GraphType &input_sg,
             }
         }
     }
+}
+
+/** Append the end vertices (degree 1) and then the junctions (degree > 2).*/
+void append_start_vertices(const GraphType &input_sg,
+                           const vertex_descriptor *vertices_begin,
+                           const vertex_descriptor *vertices_end,
+                           std::vector<vertex_descriptor> &start_vertices) {
+    for (auto it = vertices_begin; it != vertices_end; ++it) {
+        if (boost::out_degree(*it, input_sg) == 1) {
+            start_vertices.push_back(*it);
+        }
+    }
+    for (auto it = vertices_begin; it != vertices_end; ++it) {
+        if (boost::out_degree(*it, input_sg) > 2) {
+            start_vertices.push_back(*it);
+        }
+    }
+}
+
+/**
+ * Unit of work of reduce_spatial_graph_via_dfs_parallel.
+ * Either a group of whole components, or a chunk of the start vertices of
+ * a large component (shared = true), whose edges can be found by other
+ * work items too.
+ */
+struct ReduceWorkItem {
+    std::vector<vertex_descriptor> start_vertices;
+    std::vector<vertex_descriptor> self_loop_vertices;
+    bool shared = false;
+    // Output
+    GraphType sg;
+    VertexMap vertex_map;
+    std::exception_ptr exception;
+};
+
+std::vector<ReduceWorkItem>
+create_work_items(const GraphType &input_sg,
+                  const size_t max_work_item_size,
+                  size_t &num_components) {
+    const auto num_vertices = boost::num_vertices(input_sg);
+    std::vector<size_t> component(num_vertices);
+    num_components = num_vertices == 0 ? 0 :
+            static_cast<size_t>(boost::connected_components(
+                    input_sg,
+                    boost::make_iterator_property_map(
+                            component.begin(),
+                            boost::get(boost::vertex_index, input_sg))));
+    // Vertices sorted by component (and by vertex inside each component)
+    std::vector<size_t> component_offsets(num_components + 1, 0);
+    for (const auto c : component) {
+        ++component_offsets[c + 1];
+    }
+    for (size_t c = 0; c < num_components; ++c) {
+        component_offsets[c + 1] += component_offsets[c];
+    }
+    std::vector<vertex_descriptor> component_vertices(num_vertices);
+    {
+        auto position = component_offsets;
+        for (vertex_descriptor v = 0; v < num_vertices; ++v) {
+            component_vertices[position[component[v]]++] = v;
+        }
+    }
+
+    std::vector<ReduceWorkItem> work_items;
+    ReduceWorkItem group;
+    size_t group_size = 0;
+    const auto flush_group = [&work_items, &group, &group_size]() {
+        if (group_size != 0) {
+            work_items.push_back(std::move(group));
+            group = ReduceWorkItem();
+            group_size = 0;
+        }
+    };
+    // Components are labeled in order of their first vertex.
+    for (size_t c = 0; c < num_components; ++c) {
+        const auto *begin = component_vertices.data() + component_offsets[c];
+        const auto *end = component_vertices.data() + component_offsets[c + 1];
+        const auto size = static_cast<size_t>(end - begin);
+        std::vector<vertex_descriptor> start_vertices;
+        append_start_vertices(input_sg, begin, end, start_vertices);
+        if (size <= max_work_item_size || start_vertices.empty()) {
+            append_start_vertices(input_sg, begin, end, group.start_vertices);
+            group.self_loop_vertices.insert(group.self_loop_vertices.end(),
+                                            begin, end);
+            group_size += size;
+            if (group_size >= max_work_item_size) {
+                flush_group();
+            }
+            continue;
+        }
+        // Large component: split the start vertices (junction-bounded)
+        flush_group();
+        const auto num_chunks =
+                (size + max_work_item_size - 1) / max_work_item_size;
+        const auto chunk_size =
+                (start_vertices.size() + num_chunks - 1) / num_chunks;
+        for (size_t first = 0; first < start_vertices.size();
+             first += chunk_size) {
+            const auto last = std::min(first + chunk_size,
+                                       start_vertices.size());
+            ReduceWorkItem chunk;
+            chunk.shared = true;
+            chunk.start_vertices.assign(start_vertices.begin() + first,
+                                        start_vertices.begin() + last);
+            work_items.push_back(std::move(chunk));
+        }
+    }
+    flush_group();
+    return work_items;
+}
+
+/**
+ * Return true if sg has an edge between source and target with the same
+ * edge points (in any order) as sg_edge.
+ */
+bool edge_already_exists(const vertex_descriptor source,
+                         const vertex_descriptor target,
+                         const SpatialEdge &sg_edge,
+                         const GraphType &sg) {
+    SpatialEdge::PointContainer sorted_edge_points;
+    bool sorted = false;
+    for (const auto e :
+         boost::make_iterator_range(boost::out_edges(source, sg))) {
+        if (boost::target(e, sg) != target ||
+            sg[e].edge_points.size() != sg_edge.edge_points.size()) {
+            continue;
+        }
+        if (!sorted) {
+            sorted_edge_points = sg_edge.edge_points;
+            std::sort(std::begin(sorted_edge_points),
+                      std::end(sorted_edge_points));
+            sorted = true;
+        }
+        auto sorted_parallel_edge_points = sg[e].edge_points;
+        std::sort(std::begin(sorted_parallel_edge_points),
+                  std::end(sorted_parallel_edge_points));
+        if (sorted_edge_points == sorted_parallel_edge_points) {
+            return true;
+        }
+    }
+    return false;
+}
 
+/**
+ * Append the output of the work item to sg, in order.
+ * input_to_output maps the vertices of the input graph to the vertices of sg.
+ */
+void merge_work_item(const ReduceWorkItem &work_item,
+                     std::vector<vertex_descriptor> &input_to_output,
+                     GraphType &sg) {
+    constexpr auto no_vertex = std::numeric_limits<vertex_descriptor>::max();
+    const auto &item_sg = work_item.sg;
+    const auto num_item_vertices = boost::num_vertices(item_sg);
+    std::vector<vertex_descriptor> item_to_input(num_item_vertices, no_vertex);
+    for (const auto &input_item : work_item.vertex_map) {
+        item_to_input[input_item.second] = input_item.first;
+    }
+    std::vector<vertex_descriptor> item_to_output(num_item_vertices);
+    for (vertex_descriptor v = 0; v < num_item_vertices; ++v) {
+        const auto input_vertex = item_to_input[v];
+        if (input_vertex == no_vertex) {
+            // Vertex created by split_loop
+            item_to_output[v] = boost::add_vertex(item_sg[v], sg);
+            continue;
+        }
+        auto &output_vertex = input_to_output[input_vertex];
+        if (output_vertex == no_vertex) {
+            output_vertex = boost::add_vertex(item_sg[v], sg);
+        }
+        item_to_output[v] = output_vertex;
+    }
+    for (const auto e : boost::make_iterator_range(boost::edges(item_sg))) {
+        const auto source = item_to_output[boost::source(e, item_sg)];
+        const auto target = item_to_output[boost::target(e, item_sg)];
+        if (work_item.shared &&
+            edge_already_exists(source, target, item_sg[e], sg)) {
+            continue;
+        }
+        boost::add_edge(source, target, item_sg[e], sg);
+    }
+}
+} // namespace
+
+GraphType reduce_spatial_graph_via_dfs(const GraphType &input_sg,
+                                       bool verbose) {
+    GraphType sg;
+    VertexMap vertex_map;
+    std::vector<vertex_descriptor> all_vertices(boost::num_vertices(input_sg));
+    std::iota(all_vertices.begin(), all_vertices.end(), 0);
+    std::vector<vertex_descriptor> start_vertices;
+    append_start_vertices(input_sg, all_vertices.data(),
+                          all_vertices.data() + all_vertices.size(),
+                          start_vertices);
+    ColorMap colorMap(all_vertices.size());
+    reduce_from_start_vertices(input_sg, start_vertices, all_vertices, sg,
+                               vertex_map, colorMap, verbose);
+    return sg;
+}
+
+GraphType reduce_spatial_graph_via_dfs_parallel(const GraphType &input_sg,
+                                                size_t num_threads,
+                                                size_t max_work_item_size,
+                                                bool verbose) {
+    if (max_work_item_size == 0) {
+        throw std::runtime_error("reduce_spatial_graph_via_dfs_parallel: "
+                                 "max_work_item_size cannot be 0.");
+    }
+    num_threads = resolve_num_threads(num_threads);
+    size_t num_components = 0;
+    auto work_items =
+            create_work_items(input_sg, max_work_item_size, num_components);
+    num_threads = std::max<size_t>(1, std::min(num_threads, work_items.size()));
+    if (verbose) {
+        std::cout << "reduce_spatial_graph_via_dfs_parallel: "
+                  << num_components << " components, " << work_items.size()
+                  << " work items, " << num_threads << " threads."
+                  << std::endl;
+    }
+
+    // One color map per thread, reused (reset) by all its work items.
+    std::vector<ColorMap> color_maps(num_threads);
+    run_tasks(work_items.size(), num_threads,
+              [&input_sg, &work_items, &color_maps](const size_t i,
+                                                    const size_t thread_index) {
+                  auto &colorMap = color_maps[thread_index];
+                  if (colorMap.size() == 0) {
+                      colorMap.resize(boost::num_vertices(input_sg));
+                  }
+                  auto &work_item = work_items[i];
+                  try {
+                      reduce_from_start_vertices(
+                              input_sg, work_item.start_vertices,
+                              work_item.self_loop_vertices, work_item.sg,
+                              work_item.vertex_map, colorMap, false);
+                  } catch (...) {
+                      work_item.exception = std::current_exception();
+                  }
+              });
+
+    // Merge in the order of the work items, independent of the threads.
+    GraphType sg;
+    std::vector<vertex_descriptor> input_to_output(
+            boost::num_vertices(input_sg),
+            std::numeric_limits<vertex_descriptor>::max());
+    for (const auto &work_item : work_items) {
+        if (work_item.exception) {
+            std::rethrow_exception(work_item.exception);
+        }
+        merge_work_item(work_item, input_to_output, sg);
+    }
     return sg;
 }
 } // namespace SG
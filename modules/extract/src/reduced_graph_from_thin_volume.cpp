@@ -0,0 +1,380 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "reduced_graph_from_thin_volume.hpp"
+#include "split_loop.hpp"
+#include "thin_volume_neighborhood.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace SG {
+
+namespace {
+using detail::lowest_bit;
+using detail::neighborhood_lut;
+using detail::neighbors_mask;
+using detail::no_neighbor;
+using detail::num_neighbors;
+using detail::popcount;
+/** Bit of the configuration used to mark visited chain voxels. */
+constexpr std::uint32_t visited_bit = 1u << 31;
+
+/**
+ * Foreground voxels of the volume in raster order, with their
+ * 26-neighborhood configuration.
+ * The foreground neighbors of each voxel are resolved once in the scan,
+ * works as in a CSR: the neighbors of voxel are in
+ * neighbor_voxels[neighbor_offsets[voxel], neighbor_offsets[voxel + 1]),
+ * in the order of the bits of scanned_configuration[voxel].
+ */
+struct ThinVolume {
+    std::array<std::size_t, 3> size;
+    std::array<long, 3> origin_index;
+    std::vector<std::size_t> linear_index;
+    /** Configuration, modified when extra edges are removed. */
+    std::vector<std::uint32_t> configuration;
+    /** Configuration of the volume, before removing extra edges. */
+    std::vector<std::uint32_t> scanned_configuration;
+    std::vector<std::size_t> neighbor_offsets;
+    std::vector<std::size_t> neighbor_voxels;
+
+    std::array<std::size_t, 3> coordinates(const std::size_t voxel) const {
+        const auto l = linear_index[voxel];
+        return {{l % size[0], (l / size[0]) % size[1],
+                 l / (size[0] * size[1])}};
+    }
+
+    SpatialNode::PointType position(const std::size_t voxel) const {
+        const auto c = coordinates(voxel);
+        return {{static_cast<double>(origin_index[0] +
+                                     static_cast<long>(c[0])),
+                 static_cast<double>(origin_index[1] +
+                                     static_cast<long>(c[1])),
+                 static_cast<double>(origin_index[2] +
+                                     static_cast<long>(c[2]))}};
+    }
+
+    /** Foreground voxel in the direction k of voxel, it has to exist. */
+    std::size_t neighbor(const std::size_t voxel, const int k) const {
+        const auto lower_bits =
+                scanned_configuration[voxel] & ((1u << k) - 1);
+        return neighbor_voxels[neighbor_offsets[voxel] + popcount(lower_bits)];
+    }
+
+    int degree(const std::size_t voxel) const {
+        return popcount(configuration[voxel] & neighbors_mask);
+    }
+};
+
+ThinVolume scan_thin_volume(const unsigned char *buffer,
+                            const std::array<std::size_t, 3> &size,
+                            const std::array<long, 3> &origin_index) {
+    const auto &lut = neighborhood_lut();
+    const auto nx = size[0];
+    const auto ny = size[1];
+    const auto nz = size[2];
+    ThinVolume volume;
+    volume.size = size;
+    volume.origin_index = origin_index;
+    const auto num_pixels = nx * ny * nz;
+    for (std::size_t l = 0; l < num_pixels; ++l) {
+        if (buffer[l] != 0) {
+            volume.linear_index.push_back(l);
+        }
+    }
+
+    const auto num_voxels = volume.linear_index.size();
+    volume.configuration.resize(num_voxels);
+    std::array<std::ptrdiff_t, num_neighbors> linear_offset;
+    for (std::size_t k = 0; k < num_neighbors; ++k) {
+        linear_offset[k] = lut.offset[k][0] +
+                           static_cast<std::ptrdiff_t>(nx) *
+                                   (lut.offset[k][1] +
+                                    static_cast<std::ptrdiff_t>(ny) *
+                                            lut.offset[k][2]);
+    }
+    for (std::size_t voxel = 0; voxel < num_voxels; ++voxel) {
+        const auto c = volume.coordinates(voxel);
+        const auto l_voxel = static_cast<std::ptrdiff_t>(
+                volume.linear_index[voxel]);
+        const bool interior = c[0] > 0 && c[0] + 1 < nx && c[1] > 0 &&
+                              c[1] + 1 < ny && c[2] > 0 && c[2] + 1 < nz;
+        std::uint32_t configuration = 0;
+        for (std::size_t k = 0; k < num_neighbors; ++k) {
+            if (!interior) {
+                bool inside = true;
+                for (std::size_t i = 0; i < 3; ++i) {
+                    const auto n = static_cast<long>(c[i]) + lut.offset[k][i];
+                    inside &= n >= 0 && n < static_cast<long>(size[i]);
+                }
+                if (!inside) {
+                    continue;
+                }
+            }
+            if (buffer[l_voxel + linear_offset[k]] != 0) {
+                configuration |= 1u << k;
+            }
+        }
+        volume.configuration[voxel] = configuration;
+    }
+    volume.scanned_configuration = volume.configuration;
+
+    // The linear index of the neighbor k increases with the voxel, so each
+    // direction keeps a cursor that only moves forward in linear_index.
+    volume.neighbor_offsets.resize(num_voxels + 1);
+    volume.neighbor_offsets[0] = 0;
+    for (std::size_t voxel = 0; voxel < num_voxels; ++voxel) {
+        volume.neighbor_offsets[voxel + 1] =
+                volume.neighbor_offsets[voxel] + volume.degree(voxel);
+    }
+    volume.neighbor_voxels.resize(volume.neighbor_offsets[num_voxels]);
+    std::array<std::size_t, num_neighbors> cursor;
+    cursor.fill(0);
+    for (std::size_t voxel = 0; voxel < num_voxels; ++voxel) {
+        const auto l_voxel = static_cast<std::ptrdiff_t>(
+                volume.linear_index[voxel]);
+        auto configuration = volume.configuration[voxel];
+        auto index = volume.neighbor_offsets[voxel];
+        for (; configuration; configuration &= configuration - 1) {
+            const auto k = lowest_bit(configuration);
+            const auto target =
+                    static_cast<std::size_t>(l_voxel + linear_offset[k]);
+            auto &c = cursor[k];
+            while (volume.linear_index[c] < target) {
+                ++c;
+            }
+            volume.neighbor_voxels[index++] = c;
+        }
+    }
+    return volume;
+}
+
+/**
+ * Same criteria than remove_extra_edges, applied to the configurations.
+ * @return true if any edge was removed.
+ */
+bool remove_extra_edges_from_configurations(ThinVolume &volume) {
+    const auto &lut = neighborhood_lut();
+    std::vector<std::pair<std::size_t, int>> edges_to_remove;
+    const auto num_voxels = volume.configuration.size();
+    for (std::size_t voxel = 0; voxel < num_voxels; ++voxel) {
+        const auto configuration = volume.configuration[voxel];
+        if (volume.degree(voxel) <= 2) {
+            continue;
+        }
+        for (int k1 = 0; k1 < static_cast<int>(num_neighbors); ++k1) {
+            if (!(configuration & (1u << k1))) {
+                continue;
+            }
+            std::size_t neighbor_first = 0;
+            bool neighbor_first_found = false;
+            for (int k2 = k1 + 1; k2 < static_cast<int>(num_neighbors); ++k2) {
+                if (!(configuration & (1u << k2))) {
+                    continue;
+                }
+                const auto k_between = lut.between[k1][k2];
+                if (k_between == no_neighbor) {
+                    continue;
+                }
+                if (!neighbor_first_found) {
+                    neighbor_first = volume.neighbor(voxel, k1);
+                    neighbor_first_found = true;
+                }
+                if (!(volume.configuration[neighbor_first] &
+                      (1u << k_between))) {
+                    continue;
+                }
+                const auto dist_first = lut.squared_distance[k1];
+                const auto dist_second = lut.squared_distance[k2];
+                const auto dist_between = lut.squared_distance_between[k1][k2];
+                if (dist_first > dist_second && dist_first > dist_between) {
+                    edges_to_remove.emplace_back(voxel, k1);
+                } else if (dist_second > dist_first &&
+                           dist_second > dist_between) {
+                    edges_to_remove.emplace_back(voxel, k2);
+                } else if (dist_between > dist_first &&
+                           dist_between > dist_second) {
+                    edges_to_remove.emplace_back(neighbor_first, k_between);
+                }
+            }
+        }
+    }
+    bool any_edge_was_removed = false;
+    for (const auto &edge : edges_to_remove) {
+        const auto k = edge.second;
+        if (!(volume.configuration[edge.first] & (1u << k))) {
+            continue; // Already removed
+        }
+        const auto neighbor = volume.neighbor(edge.first, k);
+        volume.configuration[edge.first] &= ~(1u << k);
+        volume.configuration[neighbor] &=
+                ~(1u << (static_cast<int>(num_neighbors) - 1 - k));
+        any_edge_was_removed = true;
+    }
+    return any_edge_was_removed;
+}
+
+/**
+ * Follow the chain voxels starting at the neighbor k of start, until
+ * reaching a voxel that is not a chain.
+ * The positions of the chain voxels are added to edge_points and marked as
+ * visited.
+ * @return the last voxel (not chain), can be start if the chain is a loop.
+ */
+std::size_t trace_chain(ThinVolume &volume,
+                        const std::size_t start,
+                        const int k,
+                        SpatialEdge::PointContainer &edge_points) {
+    auto previous = start;
+    auto current = volume.neighbor(start, k);
+    while (volume.degree(current) == 2 && current != start) {
+        volume.configuration[current] |= visited_bit;
+        edge_points.push_back(volume.position(current));
+        const auto configuration = volume.configuration[current] &
+                                   neighbors_mask;
+        const auto k_first = lowest_bit(configuration);
+        const auto k_second =
+                lowest_bit(configuration & ~(1u << k_first));
+        auto next = volume.neighbor(current, k_first);
+        if (next == previous) {
+            next = volume.neighbor(current, k_second);
+        }
+        previous = current;
+        current = next;
+    }
+    return current;
+}
+
+} // namespace
+
+GraphType reduced_graph_from_thin_volume(
+        const unsigned char *buffer,
+        const std::array<std::size_t, 3> &size,
+        const std::array<long, 3> &origin_index,
+        bool removeExtraEdges,
+        bool verbose) {
+    if (buffer == nullptr) {
+        throw std::runtime_error(
+                "reduced_graph_from_thin_volume: buffer is null.");
+    }
+    auto volume = scan_thin_volume(buffer, size, origin_index);
+    const auto num_voxels = volume.configuration.size();
+
+    if (removeExtraEdges) {
+        size_t iterations = 0;
+        while (remove_extra_edges_from_configurations(volume)) {
+            ++iterations;
+        }
+        if (verbose) {
+            std::cout << "Removed extra edges iteratively " << iterations
+                      << " times" << std::endl;
+        }
+    }
+
+    // Nodes: all the foreground voxels that are not chains.
+    constexpr auto no_vertex = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> voxel_to_vertex(num_voxels, no_vertex);
+    GraphType sg;
+    size_t num_ends = 0;
+    size_t num_chains = 0;
+    size_t num_junctions = 0;
+    for (std::size_t voxel = 0; voxel < num_voxels; ++voxel) {
+        const auto degree = volume.degree(voxel);
+        if (degree == 0) {
+            continue;
+        }
+        if (degree == 2) {
+            ++num_chains;
+            continue;
+        }
+        degree == 1 ? ++num_ends : ++num_junctions;
+        const auto v = boost::add_vertex(sg);
+        sg[v].id = v;
+        sg[v].pos = volume.position(voxel);
+        voxel_to_vertex[voxel] = v;
+    }
+    if (verbose) {
+        std::cout << "Foreground voxels: " << num_voxels
+                  << ". End: " << num_ends << ", chain: " << num_chains
+                  << ", junction: " << num_junctions << std::endl;
+    }
+
+    // Edges: trace the chains starting from end and junction nodes.
+    for (std::size_t voxel = 0; voxel < num_voxels; ++voxel) {
+        const auto source = voxel_to_vertex[voxel];
+        if (source == no_vertex) {
+            continue;
+        }
+        const auto configuration = volume.configuration[voxel];
+        for (int k = 0; k < static_cast<int>(num_neighbors); ++k) {
+            if (!(configuration & (1u << k))) {
+                continue;
+            }
+            const auto neighbor = volume.neighbor(voxel, k);
+            if (volume.degree(neighbor) != 2) {
+                // Adjacent nodes, add the edge only once.
+                if (neighbor > voxel) {
+                    boost::add_edge(source, voxel_to_vertex[neighbor], sg);
+                }
+                continue;
+            }
+            if (volume.configuration[neighbor] & visited_bit) {
+                continue;
+            }
+            SpatialEdge sg_edge;
+            const auto last = trace_chain(volume, voxel, k, sg_edge.edge_points);
+            if (last == voxel) {
+                split_loop(source, sg_edge, sg);
+            } else {
+                boost::add_edge(source, voxel_to_vertex[last], sg_edge, sg);
+            }
+        }
+    }
+
+    // Isolated loops: components where all the voxels are chains.
+    // As in reduce_spatial_graph_via_dfs, the first voxel of the loop is a
+    // node, and the loop is split in two edges.
+    for (std::size_t voxel = 0; voxel < num_voxels; ++voxel) {
+        if (volume.degree(voxel) != 2 ||
+            (volume.configuration[voxel] & visited_bit)) {
+            continue;
+        }
+        volume.configuration[voxel] |= visited_bit;
+        const auto source = boost::add_vertex(sg);
+        sg[source].id = source;
+        sg[source].pos = volume.position(voxel);
+        SpatialEdge sg_edge;
+        trace_chain(volume, voxel,
+                    lowest_bit(volume.configuration[voxel] & neighbors_mask),
+                    sg_edge.edge_points);
+        // The shortest loop (three voxels) has two edge points, and is
+        // split in two edges too.
+        split_loop(source, sg_edge, sg);
+    }
+    return sg;
+}
+
+} // namespace SG
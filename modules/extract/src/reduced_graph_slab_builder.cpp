@@ -0,0 +1,492 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "reduced_graph_slab_builder.hpp"
+#include "split_loop.hpp"
+#include "thin_volume_neighborhood.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+
+namespace SG {
+
+namespace {
+using detail::lowest_bit;
+using detail::neighborhood_lut;
+using detail::no_neighbor;
+using detail::num_neighbors;
+using detail::num_preceding_neighbors;
+using detail::popcount;
+constexpr std::uint32_t preceding_mask = (1u << num_preceding_neighbors) - 1;
+
+template <typename TPlane>
+typename TPlane::const_iterator find_xy(const TPlane &plane,
+                                        const std::size_t xy_index) {
+    const auto it = std::lower_bound(
+            std::begin(plane), std::end(plane), xy_index,
+            [](const typename TPlane::value_type &xy_value,
+               const std::size_t value) { return xy_value.first < value; });
+    if (it == std::end(plane) || it->first != xy_index) {
+        return std::end(plane);
+    }
+    return it;
+}
+
+/** Raster order (z, y, x) of the positions. */
+bool raster_less(const PointType &a, const PointType &b) {
+    return std::make_tuple(a[2], a[1], a[0]) <
+           std::make_tuple(b[2], b[1], b[0]);
+}
+} // namespace
+
+ReducedGraphSlabBuilder::ReducedGraphSlabBuilder(const std::size_t nx,
+                                                 const std::size_t ny,
+                                                 const IndexType &origin_index,
+                                                 const bool removeExtraEdges)
+        : m_size_xy({{nx, ny}}), m_origin_index(origin_index),
+          m_remove_extra_edges(removeExtraEdges) {
+    if (m_size_xy[0] == 0 || m_size_xy[1] == 0) {
+        throw std::runtime_error(
+                "ReducedGraphSlabBuilder: the size of the planes cannot be 0.");
+    }
+}
+
+void ReducedGraphSlabBuilder::add_slab(const unsigned char *slab_buffer,
+                                       const std::size_t nz) {
+    const auto plane_size = m_size_xy[0] * m_size_xy[1];
+    for (std::size_t z = 0; z < nz; ++z) {
+        add_plane(slab_buffer + z * plane_size);
+    }
+}
+
+void ReducedGraphSlabBuilder::add_plane(const unsigned char *plane_buffer) {
+    const auto z = static_cast<long>(m_num_planes);
+    const auto plane_size = m_size_xy[0] * m_size_xy[1];
+    m_plane_buffers[z % 3].assign(plane_buffer, plane_buffer + plane_size);
+    ++m_num_planes;
+    // The configurations of z - 1 need the plane z, and the extra edges of
+    // z - 2 need the configurations of z - 1.
+    if (z >= 1) {
+        compute_configurations(z - 1);
+    }
+    if (z >= 2) {
+        finish_plane(z - 2);
+    }
+}
+
+GraphType ReducedGraphSlabBuilder::release_graph() {
+    if (m_num_planes > 0) {
+        const auto last = static_cast<long>(m_num_planes) - 1;
+        compute_configurations(last);
+        if (last >= 1) {
+            finish_plane(last - 1);
+        }
+        finish_plane(last);
+    }
+    // Every chain reached a node or closed a loop in the last plane.
+    m_chains.clear();
+    m_free_chains.clear();
+    for (auto &handles : m_handles) {
+        handles.clear();
+    }
+    for (auto &configurations : m_configurations) {
+        configurations.clear();
+    }
+    for (auto &buffer : m_plane_buffers) {
+        buffer.clear();
+    }
+    return std::move(m_graph);
+}
+
+const unsigned char *ReducedGraphSlabBuilder::plane_buffer(const long z) const {
+    if (z < 0 || z >= static_cast<long>(m_num_planes)) {
+        return nullptr;
+    }
+    return m_plane_buffers[z % 3].data();
+}
+
+void ReducedGraphSlabBuilder::compute_configurations(const long z) {
+    const auto &lut = neighborhood_lut();
+    const auto nx = static_cast<long>(m_size_xy[0]);
+    const auto ny = static_cast<long>(m_size_xy[1]);
+    const std::array<const unsigned char *, 3> planes = {
+            {plane_buffer(z - 1), plane_buffer(z), plane_buffer(z + 1)}};
+    const auto *plane = planes[1];
+    auto &configurations = m_configurations[z % 3];
+    configurations.clear();
+    for (long y = 0; y < ny; ++y) {
+        for (long x = 0; x < nx; ++x) {
+            const auto xy_index = static_cast<std::size_t>(y * nx + x);
+            if (plane[xy_index] == 0) {
+                continue;
+            }
+            std::uint32_t configuration = 0;
+            for (std::size_t k = 0; k < num_neighbors; ++k) {
+                const auto &offset = lut.offset[k];
+                const auto *neighbor_plane = planes[offset[2] + 1];
+                const auto xn = x + offset[0];
+                const auto yn = y + offset[1];
+                if (neighbor_plane == nullptr || xn < 0 || xn >= nx ||
+                    yn < 0 || yn >= ny) {
+                    continue;
+                }
+                if (neighbor_plane[yn * nx + xn] != 0) {
+                    configuration |= 1u << k;
+                }
+            }
+            // Isolated voxels are ignored.
+            if (configuration) {
+                configurations.emplace_back(xy_index, configuration);
+            }
+        }
+    }
+}
+
+int ReducedGraphSlabBuilder::degree(const long z,
+                                    const std::size_t xy_index) const {
+    const auto &configurations = m_configurations[z % 3];
+    const auto it = find_xy(configurations, xy_index);
+    return it == std::end(configurations) ? 0 : popcount(it->second);
+}
+
+/**
+ * Same criteria than remove_extra_edges: in each triangle with a vertex of
+ * degree greater than 2, the strictly longest edge is removed.
+ * The triangles are found in the configurations before any removal, so
+ * there is no need to iterate.
+ */
+void ReducedGraphSlabBuilder::remove_extra_edges(
+        const long z, PlaneConfigurations &configurations) const {
+    const auto &lut = neighborhood_lut();
+    const auto nx = static_cast<long>(m_size_xy[0]);
+    for (auto &xy_configuration : configurations) {
+        const auto xy_index = xy_configuration.first;
+        const auto configuration = xy_configuration.second;
+        const auto voxel_degree = popcount(configuration);
+        if (voxel_degree < 2) {
+            continue;
+        }
+        const auto x = static_cast<long>(xy_index) % nx;
+        const auto y = static_cast<long>(xy_index) / nx;
+        std::array<int, num_neighbors> neighbor_degree;
+        neighbor_degree.fill(-1);
+        const auto get_neighbor_degree = [&](const int k) {
+            if (neighbor_degree[k] < 0) {
+                const auto &offset = lut.offset[k];
+                neighbor_degree[k] = degree(
+                        z + offset[2], static_cast<std::size_t>(
+                                               (y + offset[1]) * nx + x +
+                                               offset[0]));
+            }
+            return neighbor_degree[k];
+        };
+        std::uint32_t removed = 0;
+        for (int k1 = 0; k1 < static_cast<int>(num_neighbors); ++k1) {
+            if (!(configuration & (1u << k1))) {
+                continue;
+            }
+            for (int k2 = k1 + 1; k2 < static_cast<int>(num_neighbors); ++k2) {
+                if (!(configuration & (1u << k2)) ||
+                    lut.between[k1][k2] == no_neighbor) {
+                    continue;
+                }
+                // Isolated triangle
+                if (voxel_degree <= 2 && get_neighbor_degree(k1) <= 2 &&
+                    get_neighbor_degree(k2) <= 2) {
+                    continue;
+                }
+                const auto dist_first = lut.squared_distance[k1];
+                const auto dist_second = lut.squared_distance[k2];
+                const auto dist_between = lut.squared_distance_between[k1][k2];
+                if (dist_first > dist_second && dist_first > dist_between) {
+                    removed |= 1u << k1;
+                } else if (dist_second > dist_first &&
+                           dist_second > dist_between) {
+                    removed |= 1u << k2;
+                }
+            }
+        }
+        xy_configuration.second = configuration & ~removed;
+    }
+}
+
+void ReducedGraphSlabBuilder::finish_plane(const long z) {
+    auto configurations = m_configurations[z % 3];
+    if (m_remove_extra_edges) {
+        remove_extra_edges(z, configurations);
+    }
+    reduce_plane(z, configurations);
+}
+
+PointType ReducedGraphSlabBuilder::position(const long z,
+                                            const std::size_t xy_index) const {
+    const auto nx = m_size_xy[0];
+    return {{static_cast<double>(m_origin_index[0] +
+                                 static_cast<long>(xy_index % nx)),
+             static_cast<double>(m_origin_index[1] +
+                                 static_cast<long>(xy_index / nx)),
+             static_cast<double>(m_origin_index[2] + z)}};
+}
+
+ReducedGraphSlabBuilder::VoxelHandle &
+ReducedGraphSlabBuilder::handle(const long z, const std::size_t xy_index) {
+    auto &handles = m_handles[z % 2];
+    const auto it = find_xy(handles, xy_index);
+    if (it == std::end(handles)) {
+        throw std::logic_error(
+                "ReducedGraphSlabBuilder: voxel with pending edges not found.");
+    }
+    return handles[it - std::begin(handles)].second;
+}
+
+ReducedGraphSlabBuilder::ChainEnd
+ReducedGraphSlabBuilder::open_end(const long z, const std::size_t xy_index) {
+    return {false, 0, z, xy_index};
+}
+
+ReducedGraphSlabBuilder::ChainEnd
+ReducedGraphSlabBuilder::node_end(const std::size_t vertex) {
+    return {true, vertex, 0, 0};
+}
+
+int ReducedGraphSlabBuilder::end_at(const std::size_t chain,
+                                    const long z,
+                                    const std::size_t xy_index) const {
+    const auto &ends = m_chains[chain].ends;
+    for (int end = 0; end < 2; ++end) {
+        if (!ends[end].is_node && ends[end].z == z &&
+            ends[end].xy_index == xy_index) {
+            return end;
+        }
+    }
+    throw std::logic_error(
+            "ReducedGraphSlabBuilder: voxel is not an open end of its chain.");
+}
+
+std::size_t ReducedGraphSlabBuilder::new_chain(const ChainEnd &end0,
+                                               const PointType &point,
+                                               const ChainEnd &end1) {
+    std::size_t chain;
+    if (m_free_chains.empty()) {
+        chain = m_chains.size();
+        m_chains.emplace_back();
+    } else {
+        chain = m_free_chains.back();
+        m_free_chains.pop_back();
+    }
+    m_chains[chain].points.push_back(point);
+    m_chains[chain].ends = {{end0, end1}};
+    return chain;
+}
+
+void ReducedGraphSlabBuilder::release_chain(const std::size_t chain) {
+    std::deque<PointType>().swap(m_chains[chain].points);
+    m_free_chains.push_back(chain);
+}
+
+void ReducedGraphSlabBuilder::finish_chain_if_closed(const std::size_t chain) {
+    const auto &ends = m_chains[chain].ends;
+    if (!ends[0].is_node || !ends[1].is_node) {
+        return;
+    }
+    SpatialEdge sg_edge;
+    sg_edge.edge_points.assign(std::begin(m_chains[chain].points),
+                               std::end(m_chains[chain].points));
+    if (ends[0].vertex == ends[1].vertex) {
+        split_loop(ends[0].vertex, sg_edge, m_graph);
+    } else {
+        boost::add_edge(ends[0].vertex, ends[1].vertex, sg_edge, m_graph);
+    }
+    release_chain(chain);
+}
+
+void ReducedGraphSlabBuilder::merge_chains(std::size_t chain,
+                                           int chain_end,
+                                           std::size_t other,
+                                           int other_end,
+                                           const PointType &point) {
+    // Move the points of the shortest chain.
+    if (m_chains[chain].points.size() < m_chains[other].points.size()) {
+        std::swap(chain, other);
+        std::swap(chain_end, other_end);
+    }
+    auto &points = m_chains[chain].points;
+    const auto &other_points = m_chains[other].points;
+    const auto push = [&points, chain_end](const PointType &p) {
+        if (chain_end == 0) {
+            points.push_front(p);
+        } else {
+            points.push_back(p);
+        }
+    };
+    push(point);
+    if (other_end == 0) {
+        std::for_each(std::begin(other_points), std::end(other_points), push);
+    } else {
+        std::for_each(other_points.rbegin(), other_points.rend(), push);
+    }
+    const auto end = m_chains[other].ends[1 - other_end];
+    m_chains[chain].ends[chain_end] = end;
+    if (!end.is_node) {
+        handle(end.z, end.xy_index).index = chain;
+    }
+    release_chain(other);
+    finish_chain_if_closed(chain);
+}
+
+void ReducedGraphSlabBuilder::close_loop(const std::size_t chain,
+                                         const PointType &point) {
+    // Isolated loop, point is adjacent to both ends of the chain.
+    // As in reduced_graph_from_thin_volume, the first voxel of the loop is a
+    // node, and the loop is split in two edges.
+    auto &points = m_chains[chain].points;
+    points.push_back(point);
+    const auto first =
+            std::min_element(std::begin(points), std::end(points), raster_less);
+    SpatialEdge sg_edge;
+    sg_edge.edge_points.insert(std::end(sg_edge.edge_points), std::next(first),
+                               std::end(points));
+    sg_edge.edge_points.insert(std::end(sg_edge.edge_points),
+                               std::begin(points), first);
+    const auto source = boost::add_vertex(m_graph);
+    m_graph[source].id = source;
+    m_graph[source].pos = *first;
+    split_loop(source, sg_edge, m_graph);
+    release_chain(chain);
+}
+
+void ReducedGraphSlabBuilder::reduce_plane(
+        const long z, const PlaneConfigurations &configurations) {
+    const auto &lut = neighborhood_lut();
+    const auto nx = static_cast<long>(m_size_xy[0]);
+    // The handles of the plane z - 2 are not needed anymore.
+    auto &handles = m_handles[z % 2];
+    handles.clear();
+    for (const auto &xy_configuration : configurations) {
+        const auto xy_index = xy_configuration.first;
+        const auto configuration = xy_configuration.second;
+        const auto voxel_degree = popcount(configuration);
+        if (voxel_degree == 0) {
+            continue;
+        }
+        const auto x = static_cast<long>(xy_index) % nx;
+        const auto y = static_cast<long>(xy_index) / nx;
+        const auto point = position(z, xy_index);
+        const bool has_following = (configuration & ~preceding_mask) != 0;
+        // The preceding neighbors are already reduced, in the planes z - 1
+        // and z.
+        std::array<std::pair<long, std::size_t>, num_preceding_neighbors>
+                preceding;
+        std::size_t num_preceding = 0;
+        for (auto mask = configuration & preceding_mask; mask;
+             mask &= mask - 1) {
+            const auto &offset = lut.offset[lowest_bit(mask)];
+            preceding[num_preceding++] = {
+                    z + offset[2], static_cast<std::size_t>(
+                                           (y + offset[1]) * nx + x +
+                                           offset[0])};
+        }
+
+        if (voxel_degree != 2) {
+            // End or junction node.
+            const auto v = boost::add_vertex(m_graph);
+            m_graph[v].id = v;
+            m_graph[v].pos = point;
+            for (std::size_t i = 0; i < num_preceding; ++i) {
+                const auto neighbor = handle(preceding[i].first,
+                                             preceding[i].second);
+                if (neighbor.is_node) {
+                    boost::add_edge(neighbor.index, v, m_graph);
+                } else {
+                    const auto end = end_at(neighbor.index, preceding[i].first,
+                                            preceding[i].second);
+                    m_chains[neighbor.index].ends[end] = node_end(v);
+                    finish_chain_if_closed(neighbor.index);
+                }
+            }
+            if (has_following) {
+                handles.emplace_back(xy_index, VoxelHandle{true, v});
+            }
+            continue;
+        }
+
+        // Chain voxel
+        if (num_preceding == 0) {
+            const auto chain = new_chain(open_end(z, xy_index), point,
+                                         open_end(z, xy_index));
+            handles.emplace_back(xy_index, VoxelHandle{false, chain});
+        } else if (num_preceding == 1) {
+            const auto neighbor =
+                    handle(preceding[0].first, preceding[0].second);
+            std::size_t chain;
+            if (neighbor.is_node) {
+                chain = new_chain(node_end(neighbor.index), point,
+                                  open_end(z, xy_index));
+            } else {
+                chain = neighbor.index;
+                const auto end =
+                        end_at(chain, preceding[0].first, preceding[0].second);
+                if (end == 0) {
+                    m_chains[chain].points.push_front(point);
+                } else {
+                    m_chains[chain].points.push_back(point);
+                }
+                m_chains[chain].ends[end] = open_end(z, xy_index);
+            }
+            handles.emplace_back(xy_index, VoxelHandle{false, chain});
+        } else {
+            auto first = handle(preceding[0].first, preceding[0].second);
+            auto second = handle(preceding[1].first, preceding[1].second);
+            auto first_voxel = preceding[0];
+            if (first.is_node && second.is_node) {
+                SpatialEdge sg_edge;
+                sg_edge.edge_points.push_back(point);
+                boost::add_edge(first.index, second.index, sg_edge, m_graph);
+                continue;
+            }
+            if (first.is_node) {
+                std::swap(first, second);
+                first_voxel = preceding[1];
+            }
+            const auto chain = first.index;
+            const auto end =
+                    end_at(chain, first_voxel.first, first_voxel.second);
+            if (second.is_node) {
+                if (end == 0) {
+                    m_chains[chain].points.push_front(point);
+                } else {
+                    m_chains[chain].points.push_back(point);
+                }
+                m_chains[chain].ends[end] = node_end(second.index);
+                finish_chain_if_closed(chain);
+            } else if (second.index == chain) {
+                close_loop(chain, point);
+            } else {
+                const auto second_end = end_at(second.index,
+                                               preceding[1].first,
+                                               preceding[1].second);
+                merge_chains(chain, end, second.index, second_end, point);
+            }
+        }
+    }
+}
+
+} // namespace SG
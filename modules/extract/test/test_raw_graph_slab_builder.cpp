@@ -0,0 +1,145 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "raw_graph_slab_builder.hpp"
+#include "reduce_spatial_graph_via_dfs.hpp"
+#include "gmock/gmock.h"
+
+#include <random>
+
+/**
+ * Volume of 7x6x9 with an helix-like line crossing all the z-planes,
+ * a branch, and some random noise voxels.
+ */
+struct RawGraphSlabBuilderFixture : public ::testing::Test {
+    const size_t nx = 7;
+    const size_t ny = 6;
+    const size_t nz = 9;
+    std::vector<unsigned char> volume;
+    size_t index(size_t x, size_t y, size_t z) const {
+        return x + nx * (y + ny * z);
+    }
+    void SetUp() override {
+        volume.assign(nx * ny * nz, 0);
+        const std::array<std::array<size_t, 2>, 4> xy_turn = {
+                {{{2, 2}}, {{3, 2}}, {{3, 3}}, {{2, 3}}}};
+        for (size_t z = 0; z < nz; ++z) {
+            volume[index(xy_turn[z % 4][0], xy_turn[z % 4][1], z)] = 1;
+        }
+        // Branch in plane z = 4
+        volume[index(4, 2, 4)] = 1;
+        volume[index(5, 1, 4)] = 1;
+        volume[index(6, 0, 4)] = 255;
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<size_t> dis(0, nx * ny * nz - 1);
+        for (size_t i = 0; i < 20; ++i) {
+            volume[dis(gen)] = 1;
+        }
+    }
+
+    SG::GraphType build(const size_t slab_thickness) const {
+        SG::RawGraphSlabBuilder builder(nx, ny);
+        for (size_t z = 0; z < nz; z += slab_thickness) {
+            const auto planes = std::min(slab_thickness, nz - z);
+            builder.add_slab(volume.data() + index(0, 0, z), planes);
+        }
+        EXPECT_EQ(builder.num_planes(), nz);
+        return builder.release_graph();
+    }
+};
+
+TEST_F(RawGraphSlabBuilderFixture, vertices_and_edges_are_26_adjacency) {
+    const auto g = build(nz);
+    const auto nvoxels = static_cast<size_t>(
+            std::count_if(volume.begin(), volume.end(),
+                          [](unsigned char v) { return v != 0; }));
+    EXPECT_EQ(boost::num_vertices(g), nvoxels);
+    // Brute force count of 26-adjacent pairs.
+    size_t nadjacent = 0;
+    std::vector<SG::PointType> foreground;
+    for (size_t z = 0; z < nz; ++z) {
+        for (size_t y = 0; y < ny; ++y) {
+            for (size_t x = 0; x < nx; ++x) {
+                if (volume[index(x, y, z)]) {
+                    foreground.push_back({{static_cast<double>(x),
+                                           static_cast<double>(y),
+                                           static_cast<double>(z)}});
+                }
+            }
+        }
+    }
+    for (size_t i = 0; i < foreground.size(); ++i) {
+        for (size_t j = i + 1; j < foreground.size(); ++j) {
+            bool adjacent = true;
+            for (size_t d = 0; d < 3; ++d) {
+                adjacent &= std::abs(foreground[i][d] - foreground[j][d]) <= 1;
+            }
+            nadjacent += adjacent;
+        }
+    }
+    EXPECT_EQ(boost::num_edges(g), nadjacent);
+    // Vertices in raster order
+    for (size_t v = 0; v < foreground.size(); ++v) {
+        EXPECT_EQ(g[v].pos, foreground[v]);
+    }
+    for (const auto e : boost::make_iterator_range(boost::edges(g))) {
+        const auto &ps = g[boost::source(e, g)].pos;
+        const auto &pt = g[boost::target(e, g)].pos;
+        for (size_t d = 0; d < 3; ++d) {
+            EXPECT_LE(std::abs(ps[d] - pt[d]), 1);
+        }
+    }
+}
+
+TEST_F(RawGraphSlabBuilderFixture, independent_of_slab_thickness) {
+    const auto g_full = build(nz);
+    for (const size_t slab_thickness : {1, 2, 4}) {
+        const auto g = build(slab_thickness);
+        ASSERT_EQ(boost::num_vertices(g), boost::num_vertices(g_full));
+        ASSERT_EQ(boost::num_edges(g), boost::num_edges(g_full));
+        auto ei_full = boost::edges(g_full).first;
+        for (const auto e : boost::make_iterator_range(boost::edges(g))) {
+            EXPECT_EQ(boost::source(e, g), boost::source(*ei_full, g_full));
+            EXPECT_EQ(boost::target(e, g), boost::target(*ei_full, g_full));
+            ++ei_full;
+        }
+    }
+}
+
+TEST_F(RawGraphSlabBuilderFixture, origin_and_reduction) {
+    std::fill(volume.begin(), volume.end(), 0);
+    // A straight line along z crossing every slab
+    for (size_t z = 0; z < nz; ++z) {
+        volume[index(1, 1, z)] = 1;
+    }
+    SG::RawGraphSlabBuilder builder(nx, ny, {{10, 20, 30}});
+    for (size_t z = 0; z < nz; z += 2) {
+        builder.add_slab(volume.data() + index(0, 0, z),
+                         std::min<size_t>(2, nz - z));
+    }
+    const auto raw = builder.release_graph();
+    EXPECT_EQ(boost::num_vertices(raw), nz);
+    EXPECT_EQ(boost::num_edges(raw), nz - 1);
+    const SG::PointType expected_first = {{11, 21, 30}};
+    EXPECT_EQ(raw[0].pos, expected_first);
+    const auto reduced = SG::reduce_spatial_graph_via_dfs(raw);
+    EXPECT_EQ(boost::num_vertices(reduced), 2);
+    EXPECT_EQ(boost::num_edges(reduced), 1);
+}
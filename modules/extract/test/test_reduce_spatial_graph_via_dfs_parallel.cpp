@@ -0,0 +1,159 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "raw_graph_slab_builder.hpp"
+#include "reduce_spatial_graph_via_dfs.hpp"
+#include "remove_extra_edges.hpp"
+#include "gmock/gmock.h"
+
+#include <random>
+#include <tuple>
+
+namespace {
+using EdgeKey = std::tuple<SG::PointType, SG::PointType, SG::PointContainer>;
+/** Edges independent of the order of vertices and orientation. */
+std::vector<EdgeKey> sorted_edges(const SG::GraphType &g) {
+    std::vector<EdgeKey> keys;
+    for (const auto e : boost::make_iterator_range(boost::edges(g))) {
+        const auto &ps = g[boost::source(e, g)].pos;
+        const auto &pt = g[boost::target(e, g)].pos;
+        auto points = g[e].edge_points;
+        std::sort(points.begin(), points.end());
+        keys.emplace_back(std::min(ps, pt), std::max(ps, pt), points);
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+std::vector<SG::PointType> sorted_nodes(const SG::GraphType &g) {
+    std::vector<SG::PointType> nodes;
+    for (const auto v : boost::make_iterator_range(boost::vertices(g))) {
+        nodes.push_back(g[v].pos);
+    }
+    std::sort(nodes.begin(), nodes.end());
+    return nodes;
+}
+
+void expect_equivalent(const SG::GraphType &g, const SG::GraphType &expected) {
+    EXPECT_EQ(boost::num_vertices(g), boost::num_vertices(expected));
+    EXPECT_EQ(boost::num_edges(g), boost::num_edges(expected));
+    EXPECT_EQ(sorted_nodes(g), sorted_nodes(expected));
+    EXPECT_EQ(sorted_edges(g), sorted_edges(expected));
+}
+
+void expect_identical(const SG::GraphType &g, const SG::GraphType &expected) {
+    ASSERT_EQ(boost::num_vertices(g), boost::num_vertices(expected));
+    ASSERT_EQ(boost::num_edges(g), boost::num_edges(expected));
+    for (const auto v : boost::make_iterator_range(boost::vertices(g))) {
+        EXPECT_EQ(g[v].pos, expected[v].pos);
+    }
+    auto ei_expected = boost::edges(expected).first;
+    for (const auto e : boost::make_iterator_range(boost::edges(g))) {
+        EXPECT_EQ(boost::source(e, g), boost::source(*ei_expected, expected));
+        EXPECT_EQ(boost::target(e, g), boost::target(*ei_expected, expected));
+        EXPECT_EQ(g[e].edge_points, expected[*ei_expected].edge_points);
+        ++ei_expected;
+    }
+}
+
+SG::GraphType raw_graph(const std::vector<unsigned char> &volume,
+                        const std::array<size_t, 3> &size) {
+    SG::RawGraphSlabBuilder builder(size[0], size[1]);
+    builder.add_slab(volume.data(), size[2]);
+    auto raw = builder.release_graph();
+    while (SG::remove_extra_edges(raw)) {
+    }
+    return raw;
+}
+} // namespace
+
+struct ReduceParallelFixture : public ::testing::Test {
+    const std::array<size_t, 3> size = {{32, 30, 28}};
+    std::vector<unsigned char> volume;
+    size_t index(size_t x, size_t y, size_t z) const {
+        return x + size[0] * (y + size[1] * z);
+    }
+    /** Short random walks, creating many components. */
+    void SetUp() override {
+        volume.assign(size[0] * size[1] * size[2], 0);
+        std::mt19937 gen(7);
+        std::uniform_int_distribution<int> step(-1, 1);
+        std::array<std::uniform_int_distribution<long>, 3> start_dis = {
+                {std::uniform_int_distribution<long>(0, size[0] - 1),
+                 std::uniform_int_distribution<long>(0, size[1] - 1),
+                 std::uniform_int_distribution<long>(0, size[2] - 1)}};
+        for (size_t walk = 0; walk < 60; ++walk) {
+            std::array<long, 3> p;
+            for (size_t d = 0; d < 3; ++d) {
+                p[d] = start_dis[d](gen);
+            }
+            for (size_t i = 0; i < 15; ++i) {
+                for (size_t d = 0; d < 3; ++d) {
+                    p[d] = std::min(std::max(p[d] + step(gen), 0L),
+                                    static_cast<long>(size[d]) - 1);
+                }
+                volume[index(p[0], p[1], p[2])] = 1;
+            }
+        }
+    }
+};
+
+TEST_F(ReduceParallelFixture, components_equal_to_serial) {
+    const auto raw = raw_graph(volume, size);
+    const auto expected = SG::reduce_spatial_graph_via_dfs(raw);
+    const auto g = SG::reduce_spatial_graph_via_dfs_parallel(raw, 4, 100);
+    expect_equivalent(g, expected);
+}
+
+TEST_F(ReduceParallelFixture, independent_of_num_threads) {
+    const auto raw = raw_graph(volume, size);
+    const auto g_one_thread =
+            SG::reduce_spatial_graph_via_dfs_parallel(raw, 1, 100);
+    for (const size_t num_threads : {2, 3, 8}) {
+        const auto g =
+                SG::reduce_spatial_graph_via_dfs_parallel(raw, num_threads, 100);
+        expect_identical(g, g_one_thread);
+    }
+}
+
+TEST_F(ReduceParallelFixture, large_component_split_in_junctions) {
+    std::fill(volume.begin(), volume.end(), 0);
+    // Lattice of lines parallel to the axes: one component with
+    // many junctions and loops between them.
+    for (size_t a = 3; a < 28; a += 6) {
+        for (size_t b = 3; b < 28; b += 6) {
+            for (size_t i = 0; i < 28; ++i) {
+                volume[index(i, a, b)] = 1;
+                volume[index(a, i, b)] = 1;
+                volume[index(a, b, i)] = 1;
+            }
+        }
+    }
+    const auto raw = raw_graph(volume, size);
+    const auto expected = SG::reduce_spatial_graph_via_dfs(raw);
+    const auto g_one_thread =
+            SG::reduce_spatial_graph_via_dfs_parallel(raw, 1, 200);
+    const auto g = SG::reduce_spatial_graph_via_dfs_parallel(raw, 4, 200);
+    expect_equivalent(g, expected);
+    expect_identical(g, g_one_thread);
+    // Single work item
+    expect_equivalent(SG::reduce_spatial_graph_via_dfs_parallel(raw, 4),
+                      expected);
+}
@@ -0,0 +1,316 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "raw_graph_slab_builder.hpp"
+#include "reduce_spatial_graph_via_dfs.hpp"
+#include "reduced_graph_from_thin_volume.hpp"
+#include "reduced_graph_slab_builder.hpp"
+#include "remove_extra_edges.hpp"
+#include "gmock/gmock.h"
+
+#include <random>
+#include <tuple>
+
+namespace {
+using Size = std::array<size_t, 3>;
+
+SG::GraphType reduced_graph_via_raw_graph(const std::vector<unsigned char> &volume,
+                                          const Size &size,
+                                          const bool removeExtraEdges) {
+    SG::RawGraphSlabBuilder builder(size[0], size[1]);
+    builder.add_slab(volume.data(), size[2]);
+    auto raw = builder.release_graph();
+    if (removeExtraEdges) {
+        while (SG::remove_extra_edges(raw)) {
+        }
+    }
+    return SG::reduce_spatial_graph_via_dfs(raw);
+}
+
+SG::GraphType reduced_graph_by_slabs(const std::vector<unsigned char> &volume,
+                                     const Size &size,
+                                     const size_t slab_thickness,
+                                     const bool removeExtraEdges = true) {
+    SG::ReducedGraphSlabBuilder builder(size[0], size[1], {{0, 0, 0}},
+                                        removeExtraEdges);
+    const auto plane_size = size[0] * size[1];
+    for (size_t z = 0; z < size[2]; z += slab_thickness) {
+        builder.add_slab(volume.data() + z * plane_size,
+                         std::min(slab_thickness, size[2] - z));
+    }
+    return builder.release_graph();
+}
+
+using EdgeKey = std::tuple<SG::PointType, SG::PointType, SG::PointContainer>;
+/**
+ * Edges between nodes that are not degree 2 (created by split_loop),
+ * independent of the order of vertices and the orientation of edges.
+ */
+std::vector<EdgeKey> sorted_edges(const SG::GraphType &g) {
+    std::vector<EdgeKey> keys;
+    for (const auto e : boost::make_iterator_range(boost::edges(g))) {
+        const auto s = boost::source(e, g);
+        const auto t = boost::target(e, g);
+        if (boost::out_degree(s, g) == 2 || boost::out_degree(t, g) == 2) {
+            continue;
+        }
+        auto points = g[e].edge_points;
+        std::sort(points.begin(), points.end());
+        keys.emplace_back(std::min(g[s].pos, g[t].pos),
+                          std::max(g[s].pos, g[t].pos), points);
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+std::vector<SG::PointType> sorted_nodes(const SG::GraphType &g) {
+    std::vector<SG::PointType> nodes;
+    for (const auto v : boost::make_iterator_range(boost::vertices(g))) {
+        if (boost::out_degree(v, g) != 2) {
+            nodes.push_back(g[v].pos);
+        }
+    }
+    std::sort(nodes.begin(), nodes.end());
+    return nodes;
+}
+
+size_t num_points(const SG::GraphType &g) {
+    size_t points = boost::num_vertices(g);
+    for (const auto e : boost::make_iterator_range(boost::edges(g))) {
+        points += g[e].edge_points.size();
+    }
+    return points;
+}
+
+void expect_equivalent(const SG::GraphType &g, const SG::GraphType &expected) {
+    EXPECT_EQ(boost::num_vertices(g), boost::num_vertices(expected));
+    EXPECT_EQ(boost::num_edges(g), boost::num_edges(expected));
+    EXPECT_EQ(num_points(g), num_points(expected));
+    EXPECT_EQ(sorted_nodes(g), sorted_nodes(expected));
+    EXPECT_EQ(sorted_edges(g), sorted_edges(expected));
+}
+} // namespace
+
+struct ReducedGraphFromThinVolumeFixture : public ::testing::Test {
+    const Size size = {{20, 18, 16}};
+    std::vector<unsigned char> volume;
+    size_t index(size_t x, size_t y, size_t z) const {
+        return x + size[0] * (y + size[1] * z);
+    }
+    void SetUp() override {
+        volume.assign(size[0] * size[1] * size[2], 0);
+        // Random walks with 26-connected steps, creating branches,
+        // loops and clusters of voxels.
+        std::mt19937 gen(29);
+        std::uniform_int_distribution<int> step(-1, 1);
+        for (size_t walk = 0; walk < 6; ++walk) {
+            std::array<long, 3> p = {{static_cast<long>(size[0] / 2),
+                                      static_cast<long>(size[1] / 2),
+                                      static_cast<long>(size[2] / 2)}};
+            for (size_t i = 0; i < 40; ++i) {
+                for (size_t d = 0; d < 3; ++d) {
+                    p[d] = std::min(std::max(p[d] + step(gen), 0L),
+                                    static_cast<long>(size[d]) - 1);
+                }
+                volume[index(p[0], p[1], p[2])] = 1;
+            }
+        }
+        // A square loop isolated from the walks
+        volume[index(0, 0, 0)] = 1;
+        volume[index(1, 0, 0)] = 1;
+        volume[index(1, 1, 0)] = 1;
+        volume[index(0, 1, 0)] = 1;
+    }
+};
+
+TEST_F(ReducedGraphFromThinVolumeFixture, equivalent_to_reduce_raw_graph) {
+    for (const bool removeExtraEdges : {true, false}) {
+        const auto g = SG::reduced_graph_from_thin_volume(
+                volume.data(), size, {{0, 0, 0}}, removeExtraEdges);
+        const auto expected =
+                reduced_graph_via_raw_graph(volume, size, removeExtraEdges);
+        expect_equivalent(g, expected);
+    }
+}
+
+TEST_F(ReducedGraphFromThinVolumeFixture, cross_and_origin) {
+    std::fill(volume.begin(), volume.end(), 0);
+    // Cross in the plane z = 3, with center (5, 5, 3)
+    for (size_t i = 2; i <= 8; ++i) {
+        volume[index(i, 5, 3)] = 1;
+        volume[index(5, i, 3)] = 1;
+    }
+    const auto g = SG::reduced_graph_from_thin_volume(volume.data(), size,
+                                                      {{10, 20, 30}});
+    EXPECT_EQ(boost::num_vertices(g), 5);
+    EXPECT_EQ(boost::num_edges(g), 4);
+    size_t num_ends = 0;
+    for (const auto v : boost::make_iterator_range(boost::vertices(g))) {
+        const auto degree = boost::out_degree(v, g);
+        if (degree == 4) {
+            const SG::PointType expected_center = {{15, 25, 33}};
+            EXPECT_EQ(g[v].pos, expected_center);
+        } else {
+            EXPECT_EQ(degree, 1);
+            ++num_ends;
+        }
+    }
+    EXPECT_EQ(num_ends, 4);
+    for (const auto e : boost::make_iterator_range(boost::edges(g))) {
+        EXPECT_EQ(g[e].edge_points.size(), 2);
+    }
+}
+
+TEST_F(ReducedGraphFromThinVolumeFixture, loop_at_junction_is_split_once) {
+    std::fill(volume.begin(), volume.end(), 0);
+    // Loop of three voxels attached to the junction (4, 4, 5),
+    // and an end (5, 5, 5).
+    volume[index(3, 3, 4)] = 1;
+    volume[index(2, 4, 4)] = 1;
+    volume[index(3, 5, 4)] = 1;
+    volume[index(4, 4, 5)] = 1;
+    volume[index(5, 5, 5)] = 1;
+    const auto g = SG::reduced_graph_from_thin_volume(volume.data(), size);
+    // junction, end, and the node created by split_loop at (2, 4, 4)
+    EXPECT_EQ(boost::num_vertices(g), 3);
+    EXPECT_EQ(boost::num_edges(g), 3);
+    EXPECT_EQ(num_points(g), 5);
+    const SG::PointType expected_split = {{2, 4, 4}};
+    size_t num_split_nodes = 0;
+    for (const auto v : boost::make_iterator_range(boost::vertices(g))) {
+        if (boost::out_degree(v, g) == 2) {
+            EXPECT_EQ(g[v].pos, expected_split);
+            ++num_split_nodes;
+        }
+    }
+    EXPECT_EQ(num_split_nodes, 1);
+}
+
+TEST_F(ReducedGraphFromThinVolumeFixture, isolated_loop_of_three_voxels) {
+    std::fill(volume.begin(), volume.end(), 0);
+    volume[index(4, 4, 4)] = 1;
+    volume[index(5, 4, 4)] = 1;
+    volume[index(4, 5, 4)] = 1;
+    const auto g = SG::reduced_graph_from_thin_volume(volume.data(), size);
+    // The first voxel of the loop, and the node created by split_loop, with
+    // two parallel edges between them.
+    EXPECT_EQ(boost::num_vertices(g), 2);
+    EXPECT_EQ(boost::num_edges(g), 2);
+    EXPECT_EQ(num_points(g), 3);
+    for (const auto v : boost::make_iterator_range(boost::vertices(g))) {
+        EXPECT_EQ(boost::out_degree(v, g), 2);
+    }
+}
+
+TEST_F(ReducedGraphFromThinVolumeFixture,
+       slab_builder_equivalent_to_reduce_raw_graph) {
+    for (const bool removeExtraEdges : {true, false}) {
+        const auto expected =
+                reduced_graph_via_raw_graph(volume, size, removeExtraEdges);
+        for (const size_t slab_thickness : {1, 3, 16}) {
+            const auto g = reduced_graph_by_slabs(volume, size, slab_thickness,
+                                                  removeExtraEdges);
+            expect_equivalent(g, expected);
+        }
+    }
+}
+
+TEST_F(ReducedGraphFromThinVolumeFixture,
+       slab_builder_equivalent_to_thin_volume_with_dense_walks) {
+    for (const unsigned int seed : {1u, 2u, 3u}) {
+        std::fill(volume.begin(), volume.end(), 0);
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<long> start(0, 15);
+        std::uniform_int_distribution<int> step(-1, 1);
+        for (size_t walk = 0; walk < 12; ++walk) {
+            std::array<long, 3> p = {{start(gen), start(gen), start(gen)}};
+            for (size_t i = 0; i < 60; ++i) {
+                for (size_t d = 0; d < 3; ++d) {
+                    p[d] = std::min(std::max(p[d] + step(gen), 0L),
+                                    static_cast<long>(size[d]) - 1);
+                }
+                volume[index(p[0], p[1], p[2])] = 1;
+            }
+        }
+        for (const bool removeExtraEdges : {true, false}) {
+            const auto expected = SG::reduced_graph_from_thin_volume(
+                    volume.data(), size, {{0, 0, 0}}, removeExtraEdges);
+            expect_equivalent(
+                    reduced_graph_by_slabs(volume, size, 2, removeExtraEdges),
+                    expected);
+        }
+    }
+}
+
+TEST_F(ReducedGraphFromThinVolumeFixture, slab_builder_keeps_only_the_halo) {
+    std::fill(volume.begin(), volume.end(), 0);
+    // A line along z crossing every plane
+    for (size_t z = 0; z < size[2]; ++z) {
+        volume[index(3, 4, z)] = 1;
+    }
+    SG::ReducedGraphSlabBuilder builder(size[0], size[1], {{10, 20, 30}});
+    const auto half = size[2] / 2;
+    builder.add_slab(volume.data(), half);
+    // Only the end node at z = 0, the chain voxels are in an open chain.
+    EXPECT_EQ(boost::num_vertices(builder.graph()), 1);
+    EXPECT_EQ(boost::num_edges(builder.graph()), 0);
+    EXPECT_EQ(builder.num_open_chains(), 1);
+    builder.add_slab(volume.data() + index(0, 0, half), size[2] - half);
+    const auto g = builder.release_graph();
+    EXPECT_EQ(boost::num_vertices(g), 2);
+    ASSERT_EQ(boost::num_edges(g), 1);
+    const auto e = *boost::edges(g).first;
+    EXPECT_EQ(g[e].edge_points.size(), size[2] - 2);
+    const SG::PointType expected_first = {{13, 24, 30}};
+    EXPECT_EQ(g[0].pos, expected_first);
+}
+
+TEST_F(ReducedGraphFromThinVolumeFixture, slab_builder_loops_across_slabs) {
+    std::fill(volume.begin(), volume.end(), 0);
+    // Isolated square loop in the plane y = 2, from z = 2 to z = 6
+    for (size_t i = 2; i <= 6; ++i) {
+        volume[index(i, 2, 2)] = 1;
+        volume[index(i, 2, 6)] = 1;
+        volume[index(2, 2, i)] = 1;
+        volume[index(6, 2, i)] = 1;
+    }
+    // Loop attached to a junction, from z = 8 to z = 12, with a tail
+    for (size_t i = 8; i <= 12; ++i) {
+        volume[index(10, 10, i)] = 1;
+        volume[index(14, 10, i)] = 1;
+    }
+    for (size_t i = 11; i <= 13; ++i) {
+        volume[index(i, 10, 8)] = 1;
+        volume[index(i, 10, 12)] = 1;
+    }
+    volume[index(12, 10, 13)] = 1;
+    volume[index(12, 10, 14)] = 1;
+    const auto expected =
+            SG::reduced_graph_from_thin_volume(volume.data(), size);
+    for (const size_t slab_thickness : {1, 2, 5}) {
+        const auto g = reduced_graph_by_slabs(volume, size, slab_thickness);
+        expect_equivalent(g, expected);
+        // Each loop is split once: the isolated loop has two nodes and two
+        // edges. The other loop has the junction, the end of the tail and
+        // the node of the split.
+        EXPECT_EQ(boost::num_vertices(g), 5);
+        EXPECT_EQ(boost::num_edges(g), 5);
+    }
+}
@@ -0,0 +1,105 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+/**
+ * Time to update the cramer_von_mises_test of an histogram after moving one
+ * count between two random bins: recomputing it with
+ * cramer_von_mises_test_optimized (O(bins)), compared with
+ * cramer_von_mises_incremental (O(log bins)).
+ *
+ * Usage: bench_cramer_von_mises_incremental [num_bins] [num_updates]
+ */
+
+#include "cramer_von_mises_incremental.hpp"
+#include "cramer_von_mises_test.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+template <typename TFunction>
+double time_seconds(TFunction &&function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t num_bins = argc > 1 ? std::stoul(argv[1]) : 1000;
+    const size_t num_updates = argc > 2 ? std::stoul(argv[2]) : 100000;
+    const size_t counts_per_bin = 100;
+    const size_t total_counts = num_bins * counts_per_bin;
+    std::vector<size_t> counts(num_bins, counts_per_bin);
+    // Target: uniform distribution.
+    std::vector<double> F_optimized(num_bins);
+    for (size_t i = 0; i < num_bins; ++i) {
+        F_optimized[i] = total_counts * (i + 0.5) / num_bins + 0.5;
+    }
+    std::cout << "Bins: " << num_bins << ", counts: " << total_counts
+              << ", updates: " << num_updates << std::endl;
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<size_t> bin_dis(0, num_bins - 1);
+    std::vector<std::pair<size_t, size_t>> moves(num_updates);
+    for (auto &move : moves) {
+        move = {bin_dis(gen), bin_dis(gen)};
+    }
+
+    auto counts_full = counts;
+    double checksum_full = 0.0;
+    const auto t_full = time_seconds([&]() {
+        for (const auto &[old_bin, new_bin] : moves) {
+            if (counts_full[old_bin] == 0) {
+                continue;
+            }
+            counts_full[old_bin]--;
+            counts_full[new_bin]++;
+            checksum_full += SG::cramer_von_mises_test_optimized(
+                    counts_full, F_optimized, total_counts);
+        }
+    });
+    std::cout << "cramer_von_mises_test_optimized: " << t_full / num_updates
+              << " s/update, checksum: " << checksum_full << std::endl;
+
+    SG::cramer_von_mises_incremental tracker(counts, F_optimized,
+                                             total_counts);
+    double checksum_incremental = 0.0;
+    const auto t_incremental = time_seconds([&]() {
+        for (const auto &[old_bin, new_bin] : moves) {
+            if (counts[old_bin] == 0) {
+                continue;
+            }
+            counts[old_bin]--;
+            tracker.add(old_bin, -1);
+            counts[new_bin]++;
+            tracker.add(new_bin, 1);
+            checksum_incremental += tracker.value();
+        }
+    });
+    std::cout << "cramer_von_mises_incremental: "
+              << t_incremental / num_updates
+              << " s/update, checksum: " << checksum_incremental << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,101 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+/**
+ * Parallel tempering with num_replicas of simulated_annealing_generator,
+ * in one thread and in all the cores, compared with a single
+ * simulated_annealing_generator::engine performing the steps of one replica
+ * (same time with num_replicas cores) and the total number of steps
+ * (same time with one core). Reports time and lowest energy.
+ *
+ * Usage: bench_parallel_tempering [num_vertices] [num_replicas]
+ *                                 [steps_per_replica]
+ */
+
+#include "parallel_tempering.hpp"
+#include "rng.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+template <typename TFunction>
+double time_seconds(TFunction &&function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+SG::simulated_annealing_generator_config_tree
+make_tree(const size_t num_vertices) {
+    SG::simulated_annealing_generator_config_tree tree;
+    tree.physical_scaling_params.num_vertices = num_vertices;
+    tree.ete_distance_params.num_bins = 100;
+    tree.cosine_params.num_bins = 100;
+    return tree;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t num_vertices = argc > 1 ? std::stoul(argv[1]) : 1000;
+    const size_t num_replicas = argc > 2 ? std::stoul(argv[2]) : 4;
+    const size_t steps_per_replica = argc > 3 ? std::stoul(argv[3]) : 100000;
+    const size_t steps_per_exchange = 1000;
+    const auto tree = make_tree(num_vertices);
+    std::cout << "Vertices: " << num_vertices
+              << ", replicas: " << num_replicas
+              << ", steps per replica: " << steps_per_replica
+              << ", cores: " << std::thread::hardware_concurrency()
+              << std::endl;
+
+    for (const size_t num_threads : {size_t(1), size_t(0)}) {
+        RNG::engine().seed(42);
+        SG::parallel_tempering_parameters parameters;
+        parameters.num_replicas = num_replicas;
+        parameters.steps_per_exchange = steps_per_exchange;
+        parameters.num_exchanges = steps_per_replica / steps_per_exchange;
+        parameters.num_threads = num_threads;
+        SG::parallel_tempering pt(tree, parameters);
+        const auto t_pt = time_seconds([&]() { pt.engine(); });
+        std::cout << "parallel_tempering, num_threads " << num_threads << ": "
+                  << t_pt << " s, best energy: " << pt.best_energy()
+                  << std::endl;
+    }
+
+    for (const size_t num_steps :
+         {steps_per_replica, num_replicas * steps_per_replica}) {
+        RNG::engine().seed(42);
+        SG::simulated_annealing_generator sa(tree);
+        sa.transition_params.MAX_ENGINE_ITERATIONS = num_steps;
+        sa.transition_params.MAX_CONSECUTIVE_FAILURES = num_steps;
+        std::cout.setstate(std::ios::failbit); // Silence progress of engine.
+        const auto t_sa = time_seconds([&]() { sa.engine(); });
+        std::cout.clear();
+        std::cout << "simulated_annealing_generator, " << num_steps
+                  << " steps: " << t_sa
+                  << " s, energy: " << sa.transition_params.energy
+                  << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
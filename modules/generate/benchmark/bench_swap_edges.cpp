@@ -0,0 +1,113 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+/**
+ * Time of update_step_swap_edges::select_two_valid_edges, selecting the edges
+ * with random_access_edges (O(1)), compared with iterating over the edges
+ * of the graph (select_random_edge, O(E)), for a random graph with
+ * num_vertices and average degree 3.
+ * Then, time of swap edges steps (randomize, perform and update_graph).
+ *
+ * Usage: bench_swap_edges [num_vertices] [num_selections]
+ */
+
+#include "rng.hpp"
+#include "update_step_swap_edges.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+template <typename TFunction>
+double time_seconds(TFunction &&function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+SG::GraphType random_graph(const size_t num_vertices) {
+    SG::GraphType graph(num_vertices);
+    for (size_t i = 0; i < num_vertices; ++i) {
+        graph[i].pos = RNG::random_pos({{1.0, 1.0, 1.0}});
+    }
+    const int max_vertex = static_cast<int>(num_vertices - 1);
+    for (size_t i = 0; i < 3 * num_vertices / 2; ++i) {
+        const auto source = RNG::rand_range_int(0, max_vertex);
+        const auto target = RNG::rand_range_int(0, max_vertex);
+        if (source != target) {
+            boost::add_edge(source, target, graph);
+        }
+    }
+    return graph;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const size_t num_vertices = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const size_t num_selections = argc > 2 ? std::stoul(argv[2]) : 1000;
+    RNG::engine().seed(42);
+    auto graph = random_graph(num_vertices);
+    std::cout << "Vertices: " << num_vertices
+              << ", edges: " << boost::num_edges(graph)
+              << ", selections: " << num_selections << std::endl;
+    SG::Histogram histo_distances(
+            SG::get_all_end_to_end_distances_of_edges(
+                    graph, ArrayUtilities::boundary_condition::PERIODIC),
+            histo::GenerateBreaksFromRangeAndBins(0.0, 1.0, 100));
+    SG::Histogram histo_cosines(
+            SG::get_all_cosine_directors_between_connected_edges(
+                    graph, ArrayUtilities::boundary_condition::PERIODIC),
+            histo::GenerateBreaksFromRangeAndBins(-1.0001, 1.0001, 100));
+    SG::update_step_swap_edges step(graph, histo_distances, histo_cosines);
+
+    size_t checksum = 0;
+    const auto t_index = time_seconds([&]() {
+        for (size_t i = 0; i < num_selections; ++i) {
+            checksum += step.select_two_valid_edges(graph).first.m_source;
+        }
+    });
+    std::cout << "random_access_edges: " << t_index / num_selections
+              << " s/selection" << std::endl;
+
+    // A copy of the graph is not indexed, select_random_edge is used.
+    const auto graph_copy = graph;
+    const auto t_iterate = time_seconds([&]() {
+        for (size_t i = 0; i < num_selections; ++i) {
+            checksum += step.select_two_valid_edges(graph_copy).first.m_source;
+        }
+    });
+    std::cout << "select_random_edge: " << t_iterate / num_selections
+              << " s/selection" << std::endl;
+
+    const auto t_steps = time_seconds([&]() {
+        for (size_t i = 0; i < num_selections; ++i) {
+            step.randomize();
+            step.perform();
+            step.update_graph();
+        }
+    });
+    std::cout << "swap edges step (random_access_edges): "
+              << t_steps / num_selections << " s/step, checksum: " << checksum
+              << std::endl;
+    return EXIT_SUCCESS;
+}
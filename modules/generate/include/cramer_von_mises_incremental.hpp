@@ -0,0 +1,154 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef SG_CRAMER_VON_MISES_INCREMENTAL_HPP
+#define SG_CRAMER_VON_MISES_INCREMENTAL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SG {
+
+/**
+ * Fenwick (binary indexed) tree: point update and prefix sum in O(log n).
+ *
+ * @tparam T value type, integer or floating point.
+ */
+template <typename T> class fenwick_tree {
+  public:
+    fenwick_tree() = default;
+    explicit fenwick_tree(const size_t &n) : tree_(n + 1, T(0)) {}
+    /** Build the tree from values in O(n). */
+    explicit fenwick_tree(const std::vector<T> &values)
+            : tree_(values.size() + 1, T(0)) {
+        for (size_t i = 1; i < tree_.size(); ++i) {
+            tree_[i] += values[i - 1];
+            const size_t parent = i + (i & (~i + 1));
+            if (parent < tree_.size()) {
+                tree_[parent] += tree_[i];
+            }
+        }
+    }
+    inline size_t size() const { return tree_.empty() ? 0 : tree_.size() - 1; }
+    /** Add delta to the value at index. */
+    inline void add(size_t index, const T &delta) {
+        for (++index; index < tree_.size(); index += index & (~index + 1)) {
+            tree_[index] += delta;
+        }
+    }
+    /** Sum of the values in [0, end). */
+    inline T prefix_sum(size_t end) const {
+        T sum(0);
+        for (; end > 0; end -= end & (~end + 1)) {
+            sum += tree_[end];
+        }
+        return sum;
+    }
+
+  private:
+    std::vector<T> tree_;
+};
+
+/**
+ * Cramer-von Mises statistic of an histogram, updated in O(log B) when the
+ * count of a bin changes, instead of the O(B) of
+ * @ref cramer_von_mises_test_optimized, B being the number of bins.
+ *
+ * The statistic is 1/(12 N) + 1/N^2 * sum_i T_i, with
+ * T_i = m_i * ((m_i + 1)(6 s_i + 2 m_i + 1) / 6 + s_i^2),
+ * s_i = M_i - F_optimized_i, m_i the counts and M_i the exclusive cumulative
+ * counts. A change of m_k by d changes T_k, and shifts s_i by d for all
+ * i > k. The change of the sum of T over that suffix is
+ * d * sum m_i (m_i + 1) + 2 d * sum m_i s_i + d^2 * sum m_i,
+ * where sum m_i s_i = sum m_i M_i - sum m_i F_optimized_i is computed from
+ * the suffix sums of m_i, m_i^2 and m_i F_optimized_i, stored in Fenwick
+ * trees.
+ *
+ * It also keeps the weighted sum of the bin centers, to get histo::Mean in
+ * O(1).
+ *
+ * The total counts N is the one used to compute F_optimized, it is assumed
+ * constant (counts are moved between bins), as in
+ * simulated_annealing_generator.
+ */
+class cramer_von_mises_incremental {
+  public:
+    cramer_von_mises_incremental() = default;
+    /** @sa reset */
+    cramer_von_mises_incremental(const std::vector<size_t> &histo_counts,
+                                 const std::vector<double> &F_optimized,
+                                 const size_t &total_counts,
+                                 const std::vector<double> &bin_centers = {});
+
+    /**
+     * Initialize from the current histogram counts. O(B).
+     *
+     * @param histo_counts
+     * @param F_optimized target_cumulative_distro_at_histogram_bin_centers *
+     * total_counts - 0.5 (or the LUT of simulated_annealing_generator)
+     * @param total_counts
+     * @param bin_centers optional, required for @ref mean.
+     */
+    void reset(const std::vector<size_t> &histo_counts,
+               const std::vector<double> &F_optimized,
+               const size_t &total_counts,
+               const std::vector<double> &bin_centers = {});
+    void clear();
+
+    /** Update the statistic after the count of bin changed by delta. */
+    void add(const size_t &bin, const int64_t &delta);
+
+    /**
+     * Equal to cramer_von_mises_test_optimized of the current counts.
+     * If any count is negative, it returns infinity, the unsigned counts of
+     * the histogram would underflow and give a huge value in
+     * cramer_von_mises_test_optimized.
+     */
+    double value() const;
+    /** Equal to histo::Mean of the current counts. */
+    double mean() const;
+
+    inline size_t bins() const { return counts_.size(); }
+    inline bool empty() const { return counts_.empty(); }
+    inline const std::vector<int64_t> &counts() const { return counts_; }
+
+  private:
+    static double compute_T(const double &m, const double &s);
+
+    std::vector<int64_t> counts_;
+    std::vector<double> F_optimized_;
+    std::vector<double> bin_centers_;
+    size_t total_counts_ = 0;
+    int64_t sum_counts_ = 0;
+    size_t negative_bins_ = 0;
+    int64_t sum_counts_squared_ = 0;
+    double sum_counts_F_ = 0.0;
+    /// Sum of T_i, without the 1/N^2 factor.
+    double sum_T_ = 0.0;
+    /// Sum of counts * bin_centers.
+    double sum_weighted_centers_ = 0.0;
+    fenwick_tree<int64_t> counts_tree_;
+    fenwick_tree<int64_t> counts_squared_tree_;
+    fenwick_tree<double> counts_F_tree_;
+};
+
+} // namespace SG
+#endif
@@ -38,6 +38,15 @@ using Histogram = histo::Histo<double, size_t>;
  */
 GraphType::vertex_descriptor select_random_node(const GraphType &graph);
 
+/**
+ * Select a random edge from the input graph.
+ * It iterates over the edges, O(E). Use random_access_edges to select edges
+ * repeatedly.
+ *
+ * @param graph
+ *
+ * @return the edge descriptor
+ */
 GraphType::edge_descriptor select_random_edge(const GraphType &graph);
 
 /**
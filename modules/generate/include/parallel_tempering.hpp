@@ -0,0 +1,180 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef SG_PARALLEL_TEMPERING_HPP
+#define SG_PARALLEL_TEMPERING_HPP
+
+#include "simulated_annealing_generator.hpp"
+
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace SG {
+
+class ThreadPool;
+
+struct parallel_tempering_parameters {
+    /** Temperatures of the replicas. If empty, a geometric ladder of
+     * num_replicas temperatures from temp_max to temp_max * temp_min_ratio
+     * is used. */
+    std::vector<double> temperatures;
+    /** Number of replicas if temperatures is empty.
+     * 0 uses std::thread::hardware_concurrency, with a minimum of 2. */
+    size_t num_replicas = 0;
+    /** Highest temperature of the ladder. 0 uses the initial temperature of
+     * simulated_annealing_generator::engine for the first replica:
+     * energy_initial / num_vertices. */
+    double temp_max = 0.0;
+    double temp_min_ratio = 1.0e-3;
+    /** Steps of each replica between exchanges. */
+    size_t steps_per_exchange = 1000;
+    /** Maximum number of exchange rounds. The simulation also stops when a
+     * replica reaches its transition_params.ENERGY_CONVERGENCE. */
+    size_t num_exchanges = 100;
+    /** Threads running the replicas. 0 uses all the cores. */
+    size_t num_threads = 0;
+    inline void print(std::ostream &os, int spaces = 35) const {
+        os << "%/************PARALLEL TEMPERING PARAMETERS*****************/"
+           << '\n'
+           << std::left << std::setw(spaces)
+           << "num_replicas= " << num_replicas << '\n'
+           << std::left << std::setw(spaces) << "temp_max= " << temp_max
+           << '\n'
+           << std::left << std::setw(spaces)
+           << "temp_min_ratio= " << temp_min_ratio << '\n'
+           << std::left << std::setw(spaces)
+           << "steps_per_exchange= " << steps_per_exchange << '\n'
+           << std::left << std::setw(spaces)
+           << "num_exchanges= " << num_exchanges << '\n'
+           << std::left << std::setw(spaces) << "num_threads= " << num_threads
+           << std::endl;
+    }
+};
+
+/**
+ * Parallel tempering (replica exchange) of simulated_annealing_generator.
+ *
+ * Each replica is a Markov chain at a fixed temperature of the ladder
+ * (temp_cooling_rate = 1.0), run with engine_steps for steps_per_exchange
+ * steps, in parallel. After each round, replicas at adjacent temperatures
+ * (even pairs and odd pairs in alternate rounds) exchange their
+ * configurations with probability
+ * min(1, exp((1/T_k - 1/T_k+1) * (E_k - E_k+1))).
+ * Instead of copying the graphs, the replicas exchange their temperatures.
+ *
+ * Each replica has its own random engine, swapped with RNG::engine() of the
+ * thread running it, so the result does not depend on num_threads. The
+ * engines are seeded from RNG::engine() at construction.
+ */
+class parallel_tempering {
+  public:
+    using replica_factory_t =
+            std::function<std::unique_ptr<simulated_annealing_generator>()>;
+    /**
+     * Replicas constructed from the tree, each with its own random initial
+     * graph.
+     */
+    parallel_tempering(const simulated_annealing_generator_config_tree &tree,
+                       const parallel_tempering_parameters &parameters =
+                               parallel_tempering_parameters());
+    /**
+     * Replicas constructed with make_replica, called with the random engine
+     * of each replica.
+     */
+    parallel_tempering(const replica_factory_t &make_replica,
+                       const parallel_tempering_parameters &parameters =
+                               parallel_tempering_parameters());
+
+    /**
+     * Run num_exchanges rounds, or until a replica converges.
+     * It can be called again to continue the simulation.
+     *
+     * @return the graph with the lowest energy found.
+     */
+    const GraphType &engine();
+
+    inline size_t num_replicas() const { return replicas_.size(); }
+    inline const std::vector<double> &temperatures() const {
+        return temperatures_;
+    }
+    inline simulated_annealing_generator &replica(const size_t &index) {
+        return *replicas_[index];
+    }
+    /** Replica currently at temperatures()[temperature_index]. */
+    simulated_annealing_generator &
+    replica_at_temperature(const size_t &temperature_index);
+    /** Temperature index of each replica. */
+    inline const std::vector<size_t> &temperature_of_replica() const {
+        return temperature_of_replica_;
+    }
+
+    inline const GraphType &best_graph() const { return best_graph_; }
+    inline double best_energy() const { return best_energy_; }
+    inline size_t exchanges_performed() const { return exchanges_performed_; }
+
+    /** Accepted over proposed steps of each replica. */
+    std::vector<double> acceptance_rates() const;
+    /** Accepted over proposed steps at each temperature. */
+    std::vector<double> acceptance_rates_per_temperature() const;
+    /** Accepted over proposed exchanges of each replica. */
+    std::vector<double> swap_rates() const;
+    /** Accepted over proposed exchanges between temperatures k and k+1. */
+    std::vector<double> swap_rates_per_temperature() const;
+
+    void print(std::ostream &os, int spaces = 35) const;
+
+    parallel_tempering_parameters parameters;
+
+  private:
+    void init(const replica_factory_t &make_replica);
+    void init_temperatures();
+    void run_replicas(ThreadPool &pool);
+    void exchange_replicas();
+    void update_best_graph();
+
+    std::vector<std::unique_ptr<simulated_annealing_generator>> replicas_;
+    std::vector<std::mt19937> replica_engines_;
+    /// Random engine of the exchanges.
+    std::mt19937 exchange_engine_;
+    std::vector<double> temperatures_;
+    std::vector<size_t> temperature_of_replica_;
+    std::vector<size_t> replica_at_temperature_;
+    GraphType best_graph_;
+    double best_energy_ = std::numeric_limits<double>::infinity();
+    size_t exchanges_performed_ = 0;
+
+    // Statistics
+    std::vector<size_t> proposed_steps_;
+    std::vector<size_t> accepted_steps_;
+    std::vector<size_t> proposed_steps_per_temperature_;
+    std::vector<size_t> accepted_steps_per_temperature_;
+    std::vector<size_t> proposed_swaps_;
+    std::vector<size_t> accepted_swaps_;
+    std::vector<size_t> proposed_swaps_per_temperature_;
+    std::vector<size_t> accepted_swaps_per_temperature_;
+};
+
+} // namespace SG
+#endif
@@ -0,0 +1,82 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#ifndef SG_RANDOM_ACCESS_EDGES_HPP
+#define SG_RANDOM_ACCESS_EDGES_HPP
+
+#include "spatial_graph.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace SG {
+
+/**
+ * Dense vector with the edge descriptors of a graph, to select a random edge
+ * in O(1), instead of iterating over boost::edges.
+ *
+ * Each edge stores its position in the vector (keyed by the edge property),
+ * so @ref add and @ref remove are O(1): the removed edge is replaced by the
+ * last one. The order of the edges is not preserved.
+ *
+ * The index has to be updated with every edge added or removed from the
+ * graph, or rebuilt with @ref build.
+ * Valid for graphs with stable edge descriptors (GraphType, listS edges).
+ */
+class random_access_edges {
+  public:
+    using edge_descriptor = GraphType::edge_descriptor;
+
+    random_access_edges() = default;
+    explicit random_access_edges(const GraphType &graph);
+
+    /** Clear the index and add all the edges of graph. */
+    void build(const GraphType &graph);
+    void clear();
+    /** Add an edge, for example the one returned by boost::add_edge. */
+    void add(const edge_descriptor &edge);
+    /** Remove an edge, it throws if the edge is not in the index. */
+    void remove(const edge_descriptor &edge);
+    bool contains(const edge_descriptor &edge) const;
+
+    inline size_t size() const { return edges_.size(); }
+    inline bool empty() const { return edges_.empty(); }
+    inline const edge_descriptor &operator[](const size_t index) const {
+        return edges_[index];
+    }
+    inline const std::vector<edge_descriptor> &edges() const {
+        return edges_;
+    }
+
+    /**
+     * Select a random edge, using RNG::rand_range_int.
+     *
+     * @return the edge descriptor
+     */
+    edge_descriptor select_random_edge() const;
+
+  private:
+    std::vector<edge_descriptor> edges_;
+    /// Position of each edge in edges_, keyed by the edge property.
+    std::unordered_map<const void *, size_t> positions_;
+};
+
+} // namespace SG
+#endif
@@ -2,6 +2,7 @@
 #define SIMULATEDANNEALING_HPP
 
 #include "boundary_conditions.hpp" // for boundary_condition
+#include "cramer_von_mises_incremental.hpp"
 #include "generate_common.hpp"     // for Histogram
 #include "simulated_annealing_generator_config_tree.hpp"
 #include "simulated_annealing_generator_parameters.hpp"
@@ -69,6 +70,12 @@ class simulated_annealing_generator {
     update_step_move_node step_move_node_;
     update_step_swap_edges step_swap_edges_;
     bool verbose = false;
+    /**
+     * Update the cramer_von_mises_test and the mean of the histograms in
+     * O(log bins) with every step of engine, instead of recomputing them in
+     * O(bins) in compute_energy.
+     */
+    bool use_incremental_energy = true;
 
     /**
      * Create a random graph from a degree distribution (@sa
@@ -198,6 +205,16 @@ class simulated_annealing_generator {
      * distributions.
      */
     void engine(const bool &reset_steps = false);
+    /**
+     * Continue the simulation for num_steps, at the current temperature
+     * (transition_params.temp_current), unlike engine() that resets it.
+     * The other stop criteria of engine() apply.
+     * Used by parallel_tempering, set temp_cooling_rate to 1.0 to keep a
+     * constant temperature.
+     *
+     * @param num_steps maximum number of steps to perform.
+     */
+    void engine_steps(const size_t &num_steps);
     simulated_annealing_generator::transition check_transition();
     void set_boundary_condition(const ArrayUtilities::boundary_condition &bc);
     void print(std::ostream &os, int spaces = 35) const;
@@ -220,6 +237,18 @@ class simulated_annealing_generator {
     std::vector<double> LUT_cumulative_histo_cosines_;
     size_t total_counts_ete_distances_ = 0;
     size_t total_counts_cosines_ = 0;
+    /** Used by the energy functions while engine is running, and
+     * use_incremental_energy is true. Updated by the update_steps. */
+    cramer_von_mises_incremental tracker_ete_distances_;
+    cramer_von_mises_incremental tracker_cosines_;
+    bool incremental_energy_active_ = false;
+    /** Reset the trackers with the current histograms and attach them to
+     * the update_steps. */
+    void start_incremental_energy();
+    void stop_incremental_energy();
+    /** Steps of engine until steps_performed is max_steps, or any other stop
+     * criteria is met. */
+    void engine_loop(const size_t &max_steps, const bool &show_progress);
 };
 } // namespace SG
 #endif
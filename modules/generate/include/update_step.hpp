@@ -7,6 +7,8 @@
 
 namespace SG {
 
+class cramer_von_mises_incremental;
+
 /**
  * Abstract class performing single changes in the graph.
  * For example, moving a node, or swapping two edges.
@@ -53,6 +55,8 @@ class update_step_with_distance_and_cosine_histograms : public update_step {
 
     /**
      * Remove old distances and add new from histogram.
+     * If histo_distances is histo_distances_, the tracker_distances_ is also
+     * updated.
      *
      * @param histo_distances
      * @param old_distances
@@ -65,6 +69,8 @@ class update_step_with_distance_and_cosine_histograms : public update_step {
 
     /**
      * Remove old cosines and add new ones from histogram.
+     * If histo_cosines is histo_cosines_, the tracker_cosines_ is also
+     * updated.
      *
      * @param histo_cosines
      * @param old_cosines
@@ -77,6 +83,13 @@ class update_step_with_distance_and_cosine_histograms : public update_step {
     GraphType *graph_;
     Histogram *histo_distances_;
     Histogram *histo_cosines_;
+    /**
+     * Optional trackers of the cramer_von_mises_test of histo_distances_ and
+     * histo_cosines_, updated with every change of their counts.
+     * Not owned, set by simulated_annealing_generator::engine.
+     */
+    cramer_von_mises_incremental *tracker_distances_ = nullptr;
+    cramer_von_mises_incremental *tracker_cosines_ = nullptr;
 
     /**
      * Flag indicating that a random node or edge has been selected. perform()
@@ -2,6 +2,7 @@
 #define UPDATE_STEP_SWAP_EDGES_HPP
 
 #include "generate_common.hpp" // for Histogram
+#include "random_access_edges.hpp"
 #include "update_step.hpp"
 #include <utility> // for std::pair
 
@@ -17,7 +18,8 @@ class update_step_swap_edges
                            Histogram &histo_distances_input,
                            Histogram &histo_cosines_input)
             : parent_class(
-                      graph_input, histo_distances_input, histo_cosines_input) {
+                      graph_input, histo_distances_input, histo_cosines_input),
+              edges_index_(graph_input) {
         this->clear_selected_edges(selected_edges_, new_edges_);
     }
 
@@ -84,7 +86,16 @@ class update_step_swap_edges
             throw std::logic_error("update_graph() has to be called after "
                                    "perform(), not before.");
         }
-        this->update_graph(*graph_, selected_edges_, is_swap_parallel_);
+        const bool edges_index_is_valid =
+                this->edges_index_is_valid(*graph_);
+        const auto added_edges = this->update_graph(*graph_, selected_edges_,
+                                                    is_swap_parallel_);
+        if (edges_index_is_valid) {
+            edges_index_.remove(selected_edges_.first);
+            edges_index_.remove(selected_edges_.second);
+            edges_index_.add(added_edges.first);
+            edges_index_.add(added_edges.second);
+        }
     };
     /**
      * Update Graph, given the selected edges and if the swap is parallel. If
@@ -93,14 +104,30 @@ class update_step_swap_edges
      * @param graph
      * @param selected_edges
      * @param is_swap_parallel
+     *
+     * @return the edges added to the graph
      */
-    void update_graph(GraphType &graph,
-                      const edge_descriptor_pair &selected_edges,
-                      const bool &is_swap_parallel) const;
+    edge_descriptor_pair update_graph(GraphType &graph,
+                                      const edge_descriptor_pair &selected_edges,
+                                      const bool &is_swap_parallel) const;
 
     edge_descriptor_pair selected_edges_;
     edge_descriptor_pair new_edges_;
     bool is_swap_parallel_;
+    /**
+     * Edges of graph_ for O(1) random selection, updated in update_graph().
+     * Call reset_edges_index() if graph_ is modified by other means.
+     */
+    random_access_edges edges_index_;
+    inline void reset_edges_index() { edges_index_.build(*graph_); }
+    /**
+     * True if edges_index_ can be used to select edges of graph: graph is
+     * graph_ and the number of edges is the same.
+     */
+    inline bool edges_index_is_valid(const GraphType &graph) const {
+        return &graph == graph_ &&
+               edges_index_.size() == boost::num_edges(graph);
+    }
 
   public:
     /**
@@ -109,6 +136,9 @@ class update_step_swap_edges
      * It might throw if the edges of the graph are not swapable.
      * For example if all of them are adjacent.
      *
+     * The edges are selected in O(1) from edges_index_ if
+     * edges_index_is_valid(graph), otherwise iterating over the edges.
+     *
      * @param graph
      * @param recursive_count
      *
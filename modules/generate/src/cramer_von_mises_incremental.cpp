@@ -0,0 +1,175 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "cramer_von_mises_incremental.hpp"
+#include "cramer_von_mises_test.hpp" // for detail::one_over_six
+
+#include <cassert>
+#include <limits>
+#include <stdexcept>
+
+namespace SG {
+
+cramer_von_mises_incremental::cramer_von_mises_incremental(
+        const std::vector<size_t> &histo_counts,
+        const std::vector<double> &F_optimized,
+        const size_t &total_counts,
+        const std::vector<double> &bin_centers) {
+    this->reset(histo_counts, F_optimized, total_counts, bin_centers);
+}
+
+double cramer_von_mises_incremental::compute_T(const double &m,
+                                               const double &s) {
+    return m * (detail::one_over_six * (m + 1) * (6 * s + 2 * m + 1) + s * s);
+}
+
+void cramer_von_mises_incremental::reset(
+        const std::vector<size_t> &histo_counts,
+        const std::vector<double> &F_optimized,
+        const size_t &total_counts,
+        const std::vector<double> &bin_centers) {
+    const auto num_bins = histo_counts.size();
+    if (F_optimized.size() != num_bins) {
+        throw std::runtime_error(
+                "cramer_von_mises_incremental: F_optimized and histo_counts "
+                "have different sizes.");
+    }
+    if (!bin_centers.empty() && bin_centers.size() != num_bins) {
+        throw std::runtime_error(
+                "cramer_von_mises_incremental: bin_centers and histo_counts "
+                "have different sizes.");
+    }
+    if (total_counts == 0) {
+        throw std::runtime_error(
+                "cramer_von_mises_incremental: total_counts is zero.");
+    }
+    counts_.assign(histo_counts.begin(), histo_counts.end());
+    F_optimized_ = F_optimized;
+    bin_centers_ = bin_centers;
+    total_counts_ = total_counts;
+
+    std::vector<int64_t> counts_squared(num_bins);
+    std::vector<double> counts_F(num_bins);
+    sum_counts_ = 0;
+    negative_bins_ = 0;
+    sum_counts_squared_ = 0;
+    sum_counts_F_ = 0.0;
+    sum_T_ = 0.0;
+    sum_weighted_centers_ = 0.0;
+    for (size_t i = 0; i < num_bins; ++i) {
+        const auto m = counts_[i];
+        if (m < 0) {
+            ++negative_bins_;
+        }
+        counts_squared[i] = m * m;
+        counts_F[i] = m * F_optimized_[i];
+        // sum_counts_ is the exclusive cumulative count of bin i.
+        sum_T_ += compute_T(m, sum_counts_ - F_optimized_[i]);
+        sum_counts_ += m;
+        sum_counts_squared_ += counts_squared[i];
+        sum_counts_F_ += counts_F[i];
+        if (!bin_centers_.empty()) {
+            sum_weighted_centers_ += m * bin_centers_[i];
+        }
+    }
+    counts_tree_ = fenwick_tree<int64_t>(counts_);
+    counts_squared_tree_ = fenwick_tree<int64_t>(counts_squared);
+    counts_F_tree_ = fenwick_tree<double>(counts_F);
+}
+
+void cramer_von_mises_incremental::clear() {
+    *this = cramer_von_mises_incremental();
+}
+
+void cramer_von_mises_incremental::add(const size_t &bin,
+                                       const int64_t &delta) {
+    assert(bin < counts_.size());
+    if (delta == 0) {
+        return;
+    }
+    const int64_t m = counts_[bin];
+    const int64_t m_new = m + delta;
+    const double d = static_cast<double>(delta);
+
+    // Bin k: s_k does not depend on m_k (exclusive cumulative counts).
+    const int64_t cumulative_exclusive = counts_tree_.prefix_sum(bin);
+    const double s = cumulative_exclusive - F_optimized_[bin];
+    sum_T_ += compute_T(m_new, s) - compute_T(m, s);
+
+    // Suffix i > k: s_i is shifted by delta.
+    const int64_t cumulative_inclusive = cumulative_exclusive + m;
+    const int64_t suffix_counts = sum_counts_ - cumulative_inclusive;
+    if (suffix_counts != 0) {
+        const int64_t suffix_counts_squared =
+                sum_counts_squared_ -
+                counts_squared_tree_.prefix_sum(bin + 1);
+        const double suffix_counts_F =
+                sum_counts_F_ - counts_F_tree_.prefix_sum(bin + 1);
+        // sum m_i M_i over the suffix, with
+        // M_i = cumulative_inclusive + sum_{k < j < i} m_j
+        const int64_t suffix_counts_cumulative =
+                cumulative_inclusive * suffix_counts +
+                (suffix_counts * suffix_counts - suffix_counts_squared) / 2;
+        const double suffix_counts_s =
+                suffix_counts_cumulative - suffix_counts_F;
+        sum_T_ += d * (suffix_counts_squared + suffix_counts) +
+                  2 * d * suffix_counts_s + d * d * suffix_counts;
+    }
+
+    const int64_t delta_squared = m_new * m_new - m * m;
+    const double delta_F = d * F_optimized_[bin];
+    if (m < 0 && m_new >= 0) {
+        --negative_bins_;
+    } else if (m >= 0 && m_new < 0) {
+        ++negative_bins_;
+    }
+    counts_[bin] = m_new;
+    counts_tree_.add(bin, delta);
+    counts_squared_tree_.add(bin, delta_squared);
+    counts_F_tree_.add(bin, delta_F);
+    sum_counts_ += delta;
+    sum_counts_squared_ += delta_squared;
+    sum_counts_F_ += delta_F;
+    if (!bin_centers_.empty()) {
+        sum_weighted_centers_ += d * bin_centers_[bin];
+    }
+}
+
+double cramer_von_mises_incremental::value() const {
+    if (total_counts_ == 0) {
+        throw std::runtime_error(
+                "cramer_von_mises_incremental is not initialized.");
+    }
+    if (negative_bins_ > 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return 1.0 / (12 * total_counts_) +
+           sum_T_ / static_cast<double>(total_counts_ * total_counts_);
+}
+
+double cramer_von_mises_incremental::mean() const {
+    if (bin_centers_.empty()) {
+        throw std::runtime_error("cramer_von_mises_incremental::mean requires "
+                                 "the bin_centers in reset.");
+    }
+    return sum_weighted_centers_ / counts_.size();
+}
+
+} // namespace SG
@@ -0,0 +1,310 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "parallel_tempering.hpp"
+#include "parallel_tasks.hpp"
+#include "rng.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace SG {
+namespace {
+/** Swap RNG::engine() of this thread with engine, during the scope. */
+class scoped_rng_engine {
+  public:
+    explicit scoped_rng_engine(std::mt19937 &engine) : engine_(engine) {
+        std::swap(RNG::engine(), engine_);
+    }
+    ~scoped_rng_engine() { std::swap(RNG::engine(), engine_); }
+    scoped_rng_engine(const scoped_rng_engine &) = delete;
+    scoped_rng_engine &operator=(const scoped_rng_engine &) = delete;
+
+  private:
+    std::mt19937 &engine_;
+};
+
+double rate(const size_t &accepted, const size_t &proposed) {
+    return proposed == 0 ? 0.0 : static_cast<double>(accepted) / proposed;
+}
+} // namespace
+
+parallel_tempering::parallel_tempering(
+        const simulated_annealing_generator_config_tree &tree,
+        const parallel_tempering_parameters &input_parameters)
+        : parameters(input_parameters) {
+    this->init([&tree]() {
+        return std::make_unique<simulated_annealing_generator>(tree);
+    });
+}
+
+parallel_tempering::parallel_tempering(
+        const replica_factory_t &make_replica,
+        const parallel_tempering_parameters &input_parameters)
+        : parameters(input_parameters) {
+    this->init(make_replica);
+}
+
+void parallel_tempering::init(const replica_factory_t &make_replica) {
+    size_t num_replicas = parameters.temperatures.size();
+    if (num_replicas == 0) {
+        num_replicas = parameters.num_replicas;
+        if (num_replicas == 0) {
+            num_replicas = std::max(2u, std::thread::hardware_concurrency());
+        }
+    }
+    if (num_replicas < 2) {
+        throw std::runtime_error(
+                "parallel_tempering requires at least two replicas.");
+    }
+    auto &engine = RNG::engine();
+    exchange_engine_.seed(engine());
+    replicas_.reserve(num_replicas);
+    replica_engines_.reserve(num_replicas);
+    for (size_t i = 0; i < num_replicas; ++i) {
+        std::seed_seq seed{engine(), engine()};
+        replica_engines_.emplace_back(seed);
+        scoped_rng_engine replica_engine(replica_engines_.back());
+        replicas_.push_back(make_replica());
+        if (!replicas_.back()) {
+            throw std::runtime_error(
+                    "parallel_tempering: make_replica returned a null replica.");
+        }
+    }
+    init_temperatures();
+
+    proposed_steps_.assign(num_replicas, 0);
+    accepted_steps_.assign(num_replicas, 0);
+    proposed_steps_per_temperature_.assign(num_replicas, 0);
+    accepted_steps_per_temperature_.assign(num_replicas, 0);
+    proposed_swaps_.assign(num_replicas, 0);
+    accepted_swaps_.assign(num_replicas, 0);
+    proposed_swaps_per_temperature_.assign(num_replicas - 1, 0);
+    accepted_swaps_per_temperature_.assign(num_replicas - 1, 0);
+    update_best_graph();
+}
+
+void parallel_tempering::init_temperatures() {
+    const auto num_replicas = replicas_.size();
+    temperatures_ = parameters.temperatures;
+    if (temperatures_.empty()) {
+        double temp_max = parameters.temp_max;
+        if (temp_max <= 0.0) {
+            const auto &first = *replicas_.front();
+            temp_max = first.compute_energy() /
+                       boost::num_vertices(first.graph_);
+        }
+        const double temp_min = temp_max * parameters.temp_min_ratio;
+        if (!(temp_min > 0.0) || !(temp_max >= temp_min)) {
+            throw std::runtime_error(
+                    "parallel_tempering: invalid temperature ladder, "
+                    "temp_max: " + std::to_string(temp_max) +
+                    ", temp_min_ratio: " +
+                    std::to_string(parameters.temp_min_ratio));
+        }
+        temperatures_.resize(num_replicas);
+        for (size_t k = 0; k < num_replicas; ++k) {
+            temperatures_[k] =
+                    temp_min * std::pow(temp_max / temp_min,
+                                        static_cast<double>(k) /
+                                                (num_replicas - 1));
+        }
+    }
+    std::sort(temperatures_.begin(), temperatures_.end());
+    if (!(temperatures_.front() > 0.0)) {
+        throw std::runtime_error(
+                "parallel_tempering: temperatures must be positive.");
+    }
+    temperature_of_replica_.resize(num_replicas);
+    replica_at_temperature_.resize(num_replicas);
+    for (size_t i = 0; i < num_replicas; ++i) {
+        temperature_of_replica_[i] = i;
+        replica_at_temperature_[i] = i;
+        auto &transition_params = replicas_[i]->transition_params;
+        transition_params.temp_cooling_rate = 1.0;
+        transition_params.temp_initial = temperatures_[i];
+        transition_params.temp_current = temperatures_[i];
+        transition_params.energy_initial = replicas_[i]->compute_energy();
+        transition_params.energy = transition_params.energy_initial;
+    }
+}
+
+simulated_annealing_generator &
+parallel_tempering::replica_at_temperature(const size_t &temperature_index) {
+    return *replicas_[replica_at_temperature_[temperature_index]];
+}
+
+const GraphType &parallel_tempering::engine() {
+    // The threads are reused by all the rounds.
+    ThreadPool pool(std::max<size_t>(
+            1, std::min(resolve_num_threads(parameters.num_threads),
+                        replicas_.size())));
+    for (size_t round = 0; round < parameters.num_exchanges; ++round) {
+        run_replicas(pool);
+        update_best_graph();
+        const bool converged = std::any_of(
+                replicas_.cbegin(), replicas_.cend(), [](const auto &replica) {
+                    return replica->transition_params.energy <
+                           replica->transition_params.ENERGY_CONVERGENCE;
+                });
+        if (converged) {
+            break;
+        }
+        exchange_replicas();
+    }
+    return best_graph_;
+}
+
+void parallel_tempering::run_replicas(ThreadPool &pool) {
+    const auto steps_per_exchange = parameters.steps_per_exchange;
+    pool.run(replicas_.size(),
+             [this, steps_per_exchange](const size_t i) {
+                 scoped_rng_engine replica_engine(replica_engines_[i]);
+                 auto &transition_params = replicas_[i]->transition_params;
+                 const auto steps_before = transition_params.steps_performed;
+                 const auto accepted_before =
+                         transition_params.accepted_transitions;
+                 // The chain continues, the stop criteria applies to each
+                 // round.
+                 transition_params.consecutive_failures = 0;
+                 replicas_[i]->engine_steps(steps_per_exchange);
+                 const auto proposed =
+                         transition_params.steps_performed - steps_before;
+                 const auto accepted = transition_params.accepted_transitions -
+                                       accepted_before;
+                 // Each replica is in a different temperature, no races.
+                 const auto k = temperature_of_replica_[i];
+                 proposed_steps_[i] += proposed;
+                 accepted_steps_[i] += accepted;
+                 proposed_steps_per_temperature_[k] += proposed;
+                 accepted_steps_per_temperature_[k] += accepted;
+             });
+}
+
+void parallel_tempering::exchange_replicas() {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    // Even pairs (0-1, 2-3...) and odd pairs (1-2, 3-4...) alternate.
+    for (size_t k = exchanges_performed_ % 2; k + 1 < replicas_.size();
+         k += 2) {
+        const auto a = replica_at_temperature_[k];
+        const auto b = replica_at_temperature_[k + 1];
+        const double energy_a = replicas_[a]->transition_params.energy;
+        const double energy_b = replicas_[b]->transition_params.energy;
+        const double exponent =
+                (1.0 / temperatures_[k] - 1.0 / temperatures_[k + 1]) *
+                (energy_a - energy_b);
+        ++proposed_swaps_per_temperature_[k];
+        ++proposed_swaps_[a];
+        ++proposed_swaps_[b];
+        if (exponent >= 0.0 || uniform(exchange_engine_) < std::exp(exponent)) {
+            ++accepted_swaps_per_temperature_[k];
+            ++accepted_swaps_[a];
+            ++accepted_swaps_[b];
+            std::swap(replica_at_temperature_[k],
+                      replica_at_temperature_[k + 1]);
+            temperature_of_replica_[a] = k + 1;
+            temperature_of_replica_[b] = k;
+            replicas_[a]->transition_params.temp_current = temperatures_[k + 1];
+            replicas_[b]->transition_params.temp_current = temperatures_[k];
+        }
+    }
+    ++exchanges_performed_;
+}
+
+void parallel_tempering::update_best_graph() {
+    for (const auto &replica : replicas_) {
+        if (replica->transition_params.energy < best_energy_) {
+            best_energy_ = replica->transition_params.energy;
+            best_graph_ = replica->graph_;
+        }
+    }
+}
+
+std::vector<double> parallel_tempering::acceptance_rates() const {
+    std::vector<double> rates(replicas_.size());
+    for (size_t i = 0; i < rates.size(); ++i) {
+        rates[i] = rate(accepted_steps_[i], proposed_steps_[i]);
+    }
+    return rates;
+}
+
+std::vector<double>
+parallel_tempering::acceptance_rates_per_temperature() const {
+    std::vector<double> rates(replicas_.size());
+    for (size_t k = 0; k < rates.size(); ++k) {
+        rates[k] = rate(accepted_steps_per_temperature_[k],
+                        proposed_steps_per_temperature_[k]);
+    }
+    return rates;
+}
+
+std::vector<double> parallel_tempering::swap_rates() const {
+    std::vector<double> rates(replicas_.size());
+    for (size_t i = 0; i < rates.size(); ++i) {
+        rates[i] = rate(accepted_swaps_[i], proposed_swaps_[i]);
+    }
+    return rates;
+}
+
+std::vector<double> parallel_tempering::swap_rates_per_temperature() const {
+    std::vector<double> rates(accepted_swaps_per_temperature_.size());
+    for (size_t k = 0; k < rates.size(); ++k) {
+        rates[k] = rate(accepted_swaps_per_temperature_[k],
+                        proposed_swaps_per_temperature_[k]);
+    }
+    return rates;
+}
+
+void parallel_tempering::print(std::ostream &os, int spaces) const {
+    parameters.print(os, spaces);
+    os << std::left << std::setw(spaces)
+       << "exchanges_performed= " << exchanges_performed_ << '\n'
+       << std::left << std::setw(spaces) << "best_energy= " << best_energy_
+       << '\n';
+    const auto acceptance = acceptance_rates_per_temperature();
+    const auto swaps = swap_rates_per_temperature();
+    os << "% temperature, replica, energy, acceptance_rate, "
+          "swap_rate_with_next_temperature"
+       << '\n';
+    for (size_t k = 0; k < temperatures_.size(); ++k) {
+        const auto replica = replica_at_temperature_[k];
+        os << temperatures_[k] << ", " << replica << ", "
+           << replicas_[replica]->transition_params.energy << ", "
+           << acceptance[k] << ", ";
+        if (k < swaps.size()) {
+            os << swaps[k];
+        } else {
+            os << "-";
+        }
+        os << '\n';
+    }
+    os << "% replica, acceptance_rate, swap_rate" << '\n';
+    const auto replica_acceptance = acceptance_rates();
+    const auto replica_swaps = swap_rates();
+    for (size_t i = 0; i < replicas_.size(); ++i) {
+        os << i << ", " << replica_acceptance[i] << ", " << replica_swaps[i]
+           << '\n';
+    }
+    os << std::flush;
+}
+
+} // namespace SG
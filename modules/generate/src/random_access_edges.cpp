@@ -0,0 +1,83 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "random_access_edges.hpp"
+#include "rng.hpp"
+
+#include <cassert>
+#include <stdexcept>
+
+namespace SG {
+
+random_access_edges::random_access_edges(const GraphType &graph) {
+    this->build(graph);
+}
+
+void random_access_edges::build(const GraphType &graph) {
+    this->clear();
+    const auto num_edges = boost::num_edges(graph);
+    edges_.reserve(num_edges);
+    positions_.reserve(num_edges);
+    for (auto [ei, ei_end] = boost::edges(graph); ei != ei_end; ++ei) {
+        this->add(*ei);
+    }
+}
+
+void random_access_edges::clear() {
+    edges_.clear();
+    positions_.clear();
+}
+
+void random_access_edges::add(const edge_descriptor &edge) {
+    const auto inserted = positions_.emplace(edge.get_property(), edges_.size());
+    if (!inserted.second) {
+        throw std::logic_error(
+                "random_access_edges::add: the edge is already in the index.");
+    }
+    edges_.push_back(edge);
+}
+
+void random_access_edges::remove(const edge_descriptor &edge) {
+    const auto found = positions_.find(edge.get_property());
+    if (found == positions_.end()) {
+        throw std::logic_error(
+                "random_access_edges::remove: the edge is not in the index.");
+    }
+    const auto position = found->second;
+    positions_.erase(found);
+    // Move the last edge to the position of the removed one.
+    if (position + 1 != edges_.size()) {
+        edges_[position] = edges_.back();
+        positions_[edges_[position].get_property()] = position;
+    }
+    edges_.pop_back();
+}
+
+bool random_access_edges::contains(const edge_descriptor &edge) const {
+    return positions_.count(edge.get_property()) > 0;
+}
+
+random_access_edges::edge_descriptor
+random_access_edges::select_random_edge() const {
+    assert(!edges_.empty());
+    return edges_[RNG::rand_range_int(0, static_cast<int>(edges_.size() - 1))];
+}
+
+} // namespace SG
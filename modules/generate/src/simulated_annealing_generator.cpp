@@ -140,6 +140,7 @@ void simulated_annealing_generator::init_graph_degree(
     assert(boost::num_vertices(graph_) == std::size(degree_sequence));
     assert(boost::num_edges(graph_) > 0);
     assert(boost::num_edges(graph_) <= sum);
+    step_swap_edges_.reset_edges_index();
 }
 void simulated_annealing_generator::init_graph_vertex_positions() {
 
@@ -268,14 +269,11 @@ void simulated_annealing_generator::engine(const bool &reset_steps) {
     const auto t_start = std::chrono::high_resolution_clock::now();
     auto & steps = transition_params.steps_performed;
     if(reset_steps) { steps = 0; }
-    /****** For reporting progress **********/
-    const double log_size =
-            std::log10(transition_params.MAX_ENGINE_ITERATIONS) - 2;
-    const size_t report_every = log_size > 0 ?
-        static_cast<size_t>(std::pow(10, log_size)) :
-        1;
-    size_t progress_count = 0;
-    /****/
+    // graph_ might have been modified since the construction.
+    step_swap_edges_.reset_edges_index();
+    if (use_incremental_energy) {
+        start_incremental_energy();
+    }
     const double energy_initial = compute_energy();
     transition_params.energy_initial = energy_initial;
     transition_params.energy = energy_initial;
@@ -285,14 +283,47 @@ void simulated_annealing_generator::engine(const bool &reset_steps) {
     // const double energy_diff = energy_new - transition_params.energy;
     // transition_params.temp_initial = std::abs(energy_diff /
     // log(0.5));
+    engine_loop(transition_params.MAX_ENGINE_ITERATIONS, true);
+    stop_incremental_energy();
+
+    const auto t_final = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = t_final - t_start;
+    transition_params.time_elapsed = elapsed.count();
+}
+
+void simulated_annealing_generator::engine_steps(const size_t &num_steps) {
+    const auto t_start = std::chrono::high_resolution_clock::now();
+    step_swap_edges_.reset_edges_index();
+    if (use_incremental_energy) {
+        start_incremental_energy();
+    }
+    transition_params.energy = compute_energy();
+    engine_loop(transition_params.steps_performed + num_steps, false);
+    stop_incremental_energy();
+
+    const auto t_final = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = t_final - t_start;
+    transition_params.time_elapsed = elapsed.count();
+}
+
+void simulated_annealing_generator::engine_loop(const size_t &max_steps,
+                                                const bool &show_progress) {
+    auto & steps = transition_params.steps_performed;
+    /****** For reporting progress **********/
+    const double log_size =
+            std::log10(transition_params.MAX_ENGINE_ITERATIONS) - 2;
+    const size_t report_every = log_size > 0 ?
+        static_cast<size_t>(std::pow(10, log_size)) :
+        1;
+    size_t progress_count = 0;
+    /****/
     while (transition_params.consecutive_failures !=
                    transition_params.MAX_CONSECUTIVE_FAILURES &&
-           steps != transition_params.MAX_ENGINE_ITERATIONS &&
+           steps != max_steps &&
            transition_params.energy >= transition_params.ENERGY_CONVERGENCE) {
         if (verbose) {
             std::cout << "Step #: " << steps << std::endl;
         }
-        const bool show_progress = true;
         if (show_progress) {
             if (progress_count == report_every) {
                 progress_count = 0;
@@ -334,15 +365,37 @@ void simulated_annealing_generator::engine(const bool &reset_steps) {
         }
         steps++;
     }
+}
 
-    const auto t_final = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double> elapsed = t_final - t_start;
-    transition_params.time_elapsed = elapsed.count();
-} // namespace SG
+void simulated_annealing_generator::start_incremental_energy() {
+    tracker_ete_distances_.reset(histo_ete_distances_.counts,
+                                 LUT_cumulative_histo_ete_distances_,
+                                 total_counts_ete_distances_,
+                                 histo_ete_distances_.ComputeBinCenters());
+    tracker_cosines_.reset(histo_cosines_.counts, LUT_cumulative_histo_cosines_,
+                           total_counts_cosines_);
+    step_move_node_.tracker_distances_ = &tracker_ete_distances_;
+    step_move_node_.tracker_cosines_ = &tracker_cosines_;
+    step_swap_edges_.tracker_distances_ = &tracker_ete_distances_;
+    step_swap_edges_.tracker_cosines_ = &tracker_cosines_;
+    incremental_energy_active_ = true;
+}
+
+void simulated_annealing_generator::stop_incremental_energy() {
+    incremental_energy_active_ = false;
+    step_move_node_.tracker_distances_ = nullptr;
+    step_move_node_.tracker_cosines_ = nullptr;
+    step_swap_edges_.tracker_distances_ = nullptr;
+    step_swap_edges_.tracker_cosines_ = nullptr;
+}
 
 double simulated_annealing_generator::energy_ete_distances() const {
     // return cramer_von_mises_test(histo_ete_distances_.counts,
     //                              target_cumulative_distro_histo_ete_distances_);
+    if (incremental_energy_active_) {
+        return energy_ete_distances_extra_penalty() +
+               tracker_ete_distances_.value();
+    }
     return energy_ete_distances_extra_penalty() +
            cramer_von_mises_test_optimized(histo_ete_distances_.counts,
                                            LUT_cumulative_histo_ete_distances_,
@@ -351,15 +404,16 @@ double simulated_annealing_generator::energy_ete_distances() const {
 
 double
 simulated_annealing_generator::energy_ete_distances_extra_penalty() const {
-    // TODO: Implement average ete_distances (cheap).
-    // Hint, use the histograms and the distances stores in update_steps
-    // Or accumulate in the histograms
-    // Or, instead of average, any test of the tail of the distro.
+    // The mean is updated in O(1) by tracker_ete_distances_ in engine.
+    // TODO: instead of average, any test of the tail of the distro.
     // Use penalty from Lindstrom et al:
     // "Finite-strain, finite-size mechanics of rigidly cross-linked
     // biopolymer-networks."
+    const double mean = incremental_energy_active_
+                                ? tracker_ete_distances_.mean()
+                                : histo::Mean(histo_ete_distances_);
     const double penalize_long_fibers =
-            std::abs(histo::Mean(histo_ete_distances_) /
+            std::abs(mean /
                              ete_distance_params.normalized_normal_mean -
                      1);
     return penalize_long_fibers;
@@ -370,6 +424,9 @@ double simulated_annealing_generator::energy_cosines() const {
     //                              target_cumulative_distro_histo_cosines_);
     // Correcting term to avoid accumulation in the last bin. The value of
     // target_distribution_cosines_ in the last bin is zero or close by.
+    if (incremental_energy_active_) {
+        return energy_cosines_extra_penalty() + tracker_cosines_.value();
+    }
     return energy_cosines_extra_penalty() +
            cramer_von_mises_test_optimized(histo_cosines_.counts,
                                            LUT_cumulative_histo_cosines_,
@@ -1,4 +1,5 @@
 #include "update_step.hpp"
+#include "cramer_von_mises_incremental.hpp"
 // #include "array_utilities.hpp"
 // #include "boundary_conditions.hpp"
 // #include "generate_common.hpp"
@@ -45,29 +46,46 @@ void update_step_with_distance_and_cosine_histograms::
     //           << std::endl;
     // std::cout << "NEW_DISTANCES_UPDATING_HISTOGRAM: " << new_distances.size()
     //           << std::endl;
+    auto *tracker = &histo_distances == histo_distances_ ? tracker_distances_
+                                                         : nullptr;
     for (const auto &dist : new_distances) {
         const auto bin = histo_distances.IndexFromValue(dist);
         // std::cout << "bin: " << bin << "; new_distance: " << dist <<
         // std::endl;
         histo_distances.counts[bin]++;
+        if (tracker) {
+            tracker->add(bin, 1);
+        }
     }
     for (const auto &dist : old_distances) {
         const auto bin = histo_distances.IndexFromValue(dist);
         // std::cout << "bin: " << bin << "; old_distance: " << dist <<
         // std::endl;
         histo_distances.counts[bin]--;
+        if (tracker) {
+            tracker->add(bin, -1);
+        }
     }
 }
 void update_step_with_distance_and_cosine_histograms::update_cosines_histogram(
         Histogram &histo_cosines,
         const std::vector<double> &old_cosines,
         const std::vector<double> &new_cosines) const {
-
+    auto *tracker =
+            &histo_cosines == histo_cosines_ ? tracker_cosines_ : nullptr;
     for (const auto &cosine : new_cosines) {
-        histo_cosines.counts[histo_cosines.IndexFromValue(cosine)]++;
+        const auto bin = histo_cosines.IndexFromValue(cosine);
+        histo_cosines.counts[bin]++;
+        if (tracker) {
+            tracker->add(bin, 1);
+        }
     }
     for (const auto &cosine : old_cosines) {
-        histo_cosines.counts[histo_cosines.IndexFromValue(cosine)]--;
+        const auto bin = histo_cosines.IndexFromValue(cosine);
+        histo_cosines.counts[bin]--;
+        if (tracker) {
+            tracker->add(bin, -1);
+        }
     }
 }
 void update_step_with_distance_and_cosine_histograms::print(
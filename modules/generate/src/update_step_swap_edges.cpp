@@ -240,7 +240,8 @@ void update_step_swap_edges::undo(
     this->clear_selected_edges(selected_edges, new_edges);
 }
 
-void update_step_swap_edges::update_graph(
+update_step_swap_edges::edge_descriptor_pair
+update_step_swap_edges::update_graph(
         GraphType &graph,
         const edge_descriptor_pair &selected_edges,
         const bool &is_swap_parallel) const {
@@ -259,8 +260,11 @@ void update_step_swap_edges::update_graph(
     boost::remove_edge(edge1, graph);
     boost::remove_edge(edge2, graph);
     // add the new edges
-    boost::add_edge(nedge1_source, nedge1_target, graph);
-    boost::add_edge(nedge2_source, nedge2_target, graph);
+    const auto added_edge1 =
+            boost::add_edge(nedge1_source, nedge1_target, graph).first;
+    const auto added_edge2 =
+            boost::add_edge(nedge2_source, nedge2_target, graph).first;
+    return std::make_pair(added_edge1, added_edge2);
 }
 
 std::pair<update_step_swap_edges::edge_descriptor,
@@ -277,8 +281,13 @@ update_step_swap_edges::select_two_valid_edges(const GraphType &graph,
                                  "small? or over-connected?");
     }
     // select two edges to swap at random
-    edge_descriptor edge1 = select_random_edge(graph);
-    edge_descriptor edge2 = select_random_edge(graph);
+    const bool use_edges_index = this->edges_index_is_valid(graph);
+    const auto select_edge = [&]() {
+        return use_edges_index ? edges_index_.select_random_edge()
+                               : SG::select_random_edge(graph);
+    };
+    edge_descriptor edge1 = select_edge();
+    edge_descriptor edge2 = select_edge();
 
     if (boost::num_edges(graph) <= 1) {
         throw std::logic_error("select_two_valid_edges in "
@@ -287,7 +296,7 @@ update_step_swap_edges::select_two_valid_edges(const GraphType &graph,
                                "one edge");
     }
     while (edge1 == edge2) {
-        edge2 = select_random_edge(graph);
+        edge2 = select_edge();
     }
 
     // Check that edges are not adjacent. Just comparing if any source or
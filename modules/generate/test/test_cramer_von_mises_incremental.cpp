@@ -0,0 +1,115 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "cramer_von_mises_incremental.hpp"
+#include "cramer_von_mises_test.hpp"
+#include "cumulative_distribution_functions.hpp"
+#include "generate_common.hpp" // For Histogram
+#include "gmock/gmock.h"
+
+#include <random>
+
+TEST(FenwickTree, prefix_sum) {
+    const std::vector<int64_t> values = {3, 0, -2, 7, 1, 4, 4, 9, -1};
+    SG::fenwick_tree<int64_t> tree(values);
+    SG::fenwick_tree<int64_t> tree_from_adds(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        tree_from_adds.add(i, values[i]);
+    }
+    EXPECT_EQ(tree.size(), values.size());
+    int64_t expected = 0;
+    for (size_t end = 0; end <= values.size(); ++end) {
+        EXPECT_EQ(tree.prefix_sum(end), expected);
+        EXPECT_EQ(tree_from_adds.prefix_sum(end), expected);
+        if (end < values.size()) {
+            expected += values[end];
+        }
+    }
+    tree.add(3, -7);
+    EXPECT_EQ(tree.prefix_sum(4), 1);
+    EXPECT_EQ(tree.prefix_sum(values.size()), 18);
+}
+
+TEST(CramerVonMisesIncremental, equal_to_cramer_von_mises_test_optimized) {
+    const size_t num_bins = 100;
+    const size_t num_counts = 5000;
+    std::mt19937 gen(11);
+    std::normal_distribution<double> value_dis(0.6, 0.25);
+    std::vector<double> values(num_counts);
+    for (auto &value : values) {
+        value = std::clamp(value_dis(gen), 0.0, 1.4);
+    }
+    SG::Histogram histogram(values, histo::GenerateBreaksFromRangeAndBins(
+                                            0.0, 1.5, num_bins));
+    const auto centers = histogram.ComputeBinCenters();
+    std::vector<double> F_optimized(num_bins);
+    for (size_t i = 0; i < num_bins; ++i) {
+        F_optimized[i] = num_counts * SG::cumulative_distribution_lognormal(
+                                              centers[i], -0.5, 0.4) +
+                         0.5;
+    }
+
+    SG::cramer_von_mises_incremental tracker(histogram.counts, F_optimized,
+                                             num_counts, centers);
+    EXPECT_EQ(tracker.bins(), num_bins);
+    EXPECT_DOUBLE_EQ(tracker.value(),
+                     SG::cramer_von_mises_test_optimized(
+                             histogram.counts, F_optimized, num_counts));
+    EXPECT_DOUBLE_EQ(tracker.mean(), histo::Mean(histogram));
+
+    // Move counts between bins, as the update_steps do.
+    std::uniform_int_distribution<size_t> bin_dis(0, num_bins - 1);
+    for (size_t step = 0; step < 20000; ++step) {
+        const auto old_bin = bin_dis(gen);
+        if (histogram.counts[old_bin] == 0) {
+            continue;
+        }
+        const auto new_bin = bin_dis(gen);
+        histogram.counts[new_bin]++;
+        tracker.add(new_bin, 1);
+        histogram.counts[old_bin]--;
+        tracker.add(old_bin, -1);
+        if (step % 1000 == 0) {
+            const auto expected = SG::cramer_von_mises_test_optimized(
+                    histogram.counts, F_optimized, num_counts);
+            EXPECT_NEAR(tracker.value(), expected, 1e-12 * expected);
+            EXPECT_NEAR(tracker.mean(), histo::Mean(histogram), 1e-12);
+        }
+    }
+    const auto expected = SG::cramer_von_mises_test_optimized(
+            histogram.counts, F_optimized, num_counts);
+    EXPECT_NEAR(tracker.value(), expected, 1e-12 * expected);
+    for (size_t i = 0; i < num_bins; ++i) {
+        EXPECT_EQ(tracker.counts()[i],
+                  static_cast<int64_t>(histogram.counts[i]));
+    }
+}
+
+TEST(CramerVonMisesIncremental, throws) {
+    SG::cramer_von_mises_incremental tracker;
+    EXPECT_TRUE(tracker.empty());
+    EXPECT_THROW(tracker.value(), std::runtime_error);
+    const std::vector<size_t> counts = {1, 2, 3};
+    EXPECT_THROW(tracker.reset(counts, {0.5, 1.0}, 6), std::runtime_error);
+    EXPECT_THROW(tracker.reset(counts, {0.5, 1.0, 2.0}, 0),
+                 std::runtime_error);
+    tracker.reset(counts, {0.5, 1.0, 2.0}, 6);
+    EXPECT_THROW(tracker.mean(), std::runtime_error);
+}
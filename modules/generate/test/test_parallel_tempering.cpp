@@ -0,0 +1,120 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "parallel_tempering.hpp"
+#include "rng.hpp"
+#include "gmock/gmock.h"
+
+namespace {
+SG::parallel_tempering::replica_factory_t make_replica_factory() {
+    return []() {
+        auto replica = std::make_unique<SG::simulated_annealing_generator>(100);
+        replica->transition_params.UPDATE_STEP_MOVE_NODE_PROBABILITY = 0.5;
+        return replica;
+    };
+}
+} // namespace
+
+TEST(ParallelTempering, temperatures_and_rates) {
+    RNG::engine().seed(10);
+    SG::parallel_tempering_parameters parameters;
+    parameters.num_replicas = 4;
+    parameters.temp_max = 1.0;
+    parameters.temp_min_ratio = 1.0e-3;
+    parameters.steps_per_exchange = 50;
+    parameters.num_exchanges = 10;
+    SG::parallel_tempering pt(make_replica_factory(), parameters);
+    ASSERT_EQ(pt.num_replicas(), 4);
+    const auto &temperatures = pt.temperatures();
+    EXPECT_DOUBLE_EQ(temperatures.front(), 1.0e-3);
+    EXPECT_DOUBLE_EQ(temperatures.back(), 1.0);
+    EXPECT_NEAR(temperatures[1] / temperatures[0],
+                temperatures[2] / temperatures[1], 1e-12);
+    for (size_t k = 0; k < pt.num_replicas(); ++k) {
+        EXPECT_EQ(pt.replica_at_temperature(k).transition_params.temp_current,
+                  temperatures[k]);
+        EXPECT_EQ(pt.replica(k).transition_params.temp_cooling_rate, 1.0);
+    }
+
+    const auto &best_graph = pt.engine();
+    EXPECT_EQ(pt.exchanges_performed(), 10);
+    EXPECT_EQ(boost::num_vertices(best_graph), 100);
+    for (size_t i = 0; i < pt.num_replicas(); ++i) {
+        EXPECT_LE(pt.best_energy(), pt.replica(i).transition_params.energy);
+        EXPECT_EQ(pt.replica(i).transition_params.steps_performed, 500);
+        // The temperature follows the exchanges.
+        const auto k = pt.temperature_of_replica()[i];
+        EXPECT_EQ(pt.replica(i).transition_params.temp_current,
+                  temperatures[k]);
+        EXPECT_EQ(&pt.replica_at_temperature(k), &pt.replica(i));
+    }
+    for (const auto &rates :
+         {pt.acceptance_rates(), pt.acceptance_rates_per_temperature(),
+          pt.swap_rates(), pt.swap_rates_per_temperature()}) {
+        for (const auto &rate : rates) {
+            EXPECT_GE(rate, 0.0);
+            EXPECT_LE(rate, 1.0);
+        }
+    }
+    EXPECT_EQ(pt.swap_rates_per_temperature().size(), 3);
+    const auto acceptance = pt.acceptance_rates_per_temperature();
+    // Higher temperatures accept more steps.
+    EXPECT_LT(acceptance.front(), acceptance.back());
+    pt.print(std::cout);
+}
+
+TEST(ParallelTempering, result_does_not_depend_on_num_threads) {
+    auto run = [](const size_t num_threads) {
+        RNG::engine().seed(42);
+        SG::parallel_tempering_parameters parameters;
+        parameters.temperatures = {0.01, 0.1, 0.001};
+        parameters.steps_per_exchange = 30;
+        parameters.num_exchanges = 8;
+        parameters.num_threads = num_threads;
+        auto pt = std::make_unique<SG::parallel_tempering>(
+                make_replica_factory(), parameters);
+        pt->engine();
+        return pt;
+    };
+    const auto serial = run(1);
+    const auto parallel = run(3);
+    EXPECT_THAT(serial->temperatures(),
+                ::testing::ElementsAre(0.001, 0.01, 0.1));
+    EXPECT_EQ(serial->best_energy(), parallel->best_energy());
+    EXPECT_EQ(serial->temperature_of_replica(),
+              parallel->temperature_of_replica());
+    EXPECT_EQ(serial->swap_rates(), parallel->swap_rates());
+    for (size_t i = 0; i < serial->num_replicas(); ++i) {
+        EXPECT_EQ(serial->replica(i).transition_params.energy,
+                  parallel->replica(i).transition_params.energy);
+    }
+}
+
+TEST(ParallelTempering, throws) {
+    SG::parallel_tempering_parameters parameters;
+    parameters.num_replicas = 1;
+    EXPECT_THROW(SG::parallel_tempering(make_replica_factory(), parameters),
+                 std::runtime_error);
+    parameters.num_replicas = 2;
+    parameters.temp_max = 1.0;
+    parameters.temp_min_ratio = 0.0;
+    EXPECT_THROW(SG::parallel_tempering(make_replica_factory(), parameters),
+                 std::runtime_error);
+}
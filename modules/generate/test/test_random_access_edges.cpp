@@ -0,0 +1,85 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "random_access_edges.hpp"
+#include "rng.hpp"
+#include "gmock/gmock.h"
+
+#include <set>
+
+namespace {
+/** Chain of num_vertices */
+SG::GraphType chain_graph(const size_t num_vertices) {
+    SG::GraphType graph(num_vertices);
+    for (size_t i = 0; i + 1 < num_vertices; ++i) {
+        boost::add_edge(i, i + 1, graph);
+    }
+    return graph;
+}
+} // namespace
+
+TEST(random_access_edges, build_add_and_remove) {
+    auto graph = chain_graph(10);
+    SG::random_access_edges edges_index(graph);
+    ASSERT_EQ(edges_index.size(), boost::num_edges(graph));
+    for (auto [ei, ei_end] = boost::edges(graph); ei != ei_end; ++ei) {
+        EXPECT_TRUE(edges_index.contains(*ei));
+    }
+    EXPECT_THROW(edges_index.add(*boost::edges(graph).first),
+                 std::logic_error);
+
+    // Remove an edge in the middle, the last edge takes its place.
+    const auto removed = edges_index[3];
+    const auto last = edges_index[edges_index.size() - 1];
+    edges_index.remove(removed);
+    boost::remove_edge(removed, graph);
+    EXPECT_EQ(edges_index.size(), boost::num_edges(graph));
+    EXPECT_FALSE(edges_index.contains(removed));
+    EXPECT_EQ(edges_index[3], last);
+    EXPECT_THROW(edges_index.remove(removed), std::logic_error);
+    // The moved edge can be removed.
+    edges_index.remove(last);
+    boost::remove_edge(last, graph);
+
+    const auto added = boost::add_edge(0, 9, graph).first;
+    edges_index.add(added);
+    EXPECT_TRUE(edges_index.contains(added));
+    EXPECT_EQ(edges_index.size(), boost::num_edges(graph));
+    for (auto [ei, ei_end] = boost::edges(graph); ei != ei_end; ++ei) {
+        EXPECT_TRUE(edges_index.contains(*ei));
+    }
+
+    edges_index.clear();
+    EXPECT_TRUE(edges_index.empty());
+}
+
+TEST(random_access_edges, select_random_edge) {
+    RNG::engine().seed(1);
+    const auto graph = chain_graph(6);
+    const SG::random_access_edges edges_index(graph);
+    std::set<std::pair<size_t, size_t>> selected;
+    for (size_t i = 0; i < 200; ++i) {
+        const auto edge = edges_index.select_random_edge();
+        EXPECT_TRUE(boost::edge(edge.m_source, edge.m_target, graph).second);
+        selected.emplace(edge.m_source, edge.m_target);
+    }
+    // All the edges are selected.
+    EXPECT_EQ(selected.size(), boost::num_edges(graph));
+}
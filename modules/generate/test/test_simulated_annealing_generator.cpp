@@ -111,3 +111,18 @@ TEST_F(SimulatedAnnealingGeneratorFixture, config_tree_constructor_works) {
     gen.engine();
     gen.print(std::cout);
 }
+
+TEST_F(SimulatedAnnealingGeneratorFixture, incremental_energy) {
+    auto gen = SG::simulated_annealing_generator(200);
+    gen.transition_params.UPDATE_STEP_MOVE_NODE_PROBABILITY = 0.5;
+    ASSERT_TRUE(gen.use_incremental_energy);
+    for (size_t steps = 100; steps <= 2000; steps += 100) {
+        gen.transition_params.MAX_ENGINE_ITERATIONS = steps;
+        gen.engine();
+        // Outside engine, compute_energy recomputes the energy from the
+        // histograms.
+        const auto energy = gen.compute_energy();
+        EXPECT_NEAR(gen.transition_params.energy, energy, 1e-10 * energy);
+    }
+    EXPECT_GT(gen.transition_params.accepted_transitions, 0);
+}
@@ -143,3 +143,50 @@ TEST_F(UpdateStepSwapEdgesFixture,
     EXPECT_EQ(step.new_edges_.second.m_source, 2);
     EXPECT_EQ(step.new_edges_.second.m_target, 1);
 }
+
+TEST(UpdateStepSwapEdges, edges_index_follows_update_graph) {
+    RNG::engine().seed(42);
+    // Ring of 30 vertices
+    const size_t num_vertices = 30;
+    SG::GraphType graph(num_vertices);
+    for (size_t i = 0; i < num_vertices; ++i) {
+        graph[i].pos = {{std::cos(0.2 * i), std::sin(0.2 * i), 0.0}};
+        boost::add_edge(i, (i + 1) % num_vertices, graph);
+    }
+    SG::Histogram histo_distances(
+            SG::get_all_end_to_end_distances_of_edges(
+                    graph, ArrayUtilities::boundary_condition::NONE),
+            histo::GenerateBreaksFromRangeAndBins(0.0, 2.5, 10));
+    SG::Histogram histo_cosines(
+            std::vector<double>(),
+            histo::GenerateBreaksFromRangeAndBins(-1.5, 1.5, 10));
+    auto step = SG::update_step_swap_edges(graph, histo_distances,
+                                           histo_cosines);
+    step.boundary_condition = ArrayUtilities::boundary_condition::NONE;
+    EXPECT_TRUE(step.edges_index_is_valid(graph));
+    for (size_t i = 0; i < 200; ++i) {
+        step.randomize();
+        step.perform();
+        if (i % 3 == 0) {
+            step.undo();
+        } else {
+            step.update_graph();
+        }
+    }
+    ASSERT_TRUE(step.edges_index_is_valid(graph));
+    for (auto [ei, ei_end] = boost::edges(graph); ei != ei_end; ++ei) {
+        EXPECT_TRUE(step.edges_index_.contains(*ei));
+    }
+    for (const auto &edge : step.edges_index_.edges()) {
+        EXPECT_TRUE(boost::edge(edge.m_source, edge.m_target, graph).second);
+    }
+    // Another graph does not use the index.
+    SG::GraphType other_graph(4);
+    boost::add_edge(0, 1, other_graph);
+    boost::add_edge(2, 3, other_graph);
+    EXPECT_FALSE(step.edges_index_is_valid(other_graph));
+    const auto other_edges = step.select_two_valid_edges(other_graph);
+    EXPECT_TRUE(boost::edge(other_edges.first.m_source,
+                            other_edges.first.m_target, other_graph)
+                        .second);
+}
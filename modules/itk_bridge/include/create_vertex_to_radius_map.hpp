@@ -21,6 +21,7 @@
 #ifndef SG_CREATE_VERTEX_TO_RADIUS_MAP_HPP
 #define SG_CREATE_VERTEX_TO_RADIUS_MAP_HPP
 
+#include "frozen_spatial_graph.hpp"
 #include "image_types.hpp" // for image types
 #include "spatial_graph.hpp"
 #include "transform_to_physical_point.hpp" // for physical_space_array_to_index_array
@@ -37,7 +38,7 @@ using VertexToRadiusMap =
 /**
  * Create a vertex to local radius map from a distance map and a graph.
  *
- * @tparam TGraph to work with filter_graphs as well.
+ * @tparam TGraph to work with filter_graphs and FrozenSpatialGraph as well.
  *
  * @param distance_map_image obtained from a binary image @sa
  * create_distance_map_function
@@ -61,7 +62,7 @@ VertexToRadiusMap create_vertex_to_radius_map(
     // Iterate over all nodes
     using vertex_iterator = typename boost::graph_traits<TGraph>::vertex_iterator;
     vertex_iterator vi, vi_end;
-    std::tie(vi, vi_end) = boost::vertices(input_graph);
+    std::tie(vi, vi_end) = vertices(input_graph);
     for (; vi != vi_end; vi++) {
         // Get the value of the distance map image associated to the position of
         // the node
@@ -91,6 +92,12 @@ extern template VertexToRadiusMap create_vertex_to_radius_map<GraphType>(
         const GraphType &input_graph,
         const bool spatial_nodes_position_are_in_physical_space,
         const bool /*verbose*/);
+extern template VertexToRadiusMap
+create_vertex_to_radius_map<FrozenSpatialGraph>(
+        const typename FloatImageType::Pointer &distance_map_image,
+        const FrozenSpatialGraph &input_graph,
+        const bool spatial_nodes_position_are_in_physical_space,
+        const bool /*verbose*/);
 
 } // end namespace SG
 #endif
@@ -39,8 +39,15 @@ using PointsIdMapPair =
         std::pair<vtkSmartPointer<vtkPoints>, IdGraphDescriptorMap>;
 using MergePointsIdMapPair =
         std::pair<vtkSmartPointer<vtkMergePoints>, IdGraphDescriptorMap>;
+using FrozenIdGraphDescriptorMap =
+        std::unordered_map<vtkIdType, std::vector<frozen_graph_descriptor>>;
+using FrozenPointsIdMapPair =
+        std::pair<vtkSmartPointer<vtkPoints>, FrozenIdGraphDescriptorMap>;
+using FrozenMergePointsIdMapPair =
+        std::pair<vtkSmartPointer<vtkMergePoints>, FrozenIdGraphDescriptorMap>;
 
 void print_id_graph_descriptor_map(const IdGraphDescriptorMap &);
+void print_id_graph_descriptor_map(const FrozenIdGraphDescriptorMap &);
 /**
  * Get vtkPoints extracted from the input spatial graph.
  *
@@ -57,6 +64,12 @@ void print_id_graph_descriptor_map(const IdGraphDescriptorMap &);
  * @return points and the map where they are located in the graph
  */
 PointsIdMapPair get_vtk_points_from_graph(const GraphType &g);
+/**
+ * FrozenSpatialGraph overload, the descriptors in the map are
+ * frozen_graph_descriptor. The points are inserted in the same order
+ * than the GraphType overload.
+ */
+FrozenPointsIdMapPair get_vtk_points_from_graph(const FrozenSpatialGraph &g);
 
 /**
  * Append an inputGraph to the tree structure used to merge points, and update
@@ -82,6 +95,16 @@ void append_new_graph_points(
         vtkPointLocator *mergePoints,
         std::unordered_map<vtkIdType, std::vector<graph_descriptor>>
                 &unique_id_map);
+
+void append_new_graph_points(
+        const FrozenPointsIdMapPair &new_graph_point_map_pair,
+        vtkPointLocator *mergePoints,
+        FrozenIdGraphDescriptorMap &unique_id_map);
+
+void append_new_graph_points(vtkPoints *new_graph_points,
+                             const FrozenIdGraphDescriptorMap &new_graph_id_map,
+                             vtkPointLocator *mergePoints,
+                             FrozenIdGraphDescriptorMap &unique_id_map);
 /**
  * Returns a unique set of points that are present in any of the inputs graphs
  * (the points might or might not be shared among the graphs), and a map
@@ -101,5 +124,13 @@ MergePointsIdMapPair get_vtk_points_from_graphs(
         const std::vector<std::reference_wrapper<const GraphType>> &graphs,
         const BoundingBox *box = nullptr);
 
+/**
+ * FrozenSpatialGraph overload of get_vtk_points_from_graphs
+ */
+FrozenMergePointsIdMapPair get_vtk_points_from_graphs(
+        const std::vector<std::reference_wrapper<const FrozenSpatialGraph>>
+                &graphs,
+        const BoundingBox *box = nullptr);
+
 } // namespace SG
 #endif
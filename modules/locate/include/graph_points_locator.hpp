@@ -28,11 +28,14 @@
 
 namespace SG {
 
-struct IdWithGraphDescriptor {
+template <typename TGraph> struct BasicIdWithGraphDescriptor {
     bool exist = false;
     vtkIdType id;
-    graph_descriptor descriptor;
+    basic_graph_descriptor<TGraph> descriptor;
 };
+using IdWithGraphDescriptor = BasicIdWithGraphDescriptor<GraphType>;
+using FrozenIdWithGraphDescriptor =
+        BasicIdWithGraphDescriptor<FrozenSpatialGraph>;
 
 /**
  * The output is a vector (of size equal to the number of graphs on input idMap)
@@ -44,14 +47,19 @@ struct IdWithGraphDescriptor {
  * The size of the return vector is given by the number of graphs existing in
  * idMap.
  *
+ * Instantiated for GraphType and FrozenSpatialGraph descriptors.
+ *
  * @param closeIdList
  * @param idMap
  *
  * @return vector of graph_descriptos with id
  */
-std::vector<IdWithGraphDescriptor> closest_existing_descriptors_by_graph(
+template <typename TGraph>
+std::vector<BasicIdWithGraphDescriptor<TGraph>>
+closest_existing_descriptors_by_graph(
         vtkIdList *closeIdList,
-        const std::unordered_map<vtkIdType, std::vector<graph_descriptor>>
+        const std::unordered_map<vtkIdType,
+                                 std::vector<basic_graph_descriptor<TGraph>>>
                 &idMap);
 
 /**
@@ -63,9 +71,12 @@ std::vector<IdWithGraphDescriptor> closest_existing_descriptors_by_graph(
  *
  * @return
  */
-std::vector<IdWithGraphDescriptor> closest_existing_vertex_by_graph(
+template <typename TGraph>
+std::vector<BasicIdWithGraphDescriptor<TGraph>>
+closest_existing_vertex_by_graph(
         vtkIdList *closeIdList,
-        const std::unordered_map<vtkIdType, std::vector<graph_descriptor>>
+        const std::unordered_map<vtkIdType,
+                                 std::vector<basic_graph_descriptor<TGraph>>>
                 &idMap);
 
 /**
@@ -85,9 +96,12 @@ build_octree_locator(vtkPoints *inputPoints);
  *
  * @return false if any gdesc.exist == false
  */
-bool all_graph_descriptors_exist(const std::vector<graph_descriptor> &gdescs);
+template <typename TGraph>
+bool all_graph_descriptors_exist(
+        const std::vector<basic_graph_descriptor<TGraph>> &gdescs);
+template <typename TGraph>
 bool all_graph_descriptors_exist(
-        const std::vector<IdWithGraphDescriptor> &gdescs);
+        const std::vector<BasicIdWithGraphDescriptor<TGraph>> &gdescs);
 
 /**
  * Use the octree point locator and the idMap from a set of graphs to query a
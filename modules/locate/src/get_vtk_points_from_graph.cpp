@@ -25,21 +25,29 @@
 
 namespace SG {
 
-void print_id_graph_descriptor_map(const IdGraphDescriptorMap &idMap) {
+namespace {
+template <typename TIdGraphDescriptorMap>
+void print_id_graph_descriptor_map_impl(const TIdGraphDescriptorMap &idMap) {
     std::cout << "idMap: Id --> vector.size()" << std::endl;
     for (const auto &elem : idMap) {
         std::cout << elem.first << " --> " << elem.second.size() << "\n";
     }
 }
 
-PointsIdMapPair get_vtk_points_from_graph(const GraphType &sg) {
-    using vertex_iterator = boost::graph_traits<GraphType>::vertex_iterator;
-    using edge_iterator = boost::graph_traits<GraphType>::edge_iterator;
+template <typename TGraph>
+std::pair<vtkSmartPointer<vtkPoints>,
+          std::unordered_map<vtkIdType,
+                             std::vector<basic_graph_descriptor<TGraph>>>>
+get_vtk_points_from_graph_impl(const TGraph &sg) {
+    using vertex_iterator =
+            typename boost::graph_traits<TGraph>::vertex_iterator;
+    using edge_iterator = typename boost::graph_traits<TGraph>::edge_iterator;
+    using graph_descriptor = basic_graph_descriptor<TGraph>;
     auto points = vtkSmartPointer<vtkPoints>::New();
 
     std::unordered_map<vtkIdType, std::vector<graph_descriptor>> idMap;
     vertex_iterator vi, vi_end;
-    std::tie(vi, vi_end) = boost::vertices(sg);
+    std::tie(vi, vi_end) = vertices(sg);
     for (; vi != vi_end; ++vi) {
         auto id = points->InsertNextPoint(sg[*vi].pos[0], sg[*vi].pos[1],
                                           sg[*vi].pos[2]);
@@ -53,10 +61,10 @@ PointsIdMapPair get_vtk_points_from_graph(const GraphType &sg) {
     }
 
     edge_iterator ei, ei_end;
-    std::tie(ei, ei_end) = boost::edges(sg);
+    std::tie(ei, ei_end) = edges(sg);
     for (; ei != ei_end; ++ei) {
-        auto &sg_edge = sg[*ei];
-        auto &sg_edge_points = sg_edge.edge_points;
+        const auto &sg_edge = sg[*ei];
+        const auto &sg_edge_points = sg_edge.edge_points;
         for (size_t index = 0; index < sg_edge_points.size(); ++index) {
             const auto &p = sg_edge_points[index];
             auto id = points->InsertNextPoint(p[0], p[1], p[2]);
@@ -91,22 +99,13 @@ PointsIdMapPair get_vtk_points_from_graph(const GraphType &sg) {
     return std::make_pair(points, idMap);
 }
 
-void append_new_graph_points(
-        PointsIdMapPair &new_graph_point_map_pair,
-        vtkPointLocator *mergePoints,
-        std::unordered_map<vtkIdType, std::vector<graph_descriptor>>
-                &unique_id_map) {
-    append_new_graph_points(new_graph_point_map_pair.first,
-                            new_graph_point_map_pair.second, mergePoints,
-                            unique_id_map);
-}
-
-void append_new_graph_points(
+template <typename TGraphDescriptor>
+void append_new_graph_points_impl(
         vtkPoints *new_graph_points,
-        const std::unordered_map<vtkIdType, std::vector<graph_descriptor>>
+        const std::unordered_map<vtkIdType, std::vector<TGraphDescriptor>>
                 &new_graph_id_map,
         vtkPointLocator *mergePoints,
-        std::unordered_map<vtkIdType, std::vector<graph_descriptor>>
+        std::unordered_map<vtkIdType, std::vector<TGraphDescriptor>>
                 &unique_id_map) {
     const auto number_of_previous_graphs =
             unique_id_map.cbegin()->second.size();
@@ -138,7 +137,7 @@ void append_new_graph_points(
         assert(new_graph_id_map.at(point_index).size() == 1);
         const auto &current_graph_gdesc = new_graph_id_map.at(point_index)[0];
         if (is_new_point_inserted) {
-            std::vector<graph_descriptor> gdescs_non_existant(
+            std::vector<TGraphDescriptor> gdescs_non_existant(
                     number_of_previous_graphs);
             unique_id_map[lastPtId] = gdescs_non_existant;
             // assert(unique_id_map.at(lastPtId).size() ==
@@ -156,15 +155,23 @@ void append_new_graph_points(
         // This will happen when the first graph has different points than the
         // appended graph We append an empty descriptor
         if (graph_descriptors.size() == number_of_previous_graphs) {
-            graph_descriptors.emplace_back(graph_descriptor());
+            graph_descriptors.emplace_back(TGraphDescriptor());
         }
         assert(graph_descriptors.size() == number_of_previous_graphs + 1);
     }
 }
 
-MergePointsIdMapPair get_vtk_points_from_graphs(
-        const std::vector<std::reference_wrapper<const GraphType>> &graphs,
+template <typename TGraph>
+std::pair<vtkSmartPointer<vtkMergePoints>,
+          std::unordered_map<vtkIdType,
+                             std::vector<basic_graph_descriptor<TGraph>>>>
+get_vtk_points_from_graphs_impl(
+        const std::vector<std::reference_wrapper<const TGraph>> &graphs,
         const BoundingBox *box) {
+    using graph_descriptor = basic_graph_descriptor<TGraph>;
+    using PointsIdMapPair = std::pair<
+            vtkSmartPointer<vtkPoints>,
+            std::unordered_map<vtkIdType, std::vector<graph_descriptor>>>;
     assert(!graphs.empty());
     auto unique_points = vtkSmartPointer<vtkPoints>::New();
     std::unordered_map<vtkIdType, std::vector<graph_descriptor>> unique_id_map;
@@ -180,7 +187,7 @@ MergePointsIdMapPair get_vtk_points_from_graphs(
     std::vector<double *> bounds_vector;
     for (const auto & graph: graphs) {
         graphs_point_map.emplace_back(
-                get_vtk_points_from_graph(graph));
+                get_vtk_points_from_graph(graph.get()));
         const auto &points_per_graph = graphs_point_map.back().first;
         bounds_vector.emplace_back(points_per_graph->GetBounds());
     }
@@ -213,5 +220,73 @@ MergePointsIdMapPair get_vtk_points_from_graphs(
 
     return std::make_pair(mergePoints, unique_id_map);
 }
+} // namespace
+
+void print_id_graph_descriptor_map(const IdGraphDescriptorMap &idMap) {
+    print_id_graph_descriptor_map_impl(idMap);
+}
+
+void print_id_graph_descriptor_map(const FrozenIdGraphDescriptorMap &idMap) {
+    print_id_graph_descriptor_map_impl(idMap);
+}
+
+PointsIdMapPair get_vtk_points_from_graph(const GraphType &sg) {
+    return get_vtk_points_from_graph_impl(sg);
+}
+
+FrozenPointsIdMapPair get_vtk_points_from_graph(const FrozenSpatialGraph &sg) {
+    return get_vtk_points_from_graph_impl(sg);
+}
+
+void append_new_graph_points(
+        const PointsIdMapPair &new_graph_point_map_pair,
+        vtkPointLocator *mergePoints,
+        std::unordered_map<vtkIdType, std::vector<graph_descriptor>>
+                &unique_id_map) {
+    append_new_graph_points(new_graph_point_map_pair.first,
+                            new_graph_point_map_pair.second, mergePoints,
+                            unique_id_map);
+}
+
+void append_new_graph_points(
+        vtkPoints *new_graph_points,
+        const std::unordered_map<vtkIdType, std::vector<graph_descriptor>>
+                &new_graph_id_map,
+        vtkPointLocator *mergePoints,
+        std::unordered_map<vtkIdType, std::vector<graph_descriptor>>
+                &unique_id_map) {
+    append_new_graph_points_impl(new_graph_points, new_graph_id_map,
+                                 mergePoints, unique_id_map);
+}
+
+void append_new_graph_points(
+        const FrozenPointsIdMapPair &new_graph_point_map_pair,
+        vtkPointLocator *mergePoints,
+        FrozenIdGraphDescriptorMap &unique_id_map) {
+    append_new_graph_points(new_graph_point_map_pair.first,
+                            new_graph_point_map_pair.second, mergePoints,
+                            unique_id_map);
+}
+
+void append_new_graph_points(vtkPoints *new_graph_points,
+                             const FrozenIdGraphDescriptorMap &new_graph_id_map,
+                             vtkPointLocator *mergePoints,
+                             FrozenIdGraphDescriptorMap &unique_id_map) {
+    append_new_graph_points_impl(new_graph_points, new_graph_id_map,
+                                 mergePoints, unique_id_map);
+}
+
+MergePointsIdMapPair get_vtk_points_from_graphs(
+        const std::vector<std::reference_wrapper<const GraphType>> &graphs,
+        const BoundingBox *box) {
+    return get_vtk_points_from_graphs_impl(graphs, box);
+}
+
+FrozenMergePointsIdMapPair get_vtk_points_from_graphs(
+        const std::vector<std::reference_wrapper<const FrozenSpatialGraph>>
+                &graphs,
+        const BoundingBox *box) {
+    return get_vtk_points_from_graphs_impl(graphs, box);
+}
 
 } // namespace SG
@@ -23,12 +23,16 @@
 #include "vtkPolyData.h"
 namespace SG {
 
-std::vector<IdWithGraphDescriptor> closest_existing_descriptors_by_graph(
+template <typename TGraph>
+std::vector<BasicIdWithGraphDescriptor<TGraph>>
+closest_existing_descriptors_by_graph(
         vtkIdList *closeIdList,
-        const std::unordered_map<vtkIdType, std::vector<graph_descriptor>>
+        const std::unordered_map<vtkIdType,
+                                 std::vector<basic_graph_descriptor<TGraph>>>
                 &idMap) {
     const size_t gdescs_size = idMap.cbegin()->second.size();
-    std::vector<IdWithGraphDescriptor> id_graph_descriptors(gdescs_size);
+    std::vector<BasicIdWithGraphDescriptor<TGraph>> id_graph_descriptors(
+            gdescs_size);
     // Fill id_graph_descriptors from the closest points.
     // the list should be ordered from closest to furthest
     for (vtkIdType closeId_index = 0;
@@ -54,12 +58,16 @@ std::vector<IdWithGraphDescriptor> closest_existing_descriptors_by_graph(
     return id_graph_descriptors;
 }
 
-std::vector<IdWithGraphDescriptor> closest_existing_vertex_by_graph(
+template <typename TGraph>
+std::vector<BasicIdWithGraphDescriptor<TGraph>>
+closest_existing_vertex_by_graph(
         vtkIdList *closeIdList,
-        const std::unordered_map<vtkIdType, std::vector<graph_descriptor>>
+        const std::unordered_map<vtkIdType,
+                                 std::vector<basic_graph_descriptor<TGraph>>>
                 &idMap) {
     const size_t gdescs_size = idMap.cbegin()->second.size();
-    std::vector<IdWithGraphDescriptor> id_graph_descriptors(gdescs_size);
+    std::vector<BasicIdWithGraphDescriptor<TGraph>> id_graph_descriptors(
+            gdescs_size);
     for (vtkIdType closeId_index = 0;
          closeId_index < closeIdList->GetNumberOfIds(); ++closeId_index) {
         vtkIdType idList = closeIdList->GetId(closeId_index);
@@ -94,8 +102,9 @@ build_octree_locator(vtkPoints *inputPoints) {
     return octree;
 }
 
+template <typename TGraph>
 bool all_graph_descriptors_exist(
-        const std::vector<IdWithGraphDescriptor> &gdescs) {
+        const std::vector<BasicIdWithGraphDescriptor<TGraph>> &gdescs) {
     for (const auto &gdesc_with_id : gdescs) {
         if (!gdesc_with_id.exist) {
             return false;
@@ -104,7 +113,9 @@ bool all_graph_descriptors_exist(
     return true;
 }
 
-bool all_graph_descriptors_exist(const std::vector<graph_descriptor> &gdescs) {
+template <typename TGraph>
+bool all_graph_descriptors_exist(
+        const std::vector<basic_graph_descriptor<TGraph>> &gdescs) {
     for (const auto &gdesc : gdescs) {
         if (!gdesc.exist) {
             return false;
@@ -180,4 +191,34 @@ vtkSmartPointer<vtkIdList> graph_closest_points_by_radius_locator(
     //     std::endl;
     // return out_gdescs;
 }
+
+template std::vector<IdWithGraphDescriptor>
+closest_existing_descriptors_by_graph<GraphType>(
+        vtkIdList *closeIdList,
+        const std::unordered_map<vtkIdType, std::vector<graph_descriptor>>
+                &idMap);
+template std::vector<IdWithGraphDescriptor>
+closest_existing_vertex_by_graph<GraphType>(
+        vtkIdList *closeIdList,
+        const std::unordered_map<vtkIdType, std::vector<graph_descriptor>>
+                &idMap);
+template bool all_graph_descriptors_exist<GraphType>(
+        const std::vector<graph_descriptor> &gdescs);
+template bool all_graph_descriptors_exist<GraphType>(
+        const std::vector<IdWithGraphDescriptor> &gdescs);
+template std::vector<FrozenIdWithGraphDescriptor>
+closest_existing_descriptors_by_graph<FrozenSpatialGraph>(
+        vtkIdList *closeIdList,
+        const std::unordered_map<vtkIdType,
+                                 std::vector<frozen_graph_descriptor>> &idMap);
+template std::vector<FrozenIdWithGraphDescriptor>
+closest_existing_vertex_by_graph<FrozenSpatialGraph>(
+        vtkIdList *closeIdList,
+        const std::unordered_map<vtkIdType,
+                                 std::vector<frozen_graph_descriptor>> &idMap);
+template bool all_graph_descriptors_exist<FrozenSpatialGraph>(
+        const std::vector<frozen_graph_descriptor> &gdescs);
+template bool all_graph_descriptors_exist<FrozenSpatialGraph>(
+        const std::vector<FrozenIdWithGraphDescriptor> &gdescs);
+
 } // namespace SG
@@ -18,6 +18,7 @@
  *
  * *******************************************************************/
 
+#include "frozen_spatial_graph.hpp"
 #include "get_vtk_points_from_graph.hpp"
 #include "spatial_graph.hpp"
 #include "gmock/gmock.h"
@@ -78,6 +79,39 @@ TEST_F(GetVtkPointsFromGraphFixture, get_vtk_points_from_graph) {
     EXPECT_EQ(gdesc.edge_points_index, 0);
 }
 
+TEST_F(GetVtkPointsFromGraphFixture, get_vtk_points_from_frozen_graph) {
+    const auto frozen = SG::frozen_spatial_graph_from_graph(g);
+    auto points_map_pair = SG::get_vtk_points_from_graph(g);
+    auto frozen_points_map_pair = SG::get_vtk_points_from_graph(frozen);
+    const auto &points = frozen_points_map_pair.first;
+    const auto &idMap = frozen_points_map_pair.second;
+    EXPECT_EQ(points->GetNumberOfPoints(),
+              points_map_pair.first->GetNumberOfPoints());
+    EXPECT_EQ(idMap.size(), points_map_pair.second.size());
+    for (vtkIdType id = 0; id < points->GetNumberOfPoints(); ++id) {
+        auto pptr = points->GetPoint(id);
+        auto expected_pptr = points_map_pair.first->GetPoint(id);
+        EXPECT_EQ(pptr[0], expected_pptr[0]);
+        EXPECT_EQ(pptr[1], expected_pptr[1]);
+        EXPECT_EQ(pptr[2], expected_pptr[2]);
+    }
+
+    size_t id = 0;
+    auto gdesc = idMap.at(id)[0];
+    EXPECT_TRUE(gdesc.exist);
+    EXPECT_TRUE(gdesc.is_vertex);
+    EXPECT_FALSE(gdesc.is_edge);
+    EXPECT_EQ(gdesc.vertex_d, 0);
+    id = 3; // the first edge 0--1
+    gdesc = idMap.at(id)[0];
+    EXPECT_TRUE(gdesc.exist);
+    EXPECT_FALSE(gdesc.is_vertex);
+    EXPECT_TRUE(gdesc.is_edge);
+    EXPECT_EQ(gdesc.edge_d.m_source, 0);
+    EXPECT_EQ(gdesc.edge_d.m_target, 1);
+    EXPECT_EQ(gdesc.edge_points_index, 0);
+}
+
 TEST_F(GetVtkPointsFromGraphFixture,
        get_vtk_points_from_graphs_with_two_equal_graphs) {
     const auto &g0 = g;
@@ -49,6 +49,54 @@ GraphType raw_graph_from_image(
         const SG::BinaryImageType::Pointer & thin_image);
 GraphType raw_graph_from_image(const std::string & filename);
 
+/**
+ * Build the reduced graph from a binary itk image or file, one z-slab at a
+ * time using ReducedGraphSlabBuilder, without DGtal.
+ * Equivalent to reduced_graph_from_image, but the raw graph is never built,
+ * besides the output graph only a few planes are held in memory.
+ *
+ * The file is read with an ITK streaming reader, requesting only the
+ * region of each slab. If the ImageIO of the file does not support
+ * streaming, ITK reads the whole image, and the result is the same.
+ *
+ * @param filename file holding a thin/skeletonized binary image
+ * @param slab_thickness number of z-planes per slab
+ * @param removeExtraEdges remove edges of triangles (remove_extra_edges)
+ * @param verbose print progress of the slabs
+ *
+ * @return reduced SpatialGraph
+ */
+GraphType reduced_graph_from_image_by_slabs(const std::string & filename,
+        size_t slab_thickness = 32,
+        bool removeExtraEdges = true,
+        bool verbose = false);
+GraphType reduced_graph_from_image_by_slabs(
+        const SG::BinaryImageType::Pointer & thin_image,
+        size_t slab_thickness = 32,
+        bool removeExtraEdges = true,
+        bool verbose = false);
+
+/**
+ * Build the reduced graph from a binary itk image or file directly,
+ * without creating the raw graph with a vertex per voxel.
+ * Equivalent to raw_graph_from_image, remove_extra_edges (if
+ * removeExtraEdges) and reduce_spatial_graph_via_dfs.
+ * @sa reduced_graph_from_thin_volume
+ *
+ * @param thin_image thin/skeletonized binary image
+ * @param removeExtraEdges remove edges of triangles (remove_extra_edges)
+ * @param verbose
+ *
+ * @return reduced SpatialGraph
+ */
+GraphType reduced_graph_from_image(
+        const SG::BinaryImageType::Pointer & thin_image,
+        bool removeExtraEdges = true,
+        bool verbose = false);
+GraphType reduced_graph_from_image(const std::string & filename,
+        bool removeExtraEdges = true,
+        bool verbose = false);
+
 /**
  * Merge nodes optionally using all merge nodes methods
  *
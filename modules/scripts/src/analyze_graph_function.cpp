@@ -35,8 +35,10 @@
 #include <DGtal/images/imagesSetsUtils/SetFromImage.h>
 #include <DGtal/io/readers/GenericReader.h>
 #include <DGtal/io/readers/ITKReader.h>
+#include <algorithm>
 #include <chrono>
 #include <iostream>
+#include <stdexcept>
 #include <unordered_map>
 // graph
 #include <DGtal/graph/ObjectBoostGraphInterface.h>
@@ -45,6 +47,8 @@
 // Reduce graph via dfs:
 #include "merge_nodes.hpp"
 #include "reduce_spatial_graph_via_dfs.hpp"
+#include "reduced_graph_from_thin_volume.hpp"
+#include "reduced_graph_slab_builder.hpp"
 #include "remove_extra_edges.hpp"
 #include "spatial_graph.hpp"
 #include "spatial_graph_from_object.hpp"
@@ -110,6 +114,108 @@ GraphType raw_graph_from_image(const std::string & filename) {
     return SG::raw_graph_from_image(SG::itk_image_from_file<SG::BinaryImageType>(filename));
 }
 
+GraphType reduced_graph_from_image_by_slabs(const std::string & filename,
+        size_t slab_thickness,
+        bool removeExtraEdges,
+        bool verbose) {
+    if (slab_thickness == 0) {
+        throw std::runtime_error(
+                "reduced_graph_from_image_by_slabs: slab_thickness cannot be 0.");
+    }
+    using ReaderType = itk::ImageFileReader<SG::BinaryImageType>;
+    auto reader = ReaderType::New();
+    reader->SetFileName(filename);
+    reader->UpdateOutputInformation();
+    const auto largest_region =
+            reader->GetOutput()->GetLargestPossibleRegion();
+    const auto size = largest_region.GetSize();
+    const auto start = largest_region.GetIndex();
+    const auto size_z = static_cast<size_t>(size[2]);
+    const SG::ReducedGraphSlabBuilder::IndexType origin_index = {
+            {static_cast<long>(start[0]), static_cast<long>(start[1]),
+             static_cast<long>(start[2])}};
+    SG::ReducedGraphSlabBuilder builder(size[0], size[1], origin_index,
+                                        removeExtraEdges);
+    for (size_t z = 0; z < size_z; z += slab_thickness) {
+        auto slab_region = largest_region;
+        slab_region.SetIndex(2, start[2] + static_cast<long>(z));
+        slab_region.SetSize(2, std::min(slab_thickness, size_z - z));
+        reader->GetOutput()->SetRequestedRegion(slab_region);
+        reader->Update();
+        const auto slab = reader->GetOutput();
+        // The buffered region can be larger than the requested one when the
+        // ImageIO does not support streaming.
+        const auto offset = slab->ComputeOffset(slab_region.GetIndex());
+        builder.add_slab(slab->GetBufferPointer() + offset,
+                         slab_region.GetSize()[2]);
+        if (verbose) {
+            std::cout << "Slab: " << z << " - " << z + slab_region.GetSize()[2]
+                      << " of " << size_z << ". Nodes: "
+                      << boost::num_vertices(builder.graph())
+                      << ", open chains: " << builder.num_open_chains()
+                      << std::endl;
+        }
+    }
+    return builder.release_graph();
+}
+
+GraphType reduced_graph_from_image_by_slabs(
+        const SG::BinaryImageType::Pointer & thin_image,
+        size_t slab_thickness,
+        bool removeExtraEdges,
+        bool verbose) {
+    if (slab_thickness == 0) {
+        throw std::runtime_error(
+                "reduced_graph_from_image_by_slabs: slab_thickness cannot be 0.");
+    }
+    const auto buffered_region = thin_image->GetBufferedRegion();
+    const auto size = buffered_region.GetSize();
+    const auto start = buffered_region.GetIndex();
+    const SG::ReducedGraphSlabBuilder::IndexType origin_index = {
+            {static_cast<long>(start[0]), static_cast<long>(start[1]),
+             static_cast<long>(start[2])}};
+    SG::ReducedGraphSlabBuilder builder(size[0], size[1], origin_index,
+                                        removeExtraEdges);
+    const auto size_z = static_cast<size_t>(size[2]);
+    const auto plane_size = static_cast<size_t>(size[0] * size[1]);
+    const auto *buffer = thin_image->GetBufferPointer();
+    for (size_t z = 0; z < size_z; z += slab_thickness) {
+        const auto nz = std::min(slab_thickness, size_z - z);
+        builder.add_slab(buffer + z * plane_size, nz);
+        if (verbose) {
+            std::cout << "Slab: " << z << " - " << z + nz << " of " << size_z
+                      << ". Nodes: " << boost::num_vertices(builder.graph())
+                      << ", open chains: " << builder.num_open_chains()
+                      << std::endl;
+        }
+    }
+    return builder.release_graph();
+}
+
+GraphType reduced_graph_from_image(
+        const SG::BinaryImageType::Pointer & thin_image,
+        bool removeExtraEdges,
+        bool verbose) {
+    const auto buffered_region = thin_image->GetBufferedRegion();
+    const auto size = buffered_region.GetSize();
+    const auto start = buffered_region.GetIndex();
+    return SG::reduced_graph_from_thin_volume(
+            thin_image->GetBufferPointer(),
+            {{static_cast<size_t>(size[0]), static_cast<size_t>(size[1]),
+              static_cast<size_t>(size[2])}},
+            {{static_cast<long>(start[0]), static_cast<long>(start[1]),
+              static_cast<long>(start[2])}},
+            removeExtraEdges, verbose);
+}
+
+GraphType reduced_graph_from_image(const std::string & filename,
+        bool removeExtraEdges,
+        bool verbose) {
+    return SG::reduced_graph_from_image(
+            SG::itk_image_from_file<SG::BinaryImageType>(filename),
+            removeExtraEdges, verbose);
+}
+
 void merge_nodes_interface(
         GraphType &reduced_g,
         bool mergeThreeConnectedNodes,
@@ -289,18 +395,27 @@ void export_graph_data_interface(const GraphType & reduced_g,
     std::ofstream data_out;
     data_out.setf(std::ios_base::fixed, std::ios_base::floatfield);
     data_out.open(data_output_full_path.string().c_str());
+    // Compute all the properties in one parallel pass.
+    SG::GraphPropertiesParameters properties_parameters;
+    properties_parameters.minimum_size_edges = ignoreEdgesShorterThan;
+    properties_parameters.ignore_parallel_edges =
+        ignoreAngleBetweenParallelEdges;
+    properties_parameters.ignore_end_nodes = ignoreEdgesToEndNodes;
+    properties_parameters.compute_histograms = false;
+    const auto properties =
+        SG::compute_graph_properties_all(reduced_g, properties_parameters);
     // Degrees
     {
-        auto degrees = SG::compute_degrees(reduced_g);
+        const auto &degrees = properties.degrees;
         // auto histo_degrees = SG::histogram_degrees(degrees,
         // binsHistoDegrees); SG::print_histogram(histo_degrees,
         // histo_out);
         {
             data_out.precision(
                     std::numeric_limits<decltype(
-                        degrees)::value_type>::max_digits10);
+                        properties.degrees)::value_type>::max_digits10);
             data_out << "# degrees" << std::endl;
-            std::ostream_iterator<decltype(degrees)::value_type>
+            std::ostream_iterator<decltype(properties.degrees)::value_type>
                 out_iter(data_out, " ");
             std::copy(std::begin(degrees), std::end(degrees), out_iter);
             data_out << std::endl;
@@ -308,9 +423,7 @@ void export_graph_data_interface(const GraphType & reduced_g,
     }
     // EndToEnd Distances
     {
-        auto ete_distances = SG::compute_ete_distances(
-                reduced_g, ignoreEdgesShorterThan,
-                ignoreEdgesToEndNodes);
+        const auto &ete_distances = properties.ete_distances;
 
         auto range_ptr = std::minmax_element(ete_distances.begin(),
                 ete_distances.end());
@@ -327,9 +440,9 @@ void export_graph_data_interface(const GraphType & reduced_g,
         {
             data_out.precision(
                     std::numeric_limits<decltype(
-                        ete_distances)::value_type>::max_digits10);
+                        properties.ete_distances)::value_type>::max_digits10);
             data_out << "# ete_distances" << std::endl;
-            std::ostream_iterator<decltype(ete_distances)::value_type>
+            std::ostream_iterator<decltype(properties.ete_distances)::value_type>
                 out_iter(data_out, " ");
             std::copy(std::begin(ete_distances),
                     std::end(ete_distances), out_iter);
@@ -338,34 +451,32 @@ void export_graph_data_interface(const GraphType & reduced_g,
     }
     // Angles between adjacent edges
     {
-        auto angles = SG::compute_angles(
-                reduced_g, ignoreEdgesShorterThan,
-                ignoreAngleBetweenParallelEdges, ignoreEdgesToEndNodes);
+        const auto &angles = properties.angles;
         // auto histo_angles = SG::histogram_angles( angles,
         // binsHistoAngles ); SG::print_histogram(histo_angles,
         // histo_out);
         {
             data_out.precision(
                     std::numeric_limits<decltype(
-                        angles)::value_type>::max_digits10);
+                        properties.angles)::value_type>::max_digits10);
             data_out << "# angles" << std::endl;
-            std::ostream_iterator<decltype(angles)::value_type>
+            std::ostream_iterator<decltype(properties.angles)::value_type>
                 out_iter(data_out, " ");
             std::copy(std::begin(angles), std::end(angles), out_iter);
             data_out << std::endl;
         }
         // Cosines of those angles
         {
-            auto cosines = SG::compute_cosines(angles);
+            const auto &cosines = properties.cosines;
             // auto histo_cosines = SG::histogram_cosines( cosines,
             // binsHistoCosines ); SG::print_histogram(histo_cosines,
             // histo_out);
             {
                 data_out.precision(
                         std::numeric_limits<decltype(
-                            cosines)::value_type>::max_digits10);
+                            properties.cosines)::value_type>::max_digits10);
                 data_out << "# cosines" << std::endl;
-                std::ostream_iterator<decltype(cosines)::value_type>
+                std::ostream_iterator<decltype(properties.cosines)::value_type>
                     out_iter(data_out, " ");
                 std::copy(std::begin(cosines), std::end(cosines),
                         out_iter);
@@ -375,19 +486,17 @@ void export_graph_data_interface(const GraphType & reduced_g,
     }
     // Contour length
     {
-        auto contour_lengths = SG::compute_contour_lengths(
-                reduced_g, ignoreEdgesShorterThan,
-                ignoreEdgesToEndNodes);
+        const auto &contour_lengths = properties.contour_lengths;
         // auto histo_contour_lengths =
         // SG::histogram_contour_lengths(contour_lengths,
         // widthHistoDistances);
         // SG::print_histogram(histo_contour_lengths, histo_out);
         {
             data_out.precision(std::numeric_limits<decltype(
-                        contour_lengths)::value_type>::
+                        properties.contour_lengths)::value_type>::
                     max_digits10);
             data_out << "# contour_lengths" << std::endl;
-            std::ostream_iterator<decltype(contour_lengths)::value_type>
+            std::ostream_iterator<decltype(properties.contour_lengths)::value_type>
                 out_iter(data_out, " ");
             std::copy(std::begin(contour_lengths),
                     std::end(contour_lengths), out_iter);
@@ -23,6 +23,7 @@
 
 #include "image_types.hpp" // for FloatImageType
 
+#include "frozen_spatial_graph.hpp"
 #include "spatial_graph.hpp"
 #include <unordered_map>
 
@@ -107,6 +108,9 @@ inline void print(const AnomalyParameters & parameters, std::ostream &os) {
  * @param verbose extra infro to std::cout
  *
  * @return A map vertex to generation
+ *
+ * The FrozenSpatialGraph overload runs the same visitor on the frozen graph,
+ * the vertex descriptors of the output are the same.
  */
 
 using VertexGenerationMap =
@@ -125,6 +129,20 @@ VertexGenerationMap tree_generation(
                 VertexGenerationMap(),
         const AnomalyParameters &anomaly_parameters = AnomalyParameters(),
         const bool verbose = false);
+VertexGenerationMap tree_generation(
+        const FrozenSpatialGraph &graph,
+        const typename FloatImageType::Pointer &distance_map_image,
+        const bool spatial_nodes_position_are_in_physical_space = false,
+        const double &decrease_radius_ratio_to_increase_generation = 0.1,
+        const double &keep_generation_if_angle_less_than = 10,
+        const double &increase_generation_if_angle_greater_than = 40,
+        const size_t &num_of_edge_points_to_compute_angle = 5,
+        const std::vector<GraphType::vertex_descriptor> &input_roots =
+        std::vector<GraphType::vertex_descriptor>(),
+        const VertexGenerationMap &input_fixed_generation_map =
+                VertexGenerationMap(),
+        const AnomalyParameters &anomaly_parameters = AnomalyParameters(),
+        const bool verbose = false);
 
 /**
  * Read/Write a CSV-like file containing a one-line header and two
@@ -267,10 +267,10 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
             const SpatialGraph &input_sg,
             const size_t minimum_size_edge_points = 5,
             const double differences_ratio = 2.0) const {
-        const auto source = boost::source(input_edge, input_sg);
-        const auto target = boost::target(input_edge, input_sg);
-        const auto &source_radius = m_vertex_to_local_radius_map.at(source);
-        const auto &target_radius = m_vertex_to_local_radius_map.at(target);
+        const auto source_vertex = source(input_edge, input_sg);
+        const auto target_vertex = target(input_edge, input_sg);
+        const auto &source_radius = m_vertex_to_local_radius_map.at(source_vertex);
+        const auto &target_radius = m_vertex_to_local_radius_map.at(target_vertex);
         const auto &edge_points = input_sg[input_edge].edge_points;
         const auto edge_points_size = std::size(edge_points);
         // There must be at least some edge points for this to make sense
@@ -326,18 +326,18 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
     std::vector<edge_descriptor>
     get_edges_with_same_source_than_input_edge(edge_descriptor input_edge,
                                                const SpatialGraph &input_sg) {
-        const auto source = boost::source(input_edge, input_sg);
-        const auto target = boost::target(input_edge, input_sg);
+        const auto source_vertex = source(input_edge, input_sg);
+        const auto target_vertex = target(input_edge, input_sg);
         using out_edge_iterator =
-                boost::graph_traits<GraphType>::out_edge_iterator;
+                typename boost::graph_traits<SpatialGraph>::out_edge_iterator;
         out_edge_iterator ei, ei_end;
         std::vector<edge_descriptor> edges_with_same_source_than_input_edge;
-        for (std::tie(ei, ei_end) = boost::out_edges(source, input_sg);
+        for (std::tie(ei, ei_end) = out_edges(source_vertex, input_sg);
              ei != ei_end; ++ei) {
             if (*ei != input_edge) {
-                const auto edge_target = boost::target(*ei, input_sg);
+                const auto edge_target = target(*ei, input_sg);
                 const auto edge_pair_exist =
-                        boost::edge(target, edge_target, input_sg);
+                        edge(target_vertex, edge_target, input_sg);
                 // if both targets are connected, ignore this edge.
                 if (edge_pair_exist.second) {
                     continue;
@@ -389,7 +389,7 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
             return false;
         }
         for (auto &edge : other_out_edges) {
-            const auto &edge_target = boost::target(edge, input_sg);
+            const auto &edge_target = target(edge, input_sg);
             // Check if generation is populated
             auto find_edge_target_generation =
                     m_vertex_to_generation_map.find(edge_target);
@@ -416,7 +416,7 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
             const SpatialGraph &input_sg) {
         std::vector<size_t> generations;
         for (auto &edge : other_out_edges) {
-            const auto &edge_target = boost::target(edge, input_sg);
+            const auto &edge_target = target(edge, input_sg);
             auto find_edge_target_generation =
                     m_vertex_to_generation_map.find(edge_target);
             if (find_edge_target_generation ==
@@ -480,7 +480,7 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
         }
         const size_t target_generation = find_input_target_generation->second;
         for (auto &edge : other_out_edges) {
-            const auto &edge_target = boost::target(edge, input_sg);
+            const auto &edge_target = target(edge, input_sg);
             auto find_edge_target_generation =
                     m_vertex_to_generation_map.find(edge_target);
             if (find_edge_target_generation ==
@@ -515,7 +515,7 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
         }
         std::vector<vertex_descriptor> edge_targets_generations;
         for (auto &edge : other_out_edges) {
-            const auto &edge_target = boost::target(edge, input_sg);
+            const auto &edge_target = target(edge, input_sg);
             auto find_edge_target_generation =
                     m_vertex_to_generation_map.find(edge_target);
             if (find_edge_target_generation ==
@@ -566,8 +566,8 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
             edge_descriptor input_edge, const SpatialGraph &input_sg) {
         // Interested in studying target of the edge_descriptor
         // Obtain the edges that share the source node with e.
-        const auto source = boost::source(input_edge, input_sg);
-        const auto target = boost::target(input_edge, input_sg);
+        const auto source_vertex = source(input_edge, input_sg);
+        const auto target_vertex = target(input_edge, input_sg);
         const auto edges_with_same_source_than_input_edge =
                 get_edges_with_same_source_than_input_edge(input_edge,
                                                            input_sg);
@@ -577,7 +577,7 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
         }
         bool all_targets_have_same_generation =
                 all_out_edge_targets_have_same_generation_than_input_target(
-                        target, edges_with_same_source_than_input_edge,
+                        target_vertex, edges_with_same_source_than_input_edge,
                         input_sg);
         if (!all_targets_have_same_generation) {
             return {};
@@ -594,7 +594,7 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
         std::vector<size_t> distances_from_root;
         std::vector<double> radiuses;
         for (auto &edge : out_edges) {
-            const auto &edge_target = boost::target(edge, input_sg);
+            const auto &edge_target = target(edge, input_sg);
             out_targets.push_back(edge_target);
             distances_from_root.push_back(
                     m_vertex_to_distance_from_root_map.at(edge_target));
@@ -635,19 +635,19 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
             const edge_descriptor &edge_other,
             const SpatialGraph &input_sg,
             const size_t &num_of_edge_points_to_compute_angle) {
-        if (boost::source(edge_coming_from_root, input_sg) !=
-            boost::source(edge_other, input_sg)) {
+        if (source(edge_coming_from_root, input_sg) !=
+            source(edge_other, input_sg)) {
             throw std::runtime_error("angle_between_edges_with_same_source: "
                                      "edges don't have the same source.");
         }
         // Get the source (both edges should share it if we have used
         // boost::out_edges in source)
-        const auto source = boost::source(edge_coming_from_root, input_sg);
-        const auto source_pos = input_sg[source].pos;
+        const auto source_vertex = source(edge_coming_from_root, input_sg);
+        const auto source_pos = input_sg[source_vertex].pos;
 
         const auto target_coming_from_root =
-                boost::target(edge_coming_from_root, input_sg);
-        const auto target_other = boost::target(edge_other, input_sg);
+                target(edge_coming_from_root, input_sg);
+        const auto target_other = target(edge_other, input_sg);
 
         // Initialize the angle point to the node positions of targets.
         SG::PointType angle_point_of_edge_coming_from_root =
@@ -743,7 +743,7 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
             edge_descriptor input_edge, const SpatialGraph &input_sg) {
         // Interested in studying target of the edge_descriptor
         // Obtain the edges that share the source node with e.
-        const auto target = boost::target(input_edge, input_sg);
+        const auto target_vertex = target(input_edge, input_sg);
         const auto edges_with_same_source_than_input_edge =
                 get_edges_with_same_source_than_input_edge(input_edge,
                                                            input_sg);
@@ -753,7 +753,7 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
         }
         bool all_targets_have_generation_populated =
                 all_out_edge_targets_have_generation_populated(
-                        target, edges_with_same_source_than_input_edge,
+                        target_vertex, edges_with_same_source_than_input_edge,
                         input_sg);
         if (!all_targets_have_generation_populated) {
             return {};
@@ -770,7 +770,7 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
         std::vector<vertex_descriptor> out_targets;
         std::vector<size_t> distances_from_root;
         for (auto &edge : out_edges) {
-            const auto &edge_target = boost::target(edge, input_sg);
+            const auto &edge_target = target(edge, input_sg);
             out_targets.push_back(edge_target);
             distances_from_root.push_back(
                     m_vertex_to_distance_from_root_map.at(edge_target));
@@ -818,7 +818,7 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
         std::vector<double> angles;
         std::vector<double> out_targets_siblings_with_lowest_same_genration;
         for (auto &edge : sibling_edges_with_multiple_lowest_generation) {
-            const auto edge_target = boost::target(edge, input_sg);
+            const auto edge_target = target(edge, input_sg);
             // if (edge_target == target_of_edge_coming_from_root) {
             //     angles.push_back(std::numeric_limits<double>::lowest());
             //     continue;
@@ -863,7 +863,7 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
         std::vector<vertex_descriptor> out_targets;
         std::vector<size_t> distances_from_root;
         for (auto &edge : out_edges) {
-            const auto &edge_target = boost::target(edge, input_sg);
+            const auto &edge_target = target(edge, input_sg);
             out_targets.push_back(edge_target);
             // Only study targets that are already visited on tree_edge
             auto find_edge_target_root_distance =
@@ -901,37 +901,37 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
     }
 
     void tree_edge(edge_descriptor e, const SpatialGraph &input_sg) {
-        const auto source = boost::source(e, input_sg);
-        const auto target = boost::target(e, input_sg);
+        const auto source_vertex = source(e, input_sg);
+        const auto target_vertex = target(e, input_sg);
 
         if (m_verbose) {
-            std::cout << "tree_edge: " << e << " , target: " << target << " : "
-                      << ArrayUtilities::to_string(input_sg[target].pos)
+            std::cout << "tree_edge: " << e << " , target: " << target_vertex << " : "
+                      << ArrayUtilities::to_string(input_sg[target_vertex].pos)
                       << std::endl;
         }
 
-        if (!m_vertex_to_distance_from_root_map.count(target)) {
+        if (!m_vertex_to_distance_from_root_map.count(target_vertex)) {
             const size_t source_distance =
-                    m_vertex_to_distance_from_root_map.at(source);
+                    m_vertex_to_distance_from_root_map.at(source_vertex);
             const size_t target_distance = source_distance + 1;
-            m_vertex_to_distance_from_root_map.emplace(target, target_distance);
+            m_vertex_to_distance_from_root_map.emplace(target_vertex, target_distance);
         }
 
         // This would only happen when the user has provided an
         // input_fixed_generation_map
-        if (m_vertex_to_generation_map.count(target)) {
+        if (m_vertex_to_generation_map.count(target_vertex)) {
             // Mark the node as already increased to avoid modifying it in the
             // angle analysis at the end.
-            m_vertex_already_increased.emplace(target, true);
+            m_vertex_already_increased.emplace(target_vertex, true);
             if (m_verbose) {
                 std::cout << "target generation already populated with value: "
-                          << m_vertex_to_generation_map.at(target) << std::endl;
+                          << m_vertex_to_generation_map.at(target_vertex) << std::endl;
             }
             return;
         }
         // Get the radius value of source and target
-        const auto &source_radius = m_vertex_to_local_radius_map.at(source);
-        const auto &target_radius = m_vertex_to_local_radius_map.at(target);
+        const auto &source_radius = m_vertex_to_local_radius_map.at(source_vertex);
+        const auto &target_radius = m_vertex_to_local_radius_map.at(target_vertex);
         const double radius_ratio = target_radius / source_radius;
         const double decrease_ratio = 1.0 - radius_ratio;
         // We consider an anomaly if target has a bigger radius
@@ -944,8 +944,8 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
              m_decrease_radius_ratio_to_increase_generation *
              m_anomaly_parameters.decrease_radius_ratio_factor &&
             input_sg[e].edge_points.size() <= m_anomaly_parameters.num_edge_points_for_short &&
-            boost::degree(target, input_sg) == 1) {
-            m_vertex_anomalies[target] = radius_ratio;
+            degree(target_vertex, input_sg) == 1) {
+            m_vertex_anomalies[target_vertex] = radius_ratio;
         }
 
         /* *****************************************************************/
@@ -969,7 +969,7 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
         // Radius ratio decrease when target is an end node
         // Disable: end point is going to be increased by angle most likely
         const bool target_is_end_point =
-                boost::degree(target, input_sg) == 1 ? true : false;
+                degree(target_vertex, input_sg) == 1 ? true : false;
         // If the target is an end point, be more willing to increase the
         // generation even if there is less reduction of radius. The false
         // positives because this will only come from noisy graphs.
@@ -1014,18 +1014,18 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
 
         // source generation should be always initialized (we start the
         // visit at root)
-        const size_t source_generation = m_vertex_to_generation_map.at(source);
+        const size_t source_generation = m_vertex_to_generation_map.at(source_vertex);
         const size_t target_generation = keep_same_generation
                                                  ? source_generation
                                                  : source_generation + 1;
 
         // We know for sure that target hasn't already been emplaced.
         auto emplaced_pair =
-                m_vertex_to_generation_map.emplace(target, target_generation);
+                m_vertex_to_generation_map.emplace(target_vertex, target_generation);
 
         if (!keep_same_generation) {
             // Mark it to avoid future analysis to increase it further.
-            m_vertex_already_increased.emplace(target, true);
+            m_vertex_already_increased.emplace(target_vertex, true);
         }
 
         // Decrease generation (after radius analysis) if angle is small
@@ -1049,10 +1049,10 @@ struct TreeGenerationVisitor : public boost::default_bfs_visitor {
             std::cout << "  source_generation: " << source_generation
                       << ", target_generation: " << target_generation
                       << std::endl;
-            if (m_vertex_anomalies.count(target)) {
+            if (m_vertex_anomalies.count(target_vertex)) {
                 std::cout << "anomaly: target has a bigger radius than source, "
                              "ratio: "
-                          << m_vertex_anomalies.at(target) << std::endl;
+                          << m_vertex_anomalies.at(target_vertex) << std::endl;
             }
             std::cout << "  increase_generation_because_radius_of_edge: "
                       << std::boolalpha
@@ -21,25 +21,29 @@
 #include "tree_generation.hpp"
 #include "create_vertex_to_radius_map.hpp"
 #include "tree_generation_visitor.hpp"
-#include "filter_spatial_graph.hpp"
+#include "vertex_vector_map.hpp"
+#include <boost/graph/connected_components.hpp>
 #include <fstream>
 #include <iostream>
 
 namespace SG {
 
+namespace {
+template <typename TGraph>
 VertexGenerationMap
-tree_generation(const GraphType &graph,
-                const typename FloatImageType::Pointer &distance_map_image,
-                const bool spatial_nodes_position_are_in_physical_space,
-                const double &decrease_radius_ratio_to_increase_generation,
-                const double &keep_generation_if_angle_less_than,
-                const double &increase_generation_if_angle_greater_than,
-                const size_t &num_of_edge_points_to_compute_angle,
-                const std::vector<GraphType::vertex_descriptor> &input_roots,
-                const VertexGenerationMap &input_fixed_generation_map,
-                const AnomalyParameters &anomaly_parameters,
-                const bool verbose) {
-    using vertex_descriptor = GraphType::vertex_descriptor;
+tree_generation_impl(const TGraph &graph,
+                     const typename FloatImageType::Pointer &distance_map_image,
+                     const bool spatial_nodes_position_are_in_physical_space,
+                     const double &decrease_radius_ratio_to_increase_generation,
+                     const double &keep_generation_if_angle_less_than,
+                     const double &increase_generation_if_angle_greater_than,
+                     const size_t &num_of_edge_points_to_compute_angle,
+                     const std::vector<GraphType::vertex_descriptor> &input_roots,
+                     const VertexGenerationMap &input_fixed_generation_map,
+                     const AnomalyParameters &anomaly_parameters,
+                     const bool verbose) {
+    using vertex_descriptor =
+            typename boost::graph_traits<TGraph>::vertex_descriptor;
     // Start the visit at the root
     // As a first approximation, we select as root the vertex with largest
     // radius
@@ -57,34 +61,41 @@ tree_generation(const GraphType &graph,
 
     std::vector<vertex_descriptor> final_root_nodes;
     if(input_roots.empty()) {
-        const auto component_graphs = SG::filter_component_graphs(graph);
-        const auto num_of_components = component_graphs.size();
+        // The vertex with largest radius of each connected component.
+        std::vector<int> components(num_vertices(graph));
+        const size_t num_of_components = boost::connected_components(
+                graph, boost::make_iterator_property_map(
+                               components.begin(),
+                               get(boost::vertex_index, graph)));
+        std::vector<vertex_descriptor> vertices_with_largest_radius(
+                num_of_components);
+        std::vector<double> largest_radius_per_component(
+                num_of_components, std::numeric_limits<double>::lowest());
+        typename boost::graph_traits<TGraph>::vertex_iterator vi, vi_end;
+        for (std::tie(vi, vi_end) = vertices(graph); vi != vi_end; ++vi) {
+            const auto comp_index = components[*vi];
+            const auto radius = vertex_to_radius_map.at(*vi);
+            if (radius > largest_radius_per_component[comp_index]) {
+                largest_radius_per_component[comp_index] = radius;
+                vertices_with_largest_radius[comp_index] = *vi;
+            }
+        }
         if(verbose) {
             std::cout << "vertices_with_largest_radius per graph component "
                 "(graph componentes where largest radius is 1 are ignored):" << std::endl;
         }
         for (size_t comp_index = 0; comp_index < num_of_components; comp_index++) {
-            const auto & comp_graph  = component_graphs[comp_index];
-            const auto comp_vertex_to_radius_map = create_vertex_to_radius_map(
-                    distance_map_image, comp_graph,
-                    spatial_nodes_position_are_in_physical_space, verbose);
-            using vertex_radius_pair = std::pair<GraphType::vertex_descriptor, double>;
-            const auto max_radius_element = std::max_element(
-                    std::cbegin(comp_vertex_to_radius_map), std::cend(comp_vertex_to_radius_map),
-                    [](const vertex_radius_pair &lhs, const vertex_radius_pair &rhs) {
-                        return lhs.second < rhs.second;
-                    });
-
-            const auto vertex_with_largest_radius = max_radius_element->first;
-            const auto & largest_radius_per_component = max_radius_element->second;
-            if(largest_radius_per_component > 1.0) {
+            const auto vertex_with_largest_radius =
+                    vertices_with_largest_radius[comp_index];
+            const auto largest_radius = largest_radius_per_component[comp_index];
+            if(largest_radius > 1.0) {
                 final_root_nodes.push_back(vertex_with_largest_radius);
                 if (verbose) {
                     std::cout << " - component_index: " << comp_index
                         << " -> vertex_with_largest_radius: "
                         << vertex_with_largest_radius
                         << " with radius: "
-                        << largest_radius_per_component
+                        << largest_radius
                         << std::endl;
                 }
             }
@@ -98,7 +109,7 @@ tree_generation(const GraphType &graph,
     VertexGenerationMap vertex_to_generation_map;
     std::unordered_map<vertex_descriptor, size_t>
         vertex_to_distance_from_root_map;
-    const auto total_vertices = boost::num_vertices(graph);
+    const auto total_vertices = num_vertices(graph);
     for(const auto & root : final_root_nodes) {
         // Check root exists in graph
         if(root > total_vertices - 1) {
@@ -130,9 +141,9 @@ tree_generation(const GraphType &graph,
     // - targets with bigger radius than source,
     // - end points (degree 1)
     // - number of edge points is lesser than:
-    TreeGenerationVisitor<GraphType>::VertexAnomalies vertex_anomalies;
+    typename TreeGenerationVisitor<TGraph>::VertexAnomalies vertex_anomalies;
     // Start the visit from root
-    TreeGenerationVisitor<GraphType> visitor(
+    TreeGenerationVisitor<TGraph> visitor(
             vertex_to_generation_map, distance_map_image, vertex_to_radius_map,
             vertex_to_distance_from_root_map,
             decrease_radius_ratio_to_increase_generation,
@@ -144,9 +155,8 @@ tree_generation(const GraphType &graph,
             anomaly_parameters,
             verbose);
 
-    using ColorMap = std::map<vertex_descriptor, boost::default_color_type>;
-    ColorMap colorMap;
-    boost::associative_property_map<ColorMap> propColorMap(colorMap);
+    VertexColorMap colorMap(num_vertices(graph));
+    auto propColorMap = colorMap.property_map();
     boost::queue<vertex_descriptor> Q; // buffer for bfs
     for(const auto & root: final_root_nodes) {
         if(verbose) {
@@ -172,6 +182,51 @@ tree_generation(const GraphType &graph,
     }
     return vertex_to_generation_map;
 }
+} // namespace
+
+VertexGenerationMap
+tree_generation(const GraphType &graph,
+                const typename FloatImageType::Pointer &distance_map_image,
+                const bool spatial_nodes_position_are_in_physical_space,
+                const double &decrease_radius_ratio_to_increase_generation,
+                const double &keep_generation_if_angle_less_than,
+                const double &increase_generation_if_angle_greater_than,
+                const size_t &num_of_edge_points_to_compute_angle,
+                const std::vector<GraphType::vertex_descriptor> &input_roots,
+                const VertexGenerationMap &input_fixed_generation_map,
+                const AnomalyParameters &anomaly_parameters,
+                const bool verbose) {
+    return tree_generation_impl(
+            graph, distance_map_image,
+            spatial_nodes_position_are_in_physical_space,
+            decrease_radius_ratio_to_increase_generation,
+            keep_generation_if_angle_less_than,
+            increase_generation_if_angle_greater_than,
+            num_of_edge_points_to_compute_angle, input_roots,
+            input_fixed_generation_map, anomaly_parameters, verbose);
+}
+
+VertexGenerationMap
+tree_generation(const FrozenSpatialGraph &graph,
+                const typename FloatImageType::Pointer &distance_map_image,
+                const bool spatial_nodes_position_are_in_physical_space,
+                const double &decrease_radius_ratio_to_increase_generation,
+                const double &keep_generation_if_angle_less_than,
+                const double &increase_generation_if_angle_greater_than,
+                const size_t &num_of_edge_points_to_compute_angle,
+                const std::vector<GraphType::vertex_descriptor> &input_roots,
+                const VertexGenerationMap &input_fixed_generation_map,
+                const AnomalyParameters &anomaly_parameters,
+                const bool verbose) {
+    return tree_generation_impl(
+            graph, distance_map_image,
+            spatial_nodes_position_are_in_physical_space,
+            decrease_radius_ratio_to_increase_generation,
+            keep_generation_if_angle_less_than,
+            increase_generation_if_angle_greater_than,
+            num_of_edge_points_to_compute_angle, input_roots,
+            input_fixed_generation_map, anomaly_parameters, verbose);
+}
 
 VertexGenerationMap read_vertex_to_generation_map(
         const std::string &input_fixed_generation_map_file) {
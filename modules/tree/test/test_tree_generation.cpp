@@ -220,6 +220,41 @@ TEST_F(TreeFixture, tree_generation) {
     EXPECT_EQ(map_from_file, expected_vertex_generation_map);
 }
 
+TEST_F(TreeFixture, tree_generation_frozen_equals_graph) {
+    const double decrease_radius_ratio_to_increase_generation = 0.1;
+    const double keep_generation_if_angle_less_than = 10;
+    const double increase_generation_if_angle_greater_than = 40;
+    const size_t num_of_edge_points_to_compute_angle = 5;
+    const std::vector<SG::GraphType::vertex_descriptor> input_roots;
+    const SG::VertexGenerationMap input_fix_generation_map;
+    const SG::AnomalyParameters anomaly_parameters;
+    const bool verbose = false;
+    const auto vertex_generation_map =
+            SG::tree_generation(g0, distance_map_image,
+                                spatial_nodes_position_are_in_physical_space,
+                                decrease_radius_ratio_to_increase_generation,
+                                keep_generation_if_angle_less_than,
+                                increase_generation_if_angle_greater_than,
+                                num_of_edge_points_to_compute_angle,
+                                input_roots,
+                                input_fix_generation_map,
+                                anomaly_parameters,
+                                verbose);
+    const auto frozen = SG::frozen_spatial_graph_from_graph(g0);
+    const auto frozen_vertex_generation_map =
+            SG::tree_generation(frozen, distance_map_image,
+                                spatial_nodes_position_are_in_physical_space,
+                                decrease_radius_ratio_to_increase_generation,
+                                keep_generation_if_angle_less_than,
+                                increase_generation_if_angle_greater_than,
+                                num_of_edge_points_to_compute_angle,
+                                input_roots,
+                                input_fix_generation_map,
+                                anomaly_parameters,
+                                verbose);
+    EXPECT_EQ(frozen_vertex_generation_map, vertex_generation_map);
+}
+
 TEST_F(TreeFixture, tree_generation_with_input_fixture_map) {
     const double decrease_radius_ratio_to_increase_generation = 0.1;
     const double keep_generation_if_angle_less_than = 10;
@@ -25,7 +25,9 @@ namespace py = pybind11;
 using namespace SG;
 
 void init_spatial_graph_difference(py::module &m) {
-    m.def("spatial_graph_difference", &spatial_graph_difference,
+    m.def("spatial_graph_difference",
+          py::overload_cast<const GraphType &, const GraphType &, double,
+                            bool>(&spatial_graph_difference),
             R"(
 Compute the difference between graphs using their spatial location
 Returns: D = M - S
@@ -30,6 +30,57 @@ R"(Submodule dealing with reading and writing graphs and related data structures
 
     /*******************************************/
 
+    py::class_<MappedSpatialGraph>(mio, "mapped_spatial_graph",
+R"(Read-only spatial graph backed by a memory mapped binary file written with
+write_sg_binary. Opening it only reads the header, the data is accessed
+on demand.
+Use to_graph to get a spatial_graph.)")
+            .def(py::init<const std::string &>(), py::arg("filename"))
+            .def("version", &MappedSpatialGraph::version)
+            .def("num_vertices", &MappedSpatialGraph::num_vertices)
+            .def("num_edges", &MappedSpatialGraph::num_edges)
+            .def("num_edge_points", &MappedSpatialGraph::num_edge_points)
+            .def("vertex_id", &MappedSpatialGraph::vertex_id, py::arg("vertex"))
+            .def("position", &MappedSpatialGraph::position, py::arg("vertex"))
+            .def("edge_source", &MappedSpatialGraph::edge_source,
+                    py::arg("edge_index"))
+            .def("edge_target", &MappedSpatialGraph::edge_target,
+                    py::arg("edge_index"))
+            .def("edge_points", [](const MappedSpatialGraph &mapped,
+                        const size_t edge_index) {
+                    const auto eps = mapped.edge_points(edge_index);
+                    return PointContainer(eps.begin(), eps.end());
+                    }, py::arg("edge_index"))
+            .def("to_graph", &MappedSpatialGraph::to_graph)
+            .def("__repr__", [](const MappedSpatialGraph &mapped) {
+                return "<mapped_spatial_graph: num_vertices: " +
+                       std::to_string(mapped.num_vertices()) +
+                       "; num_edges: " + std::to_string(mapped.num_edges()) +
+                       " >";
+            });
+
+    const std::string binary_sg_docs =
+            R"(
+Binary, little-endian, spatial graph format.
+It keeps the full precision of positions and edge points, and can be memory
+mapped (read_sg_mmap) without parsing the file.
+)";
+
+    mio.def("write_sg_binary",
+            [](const std::string &output_file, GraphType &graph) {
+                return SG::write_sg_binary(output_file, graph);
+    }, binary_sg_docs.c_str(), py::arg("filename"), py::arg("graph"));
+
+    mio.def("read_sg_binary", [](const std::string &input_file) {
+        return SG::read_sg_binary(input_file);
+    }, binary_sg_docs.c_str(), py::arg("filename"));
+
+    mio.def("read_sg_mmap", [](const std::string &input_file) {
+        return SG::read_sg_mmap(input_file);
+    }, binary_sg_docs.c_str(), py::arg("filename"));
+
+    /*******************************************/
+
     const std::string read_write_vertex_to_label_map_common_docs =
             R"(
 Read/Write a CSV-like file containing a one-line header and two comma-separated values
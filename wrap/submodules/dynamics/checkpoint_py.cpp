@@ -0,0 +1,41 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "pybind11_common.h"
+#include "sgdynamics_common_py.hpp"
+#include "checkpoint.hpp"
+
+namespace py = pybind11;
+using namespace SG;
+
+void init_checkpoint(py::module &m) {
+    m.def("write_checkpoint", &write_checkpoint,
+            "Write a binary checkpoint of the system and, if provided, of the "
+            "state of the integrator (method and force types). "
+            "Restore it with read_checkpoint.",
+            py::arg("file_name"), py::arg("sys"),
+            py::arg("integrator") = nullptr, py::arg("time_step") = 0);
+    m.def("read_checkpoint", &read_checkpoint,
+            "Restore a checkpoint written with write_checkpoint into sys and "
+            "integrator, which must have the same integrator method and "
+            "force types. Returns the saved time_step.",
+            py::arg("file_name"), py::arg("sys"),
+            py::arg("integrator") = nullptr);
+}
@@ -21,6 +21,7 @@
 #include "pybind11_common.h"
 #include "sgdynamics_common_py.hpp"
 #include "force_compute.hpp"
+#include "force_kernels.hpp"
 #include "pyforce_compute.hpp" // For trampolin pure virtual PyForceCompute
 
 
@@ -33,6 +34,7 @@ void init_ParticleRandomForceCompute(py::module &m);
 void init_bond_force(py::module &m);
 void init_PairBondForce(py::module &m);
 void init_FixedPairBondForce(py::module &m);
+void init_force_kernels(py::module &m);
 // Wrap to avoid including pybind11/funtional.h in this translation unit
 void wrap_force_function_with_functional(py::class_<ParticleForceCompute, ForceCompute,
         std::shared_ptr<ParticleForceCompute>> &c);
@@ -44,9 +46,11 @@ void init_force_compute(py::module &m) {
         std::shared_ptr<ForceCompute>>(m, "force_compute")
         .def(py::init<const System*>())
         .def_readwrite("particle_forces", &ForceCompute::particle_forces)
-        .def("compute", &ForceCompute::compute)
+        .def("compute", &ForceCompute::compute,
+                py::call_guard<py::gil_scoped_release>())
         .def("reset_forces_to_zero", &ForceCompute::reset_forces_to_zero)
         .def("get_type", &ForceCompute::get_type)
+        .def_readwrite("num_threads", &ForceCompute::num_threads)
         ;
     init_particle_force(m);
     init_ParticleForceCompute(m);
@@ -54,6 +58,7 @@ void init_force_compute(py::module &m) {
     init_bond_force(m);
     init_PairBondForce(m);
     init_FixedPairBondForce(m);
+    init_force_kernels(m);
 }
 
 void init_particle_force(py::module &m) {
@@ -92,6 +97,13 @@ void init_ParticleRandomForceCompute(py::module &m) {
     force_compute_class.def_readonly("gamma", &ParticleRandomForceCompute::gamma);
     force_compute_class.def_readonly("dimension", &ParticleRandomForceCompute::dimension);
     force_compute_class.def_readonly("deltaT", &ParticleRandomForceCompute::deltaT);
+    force_compute_class.def("set_seed", &ParticleRandomForceCompute::set_seed,
+            "Use the counter-based random generator, reproducible from the "
+            "seed and independent of num_threads. Resets step to 0.");
+    force_compute_class.def_readwrite("use_counter_based_rng",
+            &ParticleRandomForceCompute::use_counter_based_rng);
+    force_compute_class.def_readwrite("seed", &ParticleRandomForceCompute::seed);
+    force_compute_class.def_readwrite("step", &ParticleRandomForceCompute::step);
     ;
 }
 
@@ -113,6 +125,9 @@ void init_PairBondForce(py::module &m) {
         .def_readwrite("bond_forces", &PairBondForce::bond_forces)
         .def("only_apply_to_bonds_with_tags", &PairBondForce::only_apply_to_bonds_with_tags,
                 "Only apply the force if the bonds share any tag with the input tags")
+        .def("update_bond_table", &PairBondForce::update_bond_table,
+                "Rebuild the bond table (particle indices and parameters of the bonds). "
+                "Call it after modifying the parameters of the bonds.")
         ;
     wrap_force_function_with_functional(force_compute_class);
 }
@@ -122,8 +137,58 @@ void init_FixedPairBondForce(py::module &m) {
          PairBondForce,
          std::shared_ptr<FixedPairBondForce>>(m, "force_compute_fixed_pair_bond")
         .def("get_type", &FixedPairBondForce::get_type)
-        .def("compute", &FixedPairBondForce::compute)
-        .def("compute_once", &FixedPairBondForce::compute_once)
+        .def("compute", &FixedPairBondForce::compute,
+                py::call_guard<py::gil_scoped_release>())
+        .def("compute_once", &FixedPairBondForce::compute_once,
+                py::call_guard<py::gil_scoped_release>())
         .def("negate_forces", &FixedPairBondForce::negate_forces);
     // wrap_force_function_with_functional(force_compute_class);
 }
+
+void init_force_kernels(py::module &m) {
+    using PairBondForceWLCPetrosyan = PairBondForceT<WLCPetrosyanBondKernel>;
+    py::class_<PairBondForceWLCPetrosyan, PairBondForce,
+         std::shared_ptr<PairBondForceWLCPetrosyan>>(m,
+                 "force_compute_pair_bond_wlc_petrosyan",
+                 "PairBondForce with the wlc_petrosyan force compiled in, "
+                 "faster than using a force_function.")
+        .def(py::init<const System *>())
+        .def(py::init([](const System *sys,
+                        const BondProperties::tags_t &tags) {
+                 return std::make_shared<PairBondForceWLCPetrosyan>(
+                         sys, WLCPetrosyanBondKernel(), tags);
+             }));
+
+    using PairBondForceHarmonic = PairBondForceT<HarmonicBondKernel>;
+    py::class_<PairBondForceHarmonic, PairBondForce,
+         std::shared_ptr<PairBondForceHarmonic>>(m,
+                 "force_compute_pair_bond_harmonic",
+                 "PairBondForce with a harmonic spring F_ab = k (r - r0) r_ab / r")
+        .def(py::init([](const System *sys, const double stiffness,
+                        const double rest_length) {
+                 return std::make_shared<PairBondForceHarmonic>(
+                         sys, HarmonicBondKernel{stiffness, rest_length});
+             }),
+             py::arg("sys"), py::arg("stiffness") = 1.0,
+             py::arg("rest_length") = 0.0)
+        .def_property("stiffness",
+                [](const PairBondForceHarmonic &f) { return f.kernel.stiffness; },
+                [](PairBondForceHarmonic &f, const double v) { f.kernel.stiffness = v; })
+        .def_property("rest_length",
+                [](const PairBondForceHarmonic &f) { return f.kernel.rest_length; },
+                [](PairBondForceHarmonic &f, const double v) { f.kernel.rest_length = v; });
+
+    using ParticleForceLinearDrag = ParticleForceComputeT<LinearDragParticleKernel>;
+    py::class_<ParticleForceLinearDrag, ParticleForceCompute,
+         std::shared_ptr<ParticleForceLinearDrag>>(m,
+                 "force_compute_particle_linear_drag",
+                 "ParticleForceCompute with F = - damping_parameter * velocity")
+        .def(py::init([](const System *sys, const double damping_parameter) {
+                 return std::make_shared<ParticleForceLinearDrag>(
+                         sys, LinearDragParticleKernel{damping_parameter});
+             }),
+             py::arg("sys"), py::arg("damping_parameter") = 1.0)
+        .def_property("damping_parameter",
+                [](const ParticleForceLinearDrag &f) { return f.kernel.damping_parameter; },
+                [](ParticleForceLinearDrag &f, const double v) { f.kernel.damping_parameter = v; });
+}
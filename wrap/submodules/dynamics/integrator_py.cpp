@@ -19,6 +19,7 @@
  * *******************************************************************/
 
 #include "pybind11_common.h"
+#include "fire_minimizer.hpp"
 #include "integrator.hpp"
 #include "pyintegrator.hpp" // Trampolins for pure virtual classes
 #include "sgdynamics_common_py.hpp"
@@ -48,6 +49,32 @@ void init_integrator_methods(py::module &m) {
         .def(py::init<System*, double>())
         // .def_readwrite("deltaT", &VerletVelocitiesIntegratorMethod::deltaT)
         ;
+
+    py::class_<BrownianIntegratorMethod, TwoStepIntegratorMethod,
+        std::shared_ptr<BrownianIntegratorMethod>>(m, "integrator_method_brownian",
+                "Overdamped Brownian dynamics, with the drag and the random "
+                "force included in the method.")
+        .def(py::init<System*, double, double, double, uint64_t>(),
+                py::arg("sys"), py::arg("deltaT"), py::arg("kT"),
+                py::arg("gamma"), py::arg("seed") = 0)
+        .def_readwrite("kT", &BrownianIntegratorMethod::kT)
+        .def_readwrite("gamma", &BrownianIntegratorMethod::gamma)
+        .def_readwrite("seed", &BrownianIntegratorMethod::seed)
+        .def_readwrite("step", &BrownianIntegratorMethod::step)
+        ;
+
+    py::class_<LangevinBAOABIntegratorMethod, TwoStepIntegratorMethod,
+        std::shared_ptr<LangevinBAOABIntegratorMethod>>(m, "integrator_method_langevin_baoab",
+                "Langevin dynamics (BAOAB splitting), with the drag and the "
+                "random force included in the method.")
+        .def(py::init<System*, double, double, double, uint64_t>(),
+                py::arg("sys"), py::arg("deltaT"), py::arg("kT"),
+                py::arg("gamma"), py::arg("seed") = 0)
+        .def_readwrite("kT", &LangevinBAOABIntegratorMethod::kT)
+        .def_readwrite("gamma", &LangevinBAOABIntegratorMethod::gamma)
+        .def_readwrite("seed", &LangevinBAOABIntegratorMethod::seed)
+        .def_readwrite("step", &LangevinBAOABIntegratorMethod::step)
+        ;
 }
 
 void init_integrator(py::module &m) {
@@ -55,15 +82,49 @@ void init_integrator(py::module &m) {
     py::class_<Integrator, PyIntegrator>(m, "integrator")
         .def(py::init<System*>())
         .def_readwrite("force_types", &Integrator::force_types)
-        .def("compute_net_forces", &Integrator::compute_net_forces)
-        .def("update", &Integrator::update)
+        // The GIL is released, so the threads of num_threads can run
+        // python forces (they acquire the GIL in each call).
+        .def("compute_net_forces", &Integrator::compute_net_forces,
+                py::call_guard<py::gil_scoped_release>())
+        .def("update", &Integrator::update,
+                py::call_guard<py::gil_scoped_release>())
         // .def("add_force", &Integrator::add_force)
         // TODO wrap forces first
         .def("add_force",  py::overload_cast<std::shared_ptr<ForceCompute>>(&Integrator::add_force<ForceCompute>))
+        .def_readwrite("num_threads", &Integrator::num_threads,
+                "Number of threads to compute the forces and their sum per "
+                "particle. 1 (default) is serial, 0 uses all the cores. "
+                "The force functions have to be thread-safe, python force "
+                "functions run one at a time, holding the GIL.")
         ;
 
     py::class_<IntegratorTwoStep, Integrator>(m, "integrator_two_step")
         .def(py::init<System*>())
         .def_readwrite("integrator_method", &IntegratorTwoStep::integrator_method)
         ;
+
+    py::class_<FIREMinimizer::Result>(m, "fire_minimizer_result")
+        .def_readonly("converged", &FIREMinimizer::Result::converged)
+        .def_readonly("num_iterations", &FIREMinimizer::Result::num_iterations)
+        .def_readonly("num_force_evaluations", &FIREMinimizer::Result::num_force_evaluations)
+        .def_readonly("max_force", &FIREMinimizer::Result::max_force)
+        ;
+    py::class_<FIREMinimizer>(m, "fire_minimizer",
+            "FIRE minimizer, relaxes the particles of the system to mechanical "
+            "equilibrium under the forces of the integrator.")
+        .def(py::init<System*, Integrator*>(), py::arg("sys"), py::arg("integrator"))
+        .def_readwrite("deltaT", &FIREMinimizer::deltaT)
+        .def_readwrite("deltaT_max", &FIREMinimizer::deltaT_max)
+        .def_readwrite("deltaT_min", &FIREMinimizer::deltaT_min)
+        .def_readwrite("max_displacement", &FIREMinimizer::max_displacement)
+        .def_readwrite("n_min", &FIREMinimizer::n_min)
+        .def_readwrite("f_increase", &FIREMinimizer::f_increase)
+        .def_readwrite("f_decrease", &FIREMinimizer::f_decrease)
+        .def_readwrite("alpha_start", &FIREMinimizer::alpha_start)
+        .def_readwrite("f_alpha", &FIREMinimizer::f_alpha)
+        .def_readwrite("force_tolerance", &FIREMinimizer::force_tolerance)
+        .def_readwrite("max_iterations", &FIREMinimizer::max_iterations)
+        .def("minimize", &FIREMinimizer::minimize,
+                py::call_guard<py::gil_scoped_release>())
+        ;
 }
@@ -31,6 +31,9 @@ struct PyForceCompute : public ForceCompute {
     using ForceCompute::ForceCompute;
     /* Trampoline (need one for each virtual function) */
     void compute() override {
+        // Called from the threads of Integrator::num_threads, with the GIL
+        // released by Integrator.update.
+        pybind11::gil_scoped_acquire gil;
         PYBIND11_OVERLOAD_PURE(
                 void,             /* Return type */
                 ForceCompute, /* Parent class */
@@ -32,6 +32,8 @@ void init_forces(py::module &);
 void init_force_compute(py::module &);
 void init_integrator(py::module &);
 void init_dynamics_graph_glue(py::module &);
+void init_trajectory_io(py::module &);
+void init_checkpoint(py::module &);
 #ifdef SG_USING_VTK
 void init_vtu_file_io(py::module &);
 #endif
@@ -49,6 +51,8 @@ void init_sgdynamics(py::module & mparent) {
     init_force_compute(m);
     init_integrator(m);
     init_dynamics_graph_glue(m);
+    init_trajectory_io(m);
+    init_checkpoint(m);
 #ifdef SG_USING_VTK
     init_vtu_file_io(m);
 #endif
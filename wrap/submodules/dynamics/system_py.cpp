@@ -32,6 +32,10 @@ void init_system(py::module &m) {
         .def(py::init())
         .def_readwrite("all", &System::all)
         .def_readwrite("bonds", &System::bonds)
+        .def_readonly("topology_version", &System::topology_version)
+        .def("invalidate_topology", &System::invalidate_topology,
+                "Call after reordering the particles or changing the particle "
+                "ids of the bonds.")
         .def("__str__", [](const System &sys) {
                 std::stringstream os;
                 os << "particles: " << std::endl;
@@ -0,0 +1,62 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "pybind11_common.h"
+#include "sgdynamics_common_py.hpp"
+#include "trajectory_io.hpp"
+
+namespace py = pybind11;
+using namespace SG;
+
+void init_trajectory_io(py::module &m) {
+    py::enum_<TrajectoryContents>(m, "trajectory_contents", py::arithmetic())
+        .value("positions", TRAJECTORY_POSITIONS)
+        .value("velocities", TRAJECTORY_VELOCITIES)
+        .value("forces", TRAJECTORY_FORCES)
+        ;
+
+    py::class_<TrajectoryWriter>(m, "trajectory_writer",
+            "Write frames of the system to a binary trajectory file, "
+            "using a background thread.")
+        .def(py::init<const std::string &, const System &, const uint32_t>(),
+                py::arg("file_name"), py::arg("sys"),
+                py::arg("contents") = static_cast<uint32_t>(
+                        TRAJECTORY_VELOCITIES | TRAJECTORY_FORCES))
+        .def("write_frame", &TrajectoryWriter::write_frame,
+                py::arg("sys"), py::arg("time_step"))
+        .def("flush", &TrajectoryWriter::flush)
+        .def("close", &TrajectoryWriter::close)
+        .def("num_frames_written", &TrajectoryWriter::num_frames_written)
+        .def("contents", &TrajectoryWriter::contents)
+        ;
+
+    py::class_<TrajectoryReader>(m, "trajectory_reader",
+            "Read a binary trajectory written with trajectory_writer.")
+        .def(py::init<const std::string &>(), py::arg("file_name"))
+        .def("num_particles", &TrajectoryReader::num_particles)
+        .def("num_bonds", &TrajectoryReader::num_bonds)
+        .def("num_frames", &TrajectoryReader::num_frames)
+        .def("contents", &TrajectoryReader::contents)
+        .def("make_system", &TrajectoryReader::make_system)
+        .def("read_frame", &TrajectoryReader::read_frame,
+                py::arg("frame_index"), py::arg("sys"),
+                "Set the state of the frame into sys, returns the time step.")
+        ;
+}
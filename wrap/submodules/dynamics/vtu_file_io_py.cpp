@@ -28,4 +28,9 @@ using namespace SG;
 void init_vtu_file_io(py::module &m) {
     m.def("write_vtu_file", &SG::write_vtu_file);
     m.def("read_vtu_file", &SG::read_vtu_file);
+    m.def("write_vtu_files_from_trajectory", &SG::write_vtu_files_from_trajectory,
+            "Convert the frames of a binary trajectory to vtu files "
+            "output_prefix_<time_step>.vtu. Returns the number of files.",
+            py::arg("trajectory_file_name"), py::arg("output_prefix"),
+            py::arg("stride") = 1);
 }
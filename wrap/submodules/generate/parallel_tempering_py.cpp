@@ -0,0 +1,94 @@
+/* ********************************************************************
+ * Copyright (C) 2020 Pablo Hernandez-Cerdan.
+ *
+ * This file is part of SGEXT: http://github.com/phcerdan/sgext.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * *******************************************************************/
+
+#include "pybind11_common.h"
+
+#include "parallel_tempering.hpp"
+
+#include <sstream>
+
+namespace py = pybind11;
+using namespace SG;
+
+void init_parallel_tempering(py::module &m) {
+    py::class_<parallel_tempering_parameters>(m,
+                                              "parallel_tempering_parameters")
+            .def(py::init())
+            .def_readwrite("temperatures",
+                           &parallel_tempering_parameters::temperatures)
+            .def_readwrite("num_replicas",
+                           &parallel_tempering_parameters::num_replicas)
+            .def_readwrite("temp_max", &parallel_tempering_parameters::temp_max)
+            .def_readwrite("temp_min_ratio",
+                           &parallel_tempering_parameters::temp_min_ratio)
+            .def_readwrite("steps_per_exchange",
+                           &parallel_tempering_parameters::steps_per_exchange)
+            .def_readwrite("num_exchanges",
+                           &parallel_tempering_parameters::num_exchanges)
+            .def_readwrite("num_threads",
+                           &parallel_tempering_parameters::num_threads)
+            .def("__repr__", [](const parallel_tempering_parameters &p) {
+                std::stringstream os;
+                p.print(os);
+                return os.str();
+            });
+
+    py::class_<parallel_tempering>(m, "parallel_tempering",
+            "Parallel tempering (replica exchange) of "
+            "simulated_annealing_generator replicas, at a ladder of fixed "
+            "temperatures.")
+            .def(py::init<const simulated_annealing_generator_config_tree &,
+                          const parallel_tempering_parameters &>(),
+                 py::arg("tree"),
+                 py::arg("parameters") = parallel_tempering_parameters())
+            .def("engine", &parallel_tempering::engine,
+                 "Run the exchange rounds, returns the graph with the lowest "
+                 "energy.",
+                 py::call_guard<py::gil_scoped_release>())
+            .def_readwrite("parameters", &parallel_tempering::parameters)
+            .def_property_readonly("num_replicas",
+                                   &parallel_tempering::num_replicas)
+            .def_property_readonly("temperatures",
+                                   &parallel_tempering::temperatures)
+            .def_property_readonly("temperature_of_replica",
+                                   &parallel_tempering::temperature_of_replica)
+            .def("replica", &parallel_tempering::replica,
+                 py::return_value_policy::reference_internal)
+            .def("replica_at_temperature",
+                 &parallel_tempering::replica_at_temperature,
+                 py::return_value_policy::reference_internal)
+            .def_property_readonly("best_graph",
+                                   &parallel_tempering::best_graph)
+            .def_property_readonly("best_energy",
+                                   &parallel_tempering::best_energy)
+            .def_property_readonly("exchanges_performed",
+                                   &parallel_tempering::exchanges_performed)
+            .def("acceptance_rates", &parallel_tempering::acceptance_rates)
+            .def("acceptance_rates_per_temperature",
+                 &parallel_tempering::acceptance_rates_per_temperature)
+            .def("swap_rates", &parallel_tempering::swap_rates)
+            .def("swap_rates_per_temperature",
+                 &parallel_tempering::swap_rates_per_temperature)
+            .def("__str__", [](const parallel_tempering &pt) {
+                std::stringstream os;
+                pt.print(os);
+                return os.str();
+            });
+}
@@ -215,6 +215,10 @@ void init_simulated_annealing_generator(py::module &m) {
             .def("engine",
                  &simulated_annealing_generator::engine,
                  py::arg("reset_steps") = false)
+            .def_readwrite("use_incremental_energy",
+                 &simulated_annealing_generator::use_incremental_energy,
+                 "Update the energy in O(log bins) with every step of engine, "
+                 "instead of recomputing it from the histograms.")
             .def_readwrite("graph",
                  &simulated_annealing_generator::graph_)
             .def_readwrite("histo_ete_distances",
@@ -86,8 +86,12 @@ closest to the point in that radius, and the distance squared to the point.
 
     /* ************************************************************ */
 
-    m.def("get_vtk_points_from_graph", &get_vtk_points_from_graph);
+    m.def("get_vtk_points_from_graph",
+          py::overload_cast<const GraphType &>(&get_vtk_points_from_graph));
 
-    m.def("get_vtk_points_from_graphs", &get_vtk_points_from_graphs,
+    m.def("get_vtk_points_from_graphs",
+          py::overload_cast<
+                  const std::vector<std::reference_wrapper<const GraphType>> &,
+                  const BoundingBox *>(&get_vtk_points_from_graphs),
           py::arg("graphs"), py::arg("bounding_box") = nullptr);
 }
@@ -46,7 +46,15 @@ decrease_radius_ratio_to_increase_generation, to mark it as an anomaly.
         return os.str();
       });
 
-    m.def("tree_generation", &tree_generation,
+    m.def("tree_generation",
+          py::overload_cast<const GraphType &,
+                            const FloatImageType::Pointer &,
+                            const bool, const double &, const double &,
+                            const double &, const size_t &,
+                            const std::vector<GraphType::vertex_descriptor> &,
+                            const VertexGenerationMap &,
+                            const AnomalyParameters &, const bool>(
+                  &tree_generation),
           R"(
 Associate to each node of the graph a generation based on the branching of
 the tree. Generation = 0 is associated to the root node. An end node of the
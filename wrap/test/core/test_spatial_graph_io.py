@@ -27,6 +27,7 @@ class TestSpatialGraphIo(unittest.TestCase):
     def setUp(self):
         self.graphviz_file = "graphviz_out.dot"
         self.serialized_file = "serialized_out.txt"
+        self.binary_file = "binary_out.sgb"
         self.vertex_to_label_map_file = "vertex_to_label_map_out.txt"
         self.edge_to_label_map_file = "edge_to_label_map_out.txt"
 
@@ -54,6 +55,26 @@ class TestSpatialGraphIo(unittest.TestCase):
         self.assertEqual(graph.num_vertices(), 2)
         self.assertAlmostEqual(graph.spatial_node(1).pos[0], 1.0)
 
+    def test_a_write_sg_binary(self):
+        graph = core.spatial_graph(2);
+        sn = core.spatial_node()
+        sn.pos = [1.0,1.0,1.0]
+        graph.set_vertex(1, sn)
+        core.io.write_sg_binary(self.binary_file, graph)
+
+    def test_b_read_sg_binary(self):
+        graph = core.io.read_sg_binary(self.binary_file)
+        self.assertEqual(graph.num_vertices(), 2)
+        self.assertAlmostEqual(graph.spatial_node(1).pos[0], 1.0)
+
+    def test_b_read_sg_mmap(self):
+        mapped = core.io.read_sg_mmap(self.binary_file)
+        self.assertEqual(mapped.num_vertices(), 2)
+        self.assertEqual(mapped.num_edges(), 0)
+        self.assertAlmostEqual(mapped.position(1)[0], 1.0)
+        graph = mapped.to_graph()
+        self.assertEqual(graph.num_vertices(), 2)
+
     def test_a_write_vertex_to_label_map(self):
         vertex_to_label_map = {1: 201, 12: 23}
         core.io.write_vertex_to_label_map(
@@ -47,3 +47,21 @@ class TestDynamicsForceCompute(unittest.TestCase):
             bond.properties = props
 
         self.force_compute.compute()
+    def test_force_kernels(self):
+        self.fixture.system.all.sort()
+        force_compute = dynamics.force_compute_pair_bond_wlc_petrosyan(self.fixture.system)
+        self.assertEqual(force_compute.get_type(), "PairBondForceT")
+        with self.assertRaises(RuntimeError):
+            force_compute.compute()
+        props = dynamics.bond_properties_physical(1.0, 1.0)
+        for bond in self.fixture.system.bonds.bonds:
+            bond.properties = props
+        force_compute.update_bond_table()
+        force_compute.compute()
+        harmonic = dynamics.force_compute_pair_bond_harmonic(
+            self.fixture.system, stiffness=2.0, rest_length=0.5)
+        harmonic.compute()
+        self.assertAlmostEqual(harmonic.stiffness, 2.0)
+        drag = dynamics.force_compute_particle_linear_drag(
+            self.fixture.system, damping_parameter=0.1)
+        drag.compute()
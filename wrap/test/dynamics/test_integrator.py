@@ -18,8 +18,22 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 from sgext import dynamics
 import unittest
+import os, tempfile
 from fixture_system4 import System4Fixture
 
+def a_gravity_force(a_particle):
+    return [0.0, 0.0, -1.0]
+
+class PythonDragForce(dynamics.force_compute):
+    def __init__(self, system, damping):
+        dynamics.force_compute.__init__(self, system)
+        self.system = system
+        self.damping = damping
+    def compute(self):
+        self.particle_forces = [
+            dynamics.particle_force(p.id, [-self.damping * v for v in p.dynamics.vel])
+            for p in self.system.all.particles]
+
 class TestDynamicsIntegrator(unittest.TestCase):
     def setUp(self):
         self.fixture = System4Fixture()
@@ -29,3 +43,41 @@ class TestDynamicsIntegrator(unittest.TestCase):
 
     def test_print(self):
         print("Integrator:")
+
+    def test_checkpoint(self):
+        self.integrator.integrator_method = dynamics.integrator_method_langevin_baoab(
+            self.fixture.system, deltaT=0.01, kT=1.0, gamma=0.5, seed=3)
+        self.integrator.add_force(dynamics.force_compute_pair_bond_harmonic(
+            self.fixture.system, stiffness=2.0, rest_length=0.5))
+        for step in range(5):
+            self.integrator.update(step)
+        file_name = os.path.join(tempfile.mkdtemp(), "checkpoint.sgchk")
+        dynamics.write_checkpoint(file_name, self.fixture.system,
+                                  self.integrator, time_step=5)
+        for step in range(5):
+            self.integrator.update(step)
+        expected = [p.pos for p in self.fixture.system.all.particles]
+        time_step = dynamics.read_checkpoint(file_name, self.fixture.system,
+                                             self.integrator)
+        self.assertEqual(time_step, 5)
+        for step in range(5):
+            self.integrator.update(step)
+        for p, pos in zip(self.fixture.system.all.particles, expected):
+            self.assertEqual(list(p.pos), list(pos))
+        os.remove(file_name)
+
+    def test_python_forces_with_threads(self):
+        # update releases the GIL, the threads running the python forces
+        # take it in each call.
+        self.integrator.integrator_method = self.integrator_method
+        gravity = dynamics.force_compute_particle(self.fixture.system)
+        gravity.force_function = a_gravity_force
+        self.integrator.add_force(gravity)
+        drag = PythonDragForce(self.fixture.system, 0.5)
+        self.integrator.add_force(drag)
+        self.integrator.num_threads = 2
+        for step in range(10):
+            self.integrator.update(step)
+        for p in self.fixture.system.all.particles:
+            self.assertLess(p.pos[2], 0.0)
+            self.assertLess(p.dynamics.vel[2], 0.0)
@@ -79,5 +79,21 @@ class TestSimulatedAnnealingC(unittest.TestCase):
         gen.engine()
         gen.save_parameters_to_file(self.output_file)
 
+    def test_parallel_tempering(self):
+        config_tree = generate.simulated_annealing_generator_config_tree()
+        config_tree.load(self.parameters_file)
+        parameters = generate.parallel_tempering_parameters()
+        parameters.num_replicas = 3
+        parameters.steps_per_exchange = 100
+        parameters.num_exchanges = 5
+        pt = generate.parallel_tempering(config_tree, parameters)
+        self.assertEqual(pt.num_replicas, 3)
+        best_graph = pt.engine()
+        self.assertEqual(best_graph.num_vertices(), 100)
+        self.assertEqual(len(pt.swap_rates_per_temperature()), 2)
+        self.assertLessEqual(pt.best_energy,
+                             pt.replica_at_temperature(0).transition_params.energy)
+        print(pt)
+
 if __name__ == '__main__':
     unittest.main()